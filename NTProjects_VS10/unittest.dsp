@@ -143,6 +143,10 @@ SOURCE=..\unittest\ManyObjs.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\unittest\MapIO.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\unittest\MkComp2x.c
 # End Source File
 # Begin Source File
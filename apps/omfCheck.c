@@ -28,6 +28,11 @@
 #include <string.h>
 #include <stdlib.h>
 #include <time.h>
+#if PORT_SYS_UNIX
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
 
 #define OMFI_ENABLE_SEMCHECK 1 /* For semantic checking fns in omUtils.h */
 #include "omPublic.h"
@@ -57,6 +62,8 @@
 #define TRUE 1
 #define FALSE 0
 /*#define NULL 0	*/
+#define NUM_PASSES 3
+#define MAX_PARTS 64
 
 /**********
  * MACROS *
@@ -76,13 +83,32 @@ static void usage(char *cmdName, omfProductVersion_t toolkitVers,
 				  omfInt32 appVers);
 static void printHeader(char *name, omfProductVersion_t toolkitVers, 
 						            omfInt32 appVers);
+static omfErr_t checkPass(omfFileCheckHdl_t hdl, omfHdl_t file, 
+						  omfInt32 pass, omfInt32 *numErrors, 
+						  omfInt32 *numWarnings, FILE *textOut);
+#if PORT_SYS_UNIX
+static omfErr_t checkParts(omfSessionHdl_t session, char *fname,
+						   omfInt32 numParts, omfInt32 *numErrors,
+						   omfInt32 *numWarnings, char *errBuf,
+						   omfInt16 errBufLen);
+#endif
 
 /********************/
 /* GLOBAL VARIABLES */
 /********************/
 omfBool gVerbose = FALSE, gWarnings = FALSE;
+omfInt32 gNumParts = 1;
 const omfInt32 omfiAppVersion = 1;
 
+static char *passHeaders[NUM_PASSES] = {
+	"PASS 1.... Verify individual objects and their properties\n"
+	"**********************************************\n",
+	"PASS 2.... Verify mob structures\n"
+	"********************************\n",
+	"PASS 3.... Verify Local Media Data Integrity\n"
+	"********************************\n"
+};
+
 /****************
  * MAIN PROGRAM *
  ****************/
@@ -96,8 +122,10 @@ int main(int argc, char *argv[])
     omfInt32	totalErrors, totalWarnings;
 	omfFileCheckHdl_t	hdl;
 	omfFileRev_t fileRev;
+	omfInt32	pass;
 	char        *fname, *printfname;
     char errBuf[256];
+    omfBool errBufSet = FALSE;
     omfErr_t omfError = OM_ERR_NONE;
 #if PORT_SYS_MAC && !defined(MAC_DRAG_DROP)
 	char            namebuf[255];
@@ -142,6 +170,15 @@ int main(int argc, char *argv[])
 				gVerbose = TRUE;
 			else if (streq(argv[0], "-w"))  
 				gWarnings = TRUE;
+			else if (streq(argv[0], "-j") && (argc > 1))
+			{
+				argc--, argv++;
+				gNumParts = atoi(argv[0]);
+				if (gNumParts < 1)
+					gNumParts = 1;
+				else if (gNumParts > MAX_PARTS)
+					gNumParts = MAX_PARTS;
+			}
 		}
 
 		totalErrors = 0;
@@ -199,40 +236,36 @@ int main(int argc, char *argv[])
 				printf("File is being checked as an OMFI 1.0 file (IMA)\n");
 			else
 				printf("File is being checked as an OMFI 2.0 file\n");
-			CHECK(omfsFileCheckInit(file, &hdl));
-
-		    /***************************************************************/
-		    printf("PASS 1.... Verify individual objects and their properties\n");
-		    printf("**********************************************\n");
-		    CHECK(omfsFileCheckObjectIntegrity(hdl,
-	    				(gVerbose ? kCheckVerbose : kCheckQuiet),
-	    				(gWarnings ? kCheckPrintWarnings : kCheckNoWarnings),
-						&tstErr, &tstWarn, stdout));
-			fileErrors += tstErr;
-			fileWarnings += tstWarn;
-		
-		    /***************************************************************/
-		    printf("PASS 2.... Verify mob structures\n");
-		    printf("********************************\n");
-			omfsSemanticCheckOff(file);
-		    CHECK(omfsFileCheckMobData(hdl,
-	    				(gVerbose ? kCheckVerbose : kCheckQuiet),
-	    				(gWarnings ? kCheckPrintWarnings : kCheckNoWarnings),
-						&tstErr, &tstWarn, stdout));
-			omfsSemanticCheckOn(file);
-			fileErrors += tstErr;
-			fileWarnings += tstWarn;
-
-		    /***************************************************************/
-		    printf("PASS 3.... Verify Local Media Data Integrity\n");
-		    printf("********************************\n");
-			CHECK(omfsFileCheckMediaIntegrity(hdl,
-	    				(gVerbose ? kCheckVerbose : kCheckQuiet),
-	    				(gWarnings ? kCheckPrintWarnings : kCheckNoWarnings),
-					&tstErr, &tstWarn, stdout));
-
-			/* Cleanup and close file */
-		    CHECK(omfsFileCheckCleanup(hdl));
+
+#if PORT_SYS_UNIX
+			if (gNumParts > 1)
+			  {
+				/* Check slices of the file in worker processes */
+				omfError = checkParts(session, fname, gNumParts,
+									  &fileErrors, &fileWarnings,
+									  errBuf, sizeof(errBuf));
+				if (omfError != OM_ERR_NONE)
+				  {
+					errBufSet = TRUE;
+					RAISE(omfError);
+				  }
+			  }
+			else
+#endif
+			  {
+				CHECK(omfsFileCheckInit(file, &hdl));
+				for (pass = 0; pass < NUM_PASSES; pass++)
+				  {
+					printf("%s", passHeaders[pass]);
+					CHECK(checkPass(hdl, file, pass, &tstErr, &tstWarn, 
+									stdout));
+					fileErrors += tstErr;
+					fileWarnings += tstWarn;
+				  }
+				CHECK(omfsFileCheckCleanup(hdl));
+			  }
+
+			/* Close file */
 		    CHECK(omfsCloseFile(file));
 
 		    totalErrors += fileErrors;
@@ -254,9 +287,9 @@ int main(int argc, char *argv[])
 	} /* XPROTECT */
 	XEXCEPT
     {
-		printf("*** ERROR: %d: %s\n", XCODE(), 
-                                      omfsGetExpandedErrorString(file, 
-									  XCODE(), sizeof(errBuf), errBuf));
+		if (!errBufSet)
+			omfsGetExpandedErrorString(file, XCODE(), sizeof(errBuf), errBuf);
+		printf("*** ERROR: %d: %s\n", XCODE(), errBuf);
 		return(-1);
 	}
 	XEND;
@@ -275,10 +308,243 @@ static void usage(char *cmdName,
 	fprintf(stderr, "%s %ld.%ld.%ldr%ld\n", cmdName, 
 			toolkitVers.major, toolkitVers.minor, toolkitVers.tertiary,
 			appVers);
-	fprintf(stderr, "Usage: %s [-h] [-v] [-w] [-a] <filename>\n", cmdName);
+	fprintf(stderr, "Usage: %s [-h] [-v] [-w] [-a] [-j N] <filename>\n", cmdName);
 	fprintf(stderr, "%s semantically verifies an OMFI file\n", cmdName);
+#if PORT_SYS_UNIX
+	fprintf(stderr, "  -j N  check each file in N worker processes\n");
+#endif
+}
+
+/*************/
+/* checkPass */
+/*************/
+static omfErr_t checkPass(omfFileCheckHdl_t hdl,
+						  omfHdl_t file,
+						  omfInt32 pass,
+						  omfInt32 *numErrors,
+						  omfInt32 *numWarnings,
+						  FILE *textOut)
+{
+	omfCheckVerbose_t	verbose = (gVerbose ? kCheckVerbose : kCheckQuiet);
+	omfCheckWarnings_t	warn = (gWarnings ? kCheckPrintWarnings 
+								             : kCheckNoWarnings);
+
+	XPROTECT(file)
+	  {
+		switch (pass)
+		  {
+		  case 0:	/* Verify individual objects and their properties */
+			CHECK(omfsFileCheckObjectIntegrity(hdl, verbose, warn,
+											   numErrors, numWarnings,
+											   textOut));
+			break;
+
+		  case 1:	/* Verify mob structures */
+			omfsSemanticCheckOff(file);
+			CHECK(omfsFileCheckMobData(hdl, verbose, warn,
+									   numErrors, numWarnings, textOut));
+			omfsSemanticCheckOn(file);
+			break;
+
+		  case 2:	/* Verify local media data integrity */
+			CHECK(omfsFileCheckMediaIntegrity(hdl, verbose, warn,
+											  numErrors, numWarnings,
+											  textOut));
+			break;
+		  }
+	  }
+	XEXCEPT
+	XEND
+
+	return(OM_ERR_NONE);
 }
 
+#if PORT_SYS_UNIX
+/* What a worker process reports back about its part of a file.
+ * failedPass is -1 if the worker failed before the first pass, and
+ * NUM_PASSES if it did not fail at all.
+ */
+typedef struct
+{
+	omfInt32	numErrors[NUM_PASSES];
+	omfInt32	numWarnings[NUM_PASSES];
+	omfInt32	failedPass;
+	omfErr_t	status;
+	char		errBuf[256];
+} partResult_t;
+
+/*************/
+/* checkPart */
+/*************/
+/* Runs in a worker process.  The toolkit keeps per-session (and some
+ * static) state which may not be shared between threads, so each part is
+ * checked by a forked copy of the checker with its own handle on the file.
+ */
+static void checkPart(omfSessionHdl_t session,
+					  char *fname,
+					  omfInt32 part,
+					  omfInt32 numParts,
+					  FILE **passOut,
+					  FILE *resultOut)
+{
+	partResult_t		result;
+	omfHdl_t			file = NULL;
+	omfFileCheckHdl_t	hdl;
+	omfInt32			pass;
+
+	memset(&result, 0, sizeof(result));
+	result.failedPass = -1;
+
+	XPROTECT(NULL)
+	  {
+		CHECK(omfsOpenFile((fileHandleType) fname, session, &file));
+		CHECK(omfsFileCheckInit(file, &hdl));
+		CHECK(omfsFileCheckSetPartition(hdl, part, numParts));
+		for (pass = 0; pass < NUM_PASSES; pass++)
+		  {
+			result.failedPass = pass;
+			CHECK(checkPass(hdl, file, pass, &result.numErrors[pass], 
+							&result.numWarnings[pass], passOut[pass]));
+		  }
+		result.failedPass = NUM_PASSES;
+	  }
+	XEXCEPT
+	  {
+		NO_PROPAGATE();
+		result.status = XCODE();
+		omfsGetExpandedErrorString(file, XCODE(), sizeof(result.errBuf),
+								   result.errBuf);
+	  }
+	XEND_VOID;
+
+	for (pass = 0; pass < NUM_PASSES; pass++)
+		fflush(passOut[pass]);
+	fwrite(&result, sizeof(result), 1, resultOut);
+	fflush(resultOut);
+}
+
+/**************/
+/* checkParts */
+/**************/
+/* Checks a file in numParts worker processes, each checking one slice of
+ * the objects and mobs, and prints their output in part order under each
+ * pass header.  The output is the same as a serial check of the file.
+ */
+static omfErr_t checkParts(omfSessionHdl_t session,
+						   char *fname,
+						   omfInt32 numParts,
+						   omfInt32 *numErrors,
+						   omfInt32 *numWarnings,
+						   char *errBuf,
+						   omfInt16 errBufLen)
+{
+	FILE			*passOut[MAX_PARTS][NUM_PASSES];
+	FILE			*resultOut[MAX_PARTS];
+	partResult_t	results[MAX_PARTS];
+	omfInt32		part, pass, numStarted = 0;
+	omfErr_t		status = OM_ERR_NONE;
+	char			copyBuf[4096];
+	size_t			bytes;
+	pid_t			pid;
+
+	memset(passOut, 0, sizeof(passOut));
+	memset(resultOut, 0, sizeof(resultOut));
+	errBuf[0] = '\0';
+
+	/* Start the workers.  Output buffered in stdout must be flushed first,
+	 * or each worker would inherit a copy of it.
+	 */
+	fflush(stdout);
+	fflush(stderr);
+	for (part = 0; (part < numParts) && (status == OM_ERR_NONE); part++)
+	  {
+		for (pass = 0; pass < NUM_PASSES; pass++)
+		  {
+			passOut[part][pass] = tmpfile();
+			if (passOut[part][pass] == NULL)
+				status = OM_ERR_BADOPEN;
+		  }
+		resultOut[part] = tmpfile();
+		if (resultOut[part] == NULL)
+			status = OM_ERR_BADOPEN;
+		if (status != OM_ERR_NONE)
+			break;
+
+		pid = fork();
+		if (pid == 0)
+		  {
+			checkPart(session, fname, part, numParts, passOut[part], 
+					  resultOut[part]);
+			_exit(0);
+		  }
+		else if (pid < 0)
+			status = OM_ERR_BADOPEN;
+		else
+			numStarted++;
+	  }
+	while ((numStarted > 0) && (wait(NULL) > 0))
+		numStarted--;
+	if (status != OM_ERR_NONE)
+		strncpy(errBuf, omfsGetErrorString(status), (size_t)errBufLen);
+
+	/* Collect what the workers found */
+	for (part = 0; (part < numParts) && (status == OM_ERR_NONE); part++)
+	  {
+		rewind(resultOut[part]);
+		if (fread(&results[part], sizeof(results[part]), 1, 
+				  resultOut[part]) != 1)
+		  {
+			status = OM_ERR_TEST_FAILED;
+			sprintf(errBuf, "%.64s (checker for part %ld of %ld exited)",
+					omfsGetErrorString(status), part+1, numParts);
+		  }
+		else if (results[part].failedPass < 0)
+		  {
+			status = results[part].status;
+			strncpy(errBuf, results[part].errBuf, (size_t)errBufLen);
+		  }
+	  }
+
+	/* Print the output of each pass in part order, up to the first 
+	 * failure, as the serial check would have.
+	 */
+	for (pass = 0; (pass < NUM_PASSES) && (status == OM_ERR_NONE); pass++)
+	  {
+		printf("%s", passHeaders[pass]);
+		fflush(stdout);
+		for (part = 0; part < numParts; part++)
+		  {
+			rewind(passOut[part][pass]);
+			while ((bytes = fread(copyBuf, 1, sizeof(copyBuf), 
+								  passOut[part][pass])) > 0)
+				fwrite(copyBuf, 1, bytes, stdout);
+			*numErrors += results[part].numErrors[pass];
+			*numWarnings += results[part].numWarnings[pass];
+			if (results[part].failedPass == pass)
+			  {
+				status = results[part].status;
+				strncpy(errBuf, results[part].errBuf, (size_t)errBufLen);
+				break;
+			  }
+		  }
+	  }
+	errBuf[errBufLen-1] = '\0';
+
+	for (part = 0; part < numParts; part++)
+	  {
+		for (pass = 0; pass < NUM_PASSES; pass++)
+		  {
+			if (passOut[part][pass] != NULL)
+				fclose(passOut[part][pass]);
+		  }
+		if (resultOut[part] != NULL)
+			fclose(resultOut[part]);
+	  }
+
+	return(status);
+}
+#endif
+
 /***************/
 /* printHeader */
 /****************/
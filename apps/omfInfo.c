@@ -93,6 +93,7 @@ static omfErr_t PrintPulldownInfo(omfHdl_t fileHdl,
 /********************/
 const omfInt32 omfiAppVersion = 4;
 omfBool		printQTables = FALSE;
+omfBool		printHashStats = FALSE;
 omfInt32	frameSizeCount = 0;
 
 omfPosition_t	sourcePos;
@@ -199,6 +200,8 @@ int main(int argc, char *argv[])
 		{
 			if(strcmp(argv[filearg], "qtab") == 0)
 				printQTables = TRUE;
+			if(strcmp(argv[filearg], "-hash") == 0)
+				printHashStats = TRUE;
 			if(strcmp(argv[filearg], "-fs") == 0)
 			{
 				filearg++;
@@ -270,6 +273,17 @@ int main(int argc, char *argv[])
 	    else
 	      printf("OMF File Revision UNKNOWN\n");
 
+	    if(printHashStats)
+	      {
+		omfInt32 hist[8], longest, bin;
+
+		CHECK(omfsTableGetChainHistogram(fileHdl->mobs, 8, hist, &longest));
+		printf("Mob table probes:");
+		for(bin = 0; bin < 8; bin++)
+		  printf(" %ld%s:%ld", bin+1, (bin == 7 ? "+" : ""), hist[bin]);
+		printf(" (longest %ld)\n", longest);
+	      }
+
 /*	    omfmLocatorFailureCallback(fileHdl, locatorFailure);	*/
 
 	    omfiDatakindLookup(fileHdl, PICTUREKIND, &pictureDef, &omfError);
@@ -1385,10 +1399,11 @@ static void usage(char *cmdName,
   fprintf(stderr, "%s %ld.%ld.%ldr%ld\n", cmdName,
 	  toolkitVers.major, toolkitVers.minor, toolkitVers.tertiary,
 	  appVers);
-  fprintf(stderr, "Usage: %s [-qtab] [-fs <count>] <filename>\n", cmdName);
+  fprintf(stderr, "Usage: %s [-qtab] [-hash] [-fs <count>] <filename>\n", cmdName);
   fprintf(stderr, "%s prints general info on an OMFI file\n", cmdName);
   fprintf(stderr, "-qtab means to print the Q tables (if any)\n", cmdName);
   fprintf(stderr, "-fs <count> means to print <count> frame sizes\n", cmdName);
+  fprintf(stderr, "-hash means to print the mob table hash distribution\n", cmdName);
 }
 
 /***************/
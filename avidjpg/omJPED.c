@@ -72,15 +72,23 @@
 
 #include <setjmp.h>
 
-/* These static variables are needed by the error routines. */
-static jmp_buf  setjmp_buffer;	/* for return to caller */
-static external_methods_ptr emethods;	/* needed for access to msg_parm */
-
-static int      visited = 0;
+/*
+ * Per-call state needed by the error routines and the source/destination
+ * managers.  One of these lives on the stack of each compress/decompress
+ * call, so several samples may be coded at once.  The JPEG code only sees
+ * the embedded external methods struct, so it must come first.
+ */
+typedef struct
+{
+	struct External_methods_struct e_methods;
+	jmp_buf         setjmp_buffer;	/* for return to caller */
+	int             visited;
+	char            errorString[512];
+	int             errorRaised;
+	omfErr_t        status;
+} omJPEGContext_t;
 
-static char            OMJPEGErrorString[512];
-static int             OMJPEGErrorRaised = 0;
-static omfErr_t        localJPEGStatus =	OM_ERR_NONE;
+#define JPEG_CONTEXT(info)	((omJPEGContext_t *) (info)->emethods)
 
 #if  PORT_MEM_DOS16
 #define PIXEL unsigned char huge
@@ -89,8 +97,8 @@ static omfErr_t        localJPEGStatus =	OM_ERR_NONE;
 #endif
 
 METHODDEF void  jselromfi(decompress_info_ptr cinfo);
-METHODDEF void  trace_message(const char *msgtext);
-METHODDEF void  error_exit(const char *msgtext);
+METHODDEF void  trace_message(external_methods_ptr emethods, const char *msgtext);
+METHODDEF void  error_exit(external_methods_ptr emethods, const char *msgtext);
 METHODDEF void  input_init(compress_info_ptr cinfo);
 METHODDEF void  get_input_row(compress_info_ptr cinfo, JSAMPARRAY pixel_row);
 METHODDEF void  input_term(compress_info_ptr cinfo);
@@ -150,16 +158,18 @@ METHODDEF void  jselromfi(decompress_info_ptr dinfo);
  */
 
 METHODDEF void
-                trace_message(const char *msgtext)
+                trace_message(external_methods_ptr emethods, const char *msgtext)
 {
-	sprintf(OMJPEGErrorString, msgtext,
+	omJPEGContext_t *ctx = (omJPEGContext_t *) emethods;
+
+	sprintf(ctx->errorString, msgtext,
 		emethods->message_parm[0], emethods->message_parm[1],
 		emethods->message_parm[2], emethods->message_parm[3],
 		emethods->message_parm[4], emethods->message_parm[5],
 		emethods->message_parm[6], emethods->message_parm[7]);
 
 #ifdef JPEG_TRACE
-	fprintf(stderr, "%s\n", OMJPEGErrorString);	/* there is no \n in the
+	fprintf(stderr, "%s\n", ctx->errorString);	/* there is no \n in the
 							 * format string! */
 #endif
 }
@@ -187,23 +197,25 @@ METHODDEF void
  */
 
 METHODDEF void
-                error_exit(const char *msgtext)
+                error_exit(external_methods_ptr emethods, const char *msgtext)
 {
-	trace_message(msgtext);	/* report the error message */
-	(*emethods->free_all) ();	/* clean up memory allocation & temp
+	omJPEGContext_t *ctx = (omJPEGContext_t *) emethods;
+
+	trace_message(emethods, msgtext);	/* report the error message */
+	(*emethods->free_all) (emethods);	/* clean up memory allocation & temp
 					 * files */
 
 	/*
 	 * Set OMFI error code to signal a JPEG failure, unless set
 	 * previously
 	 */
-	if (localJPEGStatus == OM_ERR_NONE)
-		localJPEGStatus = OM_ERR_JPEGPROBLEM;
+	if (ctx->status == OM_ERR_NONE)
+		ctx->status = OM_ERR_JPEGPROBLEM;
 
-	OMJPEGErrorRaised = 1;	/* indicate that the message string is an
+	ctx->errorRaised = 1;	/* indicate that the message string is an
 				 * error message */
 
-	longjmp(setjmp_buffer, 1);	/* return control to outer routine */
+	longjmp(ctx->setjmp_buffer, 1);	/* return control to outer routine */
 }
 
 typedef enum
@@ -316,8 +328,8 @@ METHODDEF void
 										
 	if (functionJPEGStatus !=	OM_ERR_NONE)
 	{
-		if  (localJPEGStatus == OM_ERR_NONE)
-			localJPEGStatus = functionJPEGStatus;
+		if  (JPEG_CONTEXT(cinfo)->status == OM_ERR_NONE)
+			JPEG_CONTEXT(cinfo)->status = functionJPEGStatus;
 		return;
 	}
 	
@@ -351,11 +363,11 @@ METHODDEF void
 	if (cinfo->CCIR)
 	{
 		int  i;
-		cinfo->CCIRLumaInMap = (JSAMPLE *) (*cinfo->emethods->alloc_small) (256 * SIZEOF(JCOEF));
+		cinfo->CCIRLumaInMap = (JSAMPLE *) (*cinfo->emethods->alloc_small) (cinfo->emethods, 256 * SIZEOF(JCOEF));
 		for (i = 0; i < 256; i++)
 			cinfo->CCIRLumaInMap[i] = ((i * 220) / 256) + 16;
 		
-		cinfo->CCIRChromaInMap = (JSAMPLE *) (*cinfo->emethods->alloc_small) (256 * SIZEOF(JCOEF));
+		cinfo->CCIRChromaInMap = (JSAMPLE *) (*cinfo->emethods->alloc_small) (cinfo->emethods, 256 * SIZEOF(JCOEF));
 		for (i = 0; i < 256; i++)
 			cinfo->CCIRChromaInMap[i] = ((i * 225) / 256) + 16;
 	}
@@ -665,8 +677,6 @@ METHODDEF void
  * are actual data in your selected output colorspace.
  */
 
-static int      numPixDisplay = 0;
-
 METHODDEF void
                 put_pixel_rows(decompress_info_ptr dinfo, int num_rows, JSAMPIMAGE pixel_data)
 /* Write some rows of output data */
@@ -790,15 +800,15 @@ LOCAL void
 		omfInt32 i;
 		unsigned char ff = 0xff, marker=(unsigned char)mark;
 		
-		if (localJPEGStatus != OM_ERR_NONE)
-			error_exit("Problem in emit_marker.  File omJPED.c line 789");
+		if (JPEG_CONTEXT(cinfo)->status != OM_ERR_NONE)
+			ERREXIT(cinfo->emethods, "Problem in emit_marker.  File omJPED.c line 789");
 
 		functionJPEGStatus =  omcGetStreamPos32(media->stream, &offset);
 		if (functionJPEGStatus !=	OM_ERR_NONE)
 		{
-			if  (localJPEGStatus == OM_ERR_NONE)
-				localJPEGStatus = functionJPEGStatus;
-			error_exit("Bad alignment check after compression");
+			if  (JPEG_CONTEXT(cinfo)->status == OM_ERR_NONE)
+				JPEG_CONTEXT(cinfo)->status = functionJPEGStatus;
+			ERREXIT(cinfo->emethods, "Bad alignment check after compression");
 		}
 		
 		remainder = (offset+2) % 4;
@@ -809,9 +819,9 @@ LOCAL void
 				functionJPEGStatus = omcWriteStream(media->stream, 1, &ff);
 				if (functionJPEGStatus !=	OM_ERR_NONE)
 				{
-					if  (localJPEGStatus == OM_ERR_NONE)
-						localJPEGStatus = functionJPEGStatus;
-					error_exit("Bad alignment padding after compression");
+					if  (JPEG_CONTEXT(cinfo)->status == OM_ERR_NONE)
+						JPEG_CONTEXT(cinfo)->status = functionJPEGStatus;
+					ERREXIT(cinfo->emethods, "Bad alignment padding after compression");
 				}
 			}
 		}
@@ -819,17 +829,17 @@ LOCAL void
 		functionJPEGStatus = omcWriteStream(media->stream, 1, &ff);
 		if (functionJPEGStatus !=	OM_ERR_NONE)
 		{
-			if  (localJPEGStatus == OM_ERR_NONE)
-				localJPEGStatus = functionJPEGStatus;
-			error_exit("Bad alignment padding after compression");
+			if  (JPEG_CONTEXT(cinfo)->status == OM_ERR_NONE)
+				JPEG_CONTEXT(cinfo)->status = functionJPEGStatus;
+			ERREXIT(cinfo->emethods, "Bad alignment padding after compression");
 		}
 		
 		functionJPEGStatus = omcWriteStream(media->stream, 1, &marker);
 		if (functionJPEGStatus !=	OM_ERR_NONE)
 		{
-			if  (localJPEGStatus == OM_ERR_NONE)
-				localJPEGStatus = functionJPEGStatus;
-			error_exit("Bad alignment padding after compression");
+			if  (JPEG_CONTEXT(cinfo)->status == OM_ERR_NONE)
+				JPEG_CONTEXT(cinfo)->status = functionJPEGStatus;
+			ERREXIT(cinfo->emethods, "Bad alignment padding after compression");
 		}
 	}
 	else
@@ -913,9 +923,9 @@ METHODDEF void
 	JPEG_MediaParms_t   *parms = (JPEG_MediaParms_t *)cinfo->input_file;
 	omfMediaHdl_t  	 	media = parms->media;
 
-	if (localJPEGStatus == OM_ERR_NONE)
+	if (JPEG_CONTEXT(cinfo)->status == OM_ERR_NONE)
 	{ /* optimize for if we have a problem, like a disk full */
-		localJPEGStatus = omcWriteStream(media->stream, datacount, dataptr);
+		JPEG_CONTEXT(cinfo)->status = omcWriteStream(media->stream, datacount, dataptr);
 	}
 }
 
@@ -1027,33 +1037,33 @@ METHODDEF int
 	functionJPEGStatus = omcGetLength(media->stream, &length);
 	if (functionJPEGStatus !=	OM_ERR_NONE)
 	{
-		if  (localJPEGStatus == OM_ERR_NONE)
-			localJPEGStatus = functionJPEGStatus;
-		error_exit("Problem with calling omcGetLength in omJPED.c -- line 1011");
+		if  (JPEG_CONTEXT(dinfo)->status == OM_ERR_NONE)
+			JPEG_CONTEXT(dinfo)->status = functionJPEGStatus;
+		ERREXIT(dinfo->emethods, "Problem with calling omcGetLength in omJPED.c -- line 1011");
 	}
 
 	functionJPEGStatus = omcGetStreamPosition(media->stream, &offset);
 	if (functionJPEGStatus !=	OM_ERR_NONE)
 	{
-		if  (localJPEGStatus == OM_ERR_NONE)
-			localJPEGStatus = functionJPEGStatus;
-		error_exit("Problem with calling omcGetStreamPosition in omJPED.c -- line 1019");
+		if  (JPEG_CONTEXT(dinfo)->status == OM_ERR_NONE)
+			JPEG_CONTEXT(dinfo)->status = functionJPEGStatus;
+		ERREXIT(dinfo->emethods, "Problem with calling omcGetStreamPosition in omJPED.c -- line 1019");
 	}
 
 	functionJPEGStatus = omfsSubInt64fromInt64(offset, &length);
 	if (functionJPEGStatus !=	OM_ERR_NONE)
 	{
-		if  (localJPEGStatus == OM_ERR_NONE)
-			localJPEGStatus = functionJPEGStatus;
-		error_exit("Problem with calling omfsSubInt64fromInt64 in omJPED.c -- line 1027");
+		if  (JPEG_CONTEXT(dinfo)->status == OM_ERR_NONE)
+			JPEG_CONTEXT(dinfo)->status = functionJPEGStatus;
+		ERREXIT(dinfo->emethods, "Problem with calling omfsSubInt64fromInt64 in omJPED.c -- line 1027");
 	}
 
 	functionJPEGStatus = omfsTruncInt64toUInt32(length, &toRead);	/* OK MAXREAD */
 	if (functionJPEGStatus !=	OM_ERR_NONE)
 	{
-		if  (localJPEGStatus == OM_ERR_NONE)
-			localJPEGStatus = functionJPEGStatus;
-		error_exit("Problem with calling omfsTruncInt64toUInt32 in omJPED.c -- line 1035");
+		if  (JPEG_CONTEXT(dinfo)->status == OM_ERR_NONE)
+			JPEG_CONTEXT(dinfo)->status = functionJPEGStatus;
+		ERREXIT(dinfo->emethods, "Problem with calling omfsTruncInt64toUInt32 in omJPED.c -- line 1035");
 	}
 
 	if(toRead > JPEG_BUF_SIZE)
@@ -1061,9 +1071,9 @@ METHODDEF int
 	functionJPEGStatus = omcReadStream(media->stream, toRead, (dinfo->next_input_byte), &bytesRead);
 	if (functionJPEGStatus !=	OM_ERR_NONE)
 	{
-		if  (localJPEGStatus == OM_ERR_NONE)
-			localJPEGStatus = functionJPEGStatus;
-		error_exit("Problem with calling omcReadStream in omJPED.c -- line 1045");
+		if  (JPEG_CONTEXT(dinfo)->status == OM_ERR_NONE)
+			JPEG_CONTEXT(dinfo)->status = functionJPEGStatus;
+		ERREXIT(dinfo->emethods, "Problem with calling omcReadStream in omJPED.c -- line 1045");
 	}
 
 	dinfo->bytes_in_buffer = bytesRead;
@@ -1084,10 +1094,10 @@ METHODDEF int
  * 		copies the compression tables from user space to JPEG space
  *
  * Argument Notes:
- *		StuffNeededBeyondNotesInDefinition.
+ *		status - the caller's JPEG status; only set if not already set.
  *
  * ReturnValue:
- *		Set module static error code (see below).
+ *		Sets *status to the error code (see below).
  *
  * Possible Errors:
  *		Standard errors (see top of file).
@@ -1096,7 +1106,8 @@ METHODDEF int
  * Initialize and read the file header (everything through the SOF marker).
  */
 
-static void loadCompressionTable(omfMediaHdl_t media, jpeg_tables * table, omfInt32 n)
+static void loadCompressionTable(omfMediaHdl_t media, jpeg_tables * table, omfInt32 n,
+								 omfErr_t *status)
 {
 	omfJPEGTables_t aTable;
 	omfInt16 m;
@@ -1128,7 +1139,7 @@ static void loadCompressionTable(omfMediaHdl_t media, jpeg_tables * table, omfIn
 	aTable.JPEGcomp = extendComponent;
 	
 	functionJPEGStatus = codecGetInfo(media, kJPEGTables, media->pictureKind, sizeof(omfJPEGTables_t), &aTable);
-/* EVEN if there is an error, do not set localJPEGStatus, first check the other tables! */
+/* EVEN if there is an error, do not set the status, first check the other tables! */
 	if (functionJPEGStatus != OM_ERR_NONE || aTable.QTableSize == 0)
 	{
 #endif
@@ -1137,8 +1148,8 @@ static void loadCompressionTable(omfMediaHdl_t media, jpeg_tables * table, omfIn
 		functionJPEGStatus = codecGetInfo(media, kJPEGTables, media->pictureKind, sizeof(omfJPEGTables_t), &aTable);
 		if (functionJPEGStatus !=	OM_ERR_NONE)
 		{
-			if  (localJPEGStatus == OM_ERR_NONE)
-				localJPEGStatus = functionJPEGStatus;
+			if  (*status == OM_ERR_NONE)
+				*status = functionJPEGStatus;
 			return;
 		}
 
@@ -1236,15 +1247,15 @@ METHODDEF void
 										&fieldHeight, NULL, &bitsPerPixel, &memFmt);
 	if (functionJPEGStatus !=	OM_ERR_NONE)
 	{
-		if  (localJPEGStatus == OM_ERR_NONE)
-			localJPEGStatus = functionJPEGStatus;
+		if  (JPEG_CONTEXT(dinfo)->status == OM_ERR_NONE)
+			JPEG_CONTEXT(dinfo)->status = functionJPEGStatus;
 		return;
 	}
 
 	for (n = 0; n < 3; n++)
 	{
-		loadCompressionTable(media, compressionTables + n, n);
-/*		if (localJPEGStatus != OM_ERR_NONE)
+		loadCompressionTable(media, compressionTables + n, n, &JPEG_CONTEXT(dinfo)->status);
+/*		if (JPEG_CONTEXT(dinfo)->status != OM_ERR_NONE)
 			return;
 */
 	}	
@@ -1279,8 +1290,8 @@ METHODDEF void
 
 	if (functionJPEGStatus !=	OM_ERR_NONE)
 	{
-		if  (localJPEGStatus == OM_ERR_NONE)
-			localJPEGStatus = functionJPEGStatus;
+		if  (JPEG_CONTEXT(dinfo)->status == OM_ERR_NONE)
+			JPEG_CONTEXT(dinfo)->status = functionJPEGStatus;
 		return;
 	}
 		
@@ -1293,7 +1304,7 @@ METHODDEF void
 	if (dinfo->CCIR)
 	{
 		int  i;
-		dinfo->CCIRLumaOutMap = (JSAMPLE *) (*dinfo->emethods->alloc_small) (256 * SIZEOF(JCOEF));
+		dinfo->CCIRLumaOutMap = (JSAMPLE *) (*dinfo->emethods->alloc_small) (dinfo->emethods, 256 * SIZEOF(JCOEF));
 		for (i = 0; i < 256; i++)
 		{
 			if(i <= 16) 
@@ -1304,7 +1315,7 @@ METHODDEF void
 				dinfo->CCIRLumaOutMap[i] = (JSAMPLE)(((i-16) * 256) / 220 + .5);
 		}
 		
-		dinfo->CCIRChromaOutMap = (JSAMPLE *) (*dinfo->emethods->alloc_small) (256 * SIZEOF(JCOEF));
+		dinfo->CCIRChromaOutMap = (JSAMPLE *) (*dinfo->emethods->alloc_small) (dinfo->emethods, 256 * SIZEOF(JCOEF));
 		for (i = 0; i < 256; i++)
 		{
 			if(i <= 16) 
@@ -1327,7 +1338,7 @@ METHODDEF void
 	}
 
 	dinfo->comp_info = (jpeg_component_info *) (*dinfo->emethods->alloc_small)
-		(dinfo->num_components * SIZEOF(jpeg_component_info));
+		(dinfo->emethods, dinfo->num_components * SIZEOF(jpeg_component_info));
 
 	/* luminance component */
 	compptr = &dinfo->comp_info[0];
@@ -1360,7 +1371,7 @@ METHODDEF void
 	/* Set up two quantization tables */
 	if (dinfo->quant_tbl_ptrs[0] == NULL)
 		dinfo->quant_tbl_ptrs[0] = (QUANT_TBL_PTR)
-			(*dinfo->emethods->alloc_small) (SIZEOF(QUANT_TBL));
+			(*dinfo->emethods->alloc_small) (dinfo->emethods, SIZEOF(QUANT_TBL));
 	quant_ptr = dinfo->quant_tbl_ptrs[0];
 
 #ifdef JPEG_TRACE
@@ -1399,7 +1410,7 @@ METHODDEF void
 	
 	if (dinfo->quant_tbl_ptrs[1] == NULL)
 		dinfo->quant_tbl_ptrs[1] = (QUANT_TBL_PTR)
-			(*dinfo->emethods->alloc_small) (SIZEOF(QUANT_TBL));
+			(*dinfo->emethods->alloc_small) (dinfo->emethods, SIZEOF(QUANT_TBL));
 	quant_ptr = dinfo->quant_tbl_ptrs[1];
 
 	for (i = 0; i < DCTSIZE2; i++)
@@ -1457,7 +1468,7 @@ METHODDEF void
 		htblptr = &dinfo->dc_huff_tbl_ptrs[ci];
 
 		if (*htblptr == NULL)
-			*htblptr = (HUFF_TBL *) (*dinfo->emethods->alloc_small) (SIZEOF(HUFF_TBL));
+			*htblptr = (HUFF_TBL *) (*dinfo->emethods->alloc_small) (dinfo->emethods, SIZEOF(HUFF_TBL));
 
 		MEMCOPY((*htblptr)->bits, bits, SIZEOF((*htblptr)->bits));
 		MEMCOPY((*htblptr)->huffval, huffval, SIZEOF((*htblptr)->huffval));
@@ -1491,7 +1502,7 @@ METHODDEF void
 		htblptr = &dinfo->ac_huff_tbl_ptrs[ci];
 
 		if (*htblptr == NULL)
-			*htblptr = (HUFF_TBL *) (*dinfo->emethods->alloc_small) (SIZEOF(HUFF_TBL));
+			*htblptr = (HUFF_TBL *) (*dinfo->emethods->alloc_small) (dinfo->emethods, SIZEOF(HUFF_TBL));
 
 /*		MEMCOPY((*htblptr)->bits, bits, SIZEOF((*htblptr)->bits));
 		MEMCOPY((*htblptr)->huffval, huffval, SIZEOF((*htblptr)->huffval)); 
@@ -1533,11 +1544,11 @@ METHODDEF       boolean
 	 * this should only return true once.  If zero, increment and return
 	 * 1
 	 */
-	if (visited)
+	if (JPEG_CONTEXT(dinfo)->visited)
 		return (0);
 	else
 	{
-		visited++;
+		JPEG_CONTEXT(dinfo)->visited++;
 		return (1);
 	}
 }
@@ -1675,12 +1686,14 @@ omfErr_t        omfmJPEDDecompressSample(JPEG_MediaParms_t *parms)
 	 */
 	struct Decompress_info_struct dinfo;
 	struct Decompress_methods_struct dc_methods;
-	struct External_methods_struct e_methods;
+	omJPEGContext_t ctx;	/* error recovery and external methods */
 
 	omfAssertMediaHdl(media);
+	ctx.status = OM_ERR_NONE;
+	ctx.errorRaised = 0;
 	XPROTECT(media->mainFile)
 	{
-		visited = 0;		/* clear the image-visited flag */
+		ctx.visited = 0;		/* clear the image-visited flag */
 	
 		/*
 		 * Select the input and output files. In this example we want to open
@@ -1697,20 +1710,19 @@ omfErr_t        omfmJPEDDecompressSample(JPEG_MediaParms_t *parms)
 	
 		/* Initialize the system-dependent method pointers. */
 		dinfo.methods = &dc_methods;	/* links to method structs */
-		dinfo.emethods = &e_methods;
+		dinfo.emethods = &ctx.e_methods;
 		/*
 		 * Here we supply our own error handler; compare to use of standard
 		 * error handler in the previous write_JPEG_file example.
 		 */
-		emethods = &e_methods;	/* save struct addr for possible access */
-		e_methods.error_exit = error_exit;	/* supply error-exit routine */
-		e_methods.trace_message = trace_message;	/* supply trace-message
+		ctx.e_methods.error_exit = error_exit;	/* supply error-exit routine */
+		ctx.e_methods.trace_message = trace_message;	/* supply trace-message
 								 * routine */
-		e_methods.trace_level = 0;	/* default = no tracing */
-		e_methods.num_warnings = 0;	/* no warnings emitted yet */
-		e_methods.first_warning_level = 0;	/* display first corrupt-data
+		ctx.e_methods.trace_level = 0;	/* default = no tracing */
+		ctx.e_methods.num_warnings = 0;	/* no warnings emitted yet */
+		ctx.e_methods.first_warning_level = 0;	/* display first corrupt-data
 							 * warning */
-		e_methods.more_warning_level = 3;	/* but suppress additional
+		ctx.e_methods.more_warning_level = 3;	/* but suppress additional
 							 * ones */
 		/* select output routines */
 		dinfo.methods->output_init = output_init;
@@ -1719,7 +1731,7 @@ omfErr_t        omfmJPEDDecompressSample(JPEG_MediaParms_t *parms)
 		dinfo.methods->output_term = output_term;
 	
 		/* prepare setjmp context for possible exit from error_exit */
-		if (setjmp(setjmp_buffer))
+		if (setjmp(ctx.setjmp_buffer))
 		{
 			/*
 			 * If we get here, the JPEG code has signaled an error.
@@ -1735,14 +1747,14 @@ omfErr_t        omfmJPEDDecompressSample(JPEG_MediaParms_t *parms)
 		 * code. In some cases you might want to replace the memory manager,
 		 * or at least the system-dependent part of it, with your own code.
 		 */
-		jselmemmgr(&e_methods);	/* select std memory allocation routines */
+		jselmemmgr(&ctx.e_methods);	/* select std memory allocation routines */
 	
 		/*
 		 * If the decompressor requires full-image buffers (for two-pass
 		 * color quantization or a noninterleaved JPEG file), it will create
 		 * temporary files for anything that doesn't fit within the
 		 * maximum-memory setting. You can change the default maximum-memory
-		 * setting by changing e_methods.max_memory_to_use after jselmemmgr
+		 * setting by changing ctx.e_methods.max_memory_to_use after jselmemmgr
 		 * returns. On some systems you may also need to set up a signal
 		 * handler to ensure that temporary files are deleted if the program
 		 * is interrupted. (This is most important if you are on MS-DOS and
@@ -1791,7 +1803,7 @@ omfErr_t        omfmJPEDDecompressSample(JPEG_MediaParms_t *parms)
 	XEND
 	
 	/*
-	 * You might want to test e_methods.num_warnings to see if bad data
+	 * You might want to test ctx.e_methods.num_warnings to see if bad data
 	 * was detected.  In this example, we just blindly forge ahead.
 	 */
 	return OM_ERR_NONE;	/* indicate success */
@@ -1853,11 +1865,13 @@ omfErr_t        omfmJPEDCompressSample(JPEG_MediaParms_t *parms, omfBool customT
 	 */
 	struct Compress_info_struct cinfo;
 	struct Compress_methods_struct c_methods;
-	struct External_methods_struct e_methods;
+	omJPEGContext_t ctx;	/* error recovery and external methods */
 	
 	memset(huffval, 0, 256);  /* initialize memset to 0 */
 
 	omfAssertMediaHdl(media);
+	ctx.status = OM_ERR_NONE;
+	ctx.errorRaised = 0;
 	XPROTECT(media->mainFile)
 	{
 		functionJPEGStatus = omfmGetVideoInfo(media, 
@@ -1870,27 +1884,27 @@ omfErr_t        omfmJPEDCompressSample(JPEG_MediaParms_t *parms, omfBool customT
 	
 		if (functionJPEGStatus !=	OM_ERR_NONE)
 		{
-			if  (localJPEGStatus == OM_ERR_NONE)
-				localJPEGStatus = functionJPEGStatus;
+			if  (ctx.status == OM_ERR_NONE)
+				ctx.status = functionJPEGStatus;
 		}
-		CHECK(localJPEGStatus);
+		CHECK(ctx.status);
 
-	/*	localJPEGStatus = codecGetInfo(media, kCompressionParms, media->pictureKind, sizeof(omfJPEGInfo_t), &info);
+	/*	ctx.status = codecGetInfo(media, kCompressionParms, media->pictureKind, sizeof(omfJPEGInfo_t), &info);
 	    ROGER--- delete this when I know it works
 	    */
 		if(customTables)
 		{
 			for (n = 0; n < 3; n++)
 			{
-				loadCompressionTable(media, compressionTables + n, n);
-				CHECK(localJPEGStatus); /* is set in loadCompressionTable */
+				loadCompressionTable(media, compressionTables + n, n, &ctx.status);
+				CHECK(ctx.status); /* is set in loadCompressionTable */
 			}
 		}
 	
 		
 		/* Initialize the system-dependent method pointers. */
 		cinfo.methods = &c_methods;	/* links to method structs */
-		cinfo.emethods = &e_methods;
+		cinfo.emethods = &ctx.e_methods;
 	
 		/*
 		 * Here we use the default JPEG error handler, which will just print
@@ -1901,19 +1915,18 @@ omfErr_t        omfmJPEDCompressSample(JPEG_MediaParms_t *parms, omfBool customT
 		 * Here we supply our own error handler; compare to use of standard
 		 * error handler in the previous write_JPEG_file example.
 		 */
-		emethods = &e_methods;	/* save struct addr for possible access */
-		e_methods.error_exit = error_exit;	/* supply error-exit routine */
-		e_methods.trace_message = trace_message;	/* supply trace-message
+		ctx.e_methods.error_exit = error_exit;	/* supply error-exit routine */
+		ctx.e_methods.trace_message = trace_message;	/* supply trace-message
 								 * routine */
-		e_methods.trace_level = 10;	/* default = no tracing */
-		e_methods.num_warnings = 0;	/* no warnings emitted yet */
-		e_methods.first_warning_level = 0;	/* display first corrupt-data
+		ctx.e_methods.trace_level = 10;	/* default = no tracing */
+		ctx.e_methods.num_warnings = 0;	/* no warnings emitted yet */
+		ctx.e_methods.first_warning_level = 0;	/* display first corrupt-data
 							 * warning */
-		e_methods.more_warning_level = 3;	/* but suppress additional
+		ctx.e_methods.more_warning_level = 3;	/* but suppress additional
 							 * ones */
 	
 		/*
-		 * jselerror(&e_methods);	/* select std error/trace message
+		 * jselerror(&ctx.e_methods);	/* select std error/trace message
 		 * routines
 		 */
 		/*
@@ -1921,7 +1934,7 @@ omfErr_t        omfmJPEDCompressSample(JPEG_MediaParms_t *parms, omfBool customT
 		 * code. In some cases you might want to replace the memory manager,
 		 * or at least the system-dependent part of it, with your own code.
 		 */
-		jselmemmgr(&e_methods);	/* select std memory allocation routines */
+		jselmemmgr(&ctx.e_methods);	/* select std memory allocation routines */
 	
 		/*
 		 * If the compressor requires full-image buffers (for entropy-coding
@@ -1929,7 +1942,7 @@ omfErr_t        omfmJPEDCompressSample(JPEG_MediaParms_t *parms, omfBool customT
 		 * temporary files for anything that doesn't fit within the
 		 * maximum-memory setting. (Note that temp files are NOT needed if
 		 * you use the default parameters.) You can change the default
-		 * maximum-memory setting by changing e_methods.max_memory_to_use
+		 * maximum-memory setting by changing ctx.e_methods.max_memory_to_use
 		 * after jselmemmgr returns. On some systems you may also need to set
 		 * up a signal handler to ensure that temporary files are deleted if
 		 * the program is interrupted. (This is most important if you are on
@@ -1963,7 +1976,7 @@ omfErr_t        omfmJPEDCompressSample(JPEG_MediaParms_t *parms, omfBool customT
 		 * choke on non-baseline JPEG files. If you want to force baseline
 		 * compatibility, pass TRUE instead of FALSE. (If non-baseline files
 		 * are fine, but you could do without that warning message, set
-		 * e_methods.trace_level to -1.)
+		 * ctx.e_methods.trace_level to -1.)
 		 */
 	
 		/*
@@ -1978,7 +1991,7 @@ omfErr_t        omfmJPEDCompressSample(JPEG_MediaParms_t *parms, omfBool customT
 	
 	
 		if (cinfo.quant_tbl_ptrs[0] == NULL)
-			cinfo.quant_tbl_ptrs[0] = (QUANT_TBL_PTR) (*cinfo.emethods->alloc_small) (SIZEOF(QUANT_TBL));
+			cinfo.quant_tbl_ptrs[0] = (QUANT_TBL_PTR) (*cinfo.emethods->alloc_small) (cinfo.emethods, SIZEOF(QUANT_TBL));
 		quant_ptr = cinfo.quant_tbl_ptrs[0];
 		table_ptr = customTables ? compressionTables[0].Q : STD_QT_PTR[0];
 	
@@ -1998,7 +2011,7 @@ omfErr_t        omfmJPEDCompressSample(JPEG_MediaParms_t *parms, omfBool customT
 		}
 	
 		if (cinfo.quant_tbl_ptrs[1] == NULL)
-			cinfo.quant_tbl_ptrs[1] = (QUANT_TBL_PTR) (*cinfo.emethods->alloc_small) (SIZEOF(QUANT_TBL));
+			cinfo.quant_tbl_ptrs[1] = (QUANT_TBL_PTR) (*cinfo.emethods->alloc_small) (cinfo.emethods, SIZEOF(QUANT_TBL));
 		quant_ptr = cinfo.quant_tbl_ptrs[1];
 		table_ptr = customTables ? compressionTables[1].Q : STD_QT_PTR[1];
 	
@@ -2036,7 +2049,7 @@ omfErr_t        omfmJPEDCompressSample(JPEG_MediaParms_t *parms, omfBool customT
 			htblptr = &cinfo.dc_huff_tbl_ptrs[ci];
 	
 			if (*htblptr == NULL)
-				*htblptr = (HUFF_TBL *) (*cinfo.emethods->alloc_small) (SIZEOF(HUFF_TBL));
+				*htblptr = (HUFF_TBL *) (*cinfo.emethods->alloc_small) (cinfo.emethods, SIZEOF(HUFF_TBL));
 	
 			for (i = 0; i < 17; i++)
 				(*htblptr)->bits[i] = bits[i];
@@ -2067,7 +2080,7 @@ omfErr_t        omfmJPEDCompressSample(JPEG_MediaParms_t *parms, omfBool customT
 			htblptr = &cinfo.ac_huff_tbl_ptrs[ci];
 	
 			if (*htblptr == NULL)
-				*htblptr = (HUFF_TBL *) (*cinfo.emethods->alloc_small) (SIZEOF(HUFF_TBL));
+				*htblptr = (HUFF_TBL *) (*cinfo.emethods->alloc_small) (cinfo.emethods, SIZEOF(HUFF_TBL));
 	
 			for (i = 0; i < 17; i++)
 				(*htblptr)->bits[i] = bits[i];
@@ -2092,7 +2105,7 @@ omfErr_t        omfmJPEDCompressSample(JPEG_MediaParms_t *parms, omfBool customT
 		cinfo.output_file = (FILE *) parms;
 	
 		/* Here we go! */
-		if (setjmp(setjmp_buffer) == 0)
+		if (setjmp(ctx.setjmp_buffer) == 0)
 		{
 			jpeg_compress(&cinfo);
 		}
@@ -2107,12 +2120,12 @@ omfErr_t        omfmJPEDCompressSample(JPEG_MediaParms_t *parms, omfBool customT
 		 * data structures allocated in j_c_defaults are freed upon exit from
 		 * jpeg_compress.
 		 */
-		if (localJPEGStatus == OM_ERR_NONE)
+		if (ctx.status == OM_ERR_NONE)
 			*sampleSize = fieldWidth * fieldHeight * (bitsPerPixel / 8);
 		else
 			*sampleSize = 0;
 			
-		CHECK(localJPEGStatus);
+		CHECK(ctx.status);
 	
 	}
 	XEXCEPT
@@ -87,6 +87,7 @@ typedef struct
 	omfUInt32			colorRange;
 	omfInt32				bitsPerPixelAvg;
 	omfInt32				memBytesPerSample;
+	codecScratch_t		scratch;			/* Reused across reads */
 }               userDataJPEG_t;
 
 static omfErr_t codecSetJPEGTables(omfCodecParms_t * info, omfHdl_t main, userDataJPEG_t * pdata);
@@ -116,13 +117,14 @@ static omfErr_t loadDescriptorData(omfCodecParms_t * info,
 								   omfMediaHdl_t media, 
 								   omfHdl_t main, 
 								   userDataJPEG_t * pdata);
-static omfErr_t omfsGetNthFrameIndex(omfHdl_t file, omfObject_t obj,omfProperty_t prop,
-								omfUInt32 *data, omfInt32 i);
-
 static omfErr_t omfsAppendFrameIndex(omfHdl_t file, omfObject_t obj, omfProperty_t prop,
 								omfUInt32 data);
 
 static omfInt32 omfsLengthFrameIndex( omfHdl_t file, omfObject_t obj, omfProperty_t prop);
+
+static omfErr_t omfsReadFrameIndex(omfHdl_t file, omfObject_t obj, omfProperty_t prop,
+								omfUInt32 *data, omfInt32 len);
+
 static omfErr_t omfmJPEGGetMaxSampleSize(omfCodecParms_t * info,
 					                 omfMediaHdl_t media,
 					                 omfHdl_t main,
@@ -717,9 +719,7 @@ static omfErr_t codecReadSamplesJPEG(omfCodecParms_t * info,
 
 				if(decompBytesPerSample > pdata->memBytesPerSample)
 				{
-					tempBuf = (char *)omOptMalloc(main, decompBytesPerSample);
-					if(tempBuf == NULL)
-						RAISE(OM_ERR_NOMEMORY);
+					CHECK(codecGetScratchBuffer(main, &pdata->scratch, decompBytesPerSample, &tempBuf));
 					src.buf = tempBuf;
 					src.buflen = decompBytesPerSample;
 					compressParms.pixelBuffer = (char *)tempBuf;
@@ -781,11 +781,6 @@ static omfErr_t codecReadSamplesJPEG(omfCodecParms_t * info,
 				}
 				
 				CHECK(omcSwabData(media->stream, &src, &dest, media->stream->swapBytes));
-				if(tempBuf != NULL)
-				{
-					omOptFree(main, tempBuf);
-					tempBuf = NULL;
-				}
 				xfer->bytesXfered += pdata->memBytesPerSample;
 				xfer->samplesXfered++;
 			}
@@ -818,10 +813,6 @@ static omfErr_t codecReadSamplesJPEG(omfCodecParms_t * info,
 		}
 	}
 	XEXCEPT
-	{
-		if(tempBuf != NULL)
-			omOptFree(main, tempBuf);
-	}
 	XEND
 
 	return (OM_ERR_NONE);
@@ -999,7 +990,7 @@ static omfErr_t loadDescriptorData(omfCodecParms_t * info,
 	omfUInt32 				layout = 0;
 	omfUInt32 				bytesPerPixel = 0;
 	omfUInt32 				numFields = 0;
-	omfUInt32				indexSize, n, indexVal;
+	omfUInt32				indexSize, n;
 	omcAvJPEDPersistent_t *pers = NULL;
 	omfPosition_t			zeroPos;
 	omfErr_t					status;
@@ -1342,12 +1333,8 @@ static omfErr_t loadDescriptorData(omfCodecParms_t * info,
 			RAISE(OM_ERR_NOMEMORY);
 
 		pdata->maxIndex = indexSize;
-		for(n = 1; n <= indexSize; n++)
-		{
-			CHECK(omfsGetNthFrameIndex(media->dataFile, media->dataObj, pers->omJPEGFrameIndex,
-											&indexVal, n));
-			pdata->frameIndex[n-1] = indexVal;
-		}
+		CHECK(omfsReadFrameIndex(media->dataFile, media->dataObj, pers->omJPEGFrameIndex,
+										pdata->frameIndex, indexSize));
 #if OMFI_ENABLE_SEMCHECK
 		if(saveCheck)
 			omfsSemanticCheckOn(media->dataFile);
@@ -1795,6 +1782,7 @@ static omfErr_t codecCloseJPEG(omfCodecParms_t *info,
 		
 	  	if(pdata->frameIndex != NULL)
 			omOptFree(media->mainFile, pdata->frameIndex);
+		codecFreeScratchBuffer(media->mainFile, &pdata->scratch);
 		omOptFree(media->mainFile, media->userData);
 	}
 	XEXCEPT
@@ -2064,9 +2052,12 @@ static omfErr_t initUserData(userDataJPEG_t *pdata)
 	pdata->compressionTables[2].Q16len = 0;
 	pdata->compressionTables[2].DClen = 0;
 	pdata->compressionTables[2].AClen = 0;
+	pdata->scratch.buf = NULL;
+	pdata->scratch.len = 0;
 		
 	return(OM_ERR_NONE);
 }
+
 /************************
  * name
  *
@@ -2320,7 +2311,6 @@ static omfErr_t codecGetJPEGTables(omfCodecParms_t * info,
 	 *************************************************************/
 
 /************************
- * omfsGetNthFrameIndex
  * omfsAppendFrameIndex
  * omfsLengthFrameIndex
  *
@@ -2328,7 +2318,7 @@ static omfErr_t codecGetJPEGTables(omfCodecParms_t * info,
  *		objects or mobs.
  *
  * Argument Notes:
- *		i - Index is 1-based.
+ *		StuffNeededBeyondNotesInDefinition.
  *
  * ReturnValue:
  *		For omfsLengthFrameIndex:
@@ -2339,45 +2329,6 @@ static omfErr_t codecGetJPEGTables(omfCodecParms_t * info,
  * Possible Errors:
  *		Standard errors (see top of file).
  */
-static omfErr_t omfsGetNthFrameIndex(
-			omfHdl_t			file,		/* IN - From this file */
-			omfObject_t		obj,		/* IN - and this object */
-			omfProperty_t	prop,		/* IN - and this property */
-			omfUInt32		*data,	/* OUT - Get the data */
-			omfInt32			i)			/* IN - at this index. */
-{
-	omfPosition_t	offset;
-	omfErr_t		status;
-	
-	XPROTECT(file)
-	{
-#if OMFI_ENABLE_SEMCHECK
-		XASSERT(i >= 1 && i <= omfsLengthFrameIndex(file, obj, prop), OM_ERR_BADINDEX)
-#endif
-		CHECK(OMGetNthPropHdr(file, obj, prop, i, OMPosition32Array,
-										sizeof(omfUInt32), &offset));
-		status = OMReadProp(file, obj, prop, offset, kSwabIfNeeded,
-								OMPosition32Array, sizeof(omfUInt32), data);
-		if(status != OM_ERR_NONE)
-		{
-			CHECK(OMReadProp(file, obj, prop, offset, kNeverSwab,
-								OMDataValue, sizeof(omfUInt32), data));
-			if(ompvtIsForeignByteOrder(file, obj))
-				omfsFixLong((omfInt32 *) data);
-		}
-	}
-	XEXCEPT
-	{
-		return(XCODE());
-	}
-	XEND
-
-	return (OM_ERR_NONE);
-}
-
-/************************
- * omfsAppendFrameIndex
- */
 static omfErr_t omfsAppendFrameIndex(
 			omfHdl_t				file,	/* IN - From this file */
 			omfObject_t			obj,	/* IN - and this object */
@@ -2430,6 +2381,49 @@ static omfInt32 omfsLengthFrameIndex(
 	return (length);
 }
 
+/************************
+ * omfsReadFrameIndex
+ *
+ * 	Load the first len entries of the frame index with a single read,
+ *		instead of one property read per frame.
+ *
+ * Argument Notes:
+ *		len - Number of entries to read, normally omfsLengthFrameIndex().
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ */
+static omfErr_t omfsReadFrameIndex(
+			omfHdl_t			file,		/* IN - From this file */
+			omfObject_t		obj,		/* IN - and this object */
+			omfProperty_t	prop,		/* IN - and this property */
+			omfUInt32		*data,	/* OUT - Read the index into here */
+			omfInt32			len)		/* IN - which holds this many entries */
+{
+	omfErr_t		status;
+	
+	XPROTECT(file)
+	{
+		if(len != 0)
+		{
+			status = omfsReadArrayBlock(file, obj, prop, OMPosition32Array,
+									sizeof(omfUInt32), 1, len, kSwabIfNeeded, data);
+			if(status != OM_ERR_NONE)
+			{
+				CHECK(omfsReadArrayBlock(file, obj, prop, OMDataValue,
+									sizeof(omfUInt32), 1, len, kSwabIfNeeded, data));
+			}
+		}
+	}
+	XEXCEPT
+	XEND
+
+	return (OM_ERR_NONE);
+}
+
 /************************
  * name
  *
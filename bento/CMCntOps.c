@@ -536,10 +536,12 @@ static ContainerPtr CM_NEAR openContainer(CMRefCon attributes,
   container->spaceDeletedValue    = NULL;
   container->tocNewValuesValue    = NULL;
   container->freeSpaceValueHdr    = NULL;
+  container->freeSpaceIndex       = NULL;
   container->deletesValueHdr      = NULL;
   container->touchedChain         = NULL;
   container->ioBuffer             = NULL;
   container->tocIOCtl             = NULL;
+  container->tocArena             = NULL;
 
 #ifdef VIRTUAL_BENTO_OBJECTS
   /* This flag tells whether the current access MODE allows objects to be virtual
@@ -1610,13 +1612,22 @@ CMContainer CM_FIXEDARGS CMOpenContainer(CMSession sessionData,
 
   /* RPS (OMF) try to truncate first. If this step fails, add the space to the free list */
 
+  /* The old TOC space is only reused once the container is opened again (see the      */
+  /* FreeSpce.c comments).  The logical EOF is left past it so the new TOC is appended  */
+  /* rather than written over the old one.  The old TOC thus stays intact until the new */
+  /* TOC is written.                                                                    */
+
   if ((useFlags & kCMReuseFreeSpace) != 0) {
     container->logicalEOF = container->tocOffset;   /* set logical EOF to TOC start     */
  		if (! (container->handler.cmftrunc != NULL && /* if truncation handler provided...*/
            CMftrunc(container, container->logicalEOF)))  /* ...and it trucated containr*/
     {
+    	container->logicalEOF = container->physicalEOF; /* new TOC goes after the old one */
     	newSize = container->tocSize;
     	omfsAddInt32toInt64(LBLsize, &newSize);
+#ifdef VIRTUAL_BENTO_OBJECTS
+    	if (!container->objectsMayBeVirtual)        /* purged objects reload from old TOC */
+#endif
     	cmAddToFreeList(container, NULL, container->tocOffset, newSize);
     }
   }
@@ -217,4 +217,66 @@
 #define CMSHADOW_LIST 1         /* 1 ==> support reference shadow list                  */
 #endif
 
+
+/*---------------------------------*
+ | Object Property Index Controls  |
+ *---------------------------------*
+
+ The properties for an object are kept on a list, which cmGetObjectProperty() must scan
+ each time a property is looked up.  Every CMCountValues(), CMUseValue(), etc. does such a
+ lookup, so for objects with many properties the scan is repeated over and over.  When the
+ macro variable below is 1, objects with at least PropertyIndexThreshold properties get a
+ small hash index of their properties, built the first time one is looked up.  The index
+ is kept up to date as properties are added and is thrown away (to be rebuilt on demand)
+ when properties are removed.  Defining the variable as 0 suppresses the index and the
+ memory it uses.
+*/
+
+#ifndef CMPROPERTY_INDEX
+#define CMPROPERTY_INDEX 1      /* 1 ==> index the properties of large objects          */
+#endif
+
+#ifndef PropertyIndexThreshold
+#define PropertyIndexThreshold 8 /* min nbr of properties an object needs to be indexed */
+#endif
+
+
+/*---------------------------------*
+ | TOC Load Arena Controls         |
+ *---------------------------------*
+
+ When a TOC is read in from a container that is not being updated, the TOC objects,
+ properties, value headers, and values it defines are carved out of large blocks (an
+ "arena") owned by the container rather than being individually allocated.  A format 1
+ TOC is also read with one I/O rather than entry by entry.  The arena is freed all at
+ once when the TOC is freed.  Nodes created after the TOC is loaded are allocated as
+ usual.  TOCArenaMaxBlockSize limits the size of the individual arena blocks.  Defining
+ CMTOC_ARENA as 0 restores the entry-by-entry TOC read and per-node allocations.
+*/
+
+#ifndef CMTOC_ARENA
+#define CMTOC_ARENA 1           /* 1 ==> load TOCs into a bulk node arena               */
+#endif
+
+#ifndef TOCArenaMaxBlockSize
+#define TOCArenaMaxBlockSize (8L*1024L*1024L) /* max size of a single TOC arena block   */
+#endif
+
+
+/*---------------------------------*
+ | Free Space Reuse Controls       |
+ *---------------------------------*
+
+ When a container is opened with kCMReuseFreeSpace (e.g., by omfsModifyFile()), space given
+ up by deleted or rewritten value data, along with the space of the container's old TOC, is
+ recorded on the "free space" list of TOC object ID 1 (see    FreeSpce.c   ).  The next
+ time the container is opened that way, the space is handed out again for new value data
+ instead of growing the container.  Containers written any other way get no free list.
+ Defining REUSE_ENABLED as 0 neither records nor reuses free space.
+*/
+
+#ifndef REUSE_ENABLED
+#define REUSE_ENABLED 1         /* 1 ==> record and reuse freed container space         */
+#endif
+
 #endif
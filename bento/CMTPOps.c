@@ -376,7 +376,7 @@ CMCount32 CM_FIXEDARGS CMRemoveBaseType(CMType type, CMType baseType)
 
     cmAddToFreeList(container, theValue, zero, zero);       /* add freed space to free list   */
     cmDeleteListCell(&theValueHdr->valueList, theValue);
-    CMfree(container, theValue);                                 /* poof!                          */
+    cmFreeTOCNode(container, theValue);                          /* poof!                          */
 
   	omfsCvtUInt32toInt64(sizeof(CMObjectID), &objIDSize);
     omfsSubInt64fromInt64(objIDSize, &theValueHdr->size);  /* update total size in value hdr */
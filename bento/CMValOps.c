@@ -534,52 +534,23 @@ CMSize CM_FIXEDARGS CMGetValueSize(CMValue value)
 }
 
 
-/*---------------------------------------------*
- | CMReadValueData - read the data for a value |
- *---------------------------------------------*
+/*------------------------------------------------------------------*
+ | readValueHdrData - read the data for a real (non-dynamic) value |
+ *------------------------------------------------------------------*
 
- The data, starting at the offset, for the value is read into the buffer.  The size of the
- data read is returned.  Up to maxSize characters will be read (can be 0).
-
- The data is read starting at the offset, up to the end of the data, or maxSize characters,
- whichever comes first.  Offsets are relative to 0.  If the starting offset is greater than
- or equal to the current data size, no data is read and 0 returned.
-
- Normally CMReadValueData() is used on a container that was opened for input using
- CMOpenContainer().  However, it is permitted to read data already written to a container
- that has been opened with CMOpenNewContainer().
-
- It is an error to attempt to read a value which has no data, i.e., a value where only a
- CMNewValue() has been done.
+ This is the guts of CMReadValueData() for values that are not dynamic values.  It is
+ shared with cmReadPropertyValue(), which has already resolved the value header and so
+ doesn't need to revalidate it.
 */
 
-CMSize32 CM_FIXEDARGS CMReadValueData(CMValue value, CMPtr buffer, CMCount offset, CMSize32 maxSize)
+static CMSize32 CM_NEAR readValueHdrData(ContainerPtr container, TOCValueHdrPtr theValueHdr,
+                                         CMPtr buffer, CMCount offset, CMSize32 maxSize)
 {
-  TOCValueHdrPtr theValueHdr;
   TOCValuePtr    theValue;
-  ContainerPtr   container;
   unsigned char  *p;
   CMSize32		  len, remaining, totalRead, amountRead;
   CMSize		lenTmp;
 
-  ExitIfBadValue(value, 0);                         /* validate value                   */
-
-  container = ((TOCValueHdrPtr)value)->container;   /* NEVER use updatingContainer here!*/
-
-  if (IsDynamicValue(value)) {                      /* process dynamic value...         */
-    GetDynHandlerAddress(value, cmReadValueData, CMReadValueDataOpType, "CMReadValueData", 0);
-    if (IsDynamicValue(value)) {
-      SignalDynHandlerInUse(value, cmReadValueData);
-      AllowCMGetBaseValue(container);
-      totalRead = CMDynReadValueData(value, buffer, offset, maxSize);
-      DisAllowCMGetBaseValue(container);
-      SignalDynHandlerAvailable(value, cmReadValueData);
-      return (totalRead);
-    }
-  }
-
-  theValueHdr = (TOCValueHdrPtr)value;              /* ("this") value may have changed! */
-
   #if 0 /* removed check to allow reading stuff written to an output container */
   if (container->useFlags & kCMWriting) {           /* make sure we're opend for reading*/
     ERROR1(container,CM_err_ReadIllegal, CONTAINERNAME);
@@ -633,6 +604,95 @@ CMSize32 CM_FIXEDARGS CMReadValueData(CMValue value, CMPtr buffer, CMCount offse
   return (totalRead);                               /* return total amount concatenated */
 }
 
+
+/*---------------------------------------------*
+ | CMReadValueData - read the data for a value |
+ *---------------------------------------------*
+
+ The data, starting at the offset, for the value is read into the buffer.  The size of the
+ data read is returned.  Up to maxSize characters will be read (can be 0).
+
+ The data is read starting at the offset, up to the end of the data, or maxSize characters,
+ whichever comes first.  Offsets are relative to 0.  If the starting offset is greater than
+ or equal to the current data size, no data is read and 0 returned.
+
+ Normally CMReadValueData() is used on a container that was opened for input using
+ CMOpenContainer().  However, it is permitted to read data already written to a container
+ that has been opened with CMOpenNewContainer().
+
+ It is an error to attempt to read a value which has no data, i.e., a value where only a
+ CMNewValue() has been done.
+*/
+
+CMSize32 CM_FIXEDARGS CMReadValueData(CMValue value, CMPtr buffer, CMCount offset, CMSize32 maxSize)
+{
+  ContainerPtr   container;
+  CMSize32       totalRead;
+
+  ExitIfBadValue(value, 0);                         /* validate value                   */
+
+  container = ((TOCValueHdrPtr)value)->container;   /* NEVER use updatingContainer here!*/
+
+  if (IsDynamicValue(value)) {                      /* process dynamic value...         */
+    GetDynHandlerAddress(value, cmReadValueData, CMReadValueDataOpType, "CMReadValueData", 0);
+    if (IsDynamicValue(value)) {
+      SignalDynHandlerInUse(value, cmReadValueData);
+      AllowCMGetBaseValue(container);
+      totalRead = CMDynReadValueData(value, buffer, offset, maxSize);
+      DisAllowCMGetBaseValue(container);
+      SignalDynHandlerAvailable(value, cmReadValueData);
+      return (totalRead);
+    }
+  }
+
+  return (readValueHdrData(container, (TOCValueHdrPtr)value, buffer, offset, maxSize));
+}
+
+
+/*---------------------------------------------------------------------------*
+ | cmReadPropertyValue - find, size, and read an object's property value   |
+ *---------------------------------------------------------------------------*
+
+ This is an internal shortcut for the CMCountValues(), CMUseValue(), CMGetValueSize(), and
+ CMReadValueData() sequence used to read a property value.  The value is looked up once,
+ its size is returned in valueSize, and, if the offset is not past the end of the value, up
+ to maxSize bytes starting at the offset are read into the buffer.  The number of bytes
+ actually read is returned in amountRead.  maxSize may be 0 (and the buffer NULL) to just
+ get the value's size.
+
+ The function result is the value refNum, as CMUseValue() would return it, or NULL if the
+ object has no value of the given type for the property.  Dynamic values are handled by
+ calling the standard API routines, so their handlers are called just as before.
+*/
+
+CMValue CM_FIXEDARGS cmReadPropertyValue(CMObject object, CMProperty property, CMType type,
+                                         CMPtr buffer, CMCount offset, CMSize32 maxSize,
+                                         CMSize *valueSize, CMSize32 *amountRead)
+{
+  CMValue        value;
+  TOCValueHdrPtr theValueHdr;
+
+  *amountRead = 0;
+  omfsCvtUInt32toInt64(0, valueSize);
+
+  value = CMUseValue(object, property, type);       /* find value (one property lookup) */
+  if (value == NULL) return (NULL);
+
+  if (IsDynamicValue(value)) {                      /* dynamic values go the long way   */
+    *valueSize = CMGetValueSize(value);
+    if (!omfsInt64Greater(offset, *valueSize))
+      *amountRead = CMReadValueData(value, buffer, offset, maxSize);
+    return (value);
+  }
+
+  theValueHdr = (TOCValueHdrPtr)value;
+  *valueSize  = theValueHdr->size;
+  if (!omfsInt64Greater(offset, *valueSize))        /* read nothing if off the end      */
+    *amountRead = readValueHdrData(theValueHdr->container, theValueHdr, buffer, offset, maxSize);
+
+  return (value);
+}
+
 /*-------------------------------------------------------------------*
  | CMGetValueDataOffset - Get the underlying file offset for a value |
  *-------------------------------------------------------------------*
@@ -736,8 +796,6 @@ void CM_FIXEDARGS CMWriteValueData(CMValue value, CMPtr buffer, CMCount offset,
   CMSize		valueSize, lenTmp;
   unsigned int 	longVal;
   TOCValueBytes  valueBytes;
-  CMSize32  	fillBytes;
-  omfInt32		pastBoundary;
   omfInt64		zero;
 
   omfsCvtUInt32toInt64(0, &zero);
@@ -793,40 +851,8 @@ void CM_FIXEDARGS CMWriteValueData(CMValue value, CMPtr buffer, CMCount offset,
       cmAppendValue(theValueHdr, &valueBytes, kCMImmediate);
     } else if (size != 0) {                         /* value must be written...         */
 
-      nextFree = CMgetContainerSize(container);
-      CMfseek(container, zero, kCMSeekEnd);                        /* position to current eof          */
-
-      /* align new values according to container constraints */
-
-		omfsDivideInt64byInt32(nextFree, container->valueAlignment, NULL, &pastBoundary);
-		if ((container->valueAlignment != 1) && (pastBoundary != 0))
-		    {
-	    	/* if pastBoundary is the remainder of the division, then the number of bytes to */
-	    	/* reach the next boundary (fillBytes) is the difference between the boundary    */
-	    	/* factor and pastBoundary */
-
-	       unsigned char  zeroBuf[16];
-	       CMSize32		 i, overBytes;
-	       unsigned char* zeroPtr = NULL;
-
-			    overBytes = pastBoundary;
-			    fillBytes = container->valueAlignment - overBytes;
-	       		if ( fillBytes <= 16 )
-	       			zeroPtr = zeroBuf;
-	       		else
-	       			zeroPtr = (unsigned char *)CMmalloc( container, fillBytes );
-
-				for (i = 0; i< fillBytes; i++)
-					zeroPtr[i] = 0;
-
-	       if (CMfwrite(container, (void *)zeroPtr, 1, fillBytes) != fillBytes) {
-	            ERROR1(container,CM_err_BadWrite, CONTAINERNAME);
-	            if (fillBytes > 16) CMfree(container, zeroPtr);
-	            return;
-	       }
-	       if (fillBytes > 16) CMfree(container, zeroPtr);
-      }
-
+      /* cmWriteData() places the start of a new value at the container's value         */
+      /* alignment, whether it reuses free space or writes to the end of the container. */
 
       if (cmWriteData(theValueHdr, (unsigned char *)buffer, (unsigned int )size) != size)
         ERROR1(container,CM_err_BadWrite, CONTAINERNAME);
@@ -1978,7 +2004,7 @@ void CM_FIXEDARGS CMReleaseValue(CMValue value)
         cmInitList(&theValueHdr->valueList);                    /* ...done for safety   */
         cmAppendListCell(&container->deletedValues,theValueHdr);/* ...move to list      */
       } else                                                    /* if don't keep refNums*/
-        CMfree(container, theValueHdr);                                    /* ...free it           */
+        cmFreeTOCNode(container, theValueHdr);                             /* ...free it           */
     } else {                                                    /* if bottom layer...   */
       TOCPropertyPtr theProperty = theValueHdr->theProperty;    /* ...point to dyn prop.*/
       if (cmCountListCells(&theProperty->valueHdrList) == 1)    /* ...if last dyn value */
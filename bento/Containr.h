@@ -125,6 +125,7 @@ struct Container {                        /* Layout for a "Container Control Blo
   CMCount		      tocInputOffset;     /*    current TOC input offset                */
   void                *ioBuffer;          /*    current buffered TOC I/O buffer         */
   void                *tocIOCtl;          /*    current TOC I/O control block pointer   */
+  void                *tocArena;          /*    bulk TOC node arena (or NULL)           */
 
   struct TOCValue     *tocIDSeedValue;    /*    ptr to TOC ID seed value       (not hdr)*/
   struct TOCValue     *tocIDMinSeedValue; /*    ptr to TOC ID min seed value   (not hdr)*/
@@ -133,6 +134,7 @@ struct Container {                        /* Layout for a "Container Control Blo
   struct TOCValue     *spaceDeletedValue; /*    ptr to TOC space deleted value (not hdr)*/
   struct TOCValue     *tocNewValuesValue; /*    ptr to TOC new values TOC      (not hdr)*/
   struct TOCValueHdr  *freeSpaceValueHdr; /*    ptr to TOC free list (this IS value hdr)*/
+  void                *freeSpaceIndex;    /*    offset/size index of free list (or NULL)*/
   struct TOCValueHdr  *deletesValueHdr;   /*    ptr to TOC deletes list (also value hdr)*/
 
   void                *globalNameTable;   /*    ptr to global name tbl (or target)      */
@@ -1191,7 +1191,7 @@ void cmDeleteAllDynamicValueLayers(TOCValueHdrPtr theValueHdr, Boolean freeValue
         cmDeleteListCell(&theProperty->valueHdrList, theValueHdr); /*(bottom layer only)*/
 
       CMfree(container, DYNEXTENSIONS(theValueHdr));             /* ...free the extensions...      */
-      CMfree(container, theValueHdr);                            /* ...and the header itself       */
+      cmFreeTOCNode(container, theValueHdr);                     /* ...and the header itself       */
 
       theValueHdr = nextLayer;                        /*  loop up to the "real" value   */
     } /* while */
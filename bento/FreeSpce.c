@@ -20,6 +20,14 @@
  properties to keep track of all the deleted space.
 
  If a container is opened for reusing free space, we use the free list to reuse the space.
+ The list is indexed in memory by offset and by size so that freed space is combined with
+ its neighbors and a best fit is found for each write without scanning the list.
+
+ Only the space that was already free when the container was opened is reused.  Space
+ freed while the container is open, including the space of its old TOC, is still recorded
+ on the free list, but it is not reused until the container is opened again.  Until the
+ new TOC is written, the old TOC still describes the data in that space, so writing over
+ it would leave nothing to recover from if we never got to write the new TOC.
 */
 
 
@@ -74,6 +82,601 @@
 #endif
 
 
+/* The free list is kept as value segments of the "free space" property because that is */
+/* what gets written to the container.  To keep from scanning it on every free and every*/
+/* write, each free list entry is also entered in two balanced (AVL) binary trees. One  */
+/* orders the entries by offset and is used to find the neighbors that newly freed space*/
+/* can be combined with.  The other orders them by size (then offset) and is used to    */
+/* find the best (smallest) fit for a write.  The index is built from the free list the */
+/* first time it is needed and is freed along with the container's TOC.                 */
+
+/* Entries that were on the free list when the index was built (i.e., when the container*/
+/* was opened) are "reusable".  Entries for space freed after that are "pending".  Each */
+/* kind has its own pair of trees so that the two are never combined and only reusable  */
+/* entries are ever looked at for a write.                                              */
+
+#if REUSE_ENABLED
+#define ByOffset 0                          /* index of the offset ordered tree         */
+#define BySize   1                          /* index of the size ordered tree           */
+
+#define Reusable 0                          /* free when the container was opened       */
+#define Pending  1                          /* freed since the container was opened     */
+
+struct FreeExtent {                         /* Layout of a free list index entry:       */
+  struct FreeExtent *lLink[2];              /*    left links (by offset, by size)       */
+  struct FreeExtent *rLink[2];              /*    right links (by offset, by size)      */
+  short             height[2];              /*    subtree heights (by offset, by size)  */
+  short             kind;                   /*    Reusable or Pending                   */
+  TOCValuePtr       theValue;               /*    the free list entry (value segment)   */
+};
+typedef struct FreeExtent FreeExtent, *FreeExtentPtr;
+
+struct FreeSpaceIndex {                     /* Layout of a container's free list index: */
+  FreeExtentPtr     root[2][2];             /*    tree roots [kind][by offset, by size] */
+};
+typedef struct FreeSpaceIndex FreeSpaceIndex, *FreeSpaceIndexPtr;
+
+#define ExtentOffset(e) ((e)->theValue->value.notImm.value)
+#define ExtentSize(e)   ((e)->theValue->value.notImm.valueLen)
+#define Height(e, t)    ((e) != NULL ? (e)->height[t] : 0)
+
+/*-------------------------------------------------------*
+ | tooSmallToKeep - check if free space is worth keeping |
+ *-------------------------------------------------------*
+
+ Returns true if the specified amount of free space is too small to be worth a free list
+ entry (and hence a TOC entry) of its own.
+*/
+
+static Boolean CM_NEAR tooSmallToKeep(ContainerPtr container, CMSize size)
+{
+  CMSize smallest;
+
+  #if TOC1_SUPPORT
+  if (container->majorVersion == 1)
+    omfsCvtUInt32toInt64(TOCentrySize, &smallest);
+  else
+    omfsCvtUInt32toInt64(MinTOCSize, &smallest);
+  #else
+  omfsCvtUInt32toInt64(MinTOCSize, &smallest);
+  #endif
+
+  return ((Boolean)omfsInt64LessEqual(size, smallest));
+}
+
+
+/*---------------------------------------------------------------*
+ | compareExtents - compare two free list entries in a given tree |
+ *---------------------------------------------------------------*
+
+ Returns -1, 0, or 1 as e1 is "less than", equal to, or "greater than" e2 in the ordering
+ used by the specified tree.  Free list entries never overlap so offsets are unique and
+ no two different entries ever compare equal.
+*/
+
+static int CM_NEAR compareExtents(FreeExtentPtr e1, FreeExtentPtr e2, int tree)
+{
+  if (tree == BySize) {
+    if (omfsInt64Less(ExtentSize(e1), ExtentSize(e2)))       return (-1);
+    if (omfsInt64Greater(ExtentSize(e1), ExtentSize(e2)))    return (1);
+  }
+
+  if (omfsInt64Less(ExtentOffset(e1), ExtentOffset(e2)))     return (-1);
+  if (omfsInt64Greater(ExtentOffset(e1), ExtentOffset(e2)))  return (1);
+
+  return (0);
+}
+
+
+/*-------------------------------------------------------*
+ | balanceExtent - restore the AVL balance of a subtree  |
+ *-------------------------------------------------------*
+
+ Recomputes the height of the subtree rooted at e in the specified tree and, if the
+ subtree is out of balance, rotates it back into balance.  The (possibly new) subtree root
+ is returned.
+*/
+
+static FreeExtentPtr CM_NEAR rotateExtents(FreeExtentPtr e, int tree, Boolean toTheRight)
+{
+  FreeExtentPtr pivot;
+  short         hl, hr;
+
+  if (toTheRight) {                                 /* left child becomes the root      */
+    pivot = e->lLink[tree];
+    e->lLink[tree] = pivot->rLink[tree];
+    pivot->rLink[tree] = e;
+  } else {                                          /* right child becomes the root     */
+    pivot = e->rLink[tree];
+    e->rLink[tree] = pivot->lLink[tree];
+    pivot->lLink[tree] = e;
+  }
+
+  hl = Height(e->lLink[tree], tree); hr = Height(e->rLink[tree], tree);
+  e->height[tree] = (short)((hl > hr ? hl : hr) + 1);
+  hl = Height(pivot->lLink[tree], tree); hr = Height(pivot->rLink[tree], tree);
+  pivot->height[tree] = (short)((hl > hr ? hl : hr) + 1);
+
+  return (pivot);
+}
+
+static FreeExtentPtr CM_NEAR balanceExtent(FreeExtentPtr e, int tree)
+{
+  FreeExtentPtr child;
+  short         hl = Height(e->lLink[tree], tree), hr = Height(e->rLink[tree], tree);
+
+  if (hl > hr + 1) {                                /* left heavy...                    */
+    child = e->lLink[tree];
+    if (Height(child->lLink[tree], tree) < Height(child->rLink[tree], tree))
+      e->lLink[tree] = rotateExtents(child, tree, false);
+    return (rotateExtents(e, tree, true));
+  }
+
+  if (hr > hl + 1) {                                /* right heavy...                   */
+    child = e->rLink[tree];
+    if (Height(child->rLink[tree], tree) < Height(child->lLink[tree], tree))
+      e->rLink[tree] = rotateExtents(child, tree, true);
+    return (rotateExtents(e, tree, false));
+  }
+
+  e->height[tree] = (short)((hl > hr ? hl : hr) + 1);
+  return (e);
+}
+
+
+/*--------------------------------------------------------------*
+ | insertExtent - enter a free list entry into one of the trees |
+ *--------------------------------------------------------------*
+
+ Enters e into the specified tree whose (sub)tree root is root.  The new root is returned.
+*/
+
+static FreeExtentPtr CM_NEAR insertExtent(FreeExtentPtr root, FreeExtentPtr e, int tree)
+{
+  if (root == NULL) {                               /* new leaf                         */
+    e->lLink[tree] = e->rLink[tree] = NULL;
+    e->height[tree] = 1;
+    return (e);
+  }
+
+  if (compareExtents(e, root, tree) < 0)
+    root->lLink[tree] = insertExtent(root->lLink[tree], e, tree);
+  else
+    root->rLink[tree] = insertExtent(root->rLink[tree], e, tree);
+
+  return (balanceExtent(root, tree));
+}
+
+
+/*-------------------------------------------------------------*
+ | removeExtent - remove a free list entry from one of the trees |
+ *-------------------------------------------------------------*
+
+ Removes e from the specified tree whose (sub)tree root is root.  e must be in the tree.
+ The new root is returned.
+*/
+
+static FreeExtentPtr CM_NEAR removeSmallestExtent(FreeExtentPtr root, int tree)
+{
+  if (root->lLink[tree] == NULL)                    /* root is the smallest, unhook it  */
+    return (root->rLink[tree]);
+
+  root->lLink[tree] = removeSmallestExtent(root->lLink[tree], tree);
+  return (balanceExtent(root, tree));
+}
+
+static FreeExtentPtr CM_NEAR removeExtent(FreeExtentPtr root, FreeExtentPtr e, int tree)
+{
+  FreeExtentPtr successor;
+
+  if (root == NULL) return (NULL);                  /* safety                           */
+
+  if (root != e) {                                  /* keep looking...                  */
+    if (compareExtents(e, root, tree) < 0)
+      root->lLink[tree] = removeExtent(root->lLink[tree], e, tree);
+    else
+      root->rLink[tree] = removeExtent(root->rLink[tree], e, tree);
+    return (balanceExtent(root, tree));
+  }
+
+  if (e->rLink[tree] == NULL)                       /* no right subtree, left replaces e*/
+    return (e->lLink[tree]);
+
+  for (successor = e->rLink[tree]; successor->lLink[tree]; successor = successor->lLink[tree])
+    ;                                               /* e's successor replaces e         */
+  successor->rLink[tree] = removeSmallestExtent(e->rLink[tree], tree);
+  successor->lLink[tree] = e->lLink[tree];
+
+  return (balanceExtent(successor, tree));
+}
+
+
+/*-----------------------------------------------------------*
+ | findByOffset - find a free list entry at or near an offset |
+ *-----------------------------------------------------------*
+
+ If atOrBelow is true, the free list entry of the specified kind with the largest offset
+ less than or equal to the specified offset is returned.  Otherwise the entry with the
+ smallest offset greater than or equal to the specified offset is returned.  NULL is
+ returned if there is none.
+*/
+
+static FreeExtentPtr CM_NEAR findByOffset(FreeSpaceIndexPtr theIndex, int kind,
+                                          CMCount offset, Boolean atOrBelow)
+{
+  FreeExtentPtr e = theIndex->root[kind][ByOffset], found = NULL;
+
+  while (e) {
+    if (omfsInt64Equal(ExtentOffset(e), offset))
+      return (e);
+    if (omfsInt64Less(ExtentOffset(e), offset)) {
+      if (atOrBelow) found = e;
+      e = e->rLink[ByOffset];
+    } else {
+      if (!atOrBelow) found = e;
+      e = e->lLink[ByOffset];
+    }
+  }
+
+  return (found);
+}
+
+
+/*----------------------------------------------------------*
+ | findBySize - find the smallest free list entry that fits |
+ *----------------------------------------------------------*
+
+ Returns the reusable free list entry that is first in the size ordered tree at or after
+ the specified size and offset, i.e., the smallest entry at least size bytes long (and,
+ among entries of that size, the first one at or after offset).  NULL is returned if there
+ is none.  Pending entries are never returned since they may not be reused yet.
+*/
+
+static FreeExtentPtr CM_NEAR findBySize(FreeSpaceIndexPtr theIndex, CMSize size,
+                                        CMCount offset)
+{
+  FreeExtentPtr e = theIndex->root[Reusable][BySize], found = NULL;
+
+  while (e) {
+    if (omfsInt64Less(ExtentSize(e), size) ||
+        (omfsInt64Equal(ExtentSize(e), size) && omfsInt64Less(ExtentOffset(e), offset)))
+      e = e->rLink[BySize];
+    else {
+      found = e;
+      e = e->lLink[BySize];
+    }
+  }
+
+  return (found);
+}
+
+
+/*------------------------------------------------------------------*
+ | indexExtent - enter or remove a free list entry in the free index |
+ *------------------------------------------------------------------*
+
+ These enter the specified free list entry in, or remove it from, both trees of its kind
+ in the free list index.  An entry's offset and size must not be changed while it's in the
+ trees.
+*/
+
+static void CM_NEAR indexExtent(FreeSpaceIndexPtr theIndex, FreeExtentPtr e)
+{
+  FreeExtentPtr *root = theIndex->root[e->kind];
+
+  root[ByOffset] = insertExtent(root[ByOffset], e, ByOffset);
+  root[BySize]   = insertExtent(root[BySize],   e, BySize);
+}
+
+static void CM_NEAR unindexExtent(FreeSpaceIndexPtr theIndex, FreeExtentPtr e)
+{
+  FreeExtentPtr *root = theIndex->root[e->kind];
+
+  root[ByOffset] = removeExtent(root[ByOffset], e, ByOffset);
+  root[BySize]   = removeExtent(root[BySize],   e, BySize);
+}
+
+
+/*-----------------------------------------------------------*
+ | freeExtents - free all the entries of a free list subtree |
+ *-----------------------------------------------------------*/
+
+static void CM_NEAR freeExtents(ContainerPtr container, FreeExtentPtr e)
+{
+  FreeExtentPtr right;
+
+  while (e) {                                       /* recurse left, iterate right      */
+    freeExtents(container, e->lLink[ByOffset]);
+    right = e->rLink[ByOffset];
+    CMfree(container, e);
+    e = right;
+  }
+}
+
+
+/*----------------------------------------------------------------*
+ | setExtent - change the offset and size of a free list entry     |
+ *----------------------------------------------------------------*
+
+ Redefines the space covered by a free list entry, moving it to its new place in the free
+ list index.  The total size kept in the free list value header is adjusted to match.
+*/
+
+static void CM_NEAR setExtent(ContainerPtr container, FreeExtentPtr e, CMCount offset,
+                              CMSize size)
+{
+  FreeSpaceIndexPtr theIndex = (FreeSpaceIndexPtr)container->freeSpaceIndex;
+
+  unindexExtent(theIndex, e);
+
+  omfsSubInt64fromInt64(ExtentSize(e), &container->freeSpaceValueHdr->size);
+  omfsAddInt64toInt64(size, &container->freeSpaceValueHdr->size);
+  ExtentOffset(e) = offset;
+  ExtentSize(e)   = size;
+
+  indexExtent(theIndex, e);
+}
+#endif
+
+
+/*------------------------------------------------*
+ | deleteFreeListEntry - delete a free list entry |
+ *------------------------------------------------*
+
+ This routine removes the specified free list entry from the free list and its index and
+ frees up its space.  If this is the last entry of the free list, the free list property
+ itself (along with its value header, of course) and the index are removed.
+
+ Note, this routine is a low-level routine called from the other routines in this file.
+ As such there are no error checks.  The caller is assumed "happy" with what its doing by
+ the time it calls this routine.
+*/
+
+#if REUSE_ENABLED
+static void CM_NEAR deleteFreeListEntry(ContainerPtr container, FreeExtentPtr e)
+{
+  TOCObjectPtr   theTOCObject;
+  TOCPropertyPtr theFreeListProperty;
+  TOCValueHdrPtr freeSpaceValueHdr = container->freeSpaceValueHdr;
+  TOCValuePtr    theValue = e->theValue, prevValue;
+
+  unindexExtent((FreeSpaceIndexPtr)container->freeSpaceIndex, e);
+  CMfree(container, e);
+
+  /* Delete the value entry from its list and free its space.  If it was the last entry */
+  /* on the list, the one before it is now the last and is no longer continued...      */
+
+  if (cmGetNextListCell(theValue) == NULL) {
+    prevValue = (TOCValuePtr)cmGetPrevListCell(theValue);
+    if (prevValue != NULL)
+      prevValue->flags &= ~kCMContinued;
+  }
+
+  omfsSubInt64fromInt64(theValue->value.notImm.valueLen, &freeSpaceValueHdr->size);
+  cmFreeTOCNode(container, cmDeleteListCell(&freeSpaceValueHdr->valueList, theValue));
+
+  if (cmCountListCells(&freeSpaceValueHdr->valueList) < 2)
+    freeSpaceValueHdr->valueFlags &= ~ValueContinued;
+
+  /* If there are no more free list entries, delete the value header and the "free      */
+  /* space" property from TOC ID 1...                                                   */
+
+  if (cmIsEmptyList(&freeSpaceValueHdr->valueList)) {       /* if no more free list...  */
+    theFreeListProperty = freeSpaceValueHdr->theProperty;   /* ...get owning property   */
+    theTOCObject        = theFreeListProperty->theObject;   /* ...get owning object (1) */
+    cmFreeTOCNode(container, freeSpaceValueHdr);            /* ...clobber the value hdr */
+    cmFreePropertyIndex(theTOCObject);                      /* ...and its index         */
+    cmFreeTOCNode(container, cmDeleteListCell(&theTOCObject->propertyList, theFreeListProperty));
+    container->freeSpaceValueHdr = NULL;                    /* ...no more free list     */
+    cmFreeFreeSpaceIndex(container);                        /* ...and no more index     */
+  }
+}
+
+
+/*--------------------------------------------------------------------*
+ | combineFreeSpace - combine freed space with existing free list space |
+ *--------------------------------------------------------------------*
+
+ The specified freed space is combined with all the free list entries of the specified
+ kind it overlaps or abuts.  The first such entry is extended to cover the combined space
+ and all the others are deleted.  This is our on-the-fly garbage collector.  True is
+ returned if the space was combined and false if it doesn't touch any existing free space
+ of that kind.  Reusable and pending entries are never combined with each other.  That
+ waits until the container is next opened.
+*/
+
+static Boolean CM_NEAR combineFreeSpace(ContainerPtr container, int kind, CMCount offset,
+                                        CMSize size)
+{
+  FreeSpaceIndexPtr theIndex = (FreeSpaceIndexPtr)container->freeSpaceIndex;
+  FreeExtentPtr     keep, next, after;
+  CMCount           start, end, extentEnd, nextOffset;
+
+  end = offset;
+  omfsAddInt64toInt64(size, &end);                  /* end of the freed space + 1       */
+
+  /* The entry to keep is the one starting at or before the freed space if it reaches   */
+  /* it.  Otherwise it's the one starting in (or right after) the freed space if any.   */
+
+  keep = findByOffset(theIndex, kind, offset, true);
+  if (keep != NULL) {
+    extentEnd = ExtentOffset(keep);
+    omfsAddInt64toInt64(ExtentSize(keep), &extentEnd);
+    if (omfsInt64Less(extentEnd, offset))
+      keep = NULL;
+  }
+
+  if (keep == NULL) {
+    keep = findByOffset(theIndex, kind, offset, false);
+    if (keep == NULL || omfsInt64Greater(ExtentOffset(keep), end))
+      return (false);                               /* touches nothing                  */
+  }
+
+  start = ExtentOffset(keep);
+  if (omfsInt64Less(offset, start)) start = offset;
+  extentEnd = ExtentOffset(keep);
+  omfsAddInt64toInt64(ExtentSize(keep), &extentEnd);
+  if (omfsInt64Greater(extentEnd, end)) end = extentEnd;
+
+  /* Swallow all the following entries that start at or before the combined end...      */
+
+  nextOffset = ExtentOffset(keep);
+  omfsAddInt32toInt64(1, &nextOffset);
+  next = findByOffset(theIndex, kind, nextOffset, false);
+
+  while (next != NULL && omfsInt64LessEqual(ExtentOffset(next), end)) {
+    extentEnd = ExtentOffset(next);
+    omfsAddInt64toInt64(ExtentSize(next), &extentEnd);
+    if (omfsInt64Greater(extentEnd, end)) end = extentEnd;
+
+    nextOffset = ExtentOffset(next);
+    omfsAddInt32toInt64(1, &nextOffset);
+    after = findByOffset(theIndex, kind, nextOffset, false);
+    deleteFreeListEntry(container, next);
+    next = after;
+  }
+
+  omfsSubInt64fromInt64(start, &end);               /* end is now the combined size     */
+  setExtent(container, keep, start, end);
+
+  return (true);
+}
+
+
+/*-------------------------------------------------------------*
+ | getFreeSpaceIndex - get (building if necessary) the free index |
+ *-------------------------------------------------------------*
+
+ Returns the free list index for the container, building it from the free list if it
+ doesn't exist yet.  The free list read from a container may contain entries that abut
+ (or even overlap) each other.  These are combined as they are entered.  NULL is returned
+ if there isn't enough memory for the index.
+
+ The index is always built before anything is added to the free list.  So the entries
+ found on the list here are the ones read from the container and are all reusable.
+*/
+
+static FreeSpaceIndexPtr CM_NEAR getFreeSpaceIndex(ContainerPtr container)
+{
+  FreeSpaceIndexPtr theIndex = (FreeSpaceIndexPtr)container->freeSpaceIndex;
+  FreeExtentPtr     e;
+  TOCValuePtr       theValue, nextValue;
+
+  if (theIndex != NULL) return (theIndex);
+
+  if ((theIndex = (FreeSpaceIndexPtr)CMmalloc(container, sizeof(FreeSpaceIndex))) == NULL)
+    return (NULL);
+  theIndex->root[Reusable][ByOffset] = theIndex->root[Reusable][BySize] = NULL;
+  theIndex->root[Pending][ByOffset]  = theIndex->root[Pending][BySize]  = NULL;
+  container->freeSpaceIndex = (void *)theIndex;
+
+  if (container->freeSpaceValueHdr == NULL) return (theIndex);
+
+  theValue = (TOCValuePtr)cmGetListHead(&container->freeSpaceValueHdr->valueList);
+
+  while (theValue) {                                /* index the free list...           */
+    nextValue = (TOCValuePtr)cmGetNextListCell(theValue);
+
+    if (combineFreeSpace(container, Reusable, theValue->value.notImm.value,
+                         theValue->value.notImm.valueLen)) {
+      if (nextValue == NULL) {                      /* if it was the last entry...      */
+        TOCValuePtr prevValue = (TOCValuePtr)cmGetPrevListCell(theValue);
+        if (prevValue != NULL) prevValue->flags &= ~kCMContinued;
+      }
+      omfsSubInt64fromInt64(theValue->value.notImm.valueLen, &container->freeSpaceValueHdr->size);
+      cmFreeTOCNode(container, cmDeleteListCell(&container->freeSpaceValueHdr->valueList, theValue));
+    } else {
+      if ((e = (FreeExtentPtr)CMmalloc(container, sizeof(FreeExtent))) == NULL) {
+        cmFreeFreeSpaceIndex(container);            /* can't index, so don't use it     */
+        return (NULL);
+      }
+      e->kind     = Reusable;
+      e->theValue = theValue;
+      indexExtent(theIndex, e);
+    }
+
+    theValue = nextValue;
+  }
+
+  if (cmCountListCells(&container->freeSpaceValueHdr->valueList) < 2)
+    container->freeSpaceValueHdr->valueFlags &= ~ValueContinued;
+
+  return (theIndex);
+}
+
+
+/*-----------------------------------------------------------*
+ | newFreeListEntry - create a new free list (and index) entry |
+ *-----------------------------------------------------------*
+
+ Appends a new entry for the specified space on the free list and enters it in the index
+ as the specified kind of entry.
+
+ For new containers, there is no "free space" property initially for ID 1.  It is created
+ here the first time we need it.  We remember the value header for the "free space"
+ property so that we may efficiently get at the list on all future calls.
+*/
+
+static void CM_NEAR newFreeListEntry(ContainerPtr container, int kind, CMCount offset,
+                                     CMSize size)
+{
+  TOCObjectPtr   theTOCobject;
+  TOCValueHdrPtr freeSpaceValueHdr = container->freeSpaceValueHdr;
+  TOCValuePtr    theValue;
+  TOCValueBytes  valueBytes;
+  FreeExtentPtr  e;
+  void           *toc;
+
+  if ((e = (FreeExtentPtr)CMmalloc(container, sizeof(FreeExtent))) == NULL)
+    return;
+
+  /* If this is the first freed space in the container, create the "free space" property*/
+  /* for the TOC object 1.  Otherwise, just use it.  Note, the TOC we want to deal with */
+  /* here is the container's own (private) TOC.  This will be different from the current*/
+  /* TOC when we're updating containers.                                                */
+
+  if (freeSpaceValueHdr == NULL) {                /* if 1st free space for container... */
+    toc = container->toc;                         /* ...remember current TOC            */
+    container->toc = container->privateTOC;       /* use container's own (private) TOC  */
+
+    theTOCobject = cmDefineObject(container,      /* ...create "free space" property    */
+                                  CM_StdObjID_TOC, CM_StdObjID_TOC_Free,
+                                  CM_StdObjID_TOC_Type, NULL,
+                                  container->generation, 0,
+                                  (ObjectObject | ProtectedObject),
+                                  &freeSpaceValueHdr);
+
+    container->toc = toc;                         /* restore current container          */
+    if (theTOCobject == NULL) {
+      CMfree(container, e);
+      return;
+    }
+    freeSpaceValueHdr->valueFlags |= ValueProtected;/* don't allow writing to this value*/
+    container->freeSpaceValueHdr = freeSpaceValueHdr;
+  }
+
+  /* At this point we want to create a new free list entry for the newly freed offset   */
+  /* size.  The value list are standard value entries for the "free space" property of  */
+  /* TOC object ID 1.                                                                   */
+
+  theValue = (TOCValuePtr)cmGetListTail(&freeSpaceValueHdr->valueList);
+  if (theValue) {
+    theValue->flags |= kCMContinued;                /* flag the current value as cont'd */
+    freeSpaceValueHdr->valueFlags |= ValueContinued;/* also set a more convenient flag  */
+  }
+
+  (void)cmSetValueBytes(container, &valueBytes, Value_NotImm, offset, size);
+  e->kind = (short)kind;
+  if ((e->theValue = cmAppendValue(freeSpaceValueHdr, &valueBytes, 0)) == NULL) {
+    CMfree(container, e);
+    return;
+  }
+
+  indexExtent((FreeSpaceIndexPtr)container->freeSpaceIndex, e);
+}
+#endif
+
+
 /*------------------------------------------------------------*
  | cmAddToFreeList - add freed space to the "free space" list |
  *------------------------------------------------------------*
@@ -96,34 +699,28 @@
        passed.  Note that a non-null theValueToFree has precedence over explicit offset
        and size.
 
-  As part of the freeing process, we scan the free list to see if the new space can be
-  combined with an already existing entry.  It's a sort of on-the-fly garbage collector.
-
-  For new containers, there is no "free space" property initially for ID 1.  It is created
-  here the first time we need to free space.  We remember the value header for the "free
-  space" property so that we may efficiently get at the list on all future calls.
+  As part of the freeing process, the new space is combined with all existing pending free
+  list entries it overlaps or abuts.  These are found through the free list's offset index
+  rather than by scanning the list.  Space that can't be combined and is too small to be
+  worth a TOC entry is forgotten.  The freed space is not handed out again while the
+  container remains open (see getFreeSpace()).
 */
 
 void cmAddToFreeList(ContainerPtr container, TOCValuePtr theValueToFree,
                      CMCount offset, CMSize size)
 {
-#ifdef REUSE_ENABLED
-  TOCObjectPtr   theTOCobject;
-  TOCValueHdrPtr freeSpaceValueHdr = container->freeSpaceValueHdr;
-  TOCValuePtr    theValue;
-  unsigned int   valueStart, valueEndPlus1;
-  TOCValueBytes  valueBytes;
-  void           *toc;
+#if REUSE_ENABLED
   omfInt64		zero;
 
   omfsCvtUInt32toInt64(0, &zero);
-  /* We only track free space when a container is opened for writing or updating.       */
-  /* However, even when writing there is an override switch to suppress the space       */
-  /* tracking.  This is done during applying updates during open time.  We don't want   */
-  /* to track what's going on then!                                                     */
+  /* We only track free space when a container is opened to reuse free space.  Other    */
+  /* containers are written without a free list just as they always were.  Even when     */
+  /* reusing there is an override switch to suppress the space tracking.  This is done   */
+  /* during applying updates during open time.  We don't want to track what's going on   */
+  /* then!                                                                              */
 
   if (!container->trackFreeSpace ||               /* if no tracking of free space or... */
-      (container->useFlags & kCMWriting) == 0)    /* ...not opened for writing/updating */
+      (container->useFlags & kCMReuseFreeSpace) == 0) /* ...not opened for space reuse  */
     return;                                       /* ...exit                            */
 
   /* Get the offset and size from the value if it's specified. This is the amount being */
@@ -146,125 +743,146 @@ void cmAddToFreeList(ContainerPtr container, TOCValuePtr theValueToFree,
     }
   }
 
+  if (omfsInt64LessEqual(size, zero)) return;     /* nothing to free                    */
+
   /* Always record the total amount of free space for the TOC ID 1 "total free space"   */
   /* property...                                                                        */
 
-  container->spaceDeletedValue->value.imm.ulongValue += size;
-
-  /* See if the space we're freeing can be combined with some already existing free     */
-  /* space.  If the new space is already freed (now how could that happen?) we ignore   */
-  /* the new space.  If the chunk of space we are about to free is less than the size   */
-  /* of a TOC entry, we ignore it (losing track of that space), since it would cost more*/
-  /* to remember it.  However, if that space can be combined with already existing      */
-  /* space, we do the combining.                                                        */
-
-  if (freeSpaceValueHdr != NULL) {                /* if free space list exists...       */
-    theValue = (TOCValuePtr)cmGetListHead(&freeSpaceValueHdr->valueList);
-
-    while (theValue) {                            /* scan the free space list...        */
-      valueStart    = theValue->value.imm.ulongValue;
-      valueEndPlus1 = valueStart + theValue->value.notImm.valueLen;
-      if (offset >= valueStart && offset <= valueEndPlus1) { /* have overlap or concat    */
-        if (offset + size > valueEndPlus1) {      /* combine new amount with this entry */
-          size = (offset + size) - valueEndPlus1; /* reduce actual size to add in       */
-          theValue->value.notImm.valueLen += size;/* this is what we combine in         */
-          freeSpaceValueHdr->size += size;        /* echo total size in header          */
-          container->spaceDeletedValue->value.imm.ulongValue += size; /* and container    */
-        }
-        return;                                   /* exit since we updated "old" entry  */
-      }
-      theValue = (TOCValuePtr)cmGetNextListCell(theValue);
-    }
-  } /* checking for combining */
+  if (container->spaceDeletedValue != NULL)
+    omfsAddInt64toInt64(size, &container->spaceDeletedValue->value.imm.value);
 
-  /* Since the cost of recording the free space in the container will be a TOC entry, we*/
-  /* only record free space chucks whose size is LARGER than a TOC entry.  Since we     */
-  /* couldn't combine it with already existing space, we simply exit and forget it.     */
+  /* See if the space we're freeing can be combined with some space already freed since */
+  /* the container was opened.  If it can't, and it's too small to be worth a TOC entry, */
+  /* we forget it.  Otherwise it gets a (pending) free list entry of its own.            */
 
-  #if TOC1_SUPPORT
-  if (container->majorVersion == 1) {
-    if (size <= TOCentrySize) return;
-  } else
-    if (size <= MinTOCSize) return;
-  #else
-  if (size <= MinTOCSize) return;
-  #endif
+  if (getFreeSpaceIndex(container) == NULL) return;
 
-  /* If this is the first freed space in the container, create the "free space" property*/
-  /* for the TOC object 1.  Otherwise, just use it. We remember the pointer to the value*/
-  /* header for this property in the container.  Note, the TOC we want to deal with here*/
-  /* is the container's own (private) TOC.  This will be different from the current TOC */
-  /* when we're updating containers.                                                    */
+  if (combineFreeSpace(container, Pending, offset, size)) return;
 
-  if (freeSpaceValueHdr == NULL) {                /* if 1st free space for container... */
-    toc = container->toc;                         /* ...remember current TOC            */
-    container->toc = container->privateTOC;       /* use container's own (private) TOC  */
+  if (tooSmallToKeep(container, size)) return;
 
-    theTOCobject = cmDefineObject(container,      /* ...create "free space" property    */
-                                  CM_StdObjID_TOC, CM_StdObjID_TOC_Free,
-                                  CM_StdObjID_TOC_Type, NULL,
-                                  container->generation, 0,
-                                  (ObjectObject | ProtectedObject),
-                                  &freeSpaceValueHdr);
+  newFreeListEntry(container, Pending, offset, size);
+#endif
+}
 
-    container->toc = toc;                         /* restore current container          */
-    if (theTOCobject == NULL) return;
-    freeSpaceValueHdr->valueFlags |= ValueProtected;/* don't allow writing to this value*/
-    container->freeSpaceValueHdr = freeSpaceValueHdr;
-  }
 
-  /* At this point we want to create a new free list entry for the newly freed offset   */
-  /* size.  The value list are standard value entries for the "free space" property of  */
-  /* TOC object ID 1.                                                                   */
+/*---------------------------------------------------------*
+ | getFreeSpace - get free space with the desired alignment |
+ *---------------------------------------------------------*
 
-  theValue = (TOCValuePtr)cmGetListTail(&freeSpaceValueHdr->valueList);
-  if (theValue) {
-    theValue->flags |= kCMContinued;                /* flag the current value as cont'd */
-    freeSpaceValueHdr->valueFlags |= ValueContinued;/* also set a more convenient flag  */
-  }
+ This is the allocator behind cmGetFreeListEntry() and friends.  It takes desiredSize
+ bytes starting at a multiple of alignment from the smallest free list entry that can
+ hold them.  The offset of the space is returned as the function result and its size in
+ actualSize.  If no entry is big enough and mustAllFit is false, as much as possible is
+ taken from the largest entry.  Otherwise 0 is returned for both.
 
-  (void)cmSetValueBytes(container, &valueBytes, Value_NotImm, offset, size);
-  cmAppendValue(freeSpaceValueHdr, &valueBytes, 0);
+ Only reusable entries, i.e., space that was already free when the container was opened,
+ are used.  Space freed since then may still be needed by the old TOC if we never get to
+ write the new one.
 
-  container->spaceDeletedValue->value.imm.ulongValue += size;
-#endif
-}
+ Whatever is left of the entry in front of (alignment padding) and after the space taken
+ remains on the free list as long as it's worth keeping.
+*/
 
+static CMCount CM_NEAR getFreeSpace(ContainerPtr container, CMSize desiredSize,
+                                    Boolean mustAllFit, unsigned int alignment,
+                                    CMSize *actualSize)
+{
+  omfInt64          zero;
+#if REUSE_ENABLED
+  FreeSpaceIndexPtr theIndex;
+  FreeExtentPtr     e;
+  CMCount           offset, start, end, nextOffset;
+  CMSize            needed, lead, trail;
+  omfInt32          pastBoundary;
+  unsigned int      pad = 0;
+#endif
 
-/*------------------------------------------------*
- | deleteFreeListEntry - delete a free list entry |
- *------------------------------------------------*
+  omfsCvtUInt32toInt64(0, &zero);
+  *actualSize = zero;
 
- This routine removes the specified free list entry and frees up its space.  If this is
- the last entry of the free list, the free list property itself (along with its value
- header, of course) are removed.
+  /* Return null amount if there is no free list or not updating...                     */
 
- Note, this routine is a low-level routine called from the other routines in this file.
- As such there are no error checks.  The caller is assumed "happy" with what its doing by
- the time it calls this routine.
-*/
+#if REUSE_ENABLED
+  if (container->freeSpaceValueHdr == NULL || (container->useFlags & kCMReuseFreeSpace) == 0 ||
+      omfsInt64LessEqual(desiredSize, zero))
+    return (zero);
 
-static void CM_NEAR deleteFreeListEntry(TOCValuePtr theValue)
-{
-  ContainerPtr   container = theValue->theValueHdr->container;
-  TOCObjectPtr   theTOCObject;
-  TOCPropertyPtr theFreeListProperty;
-  TOCValueHdrPtr freeSpaceValueHdr = container->freeSpaceValueHdr;
+  if ((theIndex = getFreeSpaceIndex(container)) == NULL)
+    return (zero);
+  if (alignment == 0) alignment = 1;
 
-  /* Delete the value entry from its list and free its space...                         */
+  /* Find the best fit, i.e., the smallest entry that can hold desiredSize bytes after  */
+  /* its alignment padding.  With no alignment that's the first entry at least that big.*/
+  /* Otherwise we may have to look at a few more.  But one that is alignment-1 bytes    */
+  /* bigger than desired always fits so we never look further than that.               */
 
-  CMfree(container, cmDeleteListCell(&freeSpaceValueHdr->valueList, theValue));
+  e = findBySize(theIndex, desiredSize, zero);
 
-  /* If there are no more free list entries, delete the value header and the "free      */
-  /* space" property from TOC ID 1...                                                   */
+  while (e) {
+    if (alignment != 1) {
+      omfsDivideInt64byInt32(ExtentOffset(e), alignment, NULL, &pastBoundary);
+      pad = (pastBoundary != 0) ? alignment - (unsigned int)pastBoundary : 0;
+    }
+    needed = desiredSize;
+    omfsAddInt32toInt64(pad, &needed);
+    if (omfsInt64GreaterEqual(ExtentSize(e), needed))
+      break;                                        /* it fits                          */
+    nextOffset = ExtentOffset(e);
+    omfsAddInt32toInt64(1, &nextOffset);
+    e = findBySize(theIndex, ExtentSize(e), nextOffset);
+  }
 
-  if (cmIsEmptyList(&freeSpaceValueHdr->valueList)) {       /* if no more free list...  */
-    theFreeListProperty = freeSpaceValueHdr->theProperty;   /* ...get owning property   */
-    theTOCObject        = theFreeListProperty->theObject;   /* ...get owning object (1) */
-    CMfree(container, freeSpaceValueHdr);                              /* ...clobber the value hdr */
-    CMfree(container, cmDeleteListCell(&theTOCObject->propertyList, theFreeListProperty));
-    container->freeSpaceValueHdr = NULL;                    /* ...no more free list     */
+  /* If nothing is big enough, either give up or use as much of the biggest as we can...*/
+
+  if (e == NULL) {
+    if (mustAllFit) return (zero);
+    for (e = theIndex->root[Reusable][BySize]; e && e->rLink[BySize]; e = e->rLink[BySize])
+      ;
+    if (e == NULL) return (zero);
+    pad = 0;
+    if (alignment != 1) {
+      omfsDivideInt64byInt32(ExtentOffset(e), alignment, NULL, &pastBoundary);
+      pad = (pastBoundary != 0) ? alignment - (unsigned int)pastBoundary : 0;
+    }
+    desiredSize = ExtentSize(e);
+    omfsSubInt32fromInt64(pad, &desiredSize);
+    if (omfsInt64LessEqual(desiredSize, zero)) return (zero);
   }
+
+  /* Carve the space out of the entry.  Keep the pieces in front and after if they are  */
+  /* worth keeping.  If both are, the piece after gets a new entry of its own.          */
+
+  start = ExtentOffset(e);
+  end   = start;
+  omfsAddInt64toInt64(ExtentSize(e), &end);
+  offset = start;
+  omfsAddInt32toInt64(pad, &offset);
+
+  omfsCvtUInt32toInt64(pad, &lead);
+  trail = end;
+  omfsSubInt64fromInt64(offset, &trail);
+  omfsSubInt64fromInt64(desiredSize, &trail);
+  nextOffset = offset;
+  omfsAddInt64toInt64(desiredSize, &nextOffset);
+
+  if (!tooSmallToKeep(container, lead)) {
+    setExtent(container, e, start, lead);
+    if (!tooSmallToKeep(container, trail))
+      newFreeListEntry(container, Reusable, nextOffset, trail);
+  } else if (!tooSmallToKeep(container, trail))
+    setExtent(container, e, nextOffset, trail);
+  else
+    deleteFreeListEntry(container, e);
+
+  if (container->spaceDeletedValue != NULL)       /* cut total                          */
+    omfsSubInt64fromInt64(desiredSize, &container->spaceDeletedValue->value.imm.value);
+
+  *actualSize = desiredSize;
+  return (offset);                                /* return new space to use            */
+#else
+  return (zero);
+#endif
 }
 
 
@@ -279,12 +897,13 @@ static void CM_NEAR deleteFreeListEntry(TOCValuePtr theValue)
  opened to reuse free space.
 
  The desiredSize is passed as what the caller would like as the single free list entry
- amount, i.e., a "best fit".  It is also used when we find a bigger free list entry and
- only have to reduce part of it.
+ amount.  The smallest free list entry that holds it is used (a "best fit") and only the
+ desired amount is taken from it.
 
  If mustAllFit is true, then we MUST find a single free list segment big enough or 0 will
  be returned.  This is used for data that is not allowed to be continued with multiple
- value segments (e.g., global names).
+ value segments (e.g., global names).  If it's false and no entry is big enough, the
+ largest entry is used.
 
  The free list is built by cmAddToFreeList() as value segments belonging to a value header
  of the "free space" property for TOC object ID 1.   If all the free list entries are
@@ -293,82 +912,70 @@ static void CM_NEAR deleteFreeListEntry(TOCValuePtr theValue)
  value header, and the free list value entry segments.
 */
 
-CMSize cmGetFreeListEntry(ContainerPtr container,
-                                 CMSize desiredSize, Boolean mustAllFit,
-                                 CMSize *actualSize)
+CMCount cmGetFreeListEntry(ContainerPtr container,
+                           CMSize desiredSize, Boolean mustAllFit,
+                           CMSize *actualSize)
 {
-  TOCValueHdrPtr freeSpaceValueHdr = container->freeSpaceValueHdr;
-  omfInt64		zero, one;
-
-  omfsCvtUInt32toInt64(0, &zero);
-  omfsCvtUInt32toInt64(1, &one);
-
-  /* Return null amount if there is no free list or not updating...                     */
+  return (getFreeSpace(container, desiredSize, mustAllFit, 1, actualSize));
+}
 
-#ifdef REUSE_ENABLED
-  if (freeSpaceValueHdr == NULL || (container->useFlags & kCMReuseFreeSpace) == 0)
-#endif
-	{
-	*actualSize = zero;
-    return (zero);
-    }
 
-#ifdef REUSE_ENABLED
-  /* Use the next available free list entry (segment) no matter what it is unless we    */
-  /* mustAllFit.  For mustAllFit we must scann the free list for a single entry large   */
-  /* enough to hold the entire data (desiredSize bytes).                                */
+/*------------------------------------------------------------------------*
+ | cmGetAlignedFreeListEntry - get aligned space for a value from free list |
+ *------------------------------------------------------------------------*
 
-  /* Note as just said, when mustAllFit is false, we just use the first free list       */
-  /* segment on the list.  A better algorithm might be to use the desired amount and    */
-  /* find a "best fit" by scanning the free list just as in the mustAllFit case.  So    */
-  /* which is better in time and/or space?  A scan each time or just reusing each entry */
-  /* unconditionally.  The latter guarantees reuse of all available space.  But the     */
-  /* former potentially uses less value segments.  For now I take the easy way.         */
+ This is cmGetFreeListEntry() with mustAllFit for the start of a value's data.  The
+ returned offset is a multiple of the container's value alignment (see
+ omfsFileSetValueAlignment()), just as it would be if the data were written at the end of
+ the container.
+*/
 
-  /* Note we still need it to split larger free space entries when we don't need all    */
-  /* the space from an entry.                                                           */
+CMCount cmGetAlignedFreeListEntry(ContainerPtr container, CMSize desiredSize,
+                                  CMSize *actualSize)
+{
+  return (getFreeSpace(container, desiredSize, true, container->valueAlignment, actualSize));
+}
 
-  theValue = (TOCValuePtr)cmGetListHead(&freeSpaceValueHdr->valueList);
 
-  if (mustAllFit) {                                         /* if must find single seg  */
-    while (theValue) {                                      /* ...scan free list        */
-      if (theValue->value.notImm.valueLen >= desiredSize)   /* ...for one big enough    */
-        break;
-      theValue = (TOCValuePtr)cmGetNextListCell(theValue);
-    }
-    if (theValue == NULL) return (*actualSize = 0);         /* if none found, too bad   */
-  }
+/*----------------------------------------------------------------*
+ | padToAlignment - pad the end of the container for a new value |
+ *----------------------------------------------------------------*
 
-  offset      = theValue->value.notImm.value;               /* set to return this offset*/
-  *actualSize = theValue->value.notImm.valueLen;            /* and this size (maybe!)   */
+ Writes zeros at the current end of the container (whose offset is passed in offset)
+ until it reaches a multiple of the container's value alignment.  offset is updated to
+ the aligned offset.  False is returned if the padding couldn't be written.
+*/
 
-  /* If the free list entry is big enough to cover all that is desired, use only the    */
-  /* required amount and retain the free list entry.  It must, however, be reduced by   */
-  /* the amount used.                                                                   */
+static Boolean CM_NEAR padToAlignment(ContainerPtr container, CMCount *offset)
+{
+  unsigned char zeroBuf[16];
+  unsigned char *zeroPtr;
+  CMSize32      i, fillBytes;
+  omfInt32      pastBoundary;
 
-  /* UNRESOLVED QUESTION! Since we never allow free list entries to be created when the */
-  /* space is less than a TOC entry size, should we keep the split space here when it   */
-  /* becomes less than a TOC entry size?  What does it cost?                            */
+  if (container->valueAlignment == 1) return (true);
 
-  if (desiredSize < *actualSize) {                          /* free entry is too big    */
-    theValue->value.notImm.value    += desiredSize;         /* ...cut it down           */
-    theValue->value.notImm.valueLen -= desiredSize;
-    container->spaceDeletedValue->value.imm.ulongValue -= desiredSize; /* cut total     */
-    *actualSize = desiredSize;                              /* return what was desired  */
-    return (offset);
-  }
+  omfsDivideInt64byInt32(*offset, container->valueAlignment, NULL, &pastBoundary);
+  if (pastBoundary == 0) return (true);
 
-  /* Now that we used an entire an free list entry, delete it from the free list and    */
-  /* free its memory.  If there are no more free list entries, delete the value header  */
-  /* and the "free space" property from TOC ID 1...                                     */
+  /* pastBoundary is the remainder of the division, so the number of bytes to reach the */
+  /* next boundary (fillBytes) is the difference between the alignment and pastBoundary */
 
-  deleteFreeListEntry(theValue);
+  fillBytes = container->valueAlignment - (CMSize32)pastBoundary;
+  if (fillBytes <= 16)
+    zeroPtr = zeroBuf;
+  else if ((zeroPtr = (unsigned char *)CMmalloc(container, fillBytes)) == NULL)
+    return (false);
 
-  container->spaceDeletedValue->value.imm.ulongValue -= *actualSize; /* cut total       */
+  for (i = 0; i < fillBytes; i++)
+    zeroPtr[i] = 0;
 
-  return (offset);                                          /* return new space to use  */
+  i = CMfwrite(container, (void *)zeroPtr, 1, fillBytes);
+  if (fillBytes > 16) CMfree(container, zeroPtr);
+  if (i != fillBytes) return (false);
 
-#endif
+  omfsAddInt32toInt64(fillBytes, offset);
+  return (true);
 }
 
 
@@ -383,12 +990,20 @@ CMSize cmGetFreeListEntry(ContainerPtr container,
 
  The reason this routine is used rather than using the CMfwrite() handler call directly is
  that this routine checks to see if the container has been opened to reuse free space.  If
- it hasn't, we degenerate into a simple CMfwrite() call.  If it has, then we use the free
- list, built by cmAddToFreeList(), to write out the data segments to reuse the free space.
-
- In all cases the data written is recorded as value segments in the value list belonging
- to the specified value header. The new segments are appended on to the END of the segment
- list.  It is up to the caller to guarantee this is where the segments are to go.  The
+ it hasn't, we degenerate into a simple CMfwrite() at the end of the container.  If it
+ has, then we use the free list, built by cmAddToFreeList(), to find the smallest free
+ space that holds all the data and write it there.  The data is not split up among
+ smaller free spaces since each piece would cost a value segment (and TOC entry) and make
+ the value slower to read.  If no free space is big enough, the data goes at the end of
+ the container.
+
+ If the value has no data yet, the data is the start of the value and is placed at a
+ multiple of the container's value alignment, padding the end of the container if
+ necessary.
+
+ In all cases the data written is recorded as a value segment in the value list belonging
+ to the specified value header. The new segment is appended on to the END of the segment
+ list.  It is up to the caller to guarantee this is where the segment is to go.  The
  continued flags are appropriately set.
 
  Note, as just mentioned, use this routine ONLY for appending data segments to a value.
@@ -399,88 +1014,54 @@ CMSize cmGetFreeListEntry(ContainerPtr container,
  Even with these restrictions, for the main case, i.e., CMWriteValueData(), this is not a
  problem.  CMWriteValueData() is the primary caller.  It knows what it's doing with the
  data (lets hope so).  So it knows when to call us here.
-
- The net effect is to reuse free space whenever we can if the container was opened for
- updating, and to do straight CMfwrite() otherwise.
 */
 
 CMSize32 cmWriteData(TOCValueHdrPtr theValueHdr, unsigned char *buffer, CMSize32 size)
 {
   ContainerPtr  container = theValueHdr->container->updatingContainer;
   TOCValuePtr   prevValue;
-#ifdef REUSE_ENABLED
-  unsigned int  chunkSize;
-#endif
-  unsigned int  amountWritten = 0;
-  CMCount	offset;
+  CMCount       offset, endOffset;
+  CMSize        longSize, actualSize;
   TOCValueBytes valueBytes;
-  omfInt64		zero, longSize;
+  omfInt64      zero;
 
   omfsCvtUInt32toInt64(0, &zero);
   omfsCvtUInt32toInt64(size, &longSize);
 
-  /* Write out all the data (size bytes of it).  To save a little code space we check   */
-  /* for updating in the loop.  If we are not updating we will attempt to do a standard */
-  /* CMfwrite() of all the data as a single value segment.  That is also what happens   */
-  /* when we run out of free space.  Then we try to write out all the remaining data    */
-  /* as a single segment.  The code is the same, so that's why the update check is in   */
-  /* the loop.  If we are updating, and we do have free list entries, we use them to    */
-  /* see where to write and how much.  This will reuse the free list space.             */
-
   prevValue = (TOCValuePtr)cmGetListTail(&theValueHdr->valueList); /* last value seg    */
 
-#ifdef REUSE_ENABLED
-  while (size > 0) {                                  /* loop till no more data         */
-    if ((container->useFlags & kCMReuseFreeSpace)==0) /* if not reusing free space...   */
-      chunkSize = 0;                                  /* ...this will cause std write   */
-    else                                              /* if updating,get some free space*/
-      offset = cmGetFreeListEntry(container, size, false, &chunkSize);
+  /* Try for free space first (getFreeSpace() says no if we're not reusing free space). */
+  /* If there is none big enough, write to the end of the container.                    */
 
-    if (chunkSize == 0) {                             /* if no free space to reuse...   */
-#endif
-      offset = CMgetContainerSize(container);
-      CMfseek(container, zero, kCMSeekEnd);              /* position to current eof        */
-      if (CMfwrite(container, buffer, sizeof(unsigned char), size) == size) { /* write  */
-        amountWritten += size;                        /* count total amount written     */
-        container->physicalEOF = offset;
-        omfsAddInt64toInt64(longSize, &container->physicalEOF);       /* update next free container byte*/
-        SetLogicalEOF(container->physicalEOF);        /* logical EOF == physical EOF    */
-        (void)cmSetValueBytes(container, &valueBytes, Value_NotImm, offset, longSize);
-        cmAppendValue(theValueHdr, &valueBytes, 0);   /* append new value segment       */
-        if (prevValue != NULL) {                      /* if this is not 1st segment...  */
-          prevValue->flags |= kCMContinued;           /* ...flag last seg as cont'd     */
-          theValueHdr->valueFlags |= ValueContinued;  /* ...also echo flag in the hdr   */
-        }
-      }
-      return (amountWritten);                         /* return amount we wrote         */
- #ifdef REUSE_ENABLED
-   } /* chunkSize == 0 */
-
-    /* If we get here then we are going to reuse a free space segment...                */
+  offset = getFreeSpace(container, longSize, true,
+                        (prevValue == NULL) ? container->valueAlignment : 1, &actualSize);
 
-    CMfseek(container, offset, kCMSeekSet);           /* overwrite the free space chunk */
-    if (CMfwrite(container, buffer, sizeof(unsigned char), chunkSize) != chunkSize)
-      return (amountWritten);
-
-    if (prevValue != NULL) {                          /* if this is not 1st segment...  */
-      prevValue->flags |= kCMContinued;               /* ...flag last seg as cont'd     */
-      theValueHdr->valueFlags |= ValueContinued;      /* ...also echo flag in the hdr   */
-    }
+  if (omfsInt64NotEqual(actualSize, zero))          /* reuse free space...              */
+    CMfseek(container, offset, kCMSeekSet);
+  else {                                            /* ...or append to the container    */
+    offset = CMgetContainerSize(container);
+    CMfseek(container, zero, kCMSeekEnd);           /* position to current eof          */
+    if (prevValue == NULL && !padToAlignment(container, &offset))
+      return (0);
+  }
 
-    (void)cmSetValueBytes(container, &valueBytes, Value_NotImm, offset, chunkSize);
-    prevValue = cmAppendValue(theValueHdr, &valueBytes, 0); /* append new value segment */
-    if (prevValue == NULL) return (amountWritten);
+  if (CMfwrite(container, buffer, sizeof(unsigned char), size) != size)
+    return (0);
 
-    offset += chunkSize;                              /* set logical EOF                */
-    SetLogicalEOF(offset);
+  endOffset = offset;
+  omfsAddInt64toInt64(longSize, &endOffset);
+  if (omfsInt64Equal(actualSize, zero))
+    container->physicalEOF = endOffset;             /* update next free container byte  */
+  SetLogicalEOF(endOffset);                         /* set logical EOF (may != physical)*/
 
-    buffer        += chunkSize;                       /* point to next chunk to write   */
-    amountWritten += chunkSize;                       /* count total amount written     */
-    size          -= chunkSize;                       /* reduce amount yet to be written*/
-  } /* while */                                       /* loop through all the data      */
+  (void)cmSetValueBytes(container, &valueBytes, Value_NotImm, offset, longSize);
+  cmAppendValue(theValueHdr, &valueBytes, 0);       /* append new value segment         */
+  if (prevValue != NULL) {                          /* if this is not 1st segment...    */
+    prevValue->flags |= kCMContinued;               /* ...flag last seg as cont'd       */
+    theValueHdr->valueFlags |= ValueContinued;      /* ...also echo flag in the hdr     */
+  }
 
-  return (amountWritten);                             /* return amount we wrote         */
-#endif
+  return (size);                                    /* return amount we wrote           */
 }
 
 
@@ -491,6 +1072,8 @@ CMSize32 cmWriteData(TOCValueHdrPtr theValueHdr, unsigned char *buffer, CMSize32
  This routine is called to remove all free list entries that have their space beyond the
  specified offset, beyondHere.  All entries with starting offsets greater than or equal
  to beyondHere are removed.  If one spans beyondHere it will be reduced appropriately.
+ The entries of each kind are taken from the top of the offset index so only those
+ affected are looked at.
 
  These entries are removed so so that we may overwrite from beyondHere with a new TOC.
  Since we are reusing that space for the TOC we obviously can't keep free list entries for
@@ -499,48 +1082,65 @@ CMSize32 cmWriteData(TOCValueHdrPtr theValueHdr, unsigned char *buffer, CMSize32
 
 void cmDeleteFreeSpace(ContainerPtr container, CMCount beyondHere)
 {
-#ifdef REUSE_ENABLED
-  TOCValuePtr   theValue, nextValue;
-  CMCount offset;
-  CMSize 	newLen;
+#if REUSE_ENABLED
+  FreeSpaceIndexPtr theIndex;
+  FreeExtentPtr     e;
+  CMCount           end;
+  CMSize            newLen;
+  int               kind;
 
   if (container->freeSpaceValueHdr == NULL) return;       /* exit if no free list       */
+  if ((theIndex = getFreeSpaceIndex(container)) == NULL) return;
 
-  theValue = (TOCValuePtr)cmGetListHead(&container->freeSpaceValueHdr->valueList);
+  for (kind = Reusable; kind <= Pending; ++kind) {        /* for each kind of entry...  */
+    while (container->freeSpaceValueHdr != NULL) {        /* highest entry first...     */
+      if ((e = theIndex->root[kind][ByOffset]) == NULL)   /* none of this kind left     */
+        break;
+      while (e->rLink[ByOffset])
+        e = e->rLink[ByOffset];
 
-  while (theValue) {                                      /* ...scan free list          */
-    nextValue = (TOCValuePtr)cmGetNextListCell(theValue); /* get next now for deletes   */
-    offset    = theValue->value.notImm.value;             /* offset of a free chunk     */
-
-    if (offset >= beyondHere)                             /* if chunk entirely beyond   */
-      deleteFreeListEntry(theValue);                      /* ...delete it               */
-    else if (offset + theValue->value.notImm.valueLen > beyondHere) { /* if partial...  */
-      newLen = beyondHere;
-      omfsSubInt64fromInt64(offset, &newLen);             /* ...cut size down           */
-      #if TOC1_SUPPORT
-      if (container->majorVersion == 1) {                 /* and if format 1 TOC...     */
-        if (newLen <= TOCentrySize)                       /* ...and too small to keep   */
-          deleteFreeListEntry(theValue);                  /* ...delete it too           */
-        else                                              /* ...if still acceptable     */
-          theValue->value.notImm.valueLen = newLen;       /* ...set its new smaller size*/
-      } else {                                            /* if >format 1 TOC           */
-        if (newLen <= MinTOCSize)                         /* ...and still too small     */
-          deleteFreeListEntry(theValue);                  /* ...delete it too           */
+      if (omfsInt64GreaterEqual(ExtentOffset(e), beyondHere)) { /* if chunk entirely beyond*/
+        deleteFreeListEntry(container, e);                /* ...delete it               */
+        continue;
+      }
+
+      end = ExtentOffset(e);
+      omfsAddInt64toInt64(ExtentSize(e), &end);
+      if (omfsInt64Greater(end, beyondHere)) {            /* if partial...              */
+        newLen = beyondHere;
+        omfsSubInt64fromInt64(ExtentOffset(e), &newLen);  /* ...cut size down           */
+        if (tooSmallToKeep(container, newLen))            /* ...and if too small to keep*/
+          deleteFreeListEntry(container, e);              /* ...delete it too           */
         else                                              /* ...if still acceptable     */
-          theValue->value.notImm.valueLen = newLen;       /* ...set its new smaller size*/
+          setExtent(container, e, ExtentOffset(e), newLen); /* ...set its new smaller size*/
       }
-      #else
-      if (newLen <= MinTOCSize)                           /* ...but if too small to keep*/
-        deleteFreeListEntry(theValue);                    /* ...delete it too           */
-      else                                                /* ...if still acceptable     */
-        theValue->value.notImm.valueLen = newLen;         /* ...set its new smaller size*/
-      #endif
-    }
 
-    theValue = nextValue;                                 /* loop till no more entries  */
-  } /* while */
-#else
-	return;
+      break;                                              /* the rest are all below     */
+    } /* while */
+  } /* for */
+#endif
+}
+
+
+/*------------------------------------------------------------*
+ | cmFreeFreeSpaceIndex - free the in-memory free list index |
+ *------------------------------------------------------------*
+
+ Frees the index of the container's free list, if it has one.  The free list itself is
+ not touched.  This is called when the TOC containing the free list is freed.
+*/
+
+void cmFreeFreeSpaceIndex(ContainerPtr container)
+{
+#if REUSE_ENABLED
+  FreeSpaceIndexPtr theIndex = (FreeSpaceIndexPtr)container->freeSpaceIndex;
+
+  if (theIndex == NULL) return;
+
+  freeExtents(container, theIndex->root[Reusable][ByOffset]);
+  freeExtents(container, theIndex->root[Pending][ByOffset]);
+  CMfree(container, theIndex);
+  container->freeSpaceIndex = NULL;
 #endif
 }
 
@@ -20,6 +20,8 @@
  properties to keep track of all the deleted space.
  
  If a container is opened for reusing free space, we use the free list to reuse the space.
+The list is indexed in memory by offset and by size so that freed space is combined with
+its neighbors and a best fit is found for each write without scanning the list.
 */
 
 
@@ -48,7 +50,8 @@ CM_EXPORT void cmAddToFreeList(ContainerPtr container, TOCValuePtr theValueToFre
   /*
   This routine is called whenever space for value data is to be freed.  The space is
   recorded in a free list. The free list entries are maintained as value segments belonging
-  to the "free space" property of TOC object ID 1.
+  to the "free space" property of TOC object ID 1.  Space is only recorded for containers
+  opened with kCMReuseFreeSpace.
   
   The amount of space to be freed is specified in one of two possible ways:
   
@@ -64,8 +67,11 @@ CM_EXPORT void cmAddToFreeList(ContainerPtr container, TOCValuePtr theValueToFre
         passed.  Note that a non-null theValueToFree has precedence over explicit offset
         and size.
         
-   As part of the freeing process, we scan the free list to see if the new space can be 
-   combined with an already existing entry.  It's a sort of on-the-fly garbage collector.
+   As part of the freeing process, the new space is combined with all existing pending free
+   list entries it overlaps or abuts.  These are found through the free list's offset index
+   rather than by scanning the list.  Space that can't be combined and is too small to be
+   worth a TOC entry is forgotten.  The freed space is not handed out again while the
+   container remains open.
    
    For new containers, there is no "free space" property initially for ID 1.  It is created
    here the first time we need to free space.  We remember the value header for the "free
@@ -84,12 +90,14 @@ CM_EXPORT CMCount cmGetFreeListEntry(ContainerPtr container,
   opened to reuse free space.
   
   The desiredSize is passed as what the caller would like as the single free list entry
-  amount, i.e., a "best fit".  It is also used when we find a bigger free list entry and
-  only have to reduce part of it.
+  amount.  The smallest free list entry that holds it is used (a "best fit") and only the
+  desired amount is taken from it.  Only space that was already free when the container
+  was opened is used.
   
   If mustAllFit is true, then we MUST find a single free list segment big enough or 0 will
   be returned.  This is used for data that is not allowed to be continued with multiple
-  value segments (e.g., global names).
+  value segments (e.g., global names).  If it's false and no entry is big enough, the
+  largest entry is used.
   
   The free list is built by cmAddToFreeList() as value segments belonging to a value header
   of the "free space" property for TOC object ID 1.   If all the free list entries are
@@ -97,6 +105,16 @@ CM_EXPORT CMCount cmGetFreeListEntry(ContainerPtr container,
   after this through cmAddToFreeList(), it will recreate the "free space" property, its
   value header, and the free list value entry segments.
   */
+
+
+CM_EXPORT CMCount cmGetAlignedFreeListEntry(ContainerPtr container, CMSize desiredSize,
+                                            CMSize *actualSize);
+  /*
+  This is cmGetFreeListEntry() with mustAllFit for the start of a value's data.  The
+  returned offset is a multiple of the container's value alignment (see
+  omfsFileSetValueAlignment()), just as it would be if the data were written at the end of
+  the container.
+  */
   
   
 CM_EXPORT CMSize32 cmWriteData(TOCValueHdrPtr theValueHdr, unsigned char *buffer, CMSize32 size);
@@ -108,12 +126,20 @@ CM_EXPORT CMSize32 cmWriteData(TOCValueHdrPtr theValueHdr, unsigned char *buffer
   
   The reason this routine is used rather than using the CMfwrite() handler call directly is
   that this routine checks to see if the container has been opened to reuse free space.  If
-  it hasn't, we degenerate into a simple CMfwrite() call.  If it has, then we use the free
-  list, built by cmAddToFreeList(), to write out the data segments to reuse the free space.
+  it hasn't, we degenerate into a simple CMfwrite() at the end of the container.  If it
+  has, then we use the free list, built by cmAddToFreeList(), to find the smallest free
+  space that holds all the data and write it there.  The data is not split up among
+  smaller free spaces since each piece would cost a value segment (and TOC entry) and make
+  the value slower to read.  If no free space is big enough, the data goes at the end of
+  the container.
+  
+  If the value has no data yet, the data is the start of the value and is placed at a
+  multiple of the container's value alignment, padding the end of the container if
+  necessary.
   
-  In all cases the data written is recorded as value segments in the value list belonging
-  to the specified value header. The new segments are appended on to the END of the segment
-  list.  It is up to the caller to guarantee this is where the segments are to go.  The
+  In all cases the data written is recorded as a value segment in the value list belonging
+  to the specified value header. The new segment is appended on to the END of the segment
+  list.  It is up to the caller to guarantee this is where the segment is to go.  The
   continued flags are appropriately set.
   
   Note, as just mentioned, use this routine ONLY for appending data segments to a value.
@@ -140,6 +166,13 @@ CM_EXPORT void cmDeleteFreeSpace(ContainerPtr container, CMCount beyondHere);
   Since we are reusing that space for the TOC we obviously can't keep free list entries for
   it.
   */
+
+
+CM_EXPORT void cmFreeFreeSpaceIndex(ContainerPtr container);
+  /*
+  Frees the index of the container's free list, if it has one.  The free list itself is
+  not touched.  This is called when the TOC containing the free list is freed.
+  */
   
 
                               CM_END_CFUNCTIONS
@@ -486,8 +486,8 @@ static void write1GlobalName(GlobalNamePtr globalNameSymbol, CMRefCon refCon)
   TOCValueHdrPtr      theValueHdr;
   TOCObjectPtr        theObject;
   ContainerPtr        container;
-  unsigned int        nameLength, actualSize;
-  CMSize			offset, zero;
+  unsigned int        nameLength;
+  CMSize			offset, zero, largeNameLength, actualSize;
 
   omfsCvtUInt32toInt64(0, &zero);
   if (theValue == NULL) return;                     /* exit if name was deleted         */
@@ -519,20 +519,21 @@ static void write1GlobalName(GlobalNamePtr globalNameSymbol, CMRefCon refCon)
   nameLength  = strlen((char *)globalNameSymbol->globalName) + 1;
 
   if (g->reuseFreeSpace) {                          /* if we are to reuse free space... */
-#ifdef REUSE_ENABLED
-    offset = cmGetFreeListEntry(container, nameLength, true, &actualSize); /* do it     */
+#if REUSE_ENABLED
+    omfsCvtUInt32toInt64(nameLength, &largeNameLength);
+    offset = cmGetFreeListEntry(container, largeNameLength, true, &actualSize); /* do it*/
 #else
-	actualSize = 0;
+	actualSize = zero;
 	offset = zero;
 #endif
-    if (actualSize != 0)                            /* if we got some to reuse...       */
+    if (omfsInt64NotEqual(actualSize, zero))        /* if we got some to reuse...       */
       CMfseek(container, offset, kCMSeekSet);       /* ...position to write over it     */
     else {                                          /* if couldn't find a fit...        */
       CMfseek(container, zero, kCMSeekEnd);            /* ...write data to end of container*/
       offset = container->physicalEOF;              /* used to update highest written   */
     }
   } else {
-    actualSize = 0;                                 /* use as switch to update eof info */
+    actualSize = zero;                              /* use as switch to update eof info */
     offset = container->physicalEOF;                /* used to update highest written   */
   }
 
@@ -546,7 +547,7 @@ static void write1GlobalName(GlobalNamePtr globalNameSymbol, CMRefCon refCon)
   theValue->value.globalName.offset = offset;       /* define offset for global name    */
 
   omfsAddInt32toInt64(nameLength, &offset);         /* update logical OR physical EOF   */
-  if (actualSize == 0)
+  if (omfsInt64Equal(actualSize, zero))
     container->physicalEOF = offset;                /* update EOF for next global name  */
   SetLogicalEOF(offset);                            /* set logical EOF (may != physical)*/
 }
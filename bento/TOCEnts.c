@@ -212,6 +212,334 @@ struct TOCActions {             /* cmWalkThroughEntireTOC() communication area l
 typedef struct TOCActions TOCActions, *TOCActionsPtr;
 
 
+#if CMPROPERTY_INDEX
+/* An object's property index is an open addressed hash table of pointers to the        */
+/* object's properties, keyed by property ID.  The table size is always a power of 2    */
+/* and kept at least twice the number of properties so that probe sequences stay short. */
+
+struct TOCPropertyIndex {               /* Layout of an object's property index:        */
+  unsigned int   tableMask;             /*    table size - 1 (size is a power of 2)      */
+  unsigned int   nbrOfEntries;          /*    number of properties in the table          */
+  TOCPropertyPtr table[1];              /*    the hash table (actually tableMask+1 long) */
+};
+typedef struct TOCPropertyIndex TOCPropertyIndex, *TOCPropertyIndexPtr;
+
+#define PropertyIndexHash(id, mask) ((unsigned int)(((id) * 2654435761UL) >> 8) & (mask))
+
+
+/*------------------------------------------------------------------------*
+ | lookupPropertyIndex - find the property with the specified ID in index |
+ *------------------------------------------------------------------------*
+
+ Returns the property with the specified ID from an object's property index, or NULL if
+ the object has no such property.
+*/
+
+static TOCPropertyPtr CM_NEAR lookupPropertyIndex(TOCPropertyIndexPtr theIndex,
+                                                  unsigned int  propertyID)
+{
+  unsigned int   i = PropertyIndexHash(propertyID, theIndex->tableMask);
+  TOCPropertyPtr theProperty;
+
+  while ((theProperty = theIndex->table[i]) != NULL) {  /* probe until empty slot       */
+    if (theProperty->propertyID == propertyID) break;
+    i = (i + 1) & theIndex->tableMask;
+  }
+
+  return (theProperty);
+}
+
+
+/*----------------------------------------------------*
+ | addToPropertyIndex - enter a property in the index |
+ *----------------------------------------------------*
+
+ Adds the specified property to an object's property index.  The caller must make sure
+ there is room for it.
+*/
+
+static void CM_NEAR addToPropertyIndex(TOCPropertyIndexPtr theIndex, TOCPropertyPtr theProperty)
+{
+  unsigned int i = PropertyIndexHash(theProperty->propertyID, theIndex->tableMask);
+
+  while (theIndex->table[i] != NULL)                    /* find first empty slot        */
+    i = (i + 1) & theIndex->tableMask;
+
+  theIndex->table[i] = theProperty;
+  ++theIndex->nbrOfEntries;
+}
+
+
+/*-------------------------------------------------------------*
+ | buildPropertyIndex - create the property index of an object |
+ *-------------------------------------------------------------*
+
+ Builds the property index for the specified object from its property list.  Any old index
+ is freed.  If there isn't enough memory for the index the object is simply left without
+ one; cmGetObjectProperty() will continue to scan the property list.
+*/
+
+static void CM_NEAR buildPropertyIndex(TOCObjectPtr theObject)
+{
+  ContainerPtr        container = theObject->container;
+  TOCPropertyIndexPtr theIndex;
+  TOCPropertyPtr      theProperty;
+  unsigned int        tableSize, i;
+
+  cmFreePropertyIndex(theObject);
+
+  tableSize = 16;
+  while (tableSize < 2 * theObject->propertyList.nbrOfCells)
+    tableSize <<= 1;
+
+  theIndex = (TOCPropertyIndexPtr)CMmalloc(container, sizeof(TOCPropertyIndex) +
+                                                      (tableSize-1) * sizeof(TOCPropertyPtr));
+  if (theIndex == NULL) return;
+
+  theIndex->tableMask    = tableSize - 1;
+  theIndex->nbrOfEntries = 0;
+  for (i = 0; i < tableSize; i++) theIndex->table[i] = NULL;
+
+  theProperty = (TOCPropertyPtr)cmGetListHead(&theObject->propertyList);
+  while (theProperty) {
+    addToPropertyIndex(theIndex, theProperty);
+    theProperty = (TOCPropertyPtr)cmGetNextListCell(theProperty);
+  }
+
+  theObject->propertyIndex = theIndex;
+}
+
+
+/*--------------------------------------------------------------------------*
+ | indexNewProperty - add a property just put on an object's property list |
+ *--------------------------------------------------------------------------*
+
+ Keeps an existing property index current when a property is appended to the object.  The
+ index is rebuilt at a larger size when it gets more than half full.
+*/
+
+static void CM_NEAR indexNewProperty(TOCObjectPtr theObject, TOCPropertyPtr theProperty)
+{
+  TOCPropertyIndexPtr theIndex = theObject->propertyIndex;
+
+  if (theIndex == NULL) return;                         /* nothing to maintain          */
+
+  if (2 * (theIndex->nbrOfEntries + 1) > theIndex->tableMask + 1)
+    buildPropertyIndex(theObject);                      /* list already has new prop    */
+  else
+    addToPropertyIndex(theIndex, theProperty);
+}
+#endif
+
+
+/*-----------------------------------------------------------*
+ | cmFreePropertyIndex - free the property index of an object |
+ *-----------------------------------------------------------*
+
+ This routine frees the property index of an object, if it has one.  It must be called
+ whenever a property is removed from the object's property list.  A new index will be
+ built the next time a property of the object is looked up.
+*/
+
+void cmFreePropertyIndex(TOCObjectPtr theObject)
+{
+  #if CMPROPERTY_INDEX
+  ContainerPtr container = theObject->container;
+
+  if (theObject->propertyIndex != NULL) {
+    CMfree(container, theObject->propertyIndex);
+    theObject->propertyIndex = NULL;
+  }
+  #endif
+}
+
+
+#if CMTOC_ARENA
+/* A TOC arena is a list of large blocks from which the TOC nodes (objects, properties, */
+/* value headers, and values) are carved while a format 1 TOC is read in.  The nodes are*/
+/* never freed individually.  All the blocks are freed at once along with the TOC.      */
+
+struct TOCArenaBlock {                  /* Layout of a TOC arena block:                 */
+  struct TOCArenaBlock *nextBlock;      /*    next (previously allocated) block         */
+  char                 *nextFree;       /*    next free byte in this block              */
+  char                 *limit;          /*    first byte past the end of this block     */
+};
+typedef struct TOCArenaBlock TOCArenaBlock, *TOCArenaBlockPtr;
+
+struct TOCArena {                       /* Layout of a container's TOC arena:           */
+  TOCArenaBlockPtr blocks;              /*    blocks, most recently allocated first     */
+  void             *toc;                /*    the TOC whose nodes are in the arena      */
+  CMSize32         nextBlockSize;       /*    size of the next block to be allocated    */
+  Boolean          loading;             /*    true ==> new nodes come from the arena    */
+};
+typedef struct TOCArena TOCArena, *TOCArenaPtr;
+
+#define TOCArenaAlign(size)   (((size) + 7) & ~7)  /* keep all nodes 8-byte aligned     */
+#define TOCArenaMinBlockSize  4096L
+
+
+/*-----------------------------------------------------------*
+ | freeTOCArena - free all the blocks of a container's arena |
+ *-----------------------------------------------------------*
+
+ Frees the container's arena and all the TOC nodes in it.  This is only done when the TOC
+ the arena was built for is freed.
+*/
+
+static void CM_NEAR freeTOCArena(ContainerPtr container)
+{
+  TOCArenaPtr      arena = (TOCArenaPtr)container->tocArena;
+  TOCArenaBlockPtr block, nextBlock;
+
+  block = arena->blocks;
+  while (block) {
+    nextBlock = block->nextBlock;
+    CMfree(container, block);
+    block = nextBlock;
+  }
+
+  CMfree(container, arena);
+  container->tocArena = NULL;
+}
+#endif
+
+
+/*------------------------------------------------------------*
+ | cmStartTOCArena - start carving TOC nodes out of the arena |
+ *------------------------------------------------------------*
+
+ This routine is called by the TOC reader before it loads a TOC of (about) nbrOfEntries
+ entries.  Until cmEndTOCArena() is called, cmAllocTOCNode() carves the nodes for the
+ container's TOC out of the container's arena.  The first arena block is sized for the
+ expected number of nodes.
+
+ The arena is only used when the TOC being loaded is the container's one and only TOC,
+ i.e., the container is not updating another container or being opened as the target of
+ one.  Otherwise TOCs and their nodes can be passed between containers.  The function
+ returns true if the arena is in use and false if it is not (in which case the nodes are
+ simply allocated individually).
+*/
+
+Boolean cmStartTOCArena(ContainerPtr container, unsigned int nbrOfEntries)
+{
+  #if CMTOC_ARENA
+  TOCArenaPtr arena = (TOCArenaPtr)container->tocArena;
+  CMSize32    blockSize;
+
+  if (UPDATING(container) || container->usingTargetTOC ||
+      container->updatingContainer != container || container->targetContainer != container)
+    return (false);
+
+  if (arena == NULL) {
+    if ((arena = (TOCArenaPtr)CMmalloc(container, sizeof(TOCArena))) == NULL) return (false);
+
+    blockSize = (CMSize32)nbrOfEntries * TOCArenaAlign(sizeof(TOCProperty)) +
+                (CMSize32)nbrOfEntries * TOCArenaAlign(sizeof(TOCValueHdr)) +
+                (CMSize32)nbrOfEntries * TOCArenaAlign(sizeof(TOCValue));
+    if (blockSize < TOCArenaMinBlockSize) blockSize = TOCArenaMinBlockSize;
+    if (blockSize > TOCArenaMaxBlockSize) blockSize = TOCArenaMaxBlockSize;
+
+    arena->blocks        = NULL;
+    arena->toc           = container->toc;
+    arena->nextBlockSize = blockSize;
+    container->tocArena  = (void *)arena;
+  }
+
+  arena->loading = (Boolean)(arena->toc == container->toc);
+
+  return (arena->loading);
+  #else
+  return (false);
+  #endif
+}
+
+
+/*---------------------------------------------------------*
+ | cmEndTOCArena - stop carving TOC nodes out of the arena |
+ *---------------------------------------------------------*
+
+ This is called when the TOC reader is done (successfully or not) with the TOC load started
+ by cmStartTOCArena().  From here on cmAllocTOCNode() allocates nodes individually.  The
+ arena itself remains until the TOC is freed.
+*/
+
+void cmEndTOCArena(ContainerPtr container)
+{
+  #if CMTOC_ARENA
+  if (container->tocArena != NULL)
+    ((TOCArenaPtr)container->tocArena)->loading = false;
+  #endif
+}
+
+
+/*------------------------------------------------*
+ | cmAllocTOCNode - allocate a TOC node structure |
+ *------------------------------------------------*
+
+ All TOCObject's, TOCProperty's, TOCValueHdr's, and TOCValue's are allocated through this
+ routine.  While a TOC is being loaded (see cmStartTOCArena()) the node is carved out of
+ the container's arena.  Otherwise it is simply CMmalloc()'ed.  NULL is returned if there
+ is no memory.
+*/
+
+void *cmAllocTOCNode(ContainerPtr container, CMSize32 size)
+{
+  #if CMTOC_ARENA
+  TOCArenaPtr      arena = (TOCArenaPtr)container->tocArena;
+  TOCArenaBlockPtr block;
+  CMSize32         blockSize;
+  char             *node;
+
+  if (arena != NULL && arena->loading) {
+    size  = TOCArenaAlign(size);
+    block = arena->blocks;
+
+    if (block == NULL || (CMSize32)(block->limit - block->nextFree) < size) {
+      blockSize = arena->nextBlockSize;                  /* need another block...       */
+      if ((block = (TOCArenaBlockPtr)CMmalloc(container, blockSize)) == NULL)
+        return (CMmalloc(container, size));              /* ...can still try it alone   */
+      block->nextBlock = arena->blocks;
+      block->nextFree  = (char *)block + TOCArenaAlign(sizeof(TOCArenaBlock));
+      block->limit     = (char *)block + blockSize;
+      arena->blocks    = block;
+      if (2 * blockSize <= TOCArenaMaxBlockSize)         /* grow for the next one       */
+        arena->nextBlockSize = 2 * blockSize;
+    }
+
+    node = block->nextFree;
+    block->nextFree += size;
+    return ((void *)node);
+  }
+  #endif
+
+  return (CMmalloc(container, size));
+}
+
+
+/*-------------------------------------------*
+ | cmFreeTOCNode - free a TOC node structure |
+ *-------------------------------------------*
+
+ This is the counterpart to cmAllocTOCNode().  Nodes that were carved out of the
+ container's arena are left alone (they go when the TOC is freed).  All others are
+ CMfree()'ed.
+*/
+
+void cmFreeTOCNode(ContainerPtr container, void *node)
+{
+  #if CMTOC_ARENA
+  TOCArenaBlockPtr block;
+
+  if (container->tocArena != NULL)
+    for (block = ((TOCArenaPtr)container->tocArena)->blocks; block; block = block->nextBlock)
+      if ((char *)node > (char *)block && (char *)node < block->limit)
+        return;                                           /* in the arena               */
+  #endif
+
+  CMfree(container, node);
+}
+
+
 /*--------------------------------------------------------------*
  | cmMarkValueDeleted - remove a value for an object's property |
  *--------------------------------------------------------------*
@@ -250,7 +578,7 @@ void cmMarkValueDeleted(ContainerPtr container, TOCValueHdrPtr theValueHdr,
     if (theValue->flags & kCMGlobalName)                  /* mark global name as deleted*/
       if (theValue->value.globalName.globalNameSymbol)
         MarkGlobalNameDeleted(theValue->value.globalName.globalNameSymbol);
-    CMfree(container, theValue);
+    cmFreeTOCNode(container, theValue);
     theValue = nextValue;
   } /* value */
 
@@ -274,7 +602,7 @@ void cmMarkValueDeleted(ContainerPtr container, TOCValueHdrPtr theValueHdr,
   #endif
 
   if (deleteHdr || !cmKeepDeletedRefNums(container->toc))     /* free the refNum?       */
-    CMfree(container, theValueHdr);                                      /* this caller is serious!*/
+    cmFreeTOCNode(container, theValueHdr);                               /* this caller is serious!*/
   else {                                                      /* this is normal case... */
     cmInitList(&theValueHdr->valueList);                      /* no more values         */
     theValueHdr->valueFlags |= ValueDeleted;                  /* mark hdr as deleted    */
@@ -283,8 +611,10 @@ void cmMarkValueDeleted(ContainerPtr container, TOCValueHdrPtr theValueHdr,
 
   /* If the value is the only one for a property, the property itself is deleted...     */
 
-  if (cmIsEmptyList(&theProperty->valueHdrList))
-    CMfree(container, cmDeleteListCell(&theProperty->theObject->propertyList, theProperty));
+  if (cmIsEmptyList(&theProperty->valueHdrList)) {
+    cmFreePropertyIndex(theProperty->theObject);
+    cmFreeTOCNode(container, cmDeleteListCell(&theProperty->theObject->propertyList, theProperty));
+  }
 }
 
 
@@ -331,7 +661,7 @@ void cmDeleteProperty(ContainerPtr container, TOCPropertyPtr theProperty)
       if (theValue->flags & kCMGlobalName)                /* mark global name as deleted*/
         if (theValue->value.globalName.globalNameSymbol)
           MarkGlobalNameDeleted(theValue->value.globalName.globalNameSymbol);
-      CMfree(container, theValue);
+      cmFreeTOCNode(container, theValue);
       theValue = nextValue;
     } /* value */
 
@@ -357,14 +687,15 @@ void cmDeleteProperty(ContainerPtr container, TOCPropertyPtr theProperty)
       cmImplicitDeleteValueTouch(theValueHdr, theObject);     /* check touched updates  */
 #endif
     } else                                                    /* don't keep refNums     */
-      CMfree(container, theValueHdr);
+      cmFreeTOCNode(container, theValueHdr);
 
     theValueHdr = nextValueHdr;                           /* around and around we go... */
   } /* valueHdr */
 
   /* Free the property itself since it now has no values...                             */
 
-  CMfree(container, cmDeleteListCell(&theObject->propertyList, theProperty));
+  cmFreePropertyIndex(theObject);
+  cmFreeTOCNode(container, cmDeleteListCell(&theObject->propertyList, theProperty));
 }
 
 
@@ -418,7 +749,7 @@ static void deleteProperties(TOCObjectPtr theObject, CMRefCon refCon)
         if (theValue->flags & kCMGlobalName)              /* mark global name as deleted*/
           if (theValue->value.globalName.globalNameSymbol)
             MarkGlobalNameDeleted(theValue->value.globalName.globalNameSymbol);
-        CMfree(container, theValue);
+        cmFreeTOCNode(container, theValue);
         theValue = nextValue;
       } /* value */
 
@@ -446,16 +777,17 @@ static void deleteProperties(TOCObjectPtr theObject, CMRefCon refCon)
         cmImplicitDeleteValueTouch(theValueHdr, theObject);     /* check touched updates*/
 #endif
       } else                                                    /* don't keep refNums   */
-        CMfree(container, theValueHdr);
+        cmFreeTOCNode(container, theValueHdr);
 
       theValueHdr = nextValueHdr;                         /* around and around we go... */
     } /* valueHdr */
 
-    CMfree(container, theProperty);                                  /* property not needed        */
+    cmFreeTOCNode(container, theProperty);                           /* property not needed        */
     theProperty = nextProperty;
   } /* property */
 
   cmInitList(&theObject->propertyList);                   /* no properties for object   */
+  cmFreePropertyIndex(theObject);                         /* ...so no index either      */
 }
 
 
@@ -527,6 +859,8 @@ void cmFreeProperties(TOCObjectPtr theObject, CMRefCon refCon)
   cmDeleteTouchedList(theObject);
 
 #endif
+  cmFreePropertyIndex(theObject);                         /* free property index (if any)*/
+
   /* Free all the properties for this object...                                         */
 
   theProperty = (TOCPropertyPtr)cmGetListHead(&theObject->propertyList);
@@ -565,7 +899,7 @@ void cmFreeProperties(TOCObjectPtr theObject, CMRefCon refCon)
             MarkGlobalNameDeleted(theValue->value.globalName.globalNameSymbol);
         #endif
 
-        CMfree(container, theValue);
+        cmFreeTOCNode(container, theValue);
         theValue = nextValue;
       } /* value */
 
@@ -574,11 +908,11 @@ void cmFreeProperties(TOCObjectPtr theObject, CMRefCon refCon)
         cmDeleteRefDataShadowList(theValueHdr);
       #endif
 
-      CMfree(container, theValueHdr);
+      cmFreeTOCNode(container, theValueHdr);
       theValueHdr = nextValueHdr;
     } /* valueHdr */
 
-    CMfree(container, theProperty);
+    cmFreeTOCNode(container, theProperty);
     theProperty = nextProperty;
   } /* property */
 
@@ -595,10 +929,10 @@ void cmFreeProperties(TOCObjectPtr theObject, CMRefCon refCon)
       theValue = (TOCValuePtr)cmGetListHead(&theValueHdr->valueList);
       while (theValue) {
         nextValue = (TOCValuePtr)cmGetNextListCell(theValue);
-        CMfree(container, theValue);
+        cmFreeTOCNode(container, theValue);
         theValue = nextValue;
       } /* value */
-      CMfree(container, theValueHdr);
+      cmFreeTOCNode(container, theValueHdr);
       theValueHdr = nextValueHdr;
     } /* valueHdr */
   } /* theDynProperty */
@@ -616,12 +950,22 @@ void cmFreeProperties(TOCObjectPtr theObject, CMRefCon refCon)
 
  All memory for objects, properties, and types is freed.  On return the toc pointer in the
  container is NULL as well as all the master link head/tail pointers.
+
+ If the TOC's nodes were loaded into the container's arena (see cmStartTOCArena()), the
+ arena is freed along with the TOC.
 */
 
 void cmFreeTOC(ContainerPtr container, void **toc)
 {
   TOCValueHdrPtr theValueHdr, nextValueHdr;
   TOCValuePtr    theValue, nextValue;
+  void           *theTOC = *toc;
+
+  /* The container's free list lives in its own (private) TOC.  So if that is the TOC   */
+  /* going away, so does the free list's index...                                       */
+
+  if (theTOC == container->privateTOC)
+    cmFreeFreeSpaceIndex(container);
 
   /* Free the main data structures...                                                   */
 
@@ -637,14 +981,23 @@ void cmFreeTOC(ContainerPtr container, void **toc)
     theValue = (TOCValuePtr)cmGetListHead(&theValueHdr->valueList);
     while (theValue) {
       nextValue = (TOCValuePtr)cmGetNextListCell(theValue);
-      CMfree(container, theValue);
+      cmFreeTOCNode(container, theValue);
       theValue = nextValue;
     } /* value */
-    CMfree(container, theValueHdr);
+    cmFreeTOCNode(container, theValueHdr);
     theValueHdr = nextValueHdr;
   } /* valueHdr */
 
   cmInitList(&container->deletedValues);
+
+  /* If the TOC is now really gone and its nodes were loaded into the container's arena,*/
+  /* free the whole arena at once...                                                    */
+
+  #if CMTOC_ARENA
+  if (*toc == NULL && container->tocArena != NULL)
+    if (((TOCArenaPtr)container->tocArena)->toc == theTOC)
+      freeTOCArena(container);
+  #endif
 }
 
 
@@ -844,7 +1197,7 @@ TOCValuePtr cmCreateValueSegment(TOCValueHdrPtr theValueHdr, TOCValueBytesPtr va
   ContainerPtr container = theValueHdr->container;
   TOCValuePtr  theValue;
 
-  if ((theValue = (TOCValuePtr)CMmalloc(container, sizeof(TOCValue))) == NULL) { /* create seg...  */
+  if ((theValue = (TOCValuePtr)cmAllocTOCNode(container, sizeof(TOCValue))) == NULL) { /* create seg...  */
     ERROR1(container,CM_err_NoValueEntry, CONTAINERNAME);
     return (NULL);
   }
@@ -944,7 +1297,7 @@ TOCValuePtr cmAppendValue(TOCValueHdrPtr theValueHdr, TOCValueBytesPtr value,
     if (propertyID == CM_StdObjID_GlobalTypeName ||
         propertyID == CM_StdObjID_GlobalPropName)
       if (!cmBuildGlobalNameTable(theValue)) {        /* ...build (up) global name table*/
-        CMfree(container, theValue);
+        cmFreeTOCNode(container, theValue);
         return (NULL);
       }
   }
@@ -1020,7 +1373,7 @@ static TOCValueHdrPtr CM_NEAR defineValue(ContainerPtr container,
         return (NULL);
       }
 
-    if ((theValueHdr = (TOCValueHdrPtr)CMmalloc(container, sizeof(TOCValueHdr))) == NULL) {
+    if ((theValueHdr = (TOCValueHdrPtr)cmAllocTOCNode(container, sizeof(TOCValueHdr))) == NULL) {
       ERROR1(container,CM_err_NoValueEntry, CONTAINERNAME);
       return (NULL);
     }
@@ -1140,7 +1493,7 @@ static TOCPropertyPtr CM_NEAR defineProperty(ContainerPtr container,
   /* If we got a new property create it and init its fields...                          */
 
   if (*newProperty) {                             /* new property...                    */
-    if ((theProperty = (TOCPropertyPtr)CMmalloc(container, sizeof(TOCProperty))) == NULL) {
+    if ((theProperty = (TOCPropertyPtr)cmAllocTOCNode(container, sizeof(TOCProperty))) == NULL) {
       ERROR1(container,CM_err_NoPropEntry, CONTAINERNAME);
       return (NULL);
     }
@@ -1155,7 +1508,7 @@ static TOCPropertyPtr CM_NEAR defineProperty(ContainerPtr container,
   *theValueHdr = defineValue(container, theProperty, typeID, value, generation, flags, &newValueHdr);
 
   if (*theValueHdr == NULL) {
-    if (*newProperty) CMfree(container, theProperty);
+    if (*newProperty) cmFreeTOCNode(container, theProperty);
     return (NULL);
   }
 
@@ -1341,8 +1694,12 @@ TOCObjectPtr cmIntDefineObject(ContainerPtr container, unsigned int  objectID,
 
 	  /* If we indeed did create a new property add it to the object's property chain...    */
 
-	  if (newProperty)
+	  if (newProperty) {
 	  	cmAppendListCell(&theObject->propertyList, theProperty);
+	  	#if CMPROPERTY_INDEX
+	  	indexNewProperty(theObject, theProperty);
+	  	#endif
+	  }
 #ifdef VIRTUAL_BENTO_OBJECTS
 	  theObject->objectFlags &= ~ObjectIsNotLoaded;
 	}
@@ -1388,6 +1745,15 @@ TOCPropertyPtr cmGetObjectProperty(TOCObjectPtr theObject, unsigned int  propert
 			return(NULL);
 	}
 #endif
+  #if CMPROPERTY_INDEX
+  if (theObject->propertyIndex == NULL &&                 /* build index if big enough  */
+      theObject->propertyList.nbrOfCells >= PropertyIndexThreshold)
+    buildPropertyIndex(theObject);
+
+  if (theObject->propertyIndex != NULL)                   /* use index if we have one   */
+    return (lookupPropertyIndex(theObject->propertyIndex, propertyID));
+  #endif
+
   theProperty = (TOCPropertyPtr)cmGetListHead(&theObject->propertyList);
 
   while (theProperty) {                                 /* scan each property on list   */
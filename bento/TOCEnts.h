@@ -422,6 +422,9 @@ CM_EXPORT void cmFreeTOC(ContainerPtr container, void **toc);
 
   All memory for objects, properties, and types is freed.  On return the toc pointer in the
   container is NULL as well as all the master link head/tail pointers.
+
+  If the TOC's nodes were loaded into the container's arena (see cmStartTOCArena()), the
+  arena is freed along with the TOC.
   */
 
 
@@ -433,6 +436,54 @@ CM_EXPORT TOCPropertyPtr cmGetObjectProperty(TOCObjectPtr theObject, unsigned in
   */
 
 
+CM_EXPORT void cmFreePropertyIndex(TOCObjectPtr theObject);
+  /*
+  This routine frees the property index of an object, if it has one.  It must be called
+  whenever a property is removed from the object's property list.  A new index will be
+  built the next time a property of the object is looked up.
+  */
+
+
+CM_EXPORT Boolean cmStartTOCArena(ContainerPtr container, unsigned int nbrOfEntries);
+  /*
+  This routine is called by the TOC reader before it loads a TOC of (about) nbrOfEntries
+  entries.  Until cmEndTOCArena() is called, cmAllocTOCNode() carves the nodes for the
+  container's TOC out of the container's arena.  The first arena block is sized for the
+  expected number of nodes.
+
+  The arena is only used when the TOC being loaded is the container's one and only TOC,
+  i.e., the container is not updating another container or being opened as the target of
+  one.  Otherwise TOCs and their nodes can be passed between containers.  The function
+  returns true if the arena is in use and false if it is not (in which case the nodes are
+  simply allocated individually).
+  */
+
+
+CM_EXPORT void cmEndTOCArena(ContainerPtr container);
+  /*
+  This is called when the TOC reader is done (successfully or not) with the TOC load started
+  by cmStartTOCArena().  From here on cmAllocTOCNode() allocates nodes individually.  The
+  arena itself remains until the TOC is freed.
+  */
+
+
+CM_EXPORT void *cmAllocTOCNode(ContainerPtr container, CMSize32 size);
+  /*
+  All TOCObject's, TOCProperty's, TOCValueHdr's, and TOCValue's are allocated through this
+  routine.  While a TOC is being loaded (see cmStartTOCArena()) the node is carved out of
+  the container's arena.  Otherwise it is simply CMmalloc()'ed.  NULL is returned if there
+  is no memory.
+  */
+
+
+CM_EXPORT void cmFreeTOCNode(ContainerPtr container, void *node);
+  /*
+  This is the counterpart to cmAllocTOCNode().  Nodes that were carved out of the
+  container's arena are left alone (they go when the TOC is freed).  All others are
+  CMfree()'ed.
+  */
+
+
 CM_EXPORT TOCValueHdrPtr cmGetPropertyType(TOCPropertyPtr theProperty, unsigned int  typeID);
   /*
   This routine takes a pointer to a object's property and scans its value headers for one
@@ -1194,6 +1194,10 @@ static Boolean CM_NEAR buildGlobalNameTable(TOCValuePtr theValue)
        follows are TOC entries for objects to be merged with a target container's TOC.
        That will be read on a second call to read it AFTER the target is opened.  The
        updates are then automatically merged with the target's TOC which is inherited.
+
+ When the container is not an updater or a target (so the TOC is read in a single pass and
+ is the container's only TOC), the entire TOC is read in with one I/O and parsed from
+ memory, and the TOC nodes are carved out of the container's arena (see cmStartTOCArena()).
 */
 
 static Boolean CM_NEAR readTOCfmt1(ContainerPtr container, CMCount tocOffset, CMSize tocSize)
@@ -1210,12 +1214,18 @@ static Boolean CM_NEAR readTOCfmt1(ContainerPtr container, CMCount tocOffset, CM
 #endif
   char           countStr[12];
   omfInt64				entrySize64, zero;
+  Boolean        loaded = true;
+  #if CMTOC_ARENA
+  Boolean        bulkLoad;
+  omfUInt32      tocSize32 = 0;
+  #endif
 
   #if (TOCInputBufSize > 0)                   /* differnt stuff needed if buffering...  */
   void           *ioBuffer = NULL;
   jmp_buf        readTOCEnv;
   #else                                       /* ...as opposed to not buffering!        */
   unsigned char  tocBuffer[TOCentrySize];
+  unsigned char  *tocData = NULL, *nextEntry = NULL;
   #endif
 
   #if (TOCInputBufSize > 0)                   /* if buffering...                        */
@@ -1227,6 +1237,7 @@ static Boolean CM_NEAR readTOCfmt1(ContainerPtr container, CMCount tocOffset, CM
 
   if (setjmp(readTOCEnv)) {                   /* set setjmp/longjmp environment vector  */
     cmReleaseIOBuffer(ioBuffer);              /* ...if longjmp taken back to here...    */
+    cmEndTOCArena(container);
     ERROR1(container,CM_err_BadTOCRead, CONTAINERNAME); /* ...free buffer and report failure      */
     return (false);                           /* ...false ==> failure                   */
   }
@@ -1238,11 +1249,38 @@ static Boolean CM_NEAR readTOCfmt1(ContainerPtr container, CMCount tocOffset, CM
 
   CMfseek(container, tocOffset, kCMSeekSet);
 
+  /* If this TOC is all there is to read for the container, its nodes are allocated in  */
+  /* bulk from the container's arena, and if we're not buffering, the whole TOC is read */
+  /* in one shot.  If there isn't memory for the TOC we fall back to reading it entry by*/
+  /* entry.                                                                             */
+
+  #if CMTOC_ARENA
+  bulkLoad = false;
+  if (omfsTruncInt64toUInt32(tocSize, &tocSize32) == OM_ERR_NONE)
+    bulkLoad = cmStartTOCArena(container, tocSize32 / TOCentrySize);
+
+  #if (TOCInputBufSize == 0)
+  if (bulkLoad && tocSize32 > 0)
+    if ((tocData = (unsigned char *)CMmalloc(container, tocSize32)) != NULL) {
+      if (CMfread(container, tocData, sizeof(unsigned char), tocSize32) != tocSize32) {
+        CMfree(container, tocData);
+        cmEndTOCArena(container);
+        ERROR1(container,CM_err_BadTOCRead, CONTAINERNAME);
+        return (false);
+      }
+      nextEntry = tocData;
+    }
+  #endif
+  #endif
+
   /* Allocate the input buffer and prepare for buffered reading of the TOC...           */
 
   #if (TOCInputBufSize > 0)                   /* if buffering...                        */
   ioBuffer = cmUseIOBuffer(container, TOCInputBufSize, (jmp_buf *)&readTOCEnv);
-  if (ioBuffer == NULL) return (false);
+  if (ioBuffer == NULL) {
+    cmEndTOCArena(container);
+    return (false);
+  }
   cmNewBufferedInputData(ioBuffer, NULL, tocSize);
   #endif
 
@@ -1301,9 +1339,13 @@ static Boolean CM_NEAR readTOCfmt1(ContainerPtr container, CMCount tocOffset, CM
                                  isSmall);
     tocEntry.generation = (unsigned int )shortGen;
 #else                                 /* if not buffering, extract directly...      */
-    if (CMfread(container, tocBuffer, sizeof(unsigned char), TOCentrySize) != TOCentrySize) {
+    if (nextEntry != NULL) {            /* ...from the TOC already in memory          */
+      memcpy(tocBuffer, nextEntry, TOCentrySize);
+      nextEntry += TOCentrySize;
+    } else if (CMfread(container, tocBuffer, sizeof(unsigned char), TOCentrySize) != TOCentrySize) {
       ERROR1(container,CM_err_BadTOCRead, CONTAINERNAME);
-      return (false);
+      loaded = false;
+      break;
     }
     ExtractTOC(tocBuffer, tocEntry.objectID,
                           tocEntry.propertyID,
@@ -1385,7 +1427,10 @@ static Boolean CM_NEAR readTOCfmt1(ContainerPtr container, CMCount tocOffset, CM
 																	&theValueHdr);
 	  }
 #endif
-	  if (theObject == NULL) return (false);
+	  if (theObject == NULL) {
+	    loaded = false;
+	    break;
+	  }
 
     /* If this object was previously counted as undefined, reduce the count...          */
 
@@ -1439,7 +1484,10 @@ static Boolean CM_NEAR readTOCfmt1(ContainerPtr container, CMCount tocOffset, CM
     if (tocEntry.propertyID >= MinUserObjectID) {
       theObject = cmDefineObject(container, tocEntry.propertyID, 0, 0, NULL, 0, 0,
                                  UndefinedObject | PropertyObject, NULL);
-      if (theObject == NULL) return (false);
+      if (theObject == NULL) {
+        loaded = false;
+        break;
+      }
 
       /* If this object actually is undefined, count it as such (but only once)...      */
 
@@ -1455,7 +1503,10 @@ static Boolean CM_NEAR readTOCfmt1(ContainerPtr container, CMCount tocOffset, CM
     if (tocEntry.typeID >= MinUserObjectID) {
       theObject = cmDefineObject(container, tocEntry.typeID, 0, 0, NULL, 0, 0,
                                  UndefinedObject | TypeObject, NULL);
-      if (theObject == NULL) return (false);
+      if (theObject == NULL) {
+        loaded = false;
+        break;
+      }
 
       /* If this object actually is undefined, count it as such (but only once)...      */
 
@@ -1474,8 +1525,14 @@ static Boolean CM_NEAR readTOCfmt1(ContainerPtr container, CMCount tocOffset, CM
 
   #if (TOCInputBufSize > 0)
   cmReleaseIOBuffer(ioBuffer);                  /* done with input buffer               */
+  #else
+  if (tocData != NULL) CMfree(container, tocData); /* done with in-memory TOC           */
   #endif
 
+  cmEndTOCArena(container);                     /* any new nodes are malloc'ed now      */
+
+  if (!loaded) return (false);
+
   /* We're done reading.  Report an error if there are any undefined objects...         */
 
   if (nbrOfUndefObjects > 0) {
@@ -1872,6 +1929,9 @@ Boolean cmBuildGlobalNameTable(TOCValuePtr theValue)
  size are defined in the container label (by definition).  For non-updating containers,
  this will reflect the entire (only) TOC.  The non-private (updating) portion is defined
  by a TOC #1 property.
+
+ For non-updating containers the TOC nodes are carved out of the container's arena (see
+ cmStartTOCArena()) rather than being allocated one at a time.
 */
 
 Boolean cmReadTOC(ContainerPtr container, CMCount tocOffset, CMSize tocSize)
@@ -1885,6 +1945,7 @@ Boolean cmReadTOC(ContainerPtr container, CMCount tocOffset, CMSize tocSize)
   jmp_buf        readEnv;
   CMCount				entryStart;
   unsigned int  entrySize;
+  omfUInt32      tocSize32;
 
   USE_TOC_FORMAT_1_ALTERNATIVE(readTOCfmt1,(container, tocOffset, tocSize));
 
@@ -1893,8 +1954,10 @@ Boolean cmReadTOC(ContainerPtr container, CMCount tocOffset, CMSize tocSize)
   /* control block with its buffer freed if the jump is taken.  Thus all we have to do  */
   /* here is return the bad news to the caller.                                         */
 
-  if (setjmp(readEnv))                    /* set setjmp/longjmp environment vector      */
-    return (false);                       /* ...just quit if there's a TOC input error  */
+  if (setjmp(readEnv)) {                  /* set setjmp/longjmp environment vector      */
+    cmEndTOCArena(container);             /* ...just quit if there's a TOC input error  */
+    return (false);
+  }
 
   /* Position to the start of the TOC...                                                */
 
@@ -1911,6 +1974,12 @@ Boolean cmReadTOC(ContainerPtr container, CMCount tocOffset, CMSize tocSize)
   if (container->tocIOCtl == NULL)
     return (false);                       /* something went wrong (too bad)!            */
 
+  /* If this is the container's only TOC, carve its nodes out of the container's arena. */
+  /* The entries vary in size, so the number of them is only a rough guess.             */
+
+  if (omfsTruncInt64toUInt32(tocSize, &tocSize32) == OM_ERR_NONE)
+    (void)cmStartTOCArena(container, tocSize32 / 16);
+
   /* As object ID's are encountered during the reading we maintain a counter,           */
   /* nbrOfUndefObjects, representing the number of undefined objects.  Objects can be   */
   /* forward or backward referenced and we can have multiple references.  Thus we have  */
@@ -1976,7 +2045,10 @@ Boolean cmReadTOC(ContainerPtr container, CMCount tocOffset, CMSize tocSize)
 																	&theValueHdr);
 	  }
 #endif
-    if (theObject == NULL) return (false);
+    if (theObject == NULL) {
+      cmEndTOCArena(container);
+      return (false);
+    }
 
     /* If this object was previously counted as undefined, reduce the count...          */
 
@@ -2021,6 +2093,7 @@ Boolean cmReadTOC(ContainerPtr container, CMCount tocOffset, CMSize tocSize)
   /* error if there are any undefined objects...                                        */
   (void)cmEndTOCIO(container->tocIOCtl);
   container->tocIOCtl = NULL;
+  cmEndTOCArena(container);               /* any new nodes are malloc'ed now            */
 
   if (nbrOfUndefObjects > 0) {
     ERROR2(container,CM_err_UndefObjects, cmltostr(nbrOfUndefObjects, 1, false, countStr), CONTAINERNAME);
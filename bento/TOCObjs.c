@@ -451,7 +451,7 @@ TOCObjectPtr cmCreateObject(const void *toc, const CMObjectID objectID,
 
   if ((p = (TOCObjectPtr)t1[*index]) != NULL)             /* if we have a dup...        */
     *dup = true;                                          /* ...tell caller             */
-  else if ((p = (TOCObjectPtr)CMmalloc(container, sizeof(TOCObject))) != NULL){/* create new object*/
+  else if ((p = (TOCObjectPtr)cmAllocTOCNode(container, sizeof(TOCObject))) != NULL){/* create new object*/
     *dup                = false;                          /* ...tell caller it's new    */
     t1[*index]          = (Indices)p;                     /* ...set ptr in table        */
     cmInitList(&p->propertyList);                         /* ...set empty property list */
@@ -464,6 +464,7 @@ TOCObjectPtr cmCreateObject(const void *toc, const CMObjectID objectID,
     p->objectFlags      = objectFlags;                    /* ...info flags              */
     p->objectRefCon     = (CMRefCon)NULL;                 /* ...refCon                  */
     p->useCount         = 0;                              /* ...use count               */
+    p->propertyIndex    = NULL;                           /* ...no property index yet   */
   }
 
   return (p);                                             /* ptr to new or dup object   */
@@ -516,7 +517,8 @@ void cmUncreateObject(const void *toc, const CMObjectID id, CMRefCon refCon,
   object = (TOCObjectPtr)t[*index];                 /* point at found object            */
   if (freeAction) (*freeAction)(object, refCon);    /* let caller putz with it          */
 
-  CMfree(container, object);                                   /* free the object                  */
+  cmFreePropertyIndex(object);                      /* free property index (if any)     */
+  cmFreeTOCNode(container, object);                            /* free the object                  */
   t[*index] = NULL;                                 /* remove it from lowest index tbl  */
 }
 
@@ -576,7 +578,8 @@ void cmDelete1Object(const void *toc, const CMObjectID id, CMRefCon refCon,
     object->objectFlags |= DeletedObject;           /* flag object as now deleted       */
   } else {                                          /* if freeing deleted refNums...    */
     container = ((TOCPtr)toc)->container;           /* ...needed for CMfree(container, )           */
-    CMfree(container, object);                                 /* ...free the object space         */
+    cmFreePropertyIndex(object);                    /* ...free property index (if any)  */
+    cmFreeTOCNode(container, object);                          /* ...free the object space         */
   }
 
   t[*index] = NULL;                                 /* remove it from lowest index tbl  */
@@ -748,7 +751,8 @@ static void CM_NEAR freeAllObjects(register const TOCPtr toc, const Indices *t,
       if ((object = (TOCObjectPtr)(t[i])) != NULL) {/* ...if non-NULL entry...          */
         if (deleteAction)                           /* ...and if caller wants a crack...*/
           (*deleteAction)(object, refCon);          /* ...let caller do his thing       */
-        CMfree(container, object);                             /* ...free the object itself        */
+        cmFreePropertyIndex(object);                /* ...free property index (if any)  */
+        cmFreeTOCNode(container, object);                      /* ...free the object itself        */
       }
 
   CMfree(container, t);                                        /* free the index table too         */
@@ -803,7 +807,8 @@ void cmDestroyTOC(void **toc, CMRefCon refCon,
 #if USE_UPDATE_MODE
     cmDeleteTouchedList(theObject);                 /* free touched list (if any)       */
 #endif
-    CMfree(container, theObject);                   /* that's end of this object        */
+    cmFreePropertyIndex(theObject);                 /* free property index (if any)     */
+    cmFreeTOCNode(container, theObject);            /* that's end of this object        */
     theObject = nextObject;
   }
 
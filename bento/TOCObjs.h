@@ -83,6 +83,7 @@
 
 struct Container;
 struct TOCObject;
+struct TOCPropertyIndex;
 
                                   CM_CFUNCTIONS
 
@@ -104,6 +105,7 @@ struct TOCObject {                    /* Layout of a TOC object:
   ListHdr          touchedList;       /*    values/properties touched IN this object    */
   CMCount		   fileOffset;			/* JeffB: Added to support virtual objects */
   CMSize			allEntrySize;		/* JeffB: Added to support virtual objects */
+  struct TOCPropertyIndex *propertyIndex;/*   hash index of properties (or NULL)       */
 };
 typedef struct TOCObject TOCObject, *TOCObjectPtr;
 
@@ -0,0 +1,337 @@
+/* (use tabs = 2 to view this file correctly) */
+/*---------------------------------------------------------------------------*
+ |                                                                           |
+ |                          <<<   FreeTest.c    >>>                          |
+ |                                                                           |
+ |                 Container Manager Free Space Reuse Tests                  |
+ |                                                                           |
+ *---------------------------------------------------------------------------*
+
+ This file is only used to test and debug the free space list (FreeSpce.c).  Unlike the
+ other tests it looks inside the container, since what is being tested is where the data
+ goes and what is left on the free list, not just that the data reads back correctly.
+
+ The container is written, then opened twice with kCMReuseFreeSpace.  The first reuse
+ session frees some abutting value data and checks that it is combined but not handed out
+ again while the container is open.  The second checks that the space is then reused with
+ the requested alignment, and that cmDeleteFreeSpace() cuts the list back.
+*/
+
+/*#include <types.h>*/
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include "CMAPI.h"
+#include "XHandlrs.h"
+#include "XSession.h"
+#include "omCvt.h"
+#include "CMTypes.h"									/* the tests look inside the container...					*/
+#include "ListMgr.h"
+#include "TOCEnts.h"
+#include "TOCObjs.h"
+#include "TOCIO.h"
+#include "GlbNames.h"
+#include "Containr.h"
+#include "FreeSpce.h"
+
+																	CM_CFUNCTIONS
+
+#define ValueSize 100													/* size of each of the test values				*/
+
+CMSession			 	session;
+static int 			failures = 0, successes = 0;
+static char 		whatWeGot[256], whatItShouldBe[256], targetFilename[256] = {0};
+static Boolean 	quiet = true;
+static unsigned long offsetA, offsetB, firstTOCOffset, firstEOF;
+
+
+/*------------------------------*
+ | display - isolate all output |
+ *------------------------------*/
+
+static void CM_NEAR CM_C display(FILE *stream, const char *format, ...)
+{
+	va_list ap;
+
+	va_start(ap, format);
+	vfprintf(stream, format, ap);
+	va_end(ap);
+}
+
+
+/*---------*
+ | checkIt |
+ *---------*/
+
+static void CM_NEAR checkIt(char *whatWeGot, char *whatItShouldBe)
+{
+	if (strcmp(whatWeGot, whatItShouldBe) != 0) {
+		display(stderr, "### test failed! Expected \"%s\"\n"
+										"                 Got      \"%s\"\n", whatItShouldBe, whatWeGot);
+		++failures;
+	} else {
+		++successes;
+		if (!quiet) display(stderr, "%s\n", whatWeGot);
+	}
+}
+
+
+/*----------------------------------------*
+ | lo - low 32 bits of a container offset |
+ *----------------------------------------*
+
+ The test containers are small, so all their offsets and sizes fit in 32 bits.
+*/
+
+static unsigned long CM_NEAR lo(CMCount x)
+{
+	omfUInt32 result;
+
+	(void)omfsTruncInt64toUInt32(x, &result);
+	return ((unsigned long)result);
+}
+
+
+/*-----------------------------------------------------------*
+ | freeEntry - get the size of the free list entry at offset |
+ *-----------------------------------------------------------*
+
+ Returns the size of the free list entry starting at the specified offset, or 0 if there is
+ none.  If highest is not NULL, the end offset of the highest free list entry is returned
+ in it.
+*/
+
+static unsigned long CM_NEAR freeEntry(CMContainer container, unsigned long offset,
+																			 unsigned long *highest)
+{
+	TOCValueHdrPtr freeSpaceValueHdr = ((ContainerPtr)container)->freeSpaceValueHdr;
+	TOCValuePtr		 theValue;
+	unsigned long	 size = 0, end;
+
+	if (highest) *highest = 0;
+	if (freeSpaceValueHdr == NULL) return (0);
+
+	for (theValue = (TOCValuePtr)cmGetListHead(&freeSpaceValueHdr->valueList); theValue;
+			 theValue = (TOCValuePtr)cmGetNextListCell(theValue)) {
+		if (lo(theValue->value.notImm.value) == offset)
+			size = lo(theValue->value.notImm.valueLen);
+		end = lo(theValue->value.notImm.value) + lo(theValue->value.notImm.valueLen);
+		if (highest && end > *highest) *highest = end;
+	}
+
+	return (size);
+}
+
+
+/*--------------------------------------------------*
+ | openContainer - open the test container to reuse |
+ *--------------------------------------------------*/
+
+static CMContainer CM_NEAR openContainer(char *filename, CMContainerUseMode useFlags)
+{
+	CMContainer container;
+	CMRefCon	  myRefCon;
+
+	myRefCon = createRefConForMyHandlers(session, filename, NULL, NULL);
+
+	CMSetMetaHandler(session, "Free Space", containerMetahandler);
+	container = CMOpenContainer(session, myRefCon, "Free Space", useFlags);
+
+	if (container == NULL) {
+		display(stderr, "### Free space tests terminated: container == NULL\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return (container);
+}
+
+
+/*-----------------*
+ | createContainer |
+ *-----------------*
+
+ Writes three values of ValueSize bytes each, one after the other.  The first two are
+ freed by the later tests.  Freeing space here must not create a free list since the
+ container isn't opened to reuse free space.
+*/
+
+static void CM_NEAR createContainer(char *filename)
+{
+	CMContainer container;
+	CMRefCon	  myRefCon;
+	CMProperty	p1;
+	CMObject		o1;
+	CMValue			v;
+	char				*typeName[3] = {"type A", "type B", "type C"}, buffer[ValueSize];
+	omfInt64		offset, size;
+	short				i, errVal;
+
+	myRefCon = createRefConForMyHandlers(session, filename, NULL, NULL);
+
+	CMSetMetaHandler(session, "Free Space", containerMetahandler);
+	container = CMOpenNewContainer(session, myRefCon, "Free Space", 0, 2, 0);
+
+	if (container == NULL) {
+		display(stderr, "### writing free space container terminated: container == NULL\n");
+		exit(EXIT_FAILURE);
+	}
+
+	p1 = CMRegisterProperty(container, "free space tests");
+	o1 = CMNewObject(container);
+
+	for (i = 0; i < 3; ++i) {
+		memset(buffer, 'A' + i, ValueSize);
+		v = CMNewValue(o1, p1, CMRegisterType(container, typeName[i]));
+		CMWriteValueData(v, (CMPtr)buffer, 0, ValueSize);
+		if (i == 0) offsetA = lo(CMGetValueDataOffset(v, 0, &errVal));
+		if (i == 1) offsetB = lo(CMGetValueDataOffset(v, 0, &errVal));
+	}
+
+	sprintf(whatWeGot, "    values abut = %d", offsetB == offsetA + ValueSize);
+	checkIt(whatWeGot, "    values abut = 1");
+
+	omfsCvtUInt32toInt64(offsetA, &offset);
+	omfsCvtUInt32toInt64(ValueSize, &size);
+	cmAddToFreeList((ContainerPtr)container, NULL, offset, size);
+
+	sprintf(whatWeGot, "    new container free list = %d",
+					((ContainerPtr)container)->freeSpaceValueHdr != NULL);
+	checkIt(whatWeGot, "    new container free list = 0");
+
+	CMCloseContainer(container);
+}
+
+
+/*----------------*
+ | freeSomeValues |
+ *----------------*
+
+ The first reuse session.  The old TOC and the first two values are freed.  They must all
+ be recorded, the two values as a single entry, but none of it may be reused yet.
+*/
+
+static void CM_NEAR freeSomeValues(char *filename)
+{
+	CMContainer container;
+	CMProperty	p1;
+	CMObject		o1;
+	CMValue			v;
+	omfInt64		desired, actual;
+
+	container = openContainer(filename, kCMReuseFreeSpace);
+
+	firstTOCOffset = lo(((ContainerPtr)container)->tocOffset);
+	firstEOF			 = lo(((ContainerPtr)container)->physicalEOF);
+
+	sprintf(whatWeGot, "    old TOC freed = %d", freeEntry(container, firstTOCOffset, NULL) != 0);
+	checkIt(whatWeGot, "    old TOC freed = 1");
+
+	p1 = CMRegisterProperty(container, "free space tests");
+	if ((o1 = CMGetNextObjectWithProperty(container, NULL, p1)) == NULL) {
+		display(stderr, "### cannot find \"free space tests\" property in container\n");
+		exit(EXIT_FAILURE);
+	}
+	++successes;
+
+	v = CMUseValue(o1, p1, CMRegisterType(container, "type B"));
+	CMDeleteValueData(v, 0, ValueSize);
+	v = CMUseValue(o1, p1, CMRegisterType(container, "type A"));
+	CMDeleteValueData(v, 0, ValueSize);
+
+	sprintf(whatWeGot, "    freed A+B = %lu", freeEntry(container, offsetA, NULL));
+	sprintf(whatItShouldBe, "    freed A+B = %d", 2 * ValueSize);
+	checkIt(whatWeGot, whatItShouldBe);
+
+	omfsCvtUInt32toInt64(ValueSize, &desired);
+	(void)cmGetFreeListEntry((ContainerPtr)container, desired, true, &actual);
+	sprintf(whatWeGot, "    reused this session = %lu", lo(actual));
+	checkIt(whatWeGot, "    reused this session = 0");
+
+	CMCloseContainer(container);
+}
+
+
+/*-----------------*
+ | reuseFreedSpace |
+ *-----------------*
+
+ The second reuse session.  What was freed in the first session is now reused.  The start
+ of the space handed out is aligned and the rest of the entry stays on the free list.
+ Then all the free space beyond the end of that rest is deleted, cutting the rest short.
+*/
+
+static void CM_NEAR reuseFreedSpace(char *filename)
+{
+	CMContainer		container;
+	omfInt64			desired, actual, offset;
+	unsigned long	at, rest, end, highest;
+
+	container = openContainer(filename, kCMReuseFreeSpace);
+
+	sprintf(whatWeGot, "    new TOC past old EOF = %d",
+					lo(((ContainerPtr)container)->tocOffset) >= firstEOF);
+	checkIt(whatWeGot, "    new TOC past old EOF = 1");
+
+	((ContainerPtr)container)->valueAlignment = 16;
+	omfsCvtUInt32toInt64(40, &desired);
+	offset = cmGetAlignedFreeListEntry((ContainerPtr)container, desired, &actual);
+	at = lo(offset);
+
+	sprintf(whatWeGot, "    reused = %lu, aligned = %d, in A+B = %d", lo(actual), (at % 16) == 0,
+					at >= offsetA && at + 40 <= offsetA + 2 * ValueSize);
+	checkIt(whatWeGot, "    reused = 40, aligned = 1, in A+B = 1");
+
+	rest = freeEntry(container, at + 40, NULL);
+	sprintf(whatWeGot, "    rest of A+B = %lu", rest);
+	sprintf(whatItShouldBe, "    rest of A+B = %lu", offsetA + 2 * ValueSize - (at + 40));
+	checkIt(whatWeGot, whatItShouldBe);
+
+	end = offsetA + 2 * ValueSize - 20;
+	omfsCvtUInt32toInt64(end, &offset);
+	cmDeleteFreeSpace((ContainerPtr)container, offset);
+
+	rest = freeEntry(container, at + 40, &highest);
+	sprintf(whatWeGot, "    after delete: rest = %lu, highest = %d", rest, highest <= end);
+	sprintf(whatItShouldBe, "    after delete: rest = %lu, highest = 1", end - (at + 40));
+	checkIt(whatWeGot, whatItShouldBe);
+
+	sprintf(whatWeGot, "    old TOC entry = %lu", freeEntry(container, firstTOCOffset, NULL));
+	checkIt(whatWeGot, "    old TOC entry = 0");
+
+	CMCloseContainer(container);
+}
+
+
+/*------*
+ | main |
+ *------*/
+
+void CM_C main(int argc, char *argv[])
+{
+	if (argc > 1 && strcmp(argv[argc-1], "-p") == 0) {
+		quiet = false;
+		--argc;
+	}
+	strcpy(targetFilename, (argc > 1) ? argv[1] : "FreeCont");
+
+	session = CMStartSession(sessionRoutinesMetahandler, NULL);
+
+	createContainer(targetFilename);
+	freeSomeValues(targetFilename);
+	reuseFreedSpace(targetFilename);
+
+	CMEndSession(session, false);
+
+	if (failures)
+		display(stderr, "\n### successful tests passed: %d\n"
+											"    failed tests:            %d\n\n", successes, failures);
+	else
+		display(stderr, "\n### All tests passed!  Ship it!\n\n");
+
+	exit(failures ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+														  CM_END_CFUNCTIONS
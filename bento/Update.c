@@ -2434,7 +2434,7 @@ static CM_UCHAR CM_NEAR applyValueUpdateInstructions(ContainerPtr container,
 
         while (theValue != NULL) {                      /* delete excess segments...    */
           theNextValue = (TOCValuePtr)cmGetNextListCell(theValue);
-          CMfree(container, cmDeleteListCell(&theValueHdr->valueList, theValue));
+          cmFreeTOCNode(container, cmDeleteListCell(&theValueHdr->valueList, theValue));
           theValue = theNextValue;
         }
 
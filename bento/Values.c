@@ -314,7 +314,7 @@ Boolean cmConvertImmediate(TOCValuePtr theValue)
   /* Reuse free space if we're allowed and there is some.  Otherwise just write to the  */
   /* end of the container.                                                              */
 
-  offset0 = cmGetFreeListEntry(container, largeValueSize, true, &largeActualSize);
+  offset0 = cmGetAlignedFreeListEntry(container, largeValueSize, &largeActualSize);
   omfsTruncInt64toUInt32(largeActualSize, &actualSize); 	/* !!! Handle error */
   if (actualSize != 0)
     CMfseek(container, offset0, kCMSeekSet);        /* reuse free space                 */
@@ -567,7 +567,7 @@ void cmDeleteSegmentData(TOCValueHdrPtr theValueHdr, CMCount startOffset,
         }
         cmAddToFreeList(container, theValue, zero, zero); /* add freed space to free list     */
         cmDeleteListCell(&theValueHdr->valueList, theValue);
-        CMfree(container, theValue);                           /* poof!                            */
+        cmFreeTOCNode(container, theValue);                    /* poof!                            */
       }
       amountDeleted = segMaxOffset;
       omfsAddInt32toInt64(1, &amountDeleted);       /* this is how much we're deleting  */
@@ -722,13 +722,15 @@ TOCValueHdrPtr cmMoveValueHdr(TOCValueHdrPtr theFromValueHdr, CMObject object, C
   cmInsertBeforeListCell(&theToValueHdr->theProperty->valueHdrList, theFromValueHdr, theToValueHdr);
   theFromValueHdr->theProperty = theToValueHdr->theProperty;
   cmDeleteListCell(&theToValueHdr->theProperty->valueHdrList, theToValueHdr);
-  CMfree(container, theToValueHdr);                                    /* done with the dummy      */
+  cmFreeTOCNode(container, theToValueHdr);                             /* done with the dummy      */
 
   /* That was easy!  Now we look at the property for "from" value header and delete it  */
   /* if there are no more values.                                                       */
 
-  if (cmIsEmptyList(&theFromProperty->valueHdrList))
-    CMfree(container, cmDeleteListCell(&theFromObject->propertyList, theFromProperty));
+  if (cmIsEmptyList(&theFromProperty->valueHdrList)) {
+    cmFreePropertyIndex(theFromObject);
+    cmFreeTOCNode(container, cmDeleteListCell(&theFromObject->propertyList, theFromProperty));
+  }
 
   return (theFromValueHdr);                                 /* returned move refNum     */
 }
@@ -148,5 +148,21 @@ CM_EXPORT struct TOCValueHdr *cmMoveValueHdr(struct TOCValueHdr *theFromValueHdr
   */
   
 
+CM_EXPORT CMValue CM_FIXEDARGS cmReadPropertyValue(CMObject object, CMProperty property,
+                                                   CMType type, CMPtr buffer, CMCount offset,
+                                                   CMSize32 maxSize, CMSize *valueSize,
+                                                   CMSize32 *amountRead);
+  /*
+  This is an internal shortcut for the CMCountValues(), CMUseValue(), CMGetValueSize(), and
+  CMReadValueData() sequence used to read a property value.  The value is looked up once,
+  its size is returned in valueSize, and, if the offset is not past the end of the value, up
+  to maxSize bytes starting at the offset are read into the buffer.  The number of bytes
+  read is returned in amountRead.  maxSize may be 0 to just get the value's size.
+  
+  The value refNum is returned as the function result, or NULL if the object has no value
+  of the given type for the property.
+  */
+  
+
                               CM_END_CFUNCTIONS
 #endif
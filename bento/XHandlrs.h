@@ -42,21 +42,27 @@
  | Routines REQUIRED by the API |
  *------------------------------*/
   
-CMHandlerAddr CM_FIXEDARGS containerMetahandler(CMType targetType, CMconst_CMGlobalName operationType);
+OMF_EXPORT CMHandlerAddr CM_FIXEDARGS containerMetahandler(CMType targetType, CMconst_CMGlobalName operationType);
   /*
   Metahandler proc for determining the addresses of the handler operation routines.
   Pass the address of this routine to a CMSetMetaHandler() call.
   */
 
+OMF_EXPORT CMHandlerAddr CM_FIXEDARGS mappedContainerMetahandler(CMType targetType, CMconst_CMGlobalName operationType);
+  /*
+  Same as containerMetahandler(), except that containers opened for reading are mapped
+  into memory where the system allows it.  Install through omfsSetSessionIOHandlers().
+  */
+
 
 /*------------------------------------------------------------------*
  | Auxiliary routines to make the example available for general use |
  *------------------------------------------------------------------*/
 
-CMRefCon CM_FIXEDARGS createRefConForMyHandlers(CMSession sessionData,
-                                                const char CM_PTR *pathname,
-                                                GetUpdatingTargetType getTargetType,
-                                                omfHdl_t	file);
+OMF_EXPORT CMRefCon CM_FIXEDARGS createRefConForMyHandlers(CMSession sessionData,
+                                                           const char CM_PTR *pathname,
+                                                           GetUpdatingTargetType getTargetType,
+                                                           omfHdl_t	file);
   /*
   Create a reference constant (a "refCon") for container handler use.  Passed as the
   "attributes" to CMOpen[New]Container() and used as the "refCon" for all handler calls.
@@ -256,6 +256,7 @@ struct omfCodecParms
 			omfmMultiXfer_t 	*xfer;			/* IN */
 			omfInt16           	numXfers;		/* IN */
 			omfDeinterleave_t	inter;
+			omfInt32			numWorkers;		/* IN -- Decode threads (1 = caller only) */
 		} mediaXfer;
 		struct
 		{
@@ -27,6 +27,7 @@
 #ifndef _OMF_CVT_API_
 #define _OMF_CVT_API_ 1
 
+#include <stddef.h>
 #include "omErr.h"
 #include "omTypes.h"
 
@@ -45,8 +46,29 @@ extern "C"
 #define omfsIsInt64Positive(a) ((a) >= 0)
 #define omfsCvtInt32toLength(in, out)		((out) = (in))
 #define omfsCvtInt32toPosition(in, out)		((out) = (in))
-#define omfsCvtInt32toInt64(in, out)		(*out = (in), OM_ERR_NONE)
-#define omfsCvtUInt32toInt64(in, out)		(*out = (in), OM_ERR_NONE)
+
+/* Inline functions rather than comma expressions, so that callers which
+ * ignore the (always OM_ERR_NONE) result don't draw "value computed is
+ * not used" warnings.
+ */
+static PORT_INLINE omfErr_t omfsInlineCvtInt32toInt64(
+			omfInt32	in,
+			omfInt64	*out)
+{
+	*out = in;
+	return(OM_ERR_NONE);
+}
+
+static PORT_INLINE omfErr_t omfsInlineCvtUInt32toInt64(
+			omfUInt32	in,
+			omfInt64	*out)
+{
+	*out = in;
+	return(OM_ERR_NONE);
+}
+
+#define omfsCvtInt32toInt64(in, out)		omfsInlineCvtInt32toInt64(in, out)
+#define omfsCvtUInt32toInt64(in, out)		omfsInlineCvtUInt32toInt64(in, out)
 #else
 #define omfsIsInt64Positive(a) (((omfInt16)(a).words[0]) >= 0)
 #define omfsCvtInt32toLength(in, out)		\
@@ -142,6 +164,106 @@ OMF_EXPORT omfBool omfsInt64NotEqual(
 			omfInt64 a,		/* IN - Is a != b */
 			omfInt64 b);
 #endif
+
+#if PORT_USE_NATIVE64
+/* With a native 64-bit type the arithmetic reduces to single operators,
+ * so expand it inline instead of calling through omCvt.c.  The inline
+ * versions make the same checks and return the same codes as the
+ * exported ones, which omCvt.c still defines for clients that link
+ * against them.
+ */
+static PORT_INLINE omfErr_t omfsInlineAddInt32toInt64(
+			omfUInt32	in,
+			omfInt64	*out)
+{
+	if(out == NULL)
+		return(OM_ERR_NULL_PARAM);
+	*out += in;
+	return(OM_ERR_NONE);
+}
+
+static PORT_INLINE omfErr_t omfsInlineAddInt64toInt64(
+			omfInt64	in,
+			omfInt64	*out)
+{
+	if(out == NULL)
+		return(OM_ERR_NULL_PARAM);
+	*out += in;
+	return(OM_ERR_NONE);
+}
+
+static PORT_INLINE omfErr_t omfsInlineSubInt64fromInt64(
+			omfInt64	in,
+			omfInt64	*out)
+{
+	if(out == NULL)
+		return(OM_ERR_NULL_PARAM);
+	*out -= in;
+	return(OM_ERR_NONE);
+}
+
+static PORT_INLINE omfErr_t omfsInlineSubInt32fromInt64(
+			omfInt32	in,
+			omfInt64	*out)
+{
+	*out -= in;
+	return(OM_ERR_NONE);
+}
+
+static PORT_INLINE omfErr_t omfsInlineMultInt32byInt64(
+			omfInt32	in,
+			omfInt64	in2,
+			omfInt64	*out)
+{
+	if(out == NULL)
+		return(OM_ERR_NULL_PARAM);
+	*out = (omfInt64)in * in2;
+	return(OM_ERR_NONE);
+}
+
+static PORT_INLINE omfErr_t omfsInlineInt64AndInt64(
+			omfInt64	in,
+			omfInt64	*out)
+{
+	if(out == NULL)
+		return(OM_ERR_NULL_PARAM);
+	*out &= in;
+	return(OM_ERR_NONE);
+}
+
+static PORT_INLINE omfErr_t omfsInlineTruncInt64toInt32(
+			omfInt64	in,
+			omfInt32	*out)
+{
+	if(out == NULL)
+		return(OM_ERR_NULL_PARAM);
+	*out = (omfInt32)(in & 0xFFFFFFFF);
+	if((*out != in) && ((omfInt32)(-in & 0xFFFFFFFF) != *out))
+		return(OM_ERR_OFFSET_SIZE);
+	return(OM_ERR_NONE);
+}
+
+static PORT_INLINE omfErr_t omfsInlineTruncInt64toUInt32(
+			omfInt64	in,
+			omfUInt32	*out)
+{
+	if(out == NULL)
+		return(OM_ERR_NULL_PARAM);
+	*out = (omfUInt32)(in & 0xFFFFFFFF);
+	if(*out != in)
+		return(OM_ERR_OFFSET_SIZE);
+	return(OM_ERR_NONE);
+}
+
+#define omfsAddInt32toInt64(in, out)		omfsInlineAddInt32toInt64(in, out)
+#define omfsAddInt64toInt64(in, out)		omfsInlineAddInt64toInt64(in, out)
+#define omfsSubInt64fromInt64(in, out)		omfsInlineSubInt64fromInt64(in, out)
+#define omfsSubInt32fromInt64(in, out)		omfsInlineSubInt32fromInt64(in, out)
+#define omfsMultInt32byInt64(in, in2, out)	omfsInlineMultInt32byInt64(in, in2, out)
+#define omfsInt64AndInt64(in, out)			omfsInlineInt64AndInt64(in, out)
+#define omfsTruncInt64toInt32(in, out)		omfsInlineTruncInt64toInt32(in, out)
+#define omfsTruncInt64toUInt32(in, out)		omfsInlineTruncInt64toUInt32(in, out)
+#endif
 			
 
 #ifdef OMFI_SELF_TEST
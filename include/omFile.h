@@ -61,6 +61,19 @@ OMF_EXPORT omfErr_t omfsBeginSession(
 OMF_EXPORT omfErr_t omfsSetSessionIOHandlers( omfSessionHdl_t session,
 											  struct omfiBentoIOFuncs ioFuncs);
 
+OMF_EXPORT omfErr_t omfsSetReadCacheSize(omfSessionHdl_t session,
+										 omfInt32 blockSize,
+										 omfInt32 numBlocks,
+										 omfInt32 readAhead);
+
+OMF_EXPORT omfErr_t omfsGetReadCacheStats(omfSessionHdl_t session,
+										  omfUInt32 *hits,
+										  omfUInt32 *misses,
+										  omfBool reset);
+
+OMF_EXPORT omfErr_t omfsSetLazyOpen(omfSessionHdl_t session,
+									omfBool lazy);
+
 OMF_EXPORT omfErr_t omfsEndSession(omfSessionHdl_t session);
 
 OMF_EXPORT omfErr_t omfsFileGetRev(omfHdl_t file, 
@@ -215,6 +215,10 @@ OMF_EXPORT omfErr_t omfmLocatorFailureCallback(
 			omfHdl_t			file,		/* IN -- For this file */
 			omfLocatorFailureCB	callback);	/* IN -- set this callback */
 
+OMF_EXPORT omfErr_t omfmSetMediaFileCacheSize(
+			omfSessionHdl_t		sess,			/* IN -- For this session */
+			omfInt32			maxIdleFiles);	/* IN -- keep this many unused files open */
+
 /****************************************/
 /******		Create Source Mobs		*****/
 /****************************************/
@@ -488,6 +492,13 @@ OMF_EXPORT omfErr_t        omfmReadDataSamples(omfMediaHdl_t media,	/* IN -- */
 				                    void *buffer,	/* IN/OUT -- */
 					                omfUInt32 * bytesRead);	/* OUT -- */
 
+OMF_EXPORT omfErr_t        omfmReadDataSamplesParallel(omfMediaHdl_t media,	/* IN -- */
+				                    omfInt32 nSamples,	/* IN -- */
+				                    omfInt32 numWorkers,	/* IN -- */
+				                    omfInt32 buflen,	/* IN -- */
+				                    void *buffer,	/* IN/OUT -- */
+					                omfUInt32 * bytesRead);	/* OUT -- */
+
 OMF_EXPORT omfErr_t omfmReadRawData(
 			omfMediaHdl_t	media,		/* IN -- For this media reference */
 			omfInt32			nSamples,	/* IN -- write this many samples */
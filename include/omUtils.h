@@ -90,6 +90,10 @@ OMF_EXPORT omfBool omfsIsSemanticCheckOn(omfHdl_t file);
 
 OMF_EXPORT omfErr_t omfsFileCheckInit(omfHdl_t file, omfFileCheckHdl_t *hdl);
 OMF_EXPORT omfErr_t omfsFileCheckCleanup(omfFileCheckHdl_t hdl);
+OMF_EXPORT omfErr_t omfsFileCheckSetPartition(
+			omfFileCheckHdl_t hdl,
+			omfInt32		partIndex,
+			omfInt32		numParts);
 
 OMF_EXPORT omfErr_t omfsFileCheckObjectIntegrity(
 			omfFileCheckHdl_t hdl,
@@ -1057,6 +1061,16 @@ OMF_EXPORT omfErr_t omfsGetArrayLength(
 			omfType_t		dataType,	/* IN -- of this data type */
 			omfInt32			dataSize,	/* IN -- with entries of this size */
 			omfInt32			*length);		/* OUT - return the number of elements */
+OMF_EXPORT omfErr_t omfsReadArrayBlock(
+			omfHdl_t			file,			/* IN -- For this omf file */
+			omfObject_t		obj,			/* IN -- in this object */
+			omfProperty_t	prop,			/* IN -- and this property */
+			omfType_t		dataType,	/* IN -- of this data type */
+			omfInt32			dataSize,	/* IN -- with entries of this size */
+			omfInt32			first,		/* IN -- starting at this element */
+			omfInt32			count,		/* IN -- read this many elements */
+			omfSwabCheck_t	swabType,	/* IN -- Swab the data (optional) */
+			void				*data);		/* OUT - into this buffer */
 OMF_EXPORT omfErr_t OMRemoveNthArrayProp(
 			omfHdl_t			file,			/* IN -- For this omf file */
 			omfObject_t		obj,			/* IN -- in this object */
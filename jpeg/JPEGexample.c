@@ -323,7 +323,7 @@ METHODDEF void
 error_exit (const char *msgtext)
 {
   trace_message(msgtext);	/* report the error message */
-  (*emethods->free_all) ();	/* clean up memory allocation & temp files */
+  (*emethods->free_all) (emethods);	/* clean up memory allocation & temp files */
   longjmp(setjmp_buffer, 1);	/* return control to outer routine */
 }
 
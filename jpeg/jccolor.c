@@ -13,9 +13,6 @@
 #include "jinclude.h"
 
 
-static JSAMPARRAY pixel_row;	/* Workspace for a pixel row in input format */
-
-
 /**************** RGB -> YCbCr conversion: most common case **************/
 
 /*
@@ -55,7 +52,6 @@ static JSAMPARRAY pixel_row;	/* Workspace for a pixel row in input format */
  * machines (more than can hold all eight addresses, anyway).
  */
 
-static INT32 * rgb_ycc_tab;	/* => table for RGB to YCbCr conversion */
 #define R_Y_OFF		0			/* offset to R => Y section */
 #define G_Y_OFF		(1*(MAXJSAMPLE+1))	/* offset to G => Y section */
 #define B_Y_OFF		(2*(MAXJSAMPLE+1))	/* etc. */
@@ -75,28 +71,30 @@ static INT32 * rgb_ycc_tab;	/* => table for RGB to YCbCr conversion */
 METHODDEF void
 rgb_ycc_init (compress_info_ptr cinfo)
 {
+  INT32 * ctab;
   INT32 i;
 
   /* Allocate a workspace for the result of get_input_row. */
-  pixel_row = (*cinfo->emethods->alloc_small_sarray)
-		(cinfo->image_width, (int ) cinfo->input_components);
+  cinfo->color_pixel_row = (*cinfo->emethods->alloc_small_sarray)
+		(cinfo->emethods, cinfo->image_width, (int ) cinfo->input_components);
 
   /* Allocate and fill in the conversion tables. */
-  rgb_ycc_tab = (INT32 *) (*cinfo->emethods->alloc_small)
-				(TABLE_SIZE * SIZEOF(INT32));
+  ctab = (INT32 *) (*cinfo->emethods->alloc_small)
+				(cinfo->emethods, TABLE_SIZE * SIZEOF(INT32));
+  cinfo->rgb_ycc_tab = ctab;
 
   for (i = 0; i <= MAXJSAMPLE; i++) {
-    rgb_ycc_tab[i+R_Y_OFF] = FIX(0.29900) * i;
-    rgb_ycc_tab[i+G_Y_OFF] = FIX(0.58700) * i;
-    rgb_ycc_tab[i+B_Y_OFF] = FIX(0.11400) * i     + ONE_HALF;
-    rgb_ycc_tab[i+R_CB_OFF] = (-FIX(0.16874)) * i;
-    rgb_ycc_tab[i+G_CB_OFF] = (-FIX(0.33126)) * i;
-    rgb_ycc_tab[i+B_CB_OFF] = FIX(0.50000) * i    + ONE_HALF*(MAXJSAMPLE+1);
+    ctab[i+R_Y_OFF] = FIX(0.29900) * i;
+    ctab[i+G_Y_OFF] = FIX(0.58700) * i;
+    ctab[i+B_Y_OFF] = FIX(0.11400) * i     + ONE_HALF;
+    ctab[i+R_CB_OFF] = (-FIX(0.16874)) * i;
+    ctab[i+G_CB_OFF] = (-FIX(0.33126)) * i;
+    ctab[i+B_CB_OFF] = FIX(0.50000) * i    + ONE_HALF*(MAXJSAMPLE+1);
 /*  B=>Cb and R=>Cr tables are the same
-    rgb_ycc_tab[i+R_CR_OFF] = FIX(0.50000) * i    + ONE_HALF*(MAXJSAMPLE+1);
+    ctab[i+R_CR_OFF] = FIX(0.50000) * i    + ONE_HALF*(MAXJSAMPLE+1);
 */
-    rgb_ycc_tab[i+G_CR_OFF] = (-FIX(0.41869)) * i;
-    rgb_ycc_tab[i+B_CR_OFF] = (-FIX(0.08131)) * i;
+    ctab[i+G_CR_OFF] = (-FIX(0.41869)) * i;
+    ctab[i+B_CR_OFF] = (-FIX(0.08131)) * i;
   }
 }
 
@@ -115,7 +113,7 @@ get_rgb_ycc_rows (compress_info_ptr cinfo,
 #else
   register int r, g, b;
 #endif
-  register INT32 * ctab = rgb_ycc_tab;
+  register INT32 * ctab = cinfo->rgb_ycc_tab;
   register JSAMPROW inptr0, inptr1, inptr2;
   register JSAMPROW outptr0, outptr1, outptr2;
   register int  col;
@@ -124,11 +122,11 @@ get_rgb_ycc_rows (compress_info_ptr cinfo,
 
   for (row = 0; row < rows_to_read; row++) {
     /* Read one row from the source file */
-    (*cinfo->methods->get_input_row) (cinfo, pixel_row);
+    (*cinfo->methods->get_input_row) (cinfo, cinfo->color_pixel_row);
     /* Convert colorspace */
-    inptr0 = pixel_row[0];
-    inptr1 = pixel_row[1];
-    inptr2 = pixel_row[2];
+    inptr0 = cinfo->color_pixel_row[0];
+    inptr1 = cinfo->color_pixel_row[1];
+    inptr2 = cinfo->color_pixel_row[2];
     outptr0 = image_data[0][row];
     outptr1 = image_data[1][row];
     outptr2 = image_data[2][row];
@@ -189,7 +187,7 @@ get_rgb_gray_rows (compress_info_ptr cinfo,
 #else
   register int r, g, b;
 #endif
-  register INT32 * ctab = rgb_ycc_tab;
+  register INT32 * ctab = cinfo->rgb_ycc_tab;
   register JSAMPROW inptr0, inptr1, inptr2;
   register JSAMPROW outptr;
   register int  col;
@@ -198,11 +196,11 @@ get_rgb_gray_rows (compress_info_ptr cinfo,
 
   for (row = 0; row < rows_to_read; row++) {
     /* Read one row from the source file */
-    (*cinfo->methods->get_input_row) (cinfo, pixel_row);
+    (*cinfo->methods->get_input_row) (cinfo, cinfo->color_pixel_row);
     /* Convert colorspace */
-    inptr0 = pixel_row[0];
-    inptr1 = pixel_row[1];
-    inptr2 = pixel_row[2];
+    inptr0 = cinfo->color_pixel_row[0];
+    inptr1 = cinfo->color_pixel_row[1];
+    inptr2 = cinfo->color_pixel_row[2];
     outptr = image_data[0][row];
     for (col = 0; col < width; col++) {
       r = GETJSAMPLE(inptr0[col]);
@@ -230,8 +228,8 @@ METHODDEF void
 colorin_init (compress_info_ptr cinfo)
 {
   /* Allocate a workspace for the result of get_input_row. */
-  pixel_row = (*cinfo->emethods->alloc_small_sarray)
-		(cinfo->image_width, (int ) cinfo->input_components);
+  cinfo->color_pixel_row = (*cinfo->emethods->alloc_small_sarray)
+		(cinfo->emethods, cinfo->image_width, (int ) cinfo->input_components);
 }
 
 
@@ -250,9 +248,9 @@ get_grayscale_rows (compress_info_ptr cinfo,
 
   for (row = 0; row < rows_to_read; row++) {
     /* Read one row from the source file */
-    (*cinfo->methods->get_input_row) (cinfo, pixel_row);
+    (*cinfo->methods->get_input_row) (cinfo, cinfo->color_pixel_row);
     /* Convert colorspace (gamma mapping needed here) */
-    jcopy_sample_rows(pixel_row, 0, image_data[0], row,
+    jcopy_sample_rows(cinfo->color_pixel_row, 0, image_data[0], row,
 		      1, cinfo->image_width);
   }
 }
@@ -272,10 +270,10 @@ get_noconvert_rows (compress_info_ptr cinfo,
 
   for (row = 0; row < rows_to_read; row++) {
     /* Read one row from the source file */
-    (*cinfo->methods->get_input_row) (cinfo, pixel_row);
+    (*cinfo->methods->get_input_row) (cinfo, cinfo->color_pixel_row);
     /* Convert colorspace (gamma mapping needed here) */
     for (ci = 0; ci < cinfo->input_components; ci++) {
-      jcopy_sample_rows(pixel_row, ci, image_data[ci], row,
+      jcopy_sample_rows(cinfo->color_pixel_row, ci, image_data[ci], row,
 			1, cinfo->image_width);
     }
   }
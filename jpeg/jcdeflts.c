@@ -49,7 +49,7 @@ add_huff_table (compress_info_ptr cinfo, HUFF_TBL **htblptr,
 /* Define a Huffman table */
 {
   if (*htblptr == NULL)
-    *htblptr = (HUFF_TBL *) (*cinfo->emethods->alloc_small) (SIZEOF(HUFF_TBL));
+    *htblptr = (HUFF_TBL *) (*cinfo->emethods->alloc_small) (cinfo->emethods, SIZEOF(HUFF_TBL));
 
   if (bitsize > SIZEOF((*htblptr)->bits))
     bitsize = SIZEOF((*htblptr)->bits);
@@ -172,7 +172,7 @@ j_add_quant_table (compress_info_ptr cinfo, int which_tbl,
   int  temp;
 
   if (*qtblptr == NULL)
-    *qtblptr = (QUANT_TBL_PTR) (*cinfo->emethods->alloc_small) (SIZEOF(QUANT_TBL));
+    *qtblptr = (QUANT_TBL_PTR) (*cinfo->emethods->alloc_small) (cinfo->emethods, SIZEOF(QUANT_TBL));
 
   for (i = 0; i < DCTSIZE2; i++) {
     temp = ((int ) basic_table[i] * scale_factor + 50L) / 100L;
@@ -326,7 +326,7 @@ j_c_defaults (compress_info_ptr cinfo, int quality, boolean force_baseline)
   cinfo->jpeg_color_space = CS_YCbCr;
   cinfo->num_components = 3;
   cinfo->comp_info = (jpeg_component_info *)
-    (*cinfo->emethods->alloc_small) (4 * SIZEOF(jpeg_component_info));
+    (*cinfo->emethods->alloc_small) (cinfo->emethods, 4 * SIZEOF(jpeg_component_info));
   /* Note: we allocate a 4-entry comp_info array so that user interface can
    * easily change over to CMYK color space if desired.
    */
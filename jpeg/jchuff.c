@@ -13,16 +13,9 @@
 #include "jinclude.h"
 
 
-/* Static variables to avoid passing 'round extra parameters */
-
-static compress_info_ptr cinfo;
-
-static INT32 huff_put_buffer;	/* current bit-accumulation buffer */
-static int huff_put_bits;	/* # of bits now in it */
-
-static char * output_buffer;	/* output buffer */
-static int bytes_in_buffer;
-
+/* The bit-accumulation and output buffers live in the compress_info struct
+ * (huff_put_buffer etc.), so every routine here is handed cinfo explicitly.
+ */
 
 
 LOCAL void
@@ -81,18 +74,20 @@ fix_huff_tbl (HUFF_TBL * htbl)
 /* Outputting bytes to the file */
 
 LOCAL void
-flush_bytes (void)
+flush_bytes (compress_info_ptr cinfo)
 {
-  if (bytes_in_buffer)
-    (*cinfo->methods->entropy_output) (cinfo, output_buffer, bytes_in_buffer);
-  bytes_in_buffer = 0;
+  if (cinfo->huff_bytes_in_buffer)
+    (*cinfo->methods->entropy_output) (cinfo, cinfo->huff_output_buffer,
+				       cinfo->huff_bytes_in_buffer);
+  cinfo->huff_bytes_in_buffer = 0;
 }
 
 
-#define emit_byte(val)  \
-  MAKESTMT( if (bytes_in_buffer >= JPEG_BUF_SIZE) \
-	      flush_bytes(); \
-	    output_buffer[bytes_in_buffer++] = (char) (val); )
+#define emit_byte(cinfo,val)  \
+  MAKESTMT( if ((cinfo)->huff_bytes_in_buffer >= JPEG_BUF_SIZE) \
+	      flush_bytes(cinfo); \
+	    (cinfo)->huff_output_buffer[(cinfo)->huff_bytes_in_buffer++] = \
+	      (char) (val); )
 
 
 
@@ -106,11 +101,11 @@ flush_bytes (void)
 
 INLINE
 LOCAL void
-emit_bits (UINT16 code, int size)
+emit_bits (compress_info_ptr cinfo, UINT16 code, int size)
 {
   /* This routine is heavily used, so it's worth coding tightly. */
   register INT32 put_buffer = code;
-  register int put_bits = huff_put_bits;
+  register int put_bits = cinfo->huff_put_bits;
 
   /* if size is 0, caller used an invalid Huffman table entry */
   if (size == 0)
@@ -122,30 +117,30 @@ emit_bits (UINT16 code, int size)
   
   put_buffer <<= 24 - put_bits; /* align incoming bits */
 
-  put_buffer |= huff_put_buffer; /* and merge with old buffer contents */
+  put_buffer |= cinfo->huff_put_buffer; /* and merge with old buffer contents */
   
   while (put_bits >= 8) {
     int c = (int) ((put_buffer >> 16) & 0xFF);
     
-    emit_byte(c);
+    emit_byte(cinfo, c);
     if (c == 0xFF) {		/* need to stuff a zero byte? */
-      emit_byte(0);
+      emit_byte(cinfo, 0);
     }
     put_buffer <<= 8;
     put_bits -= 8;
   }
 
-  huff_put_buffer = put_buffer;	/* Update global variables */
-  huff_put_bits = put_bits;
+  cinfo->huff_put_buffer = put_buffer;	/* Update state variables */
+  cinfo->huff_put_bits = put_bits;
 }
 
 
 LOCAL void
-flush_bits (void)
+flush_bits (compress_info_ptr cinfo)
 {
-  emit_bits((UINT16) 0x7F, 7);	/* fill any partial byte with ones */
-  huff_put_buffer = 0;		/* and reset bit-buffer to empty */
-  huff_put_bits = 0;
+  emit_bits(cinfo, (UINT16) 0x7F, 7); /* fill any partial byte with ones */
+  cinfo->huff_put_buffer = 0;	/* and reset bit-buffer to empty */
+  cinfo->huff_put_bits = 0;
 }
 
 
@@ -154,7 +149,8 @@ flush_bits (void)
 /* Note that the DC coefficient has already been converted to a difference */
 
 LOCAL void
-encode_one_block (JBLOCK block, HUFF_TBL *dctbl, HUFF_TBL *actbl)
+encode_one_block (compress_info_ptr cinfo, JBLOCK block,
+		  HUFF_TBL *dctbl, HUFF_TBL *actbl)
 {
   register int temp, temp2;
   register int nbits;
@@ -179,12 +175,12 @@ encode_one_block (JBLOCK block, HUFF_TBL *dctbl, HUFF_TBL *actbl)
   }
   
   /* Emit the Huffman-coded symbol for the number of bits */
-  emit_bits(dctbl->ehufco[nbits], dctbl->ehufsi[nbits]);
+  emit_bits(cinfo, dctbl->ehufco[nbits], dctbl->ehufsi[nbits]);
 
   /* Emit that number of bits of the value, if positive, */
   /* or the complement of its magnitude, if negative. */
   if (nbits)			/* emit_bits rejects calls with size 0 */
-    emit_bits((UINT16) temp2, nbits);
+    emit_bits(cinfo, (UINT16) temp2, nbits);
   
   /* Encode the AC coefficients per section F.1.2.2 */
   
@@ -196,7 +192,7 @@ encode_one_block (JBLOCK block, HUFF_TBL *dctbl, HUFF_TBL *actbl)
     } else {
       /* if run length > 15, must emit special run-length-16 codes (0xF0) */
       while (r > 15) {
-	emit_bits(actbl->ehufco[0xF0], actbl->ehufsi[0xF0]);
+	emit_bits(cinfo, actbl->ehufco[0xF0], actbl->ehufsi[0xF0]);
 	r -= 16;
       }
 
@@ -214,11 +210,11 @@ encode_one_block (JBLOCK block, HUFF_TBL *dctbl, HUFF_TBL *actbl)
       
       /* Emit Huffman symbol for run length / number of bits */
       i = (r << 4) + nbits;
-      emit_bits(actbl->ehufco[i], actbl->ehufsi[i]);
+      emit_bits(cinfo, actbl->ehufco[i], actbl->ehufsi[i]);
       
       /* Emit that number of bits of the value, if positive, */
       /* or the complement of its magnitude, if negative. */
-      emit_bits((UINT16) temp2, nbits);
+      emit_bits(cinfo, (UINT16) temp2, nbits);
       
       r = 0;
     }
@@ -226,7 +222,7 @@ encode_one_block (JBLOCK block, HUFF_TBL *dctbl, HUFF_TBL *actbl)
 
   /* If the last coef(s) were zero, emit an end-of-block code */
   if (r > 0)
-    emit_bits(actbl->ehufco[0], actbl->ehufsi[0]);
+    emit_bits(cinfo, actbl->ehufco[0], actbl->ehufsi[0]);
 }
 
 
@@ -239,20 +235,19 @@ encode_one_block (JBLOCK block, HUFF_TBL *dctbl, HUFF_TBL *actbl)
  */
 
 METHODDEF void
-huff_init (compress_info_ptr xinfo)
+huff_init (compress_info_ptr cinfo)
 {
   short ci;
   jpeg_component_info * compptr;
 
-  /* Initialize static variables */
-  cinfo = xinfo;
-  huff_put_buffer = 0;
-  huff_put_bits = 0;
+  /* Initialize the bit-accumulation buffer */
+  cinfo->huff_put_buffer = 0;
+  cinfo->huff_put_bits = 0;
 
   /* Initialize the output buffer */
-  output_buffer = (char *) (*cinfo->emethods->alloc_small)
-				((size_t) JPEG_BUF_SIZE);
-  bytes_in_buffer = 0;
+  cinfo->huff_output_buffer = (char *) (*cinfo->emethods->alloc_small)
+				(cinfo->emethods, (size_t) JPEG_BUF_SIZE);
+  cinfo->huff_bytes_in_buffer = 0;
 
   for (ci = 0; ci < cinfo->comps_in_scan; ci++) {
     compptr = cinfo->cur_comp_info[ci];
@@ -283,10 +278,10 @@ emit_restart (compress_info_ptr cinfo)
 {
   short ci;
 
-  flush_bits();
+  flush_bits(cinfo);
 
-  emit_byte(0xFF);
-  emit_byte(RST0 + cinfo->next_restart_num);
+  emit_byte(cinfo, 0xFF);
+  emit_byte(cinfo, RST0 + cinfo->next_restart_num);
 
   /* Re-initialize DC predictions to 0 */
   for (ci = 0; ci < cinfo->comps_in_scan; ci++)
@@ -324,7 +319,7 @@ huff_encode (compress_info_ptr cinfo, JBLOCK *MCU_data)
     temp = MCU_data[blkn][0];
     MCU_data[blkn][0] -= cinfo->last_dc_val[ci];
     cinfo->last_dc_val[ci] = temp;
-    encode_one_block(MCU_data[blkn],
+    encode_one_block(cinfo, MCU_data[blkn],
 		     cinfo->dc_huff_tbl_ptrs[compptr->dc_tbl_no],
 		     cinfo->ac_huff_tbl_ptrs[compptr->ac_tbl_no]);
   }
@@ -339,10 +334,11 @@ METHODDEF void
 huff_term (compress_info_ptr cinfo)
 {
   /* Flush out the last data */
-  flush_bits();
-  flush_bytes();
+  flush_bits(cinfo);
+  flush_bytes(cinfo);
   /* Release the I/O buffer */
-  (*cinfo->emethods->free_small) ((void *) output_buffer);
+  (*cinfo->emethods->free_small) (cinfo->emethods,
+				  (void *) cinfo->huff_output_buffer);
 }
 
 
@@ -361,11 +357,6 @@ huff_term (compress_info_ptr cinfo)
 #ifdef ENTROPY_OPT_SUPPORTED
 
 
-/* These are static so htest_one_block can find 'em */
-static int  * dc_count_ptrs[NUM_HUFF_TBLS];
-static int  * ac_count_ptrs[NUM_HUFF_TBLS];
-
-
 LOCAL void
 gen_huff_coding (compress_info_ptr cinfo, HUFF_TBL *htbl, int  freq[])
 /* Generate the optimal coding for the given counts */
@@ -586,8 +577,8 @@ htest_encode (compress_info_ptr cinfo, JBLOCK *MCU_data)
     /* NB: unlike the real entropy encoder, we may not change the input data */
     htest_one_block(MCU_data[blkn],
 		    (JCOEF) (MCU_data[blkn][0] - cinfo->last_dc_val[ci]),
-		    dc_count_ptrs[compptr->dc_tbl_no],
-		    ac_count_ptrs[compptr->ac_tbl_no]);
+		    cinfo->dc_count_ptrs[compptr->dc_tbl_no],
+		    cinfo->ac_count_ptrs[compptr->ac_tbl_no]);
     cinfo->last_dc_val[ci] = MCU_data[blkn][0];
   }
 }
@@ -614,24 +605,24 @@ huff_optimize (compress_info_ptr cinfo, MCU_output_caller_ptr source_method)
   /* Note that gen_huff_coding expects 257 entries in each table! */
 
   for (i = 0; i < NUM_HUFF_TBLS; i++) {
-    dc_count_ptrs[i] = NULL;
-    ac_count_ptrs[i] = NULL;
+    cinfo->dc_count_ptrs[i] = NULL;
+    cinfo->ac_count_ptrs[i] = NULL;
   }
 
   for (i = 0; i < cinfo->comps_in_scan; i++) {
     /* Create DC table */
     tbl = cinfo->cur_comp_info[i]->dc_tbl_no;
-    if (dc_count_ptrs[tbl] == NULL) {
-      dc_count_ptrs[tbl] = (int  *) (*cinfo->emethods->alloc_small)
-					(257 * SIZEOF(int ));
-      MEMZERO(dc_count_ptrs[tbl], 257 * SIZEOF(int ));
+    if (cinfo->dc_count_ptrs[tbl] == NULL) {
+      cinfo->dc_count_ptrs[tbl] = (int  *) (*cinfo->emethods->alloc_small)
+					(cinfo->emethods, 257 * SIZEOF(int ));
+      MEMZERO(cinfo->dc_count_ptrs[tbl], 257 * SIZEOF(int ));
     }
     /* Create AC table */
     tbl = cinfo->cur_comp_info[i]->ac_tbl_no;
-    if (ac_count_ptrs[tbl] == NULL) {
-      ac_count_ptrs[tbl] = (int  *) (*cinfo->emethods->alloc_small)
-					(257 * SIZEOF(int ));
-      MEMZERO(ac_count_ptrs[tbl], 257 * SIZEOF(int ));
+    if (cinfo->ac_count_ptrs[tbl] == NULL) {
+      cinfo->ac_count_ptrs[tbl] = (int  *) (*cinfo->emethods->alloc_small)
+					(cinfo->emethods, 257 * SIZEOF(int ));
+      MEMZERO(cinfo->ac_count_ptrs[tbl], 257 * SIZEOF(int ));
     }
   }
 
@@ -647,27 +638,31 @@ huff_optimize (compress_info_ptr cinfo, MCU_output_caller_ptr source_method)
 
   /* Now generate optimal Huffman tables */
   for (tbl = 0; tbl < NUM_HUFF_TBLS; tbl++) {
-    if (dc_count_ptrs[tbl] != NULL) {
+    if (cinfo->dc_count_ptrs[tbl] != NULL) {
       htblptr = & cinfo->dc_huff_tbl_ptrs[tbl];
       if (*htblptr == NULL)
-	*htblptr = (HUFF_TBL *) (*cinfo->emethods->alloc_small) (SIZEOF(HUFF_TBL));
+	*htblptr = (HUFF_TBL *) (*cinfo->emethods->alloc_small)
+				(cinfo->emethods, SIZEOF(HUFF_TBL));
       /* Set sent_table FALSE so updated table will be written to JPEG file. */
       (*htblptr)->sent_table = FALSE;
       /* Compute the optimal Huffman encoding */
-      gen_huff_coding(cinfo, *htblptr, dc_count_ptrs[tbl]);
+      gen_huff_coding(cinfo, *htblptr, cinfo->dc_count_ptrs[tbl]);
       /* Release the count table */
-      (*cinfo->emethods->free_small) ((void *) dc_count_ptrs[tbl]);
+      (*cinfo->emethods->free_small) (cinfo->emethods,
+				      (void *) cinfo->dc_count_ptrs[tbl]);
     }
-    if (ac_count_ptrs[tbl] != NULL) {
+    if (cinfo->ac_count_ptrs[tbl] != NULL) {
       htblptr = & cinfo->ac_huff_tbl_ptrs[tbl];
       if (*htblptr == NULL)
-	*htblptr = (HUFF_TBL *) (*cinfo->emethods->alloc_small) (SIZEOF(HUFF_TBL));
+	*htblptr = (HUFF_TBL *) (*cinfo->emethods->alloc_small)
+				(cinfo->emethods, SIZEOF(HUFF_TBL));
       /* Set sent_table FALSE so updated table will be written to JPEG file. */
       (*htblptr)->sent_table = FALSE;
       /* Compute the optimal Huffman encoding */
-      gen_huff_coding(cinfo, *htblptr, ac_count_ptrs[tbl]);
+      gen_huff_coding(cinfo, *htblptr, cinfo->ac_count_ptrs[tbl]);
       /* Release the count table */
-      (*cinfo->emethods->free_small) ((void *) ac_count_ptrs[tbl]);
+      (*cinfo->emethods->free_small) (cinfo->emethods,
+				      (void *) cinfo->ac_count_ptrs[tbl]);
     }
   }
 }
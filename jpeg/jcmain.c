@@ -176,7 +176,7 @@ signal_catcher (int signum)
 {
   if (emethods != NULL) {
     emethods->trace_level = 0;	/* turn off trace output */
-    (*emethods->free_all) ();	/* clean up memory allocation & temp files */
+    (*emethods->free_all) (emethods);	/* clean up memory allocation & temp files */
   }
   exit(EXIT_FAILURE);
 }
@@ -127,7 +127,7 @@ jpeg_compress (compress_info_ptr cinfo)
   (*cinfo->methods->colorin_term) (cinfo);
   (*cinfo->methods->input_term) (cinfo);
 
-  (*cinfo->emethods->free_all) ();
+  (*cinfo->emethods->free_all) (cinfo->emethods);
 
   /* My, that was easy, wasn't it? */
 }
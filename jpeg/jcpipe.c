@@ -158,18 +158,18 @@ alloc_sampling_buffer (compress_info_ptr cinfo, JSAMPIMAGE fullsize_data[2],
 
   /* Get top-level space for array pointers */
   fullsize_data[0] = (JSAMPIMAGE) (*cinfo->emethods->alloc_small)
-				(cinfo->num_components * SIZEOF(JSAMPARRAY));
+				(cinfo->emethods, cinfo->num_components * SIZEOF(JSAMPARRAY));
   fullsize_data[1] = (JSAMPIMAGE) (*cinfo->emethods->alloc_small)
-				(cinfo->num_components * SIZEOF(JSAMPARRAY));
+				(cinfo->emethods, cinfo->num_components * SIZEOF(JSAMPARRAY));
 
   for (ci = 0; ci < cinfo->num_components; ci++) {
     /* Allocate the real storage */
     fullsize_data[0][ci] = (*cinfo->emethods->alloc_small_sarray)
-				(fullsize_width,
+				(cinfo->emethods, fullsize_width,
 				(int ) (vs * (DCTSIZE+2)));
     /* Create space for the scrambled-order pointers */
     fullsize_data[1][ci] = (JSAMPARRAY) (*cinfo->emethods->alloc_small)
-				(vs * (DCTSIZE+2) * SIZEOF(JSAMPROW));
+				(cinfo->emethods, vs * (DCTSIZE+2) * SIZEOF(JSAMPROW));
     /* Duplicate the first DCTSIZE-2 row groups */
     for (i = 0; i < vs * (DCTSIZE-2); i++) {
       fullsize_data[1][ci][i] = fullsize_data[0][ci][i];
@@ -193,14 +193,14 @@ free_sampling_buffer (compress_info_ptr cinfo, JSAMPIMAGE fullsize_data[2])
 
   for (ci = 0; ci < cinfo->num_components; ci++) {
     /* Free the real storage */
-    (*cinfo->emethods->free_small_sarray) (fullsize_data[0][ci]);
+    (*cinfo->emethods->free_small_sarray) (cinfo->emethods, fullsize_data[0][ci]);
     /* Free the scrambled-order pointers */
-    (*cinfo->emethods->free_small) ((void *) fullsize_data[1][ci]);
+    (*cinfo->emethods->free_small) (cinfo->emethods, (void *) fullsize_data[1][ci]);
   }
 
   /* Free the top-level space */
-  (*cinfo->emethods->free_small) ((void *) fullsize_data[0]);
-  (*cinfo->emethods->free_small) ((void *) fullsize_data[1]);
+  (*cinfo->emethods->free_small) (cinfo->emethods, (void *) fullsize_data[0]);
+  (*cinfo->emethods->free_small) (cinfo->emethods, (void *) fullsize_data[1]);
 }
 
 #endif
@@ -267,23 +267,19 @@ downsample (compress_info_ptr cinfo,
 
 #define MAX_WHOLE_ROW_BLOCKS	((int) (32768L / SIZEOF(JBLOCK))) /* max blocks/row */
 
-static big_barray_ptr whole_scan_MCUs; /* Big array for saving the MCUs */
-static int MCUs_in_big_row;	/* # of MCUs in each row of whole_scan_MCUs */
-static int  next_whole_row;	/* next row to access in whole_scan_MCUs */
-static int next_MCU_index;	/* next MCU in current row */
+/* The whole_scan_MCUs array and its access state are kept in cinfo. */
 
 
 METHODDEF void
 MCU_output_catcher (compress_info_ptr cinfo, JBLOCK *MCU_data)
 /* Output method for siphoning off extract_MCUs output into a big array */
 {
-  static JBLOCKARRAY rowptr;
-
-  if (next_MCU_index >= MCUs_in_big_row) {
-    rowptr = (*cinfo->emethods->access_big_barray) (whole_scan_MCUs,
-						    next_whole_row, TRUE);
-    next_whole_row++;
-    next_MCU_index = 0;
+  if (cinfo->next_MCU_index >= cinfo->MCUs_in_big_row) {
+    cinfo->MCU_rowptr = (*cinfo->emethods->access_big_barray)
+			(cinfo->emethods, cinfo->whole_scan_MCUs,
+			 cinfo->next_whole_row, TRUE);
+    cinfo->next_whole_row++;
+    cinfo->next_MCU_index = 0;
   }
 
   /*
@@ -291,9 +287,10 @@ MCU_output_catcher (compress_info_ptr cinfo, JBLOCK *MCU_data)
    * near to far pointer conversion.
    */
   jcopy_block_row((JBLOCKROW) MCU_data,
-		  rowptr[0] + next_MCU_index * cinfo->blocks_in_MCU,
+		  cinfo->MCU_rowptr[0] +
+		    cinfo->next_MCU_index * cinfo->blocks_in_MCU,
 		  (int ) cinfo->blocks_in_MCU);
-  next_MCU_index++;
+  cinfo->next_MCU_index++;
 }
 
 
@@ -316,15 +313,15 @@ dump_scan_MCUs (compress_info_ptr cinfo, MCU_output_method_ptr output_method)
   JBLOCKARRAY rowptr = NULL;	/* init only to suppress compiler complaint */
 
   next_row = 0;
-  next_index = MCUs_in_big_row;
+  next_index = cinfo->MCUs_in_big_row;
 
   for (mcurow = 0; mcurow < cinfo->MCU_rows_in_scan; mcurow++) {
     (*cinfo->methods->progress_monitor) (cinfo, mcurow,
 					 cinfo->MCU_rows_in_scan);
     for (mcuindex = 0; mcuindex < cinfo->MCUs_per_row; mcuindex++) {
-      if (next_index >= MCUs_in_big_row) {
-	rowptr = (*cinfo->emethods->access_big_barray) (whole_scan_MCUs,
-							next_row, FALSE);
+      if (next_index >= cinfo->MCUs_in_big_row) {
+	rowptr = (*cinfo->emethods->access_big_barray)
+			(cinfo->emethods, cinfo->whole_scan_MCUs, next_row, FALSE);
 	next_row++;
 	next_index = 0;
       }
@@ -394,10 +391,10 @@ single_ccontroller (compress_info_ptr cinfo)
   alloc_sampling_buffer(cinfo, fullsize_data, fullsize_width);
   /* sampled_data is sample data after downsampling */
   sampled_data = (JSAMPIMAGE) (*cinfo->emethods->alloc_small)
-				(cinfo->num_components * SIZEOF(JSAMPARRAY));
+				(cinfo->emethods, cinfo->num_components * SIZEOF(JSAMPARRAY));
   for (ci = 0; ci < cinfo->num_components; ci++) {
     sampled_data[ci] = (*cinfo->emethods->alloc_small_sarray)
-			(cinfo->comp_info[ci].downsampled_width,
+			(cinfo->emethods, cinfo->comp_info[ci].downsampled_width,
 			 (int ) (cinfo->comp_info[ci].v_samp_factor * DCTSIZE));
   }
 
@@ -406,7 +403,8 @@ single_ccontroller (compress_info_ptr cinfo)
    * but some other module (like the input file reader) may need one.
    */
   (*cinfo->emethods->alloc_big_arrays)
-	((int ) 0,				/* no more small sarrays */
+	(cinfo->emethods,
+	 (int ) 0,				/* no more small sarrays */
 	 (int ) 0,				/* no more small barrays */
 	 (int ) 0);				/* no more "medium" objects */
 
@@ -547,30 +545,31 @@ single_eopt_ccontroller (compress_info_ptr cinfo)
   alloc_sampling_buffer(cinfo, fullsize_data, fullsize_width);
   /* sampled_data is sample data after downsampling */
   sampled_data = (JSAMPIMAGE) (*cinfo->emethods->alloc_small)
-				(cinfo->num_components * SIZEOF(JSAMPARRAY));
+				(cinfo->emethods, cinfo->num_components * SIZEOF(JSAMPARRAY));
   for (ci = 0; ci < cinfo->num_components; ci++) {
     sampled_data[ci] = (*cinfo->emethods->alloc_small_sarray)
-			(cinfo->comp_info[ci].downsampled_width,
+			(cinfo->emethods, cinfo->comp_info[ci].downsampled_width,
 			 (int ) (cinfo->comp_info[ci].v_samp_factor * DCTSIZE));
   }
 
   /* Figure # of MCUs to be packed in a row of whole_scan_MCUs */
-  MCUs_in_big_row = MAX_WHOLE_ROW_BLOCKS / cinfo->blocks_in_MCU;
-  blocks_in_big_row = MCUs_in_big_row * cinfo->blocks_in_MCU;
+  cinfo->MCUs_in_big_row = MAX_WHOLE_ROW_BLOCKS / cinfo->blocks_in_MCU;
+  blocks_in_big_row = cinfo->MCUs_in_big_row * cinfo->blocks_in_MCU;
 
   /* Request a big array: whole_scan_MCUs saves the MCU data for the scan */
-  whole_scan_MCUs = (*cinfo->emethods->request_big_barray)
-		((int ) blocks_in_big_row,
+  cinfo->whole_scan_MCUs = (*cinfo->emethods->request_big_barray)
+		(cinfo->emethods, (int ) blocks_in_big_row,
 		 (int ) (cinfo->MCUs_per_row * cinfo->MCU_rows_in_scan
-			 + MCUs_in_big_row-1) / MCUs_in_big_row,
+			 + cinfo->MCUs_in_big_row-1) / cinfo->MCUs_in_big_row,
 		 1L);		/* unit height is 1 row */
 
-  next_whole_row = 0;		/* init output ptr for MCU_output_catcher */
-  next_MCU_index = MCUs_in_big_row; /* forces access on first call! */
+  cinfo->next_whole_row = 0;	/* init output ptr for MCU_output_catcher */
+  cinfo->next_MCU_index = cinfo->MCUs_in_big_row; /* forces access first time */
 
   /* Tell the memory manager to instantiate big arrays */
   (*cinfo->emethods->alloc_big_arrays)
-	((int ) 0,				/* no more small sarrays */
+	(cinfo->emethods,
+	 (int ) 0,				/* no more small sarrays */
 	 (int ) 0,				/* no more small barrays */
 	 (int ) 0);				/* no more "medium" objects */
 
@@ -50,11 +50,6 @@
 #define ONE_HALF	((INT32) 1 << (SCALEBITS-1))
 #define FIX(x)		((INT32) ((x) * (1L<<SCALEBITS) + 0.5))
 
-static int * Cr_r_tab;		/* => table for Cr to R conversion */
-static int * Cb_b_tab;		/* => table for Cb to B conversion */
-static INT32 * Cr_g_tab;	/* => table for Cr to G conversion */
-static INT32 * Cb_g_tab;	/* => table for Cb to G conversion */
-
 
 /*
  * Initialize for colorspace conversion.
@@ -63,33 +58,37 @@ static INT32 * Cb_g_tab;	/* => table for Cb to G conversion */
 METHODDEF void
 ycc_rgb_init (decompress_info_ptr cinfo)
 {
+  int * Crrtab;
+  int * Cbbtab;
+  INT32 * Crgtab;
+  INT32 * Cbgtab;
   INT32 i, x2;
   SHIFT_TEMPS
 
-  Cr_r_tab = (int *) (*cinfo->emethods->alloc_small)
-				((MAXJSAMPLE+1) * SIZEOF(int));
-  Cb_b_tab = (int *) (*cinfo->emethods->alloc_small)
-				((MAXJSAMPLE+1) * SIZEOF(int));
-  Cr_g_tab = (INT32 *) (*cinfo->emethods->alloc_small)
-				((MAXJSAMPLE+1) * SIZEOF(INT32));
-  Cb_g_tab = (INT32 *) (*cinfo->emethods->alloc_small)
-				((MAXJSAMPLE+1) * SIZEOF(INT32));
+  cinfo->Cr_r_tab = Crrtab = (int *) (*cinfo->emethods->alloc_small)
+				(cinfo->emethods, (MAXJSAMPLE+1) * SIZEOF(int));
+  cinfo->Cb_b_tab = Cbbtab = (int *) (*cinfo->emethods->alloc_small)
+				(cinfo->emethods, (MAXJSAMPLE+1) * SIZEOF(int));
+  cinfo->Cr_g_tab = Crgtab = (INT32 *) (*cinfo->emethods->alloc_small)
+				(cinfo->emethods, (MAXJSAMPLE+1) * SIZEOF(INT32));
+  cinfo->Cb_g_tab = Cbgtab = (INT32 *) (*cinfo->emethods->alloc_small)
+				(cinfo->emethods, (MAXJSAMPLE+1) * SIZEOF(INT32));
 
   for (i = 0; i <= MAXJSAMPLE; i++) {
     /* i is the actual input pixel value, in the range 0..MAXJSAMPLE */
     /* The Cb or Cr value we are thinking of is x = i - MAXJSAMPLE/2 */
     x2 = 2*i - MAXJSAMPLE;	/* twice x */
     /* Cr=>R value is nearest int to 1.40200 * x */
-    Cr_r_tab[i] = (int)
+    Crrtab[i] = (int)
 		    RIGHT_SHIFT(FIX(1.40200/2) * x2 + ONE_HALF, SCALEBITS);
     /* Cb=>B value is nearest int to 1.77200 * x */
-    Cb_b_tab[i] = (int)
+    Cbbtab[i] = (int)
 		    RIGHT_SHIFT(FIX(1.77200/2) * x2 + ONE_HALF, SCALEBITS);
     /* Cr=>G value is scaled-up -0.71414 * x */
-    Cr_g_tab[i] = (- FIX(0.71414/2)) * x2;
+    Crgtab[i] = (- FIX(0.71414/2)) * x2;
     /* Cb=>G value is scaled-up -0.34414 * x */
     /* We also add in ONE_HALF so that need not do it in inner loop */
-    Cb_g_tab[i] = (- FIX(0.34414/2)) * x2 + ONE_HALF;
+    Cbgtab[i] = (- FIX(0.34414/2)) * x2 + ONE_HALF;
   }
 }
 
@@ -113,10 +112,10 @@ ycc_rgb_convert (decompress_info_ptr cinfo, int num_rows, int  num_cols,
   register int  col;
   /* copy these pointers into registers if possible */
   register JSAMPLE * range_limit = cinfo->sample_range_limit;
-  register int * Crrtab = Cr_r_tab;
-  register int * Cbbtab = Cb_b_tab;
-  register INT32 * Crgtab = Cr_g_tab;
-  register INT32 * Cbgtab = Cb_g_tab;
+  register int * Crrtab = cinfo->Cr_r_tab;
+  register int * Cbbtab = cinfo->Cb_b_tab;
+  register INT32 * Crgtab = cinfo->Cr_g_tab;
+  register INT32 * Cbgtab = cinfo->Cb_g_tab;
   int row;
   SHIFT_TEMPS
   
@@ -159,7 +159,7 @@ j_d_defaults (decompress_info_ptr cinfo, boolean standard_buffering)
   /* Allocate memory for input buffer, unless outer application provides it. */
   if (standard_buffering) {
     cinfo->input_buffer = (char *) (*cinfo->emethods->alloc_small)
-					((size_t) (JPEG_BUF_SIZE + MIN_UNGET));
+					(cinfo->emethods, (size_t) (JPEG_BUF_SIZE + MIN_UNGET));
     cinfo->bytes_in_buffer = 0;	/* initialize buffer to empty */
   }
 
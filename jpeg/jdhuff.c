@@ -13,14 +13,7 @@
 #include "jinclude.h"
 
 
-/* Static variables to avoid passing 'round extra parameters */
-
 static short descale16(int s, int quant);
-static decompress_info_ptr dcinfo;
-
-static INT32 get_buffer;	/* current bit-extraction buffer */
-static int bits_left;		/* # of unused bits in it */
-static boolean printed_eod;	/* flag to suppress multiple end-of-data msgs */
 
 static short descale16(int s, int quant)
 {
@@ -129,24 +122,24 @@ static const int bmask[16] =	/* bmask[n] is mask for n rightmost bits */
 
 
 LOCAL int
-fill_bit_buffer (int nbits)
+fill_bit_buffer (decompress_info_ptr cinfo, int nbits)
 /* Load up the bit buffer and do get_bits(nbits) */
 {
   /* Attempt to load at least MIN_GET_BITS bits into get_buffer. */
-  while (bits_left < MIN_GET_BITS) {
-    register int c = JGETC(dcinfo);
+  while (cinfo->huff_bits_left < MIN_GET_BITS) {
+    register int c = JGETC(cinfo);
 
     /* If it's 0xFF, check and discard stuffed zero byte */
     if (c == 0xFF) {
-      int c2 = JGETC(dcinfo);
+      int c2 = JGETC(cinfo);
       if (c2 != 0) {
 	/* Oops, it's actually a marker indicating end of compressed data. */
 	/* Better put it back for use later */
-	JUNGETC(c2,dcinfo);
-	JUNGETC(c,dcinfo);
+	JUNGETC(c2,cinfo);
+	JUNGETC(c,cinfo);
 	/* There should be enough bits still left in the data segment; */
 	/* if so, just break out of the while loop. */
-	if (bits_left >= nbits)
+	if (cinfo->huff_bits_left >= nbits)
 	  break;
 	/* Uh-oh.  Report corrupted data to user and stuff zeroes into
 	 * the data stream, so we can produce some kind of image.
@@ -154,59 +147,61 @@ fill_bit_buffer (int nbits)
 	 * rest of the segment; this is a bit slow but not unreasonably so.
 	 * The main thing is to avoid getting a zillion warnings, hence:
 	 */
-	if (! printed_eod) {
-	  WARNMS(dcinfo->emethods, "Corrupt JPEG data: premature end of data segment");
-	  printed_eod = TRUE;
+	if (! cinfo->printed_eod) {
+	  WARNMS(cinfo->emethods,
+		 "Corrupt JPEG data: premature end of data segment");
+	  cinfo->printed_eod = TRUE;
 	}
 	c = 0;			/* insert a zero byte into bit buffer */
       }
     }
 
     /* OK, load c into get_buffer */
-    get_buffer = (get_buffer << 8) | c;
-    bits_left += 8;
+    cinfo->huff_get_buffer = (cinfo->huff_get_buffer << 8) | c;
+    cinfo->huff_bits_left += 8;
   }
 
   /* Having filled get_buffer, extract desired bits (this simplifies macros) */
-  bits_left -= nbits;
-  return ((int) (get_buffer >> bits_left)) & bmask[nbits];
+  cinfo->huff_bits_left -= nbits;
+  return ((int) (cinfo->huff_get_buffer >> cinfo->huff_bits_left)) & bmask[nbits];
 }
 
 
 /* Macros to make things go at some speed! */
 /* NB: parameter to get_bits should be simple variable, not expression */
 
-#define get_bits(nbits) \
-	(bits_left >= (nbits) ? \
-	 ((int) (get_buffer >> (bits_left -= (nbits)))) & bmask[nbits] : \
-	 fill_bit_buffer(nbits))
+#define get_bits(cinfo,nbits) \
+	((cinfo)->huff_bits_left >= (nbits) ? \
+	 ((int) ((cinfo)->huff_get_buffer >> \
+		 ((cinfo)->huff_bits_left -= (nbits)))) & bmask[nbits] : \
+	 fill_bit_buffer(cinfo, nbits))
 
-#define get_bit() \
-	(bits_left ? \
-	 ((int) (get_buffer >> (--bits_left))) & 1 : \
-	 fill_bit_buffer(1))
+#define get_bit(cinfo) \
+	((cinfo)->huff_bits_left ? \
+	 ((int) ((cinfo)->huff_get_buffer >> (--(cinfo)->huff_bits_left))) & 1 : \
+	 fill_bit_buffer(cinfo, 1))
 
 
 /* Figure F.16: extract next coded symbol from input stream */
 
 INLINE
 LOCAL int
-huff_DECODE (HUFF_TBL * htbl)
+huff_DECODE (decompress_info_ptr cinfo, HUFF_TBL * htbl)
 {
   register int l;
   register INT32 code;
 
-  code = get_bit();
+  code = get_bit(cinfo);
   l = 1;
   while (code > htbl->maxcode[l]) {
-    code = (code << 1) | get_bit();
+    code = (code << 1) | get_bit(cinfo);
     l++;
   }
 
   /* With garbage input we may reach the sentinel value l = 17. */
 
   if (l > 16) {
-    WARNMS(dcinfo->emethods, "Corrupt JPEG data: bad Huffman code");
+    WARNMS(cinfo->emethods, "Corrupt JPEG data: bad Huffman code");
     return 0;			/* fake a zero as the safest result */
   }
 
@@ -240,10 +235,10 @@ huff_decoder_init (decompress_info_ptr cinfo)
   short ci;
   jpeg_component_info * compptr;
 
-  /* Initialize static variables */
-  dcinfo = cinfo;
-  bits_left = 0;
-  printed_eod = FALSE;
+  /* Initialize bit-extraction state */
+  cinfo->huff_get_buffer = 0;
+  cinfo->huff_bits_left = 0;
+  cinfo->printed_eod = FALSE;
 
   for (ci = 0; ci < cinfo->comps_in_scan; ci++) {
     compptr = cinfo->cur_comp_info[ci];
@@ -276,9 +271,9 @@ process_restart (decompress_info_ptr cinfo)
   short ci;
 
   /* Throw away any unused bits remaining in bit buffer */
-  nbytes = bits_left / 8;	/* count any full bytes loaded into buffer */
-  bits_left = 0;
-  printed_eod = FALSE;		/* next segment can get another warning */
+  nbytes = cinfo->huff_bits_left / 8; /* count full bytes loaded into buffer */
+  cinfo->huff_bits_left = 0;
+  cinfo->printed_eod = FALSE;		/* next segment can get another warning */
 
   /* Scan for next JPEG marker */
   do {
@@ -375,9 +370,9 @@ huff_decode_mcu (decompress_info_ptr cinfo, JBLOCKROW *MCU_data)
     /* Decode a single block's worth of coefficients */
 
     /* Section F.2.2.1: decode the DC coefficient difference */
-    s = huff_DECODE(dctbl);
+    s = huff_DECODE(cinfo, dctbl);
     if (s) {
-      r = get_bits(s);
+      r = get_bits(cinfo, s);
       s = huff_EXTEND(r, s);
     }
 
@@ -396,14 +391,14 @@ huff_decode_mcu (decompress_info_ptr cinfo, JBLOCKROW *MCU_data)
     /* Section F.2.2.2: decode the AC coefficients */
     /* Since zero values are skipped, output area must be zeroed beforehand */
     for (k = 1; k < DCTSIZE2; k++) {
-      r = huff_DECODE(actbl);
+      r = huff_DECODE(cinfo, actbl);
 
       s = r & 15;
       r = r >> 4;
 
       if (s) {
 	k += r;
-	r = get_bits(s);
+	r = get_bits(cinfo, s);
 	s = huff_EXTEND(r, s);
 	/* Descale coefficient and output in natural (dezigzagged) order */
 #if ! STANDARD_JPEG_Q
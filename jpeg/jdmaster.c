@@ -167,7 +167,7 @@ jpeg_decompress (decompress_info_ptr cinfo)
   (*cinfo->methods->output_term) (cinfo);
   (*cinfo->methods->read_file_trailer) (cinfo);
 
-  (*cinfo->emethods->free_all) ();
+  (*cinfo->emethods->free_all) (cinfo->emethods);
 
   /* My, that was easy, wasn't it? */
 }
@@ -64,23 +64,18 @@
 
 
 /*
- * These variables are logically local to the pipeline controller,
- * but we make them static so that scan_big_image can use them
- * without having to pass them through the quantization routines.
+ * The state that is logically local to the pipeline controller, but which
+ * scan_big_image needs without having it passed through the quantization
+ * routines, is kept in the decompress_info struct:
+ *   rows_in_mem		# of sample rows in full-size buffers
+ *   output_workspace	work buffer for data being passed to output module;
+ *			has color_out_comps components if not quantizing,
+ *			but only one component when quantizing
+ *   fullsize_image	full-size image array holding upsampled, but not
+ *			color-processed data (complex controller only)
+ *   fullsize_ptrs	workspace for access_big_sarray() result
  */
 
-static int rows_in_mem;		/* # of sample rows in full-size buffers */
-/* Work buffer for data being passed to output module. */
-/* This has color_out_comps components if not quantizing, */
-/* but only one component when quantizing. */
-static JSAMPIMAGE output_workspace;
-
-#ifdef NEED_COMPLEX_CONTROLLER
-/* Full-size image array holding upsampled, but not color-processed data. */
-static big_sarray_ptr *fullsize_image;
-static JSAMPIMAGE fullsize_ptrs; /* workspace for access_big_sarray() result */
-#endif
-
 
 /*
  * Utility routines: common code for pipeline controllers
@@ -173,9 +168,9 @@ alloc_sampimage (decompress_info_ptr cinfo,
   int ci;
 
   image = (JSAMPIMAGE) (*cinfo->emethods->alloc_small)
-				(num_comps * SIZEOF(JSAMPARRAY));
+				(cinfo->emethods, num_comps * SIZEOF(JSAMPARRAY));
   for (ci = 0; ci < num_comps; ci++) {
-    image[ci] = (*cinfo->emethods->alloc_small_sarray) (num_cols, num_rows);
+    image[ci] = (*cinfo->emethods->alloc_small_sarray) (cinfo->emethods, num_cols, num_rows);
   }
   return image;
 }
@@ -190,9 +185,9 @@ free_sampimage (decompress_info_ptr cinfo, JSAMPIMAGE image, int num_comps)
   int ci;
 
   for (ci = 0; ci < num_comps; ci++) {
-      (*cinfo->emethods->free_small_sarray) (image[ci]);
+      (*cinfo->emethods->free_small_sarray) (cinfo->emethods, image[ci]);
   }
-  (*cinfo->emethods->free_small) ((void *) image);
+  (*cinfo->emethods->free_small) (cinfo->emethods, (void *) image);
 }
 
 #endif
@@ -206,10 +201,10 @@ alloc_MCU_row (decompress_info_ptr cinfo)
   int ci;
 
   image = (JBLOCKIMAGE) (*cinfo->emethods->alloc_small)
-				(cinfo->comps_in_scan * SIZEOF(JBLOCKARRAY));
+				(cinfo->emethods, cinfo->comps_in_scan * SIZEOF(JBLOCKARRAY));
   for (ci = 0; ci < cinfo->comps_in_scan; ci++) {
     image[ci] = (*cinfo->emethods->alloc_small_barray)
-			(cinfo->cur_comp_info[ci]->downsampled_width / DCTSIZE,
+			(cinfo->emethods, cinfo->cur_comp_info[ci]->downsampled_width / DCTSIZE,
 			 (int ) cinfo->cur_comp_info[ci]->MCU_height);
   }
   return image;
@@ -225,9 +220,9 @@ free_MCU_row (decompress_info_ptr cinfo, JBLOCKIMAGE image)
   int ci;
 
   for (ci = 0; ci < cinfo->comps_in_scan; ci++) {
-    (*cinfo->emethods->free_small_barray) (image[ci]);
+    (*cinfo->emethods->free_small_barray) (cinfo->emethods, image[ci]);
   }
-  (*cinfo->emethods->free_small) ((void *) image);
+  (*cinfo->emethods->free_small) (cinfo->emethods, (void *) image);
 }
 
 #endif
@@ -242,19 +237,19 @@ alloc_sampling_buffer (decompress_info_ptr cinfo, JSAMPIMAGE sampled_data[2])
 
   /* Get top-level space for array pointers */
   sampled_data[0] = (JSAMPIMAGE) (*cinfo->emethods->alloc_small)
-				(cinfo->comps_in_scan * SIZEOF(JSAMPARRAY));
+				(cinfo->emethods, cinfo->comps_in_scan * SIZEOF(JSAMPARRAY));
   sampled_data[1] = (JSAMPIMAGE) (*cinfo->emethods->alloc_small)
-				(cinfo->comps_in_scan * SIZEOF(JSAMPARRAY));
+				(cinfo->emethods, cinfo->comps_in_scan * SIZEOF(JSAMPARRAY));
 
   for (ci = 0; ci < cinfo->comps_in_scan; ci++) {
     vs = cinfo->cur_comp_info[ci]->v_samp_factor; /* row group height */
     /* Allocate the real storage */
     sampled_data[0][ci] = (*cinfo->emethods->alloc_small_sarray)
-				(cinfo->cur_comp_info[ci]->downsampled_width,
+				(cinfo->emethods, cinfo->cur_comp_info[ci]->downsampled_width,
 				(int ) (vs * (DCTSIZE+2)));
     /* Create space for the scrambled-order pointers */
     sampled_data[1][ci] = (JSAMPARRAY) (*cinfo->emethods->alloc_small)
-				(vs * (DCTSIZE+2) * SIZEOF(JSAMPROW));
+				(cinfo->emethods, vs * (DCTSIZE+2) * SIZEOF(JSAMPROW));
     /* Duplicate the first DCTSIZE-2 row groups */
     for (i = 0; i < vs * (DCTSIZE-2); i++) {
       sampled_data[1][ci][i] = sampled_data[0][ci][i];
@@ -278,14 +273,14 @@ free_sampling_buffer (decompress_info_ptr cinfo, JSAMPIMAGE sampled_data[2])
 
   for (ci = 0; ci < cinfo->comps_in_scan; ci++) {
     /* Free the real storage */
-    (*cinfo->emethods->free_small_sarray) (sampled_data[0][ci]);
+    (*cinfo->emethods->free_small_sarray) (cinfo->emethods, sampled_data[0][ci]);
     /* Free the scrambled-order pointers */
-    (*cinfo->emethods->free_small) ((void *) sampled_data[1][ci]);
+    (*cinfo->emethods->free_small) (cinfo->emethods, (void *) sampled_data[1][ci]);
   }
 
   /* Free the top-level space */
-  (*cinfo->emethods->free_small) ((void *) sampled_data[0]);
-  (*cinfo->emethods->free_small) ((void *) sampled_data[1]);
+  (*cinfo->emethods->free_small) (cinfo->emethods, (void *) sampled_data[0]);
+  (*cinfo->emethods->free_small) (cinfo->emethods, (void *) sampled_data[1]);
 }
 
 #endif
@@ -319,7 +314,7 @@ prepare_range_limit_table (decompress_info_ptr cinfo)
   int i;
 
   table = (JSAMPLE *) (*cinfo->emethods->alloc_small)
-			(3 * (MAXJSAMPLE+1) * SIZEOF(JSAMPLE));
+			(cinfo->emethods, 3 * (MAXJSAMPLE+1) * SIZEOF(JSAMPLE));
   cinfo->sample_range_limit = table + (MAXJSAMPLE+1);
   for (i = 0; i <= MAXJSAMPLE; i++) {
     table[i] = 0;			/* sample_range_limit[x] = 0 for x<0 */
@@ -404,13 +399,13 @@ emit_1pass (decompress_info_ptr cinfo, int num_rows, JSAMPIMAGE fullsize_data,
 {
   if (cinfo->quantize_colors) {
     (*cinfo->methods->color_quantize) (cinfo, num_rows, fullsize_data,
-				       output_workspace[0]);
+				       cinfo->output_workspace[0]);
   } else {
     (*cinfo->methods->color_convert) (cinfo, num_rows, cinfo->image_width,
-				      fullsize_data, output_workspace);
+				      fullsize_data, cinfo->output_workspace);
   }
     
-  (*cinfo->methods->put_pixel_rows) (cinfo, num_rows, output_workspace);
+  (*cinfo->methods->put_pixel_rows) (cinfo, num_rows, cinfo->output_workspace);
 }
 
 
@@ -430,22 +425,22 @@ scan_big_image (decompress_info_ptr cinfo, quantize_method_ptr quantize_method)
   short ci;
 
   for (pixel_rows_output = 0; pixel_rows_output < cinfo->image_height;
-       pixel_rows_output += rows_in_mem) {
+       pixel_rows_output += cinfo->rows_in_mem) {
     (*cinfo->methods->progress_monitor) (cinfo, pixel_rows_output,
 					 cinfo->image_height);
     /* Realign the big buffers */
     for (ci = 0; ci < cinfo->num_components; ci++) {
-      fullsize_ptrs[ci] = (*cinfo->emethods->access_big_sarray)
-	(fullsize_image[ci], pixel_rows_output, FALSE);
+      cinfo->fullsize_ptrs[ci] = (*cinfo->emethods->access_big_sarray)
+	(cinfo->emethods, cinfo->fullsize_image[ci], pixel_rows_output, FALSE);
     }
     /* Let the quantizer have its way with the data.
      * Note that output_workspace is simply workspace for the quantizer;
      * when it's ready to output, it must call put_pixel_rows itself.
      */
     (*quantize_method) (cinfo,
-			(int) MIN((int ) rows_in_mem,
+			(int) MIN((int ) cinfo->rows_in_mem,
 				  cinfo->image_height - pixel_rows_output),
-			fullsize_ptrs, output_workspace[0]);
+			cinfo->fullsize_ptrs, cinfo->output_workspace[0]);
   }
 
   cinfo->completed_passes++;
@@ -576,7 +571,7 @@ simple_dcontroller (decompress_info_ptr cinfo)
 
   /* Compute dimensions of full-size pixel buffers */
   /* Note these are the same whether interleaved or not. */
-  rows_in_mem = cinfo->max_v_samp_factor * DCTSIZE;
+  cinfo->rows_in_mem = cinfo->max_v_samp_factor * DCTSIZE;
   fullsize_width = jround_up(cinfo->image_width,
 			     (int ) (cinfo->max_h_samp_factor * DCTSIZE));
 
@@ -607,10 +602,10 @@ simple_dcontroller (decompress_info_ptr cinfo)
   alloc_sampling_buffer(cinfo, sampled_data);
   /* fullsize_data is sample data after upsampling */
   fullsize_data = alloc_sampimage(cinfo, (int) cinfo->num_components,
-				  (int ) rows_in_mem, fullsize_width);
+				  (int ) cinfo->rows_in_mem, fullsize_width);
   /* output_workspace is the color-processed data */
-  output_workspace = alloc_sampimage(cinfo, (int) cinfo->final_out_comps,
-				     (int ) rows_in_mem, fullsize_width);
+  cinfo->output_workspace = alloc_sampimage(cinfo, (int) cinfo->final_out_comps,
+				     (int ) cinfo->rows_in_mem, fullsize_width);
   prepare_range_limit_table(cinfo);
 
   /* Tell the memory manager to instantiate big arrays.
@@ -618,7 +613,8 @@ simple_dcontroller (decompress_info_ptr cinfo)
    * but some other module (like the output file writer) may need one.
    */
   (*cinfo->emethods->alloc_big_arrays)
-	((int ) 0,				/* no more small sarrays */
+	(cinfo->emethods,
+	 (int ) 0,				/* no more small sarrays */
 	 (int ) 0,				/* no more small barrays */
 	 (int ) 0);				/* no more "medium" objects */
   /* NB: if quantizer needs any "medium" size objects, it must get them */
@@ -680,8 +676,8 @@ simple_dcontroller (decompress_info_ptr cinfo)
 	     (short) DCTSIZE, (short) (DCTSIZE+1), (short) 0,
 	     (short) (DCTSIZE-1));
       /* and dump the previous set's expanded data */
-      emit_1pass (cinfo, rows_in_mem, fullsize_data, (JSAMPARRAY) NULL);
-      pixel_rows_output += rows_in_mem;
+      emit_1pass (cinfo, cinfo->rows_in_mem, fullsize_data, (JSAMPARRAY) NULL);
+      pixel_rows_output += cinfo->rows_in_mem;
       /* Expand first row group of this set */
       expand(cinfo, sampled_data[whichss], fullsize_data, fullsize_width,
 	     (short) (DCTSIZE+1), (short) 0, (short) 1,
@@ -768,33 +764,34 @@ complex_dcontroller (decompress_info_ptr cinfo)
 
   /* Compute dimensions of full-size pixel buffers */
   /* Note these are the same whether interleaved or not. */
-  rows_in_mem = cinfo->max_v_samp_factor * DCTSIZE;
+  cinfo->rows_in_mem = cinfo->max_v_samp_factor * DCTSIZE;
   fullsize_width = jround_up(cinfo->image_width,
 			     (int ) (cinfo->max_h_samp_factor * DCTSIZE));
 
   /* Allocate all working memory that doesn't depend on scan info */
   /* output_workspace is the color-processed data */
-  output_workspace = alloc_sampimage(cinfo, (int) cinfo->final_out_comps,
-				     (int ) rows_in_mem, fullsize_width);
+  cinfo->output_workspace = alloc_sampimage(cinfo, (int) cinfo->final_out_comps,
+				     (int ) cinfo->rows_in_mem, fullsize_width);
   prepare_range_limit_table(cinfo);
 
   /* Get a big image: fullsize_image is sample data after upsampling. */
-  fullsize_image = (big_sarray_ptr *) (*cinfo->emethods->alloc_small)
-			(cinfo->num_components * SIZEOF(big_sarray_ptr));
+  cinfo->fullsize_image = (big_sarray_ptr *) (*cinfo->emethods->alloc_small)
+			(cinfo->emethods, cinfo->num_components * SIZEOF(big_sarray_ptr));
   for (ci = 0; ci < cinfo->num_components; ci++) {
-    fullsize_image[ci] = (*cinfo->emethods->request_big_sarray)
-			(fullsize_width,
-			 jround_up(cinfo->image_height, (int ) rows_in_mem),
-			 (int ) rows_in_mem);
+    cinfo->fullsize_image[ci] = (*cinfo->emethods->request_big_sarray)
+			(cinfo->emethods, fullsize_width,
+			 jround_up(cinfo->image_height, (int ) cinfo->rows_in_mem),
+			 (int ) cinfo->rows_in_mem);
   }
   /* Also get an area for pointers to currently accessible chunks */
-  fullsize_ptrs = (JSAMPIMAGE) (*cinfo->emethods->alloc_small)
-				(cinfo->num_components * SIZEOF(JSAMPARRAY));
+  cinfo->fullsize_ptrs = (JSAMPIMAGE) (*cinfo->emethods->alloc_small)
+				(cinfo->emethods, cinfo->num_components * SIZEOF(JSAMPARRAY));
 
   /* Tell the memory manager to instantiate big arrays */
   (*cinfo->emethods->alloc_big_arrays)
+	(cinfo->emethods,
 	 /* extra sarray space is for downsampled-data buffers: */
-	((int ) (fullsize_width			/* max width in samples */
+	 (int ) (fullsize_width			/* max width in samples */
 	 * cinfo->max_v_samp_factor*(DCTSIZE+2)	/* max height */
 	 * cinfo->num_components),		/* max components per scan */
 	 /* extra barray space is for MCU-row buffers: */
@@ -863,8 +860,8 @@ complex_dcontroller (decompress_info_ptr cinfo)
 
     /* line up the big buffers for components in this scan */
     for (ci = 0; ci < cinfo->comps_in_scan; ci++) {
-      fullsize_ptrs[ci] = (*cinfo->emethods->access_big_sarray)
-	(fullsize_image[cinfo->cur_comp_info[ci]->component_index],
+      cinfo->fullsize_ptrs[ci] = (*cinfo->emethods->access_big_sarray)
+	(cinfo->emethods, cinfo->fullsize_image[cinfo->cur_comp_info[ci]->component_index],
 	 (int ) 0, TRUE);
     }
     
@@ -920,34 +917,34 @@ complex_dcontroller (decompress_info_ptr cinfo)
       
       if (cur_mcu_row) {
 	/* Expand last row group of previous set */
-	expand(cinfo, sampled_data[whichss], fullsize_ptrs, fullsize_width,
+	expand(cinfo, sampled_data[whichss], cinfo->fullsize_ptrs, fullsize_width,
 	       (short) DCTSIZE, (short) (DCTSIZE+1), (short) 0,
 	       (short) (DCTSIZE-1));
 	/* If single scan, can do color quantization prescan on-the-fly */
 	if (single_scan)
-	  (*cinfo->methods->color_quant_prescan) (cinfo, rows_in_mem,
-						  fullsize_ptrs,
-						  output_workspace[0]);
+	  (*cinfo->methods->color_quant_prescan) (cinfo, cinfo->rows_in_mem,
+						  cinfo->fullsize_ptrs,
+						  cinfo->output_workspace[0]);
 	/* Realign the big buffers */
-	pixel_rows_output += rows_in_mem;
+	pixel_rows_output += cinfo->rows_in_mem;
 	for (ci = 0; ci < cinfo->comps_in_scan; ci++) {
-	  fullsize_ptrs[ci] = (*cinfo->emethods->access_big_sarray)
-	    (fullsize_image[cinfo->cur_comp_info[ci]->component_index],
+	  cinfo->fullsize_ptrs[ci] = (*cinfo->emethods->access_big_sarray)
+	    (cinfo->emethods, cinfo->fullsize_image[cinfo->cur_comp_info[ci]->component_index],
 	     pixel_rows_output, TRUE);
 	}
 	/* Expand first row group of this set */
-	expand(cinfo, sampled_data[whichss], fullsize_ptrs, fullsize_width,
+	expand(cinfo, sampled_data[whichss], cinfo->fullsize_ptrs, fullsize_width,
 	       (short) (DCTSIZE+1), (short) 0, (short) 1,
 	       (short) 0);
       } else {
 	/* Expand first row group with dummy above-context */
-	expand(cinfo, sampled_data[whichss], fullsize_ptrs, fullsize_width,
+	expand(cinfo, sampled_data[whichss], cinfo->fullsize_ptrs, fullsize_width,
 	       (short) (-1), (short) 0, (short) 1,
 	       (short) 0);
       }
       /* Expand second through next-to-last row groups of this set */
       for (i = 1; i <= DCTSIZE-2; i++) {
-	expand(cinfo, sampled_data[whichss], fullsize_ptrs, fullsize_width,
+	expand(cinfo, sampled_data[whichss], cinfo->fullsize_ptrs, fullsize_width,
 	       (short) (i-1), (short) i, (short) (i+1),
 	       (short) i);
       }
@@ -955,14 +952,14 @@ complex_dcontroller (decompress_info_ptr cinfo)
     
     /* Expand the last row group with dummy below-context */
     /* Note whichss points to last buffer side used */
-    expand(cinfo, sampled_data[whichss], fullsize_ptrs, fullsize_width,
+    expand(cinfo, sampled_data[whichss], cinfo->fullsize_ptrs, fullsize_width,
 	   (short) (DCTSIZE-2), (short) (DCTSIZE-1), (short) (-1),
 	   (short) (DCTSIZE-1));
     /* If single scan, finish on-the-fly color quantization prescan */
     if (single_scan)
       (*cinfo->methods->color_quant_prescan) (cinfo,
 			(int) (cinfo->image_height - pixel_rows_output),
-			fullsize_ptrs, output_workspace[0]);
+			cinfo->fullsize_ptrs, cinfo->output_workspace[0]);
     
     /* Clean up after the scan */
     (*cinfo->methods->disassemble_term) (cinfo);
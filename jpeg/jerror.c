@@ -30,11 +30,8 @@
 #endif
 
 
-static external_methods_ptr methods; /* saved for access to message_parm, free_all */
-
-
 METHODDEF void
-trace_message (const char *msgtext)
+trace_message (external_methods_ptr methods, const char *msgtext)
 {
   fprintf(stderr, msgtext,
 	  methods->message_parm[0], methods->message_parm[1],
@@ -46,10 +43,10 @@ trace_message (const char *msgtext)
 
 
 METHODDEF void
-error_exit (const char *msgtext)
+error_exit (external_methods_ptr methods, const char *msgtext)
 {
-  (*methods->trace_message) (msgtext);
-  (*methods->free_all) ();	/* clean up memory allocation */
+  (*methods->trace_message) (methods, msgtext);
+  (*methods->free_all) (methods);	/* clean up memory allocation */
   exit(EXIT_FAILURE);
 }
 
@@ -63,8 +60,6 @@ error_exit (const char *msgtext)
 GLOBAL void
 jselerror (external_methods_ptr emethods)
 {
-  methods = emethods;		/* save struct addr for later access */
-
   emethods->error_exit = error_exit;
   emethods->trace_message = trace_message;
 
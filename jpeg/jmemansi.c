@@ -126,10 +126,11 @@ close_backing_store (backing_store_ptr info)
  */
 
 GLOBAL void
-jopen_backing_store (backing_store_ptr info, int  total_bytes_needed)
+jopen_backing_store (external_methods_ptr emethods, backing_store_ptr info,
+		     int  total_bytes_needed)
 {
   if ((info->temp_file = tmpfile()) == NULL)
-    ERREXIT(methods, "Failed to create temporary file");
+    ERREXIT(emethods, "Failed to create temporary file");
   info->read_backing_store = read_backing_store;
   info->write_backing_store = write_backing_store;
   info->close_backing_store = close_backing_store;
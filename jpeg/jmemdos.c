@@ -574,7 +574,8 @@ open_ems_store (backing_store_ptr info, int  total_bytes_needed)
  */
 
 GLOBAL void
-jopen_backing_store (backing_store_ptr info, int  total_bytes_needed)
+jopen_backing_store (external_methods_ptr emethods, backing_store_ptr info,
+		     int  total_bytes_needed)
 {
   /* Try extended memory, then expanded memory, then regular file. */
 #if XMS_SUPPORTED
@@ -587,7 +588,7 @@ jopen_backing_store (backing_store_ptr info, int  total_bytes_needed)
 #endif
   if (open_file_store(info, total_bytes_needed))
     return;
-  ERREXIT(methods, "Failed to create temporary file");
+  ERREXIT(emethods, "Failed to create temporary file");
 }
 
 
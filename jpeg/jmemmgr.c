@@ -89,9 +89,6 @@ typedef double align_type;
  */
 
 
-static external_methods_ptr methods; /* saved for access to error_exit */
-
-
 #ifdef MEM_STATS		/* optional extra stuff for statistics */
 
 /* These macros are the assumed overhead per block for malloc().
@@ -161,7 +158,7 @@ print_mem_stats (void)
 
 
 LOCAL void
-out_of_memory (int which)
+out_of_memory (external_methods_ptr methods, int which)
 /* Report an out-of-memory error and stop execution */
 /* If we compiled MEM_STATS support, report alloc requests before dying */
 {
@@ -185,11 +182,10 @@ typedef union small_struct {
 	align_type dummy;	/* ensures alignment of following storage */
       } small_hdr;
 
-static small_ptr small_list;	/* head of list */
 
 
 METHODDEF void *
-alloc_small (size_t sizeofobject)
+alloc_small (external_methods_ptr methods, size_t sizeofobject)
 /* Allocate a "small" object */
 {
   small_ptr result;
@@ -205,10 +201,10 @@ alloc_small (size_t sizeofobject)
 
   result = (small_ptr) jget_small(sizeofobject);
   if (result == NULL)
-    out_of_memory(1);
+    out_of_memory(methods, 1);
 
-  result->next = small_list;
-  small_list = result;
+  result->next = methods->small_list;
+  methods->small_list = result;
   result++;			/* advance past header */
 
   return (void *) result;
@@ -216,7 +212,7 @@ alloc_small (size_t sizeofobject)
 
 
 METHODDEF void
-free_small (void *ptr)
+free_small (external_methods_ptr methods, void *ptr)
 /* Free a "small" object */
 {
   small_ptr hdr;
@@ -226,7 +222,7 @@ free_small (void *ptr)
   hdr--;			/* point back to header */
 
   /* Remove item from list -- linear search is fast enough */
-  llink = &small_list;
+  llink = &methods->small_list;
   while (*llink != hdr) {
     if (*llink == NULL)
       ERREXIT(methods, "Bogus free_small request");
@@ -256,11 +252,10 @@ typedef union medium_struct {
 	align_type dummy;	/* ensures alignment of following storage */
       } medium_hdr;
 
-static medium_ptr medium_list;	/* head of list */
 
 
 METHODDEF void FAR *
-alloc_medium (size_t sizeofobject)
+alloc_medium (external_methods_ptr methods, size_t sizeofobject)
 /* Allocate a "medium-size" object */
 {
   medium_ptr result;
@@ -276,10 +271,10 @@ alloc_medium (size_t sizeofobject)
 
   result = (medium_ptr) jget_large(sizeofobject);
   if (result == NULL)
-    out_of_memory(2);
+    out_of_memory(methods, 2);
 
-  result->next = medium_list;
-  medium_list = result;
+  result->next = methods->medium_list;
+  methods->medium_list = result;
   result++;			/* advance past header */
 
   return (void FAR *) result;
@@ -287,7 +282,7 @@ alloc_medium (size_t sizeofobject)
 
 
 METHODDEF void
-free_medium (void FAR *ptr)
+free_medium (external_methods_ptr methods, void FAR *ptr)
 /* Free a "medium-size" object */
 {
   medium_ptr hdr;
@@ -297,7 +292,7 @@ free_medium (void FAR *ptr)
   hdr--;			/* point back to header */
 
   /* Remove item from list -- linear search is fast enough */
-  llink = &medium_list;
+  llink = &methods->medium_list;
   while (*llink != hdr) {
     if (*llink == NULL)
       ERREXIT(methods, "Bogus free_medium request");
@@ -335,11 +330,10 @@ typedef struct small_sarray_struct {
 	JSAMPROW dummy;		/* ensures alignment of following storage */
       } small_sarray_hdr;
 
-static small_sarray_ptr small_sarray_list; /* head of list */
 
 
 METHODDEF JSAMPARRAY
-alloc_small_sarray (int  samplesperrow, int  numrows)
+alloc_small_sarray (external_methods_ptr methods, int  samplesperrow, int  numrows)
 /* Allocate a "small" (all-in-memory) 2-D sample array */
 {
   small_sarray_ptr hdr;
@@ -359,17 +353,17 @@ alloc_small_sarray (int  samplesperrow, int  numrows)
       ERREXIT(methods, "Image too wide for this implementation");
 
   /* Get space for header and row pointers; this is always "near" on 80x86 */
-  hdr = (small_sarray_ptr) alloc_small((size_t) (numrows * SIZEOF(JSAMPROW)
+  hdr = (small_sarray_ptr) alloc_small(methods, (size_t) (numrows * SIZEOF(JSAMPROW)
 						 + SIZEOF(small_sarray_hdr)));
 
   result = (JSAMPARRAY) (hdr+1); /* advance past header */
 
   /* Insert into list now so free_all does right thing if I fail */
   /* after allocating only some of the rows... */
-  hdr->next = small_sarray_list;
+  hdr->next = methods->small_sarray_list;
   hdr->numrows = 0;
   hdr->rowsperchunk = rowsperchunk;
-  small_sarray_list = hdr;
+  methods->small_sarray_list = hdr;
 
   /* Get the rows themselves; on 80x86 these are "far" */
   currow = 0;
@@ -382,7 +376,7 @@ alloc_small_sarray (int  samplesperrow, int  numrows)
     workspace = (JSAMPROW) jget_large((size_t) (rowsperchunk * samplesperrow
 						* SIZEOF(JSAMPLE)));
     if (workspace == NULL)
-      out_of_memory(3);
+      out_of_memory(methods, 3);
     for (i = rowsperchunk; i > 0; i--) {
       result[currow++] = workspace;
       workspace += samplesperrow;
@@ -395,7 +389,7 @@ alloc_small_sarray (int  samplesperrow, int  numrows)
 
 
 METHODDEF void
-free_small_sarray (JSAMPARRAY ptr)
+free_small_sarray (external_methods_ptr methods, JSAMPARRAY ptr)
 /* Free a "small" (all-in-memory) 2-D sample array */
 {
   small_sarray_ptr hdr;
@@ -406,7 +400,7 @@ free_small_sarray (JSAMPARRAY ptr)
   hdr--;			/* point back to header */
 
   /* Remove item from list -- linear search is fast enough */
-  llink = &small_sarray_list;
+  llink = &methods->small_sarray_list;
   while (*llink != hdr) {
     if (*llink == NULL)
       ERREXIT(methods, "Bogus free_small_sarray request");
@@ -421,7 +415,7 @@ free_small_sarray (JSAMPARRAY ptr)
   }
 
   /* Free header and row pointers */
-  free_small((void *) hdr);
+  free_small(methods, (void *) hdr);
 
 #ifdef MEM_STATS
   cur_num_sarray--;
@@ -443,11 +437,10 @@ typedef struct small_barray_struct {
 	JBLOCKROW dummy;	/* ensures alignment of following storage */
       } small_barray_hdr;
 
-static small_barray_ptr small_barray_list; /* head of list */
 
 
 METHODDEF JBLOCKARRAY
-alloc_small_barray (int  blocksperrow, int  numrows)
+alloc_small_barray (external_methods_ptr methods, int  blocksperrow, int  numrows)
 /* Allocate a "small" (all-in-memory) 2-D coefficient-block array */
 {
   small_barray_ptr hdr;
@@ -467,17 +460,17 @@ alloc_small_barray (int  blocksperrow, int  numrows)
       ERREXIT(methods, "Image too wide for this implementation");
 
   /* Get space for header and row pointers; this is always "near" on 80x86 */
-  hdr = (small_barray_ptr) alloc_small((size_t) (numrows * SIZEOF(JBLOCKROW)
+  hdr = (small_barray_ptr) alloc_small(methods, (size_t) (numrows * SIZEOF(JBLOCKROW)
 						 + SIZEOF(small_barray_hdr)));
 
   result = (JBLOCKARRAY) (hdr+1); /* advance past header */
 
   /* Insert into list now so free_all does right thing if I fail */
   /* after allocating only some of the rows... */
-  hdr->next = small_barray_list;
+  hdr->next = methods->small_barray_list;
   hdr->numrows = 0;
   hdr->rowsperchunk = rowsperchunk;
-  small_barray_list = hdr;
+  methods->small_barray_list = hdr;
 
   /* Get the rows themselves; on 80x86 these are "far" */
   currow = 0;
@@ -490,7 +483,7 @@ alloc_small_barray (int  blocksperrow, int  numrows)
     workspace = (JBLOCKROW) jget_large((size_t) (rowsperchunk * blocksperrow
 						 * SIZEOF(JBLOCK)));
     if (workspace == NULL)
-      out_of_memory(4);
+      out_of_memory(methods, 4);
     for (i = rowsperchunk; i > 0; i--) {
       result[currow++] = workspace;
       workspace += blocksperrow;
@@ -503,7 +496,7 @@ alloc_small_barray (int  blocksperrow, int  numrows)
 
 
 METHODDEF void
-free_small_barray (JBLOCKARRAY ptr)
+free_small_barray (external_methods_ptr methods, JBLOCKARRAY ptr)
 /* Free a "small" (all-in-memory) 2-D coefficient-block array */
 {
   small_barray_ptr hdr;
@@ -514,7 +507,7 @@ free_small_barray (JBLOCKARRAY ptr)
   hdr--;			/* point back to header */
 
   /* Remove item from list -- linear search is fast enough */
-  llink = &small_barray_list;
+  llink = &methods->small_barray_list;
   while (*llink != hdr) {
     if (*llink == NULL)
       ERREXIT(methods, "Bogus free_small_barray request");
@@ -529,7 +522,7 @@ free_small_barray (JBLOCKARRAY ptr)
   }
 
   /* Free header and row pointers */
-  free_small((void *) hdr);
+  free_small(methods, (void *) hdr);
 
 #ifdef MEM_STATS
   cur_num_barray--;
@@ -608,7 +601,6 @@ struct big_sarray_control {
 	backing_store_info b_s_info; /* System-dependent control info */
 };
 
-static big_sarray_ptr big_sarray_list; /* head of list */
 
 struct big_barray_control {
 	int  rows_in_array;	/* total virtual array height */
@@ -624,53 +616,52 @@ struct big_barray_control {
 	backing_store_info b_s_info; /* System-dependent control info */
 };
 
-static big_barray_ptr big_barray_list; /* head of list */
 
 
 METHODDEF big_sarray_ptr
-request_big_sarray (int  samplesperrow, int  numrows, int  unitheight)
+request_big_sarray (external_methods_ptr methods, int  samplesperrow, int  numrows, int  unitheight)
 /* Request a "big" (virtual-memory) 2-D sample array */
 {
   big_sarray_ptr result;
 
   /* get control block */
-  result = (big_sarray_ptr) alloc_small(SIZEOF(struct big_sarray_control));
+  result = (big_sarray_ptr) alloc_small(methods, SIZEOF(struct big_sarray_control));
 
   result->rows_in_array = numrows;
   result->samplesperrow = samplesperrow;
   result->unitheight = unitheight;
   result->mem_buffer = NULL;	/* marks array not yet realized */
   result->b_s_open = FALSE;	/* no associated backing-store object */
-  result->next = big_sarray_list; /* add to list of big arrays */
-  big_sarray_list = result;
+  result->next = methods->big_sarray_list; /* add to list of big arrays */
+  methods->big_sarray_list = result;
 
   return result;
 }
 
 
 METHODDEF big_barray_ptr
-request_big_barray (int  blocksperrow, int  numrows, int  unitheight)
+request_big_barray (external_methods_ptr methods, int  blocksperrow, int  numrows, int  unitheight)
 /* Request a "big" (virtual-memory) 2-D coefficient-block array */
 {
   big_barray_ptr result;
 
   /* get control block */
-  result = (big_barray_ptr) alloc_small(SIZEOF(struct big_barray_control));
+  result = (big_barray_ptr) alloc_small(methods, SIZEOF(struct big_barray_control));
 
   result->rows_in_array = numrows;
   result->blocksperrow = blocksperrow;
   result->unitheight = unitheight;
   result->mem_buffer = NULL;	/* marks array not yet realized */
   result->b_s_open = FALSE;	/* no associated backing-store object */
-  result->next = big_barray_list; /* add to list of big arrays */
-  big_barray_list = result;
+  result->next = methods->big_barray_list; /* add to list of big arrays */
+  methods->big_barray_list = result;
 
   return result;
 }
 
 
 METHODDEF void
-alloc_big_arrays (int  extra_small_samples, int  extra_small_blocks,
+alloc_big_arrays (external_methods_ptr methods, int  extra_small_samples, int  extra_small_blocks,
 		  int  extra_medium_space)
 /* Allocate the in-memory buffers for any unrealized "big" arrays */
 /* 'extra' values are upper bounds for total future small-array requests */
@@ -690,7 +681,7 @@ alloc_big_arrays (int  extra_small_samples, int  extra_small_blocks,
    */
   space_per_unitheight = 0;
   maximum_space = total_extra_space;
-  for (sptr = big_sarray_list; sptr != NULL; sptr = sptr->next) {
+  for (sptr = methods->big_sarray_list; sptr != NULL; sptr = sptr->next) {
     if (sptr->mem_buffer == NULL) { /* if not realized yet */
       space_per_unitheight += sptr->unitheight *
 			      sptr->samplesperrow * SIZEOF(JSAMPLE);
@@ -698,7 +689,7 @@ alloc_big_arrays (int  extra_small_samples, int  extra_small_blocks,
 		       sptr->samplesperrow * SIZEOF(JSAMPLE);
     }
   }
-  for (bptr = big_barray_list; bptr != NULL; bptr = bptr->next) {
+  for (bptr = methods->big_barray_list; bptr != NULL; bptr = bptr->next) {
     if (bptr->mem_buffer == NULL) { /* if not realized yet */
       space_per_unitheight += bptr->unitheight *
 			      bptr->blocksperrow * SIZEOF(JBLOCK);
@@ -731,7 +722,7 @@ alloc_big_arrays (int  extra_small_samples, int  extra_small_blocks,
 
   /* Allocate the in-memory buffers and initialize backing store as needed. */
 
-  for (sptr = big_sarray_list; sptr != NULL; sptr = sptr->next) {
+  for (sptr = methods->big_sarray_list; sptr != NULL; sptr = sptr->next) {
     if (sptr->mem_buffer == NULL) { /* if not realized yet */
       unitheights = (sptr->rows_in_array + sptr->unitheight - 1L)
 		    / sptr->unitheight;
@@ -741,12 +732,12 @@ alloc_big_arrays (int  extra_small_samples, int  extra_small_blocks,
       } else {
 	/* It doesn't fit in memory, create backing store. */
 	sptr->rows_in_mem = max_unitheights * sptr->unitheight;
-	jopen_backing_store(& sptr->b_s_info,
+	jopen_backing_store(methods, & sptr->b_s_info,
 			    (int ) (sptr->rows_in_array *
 				    sptr->samplesperrow * SIZEOF(JSAMPLE)));
 	sptr->b_s_open = TRUE;
       }
-      sptr->mem_buffer = alloc_small_sarray(sptr->samplesperrow,
+      sptr->mem_buffer = alloc_small_sarray(methods, sptr->samplesperrow,
 					    sptr->rows_in_mem);
       /* Reach into the small_sarray header and get the rowsperchunk field.
        * Yes, I know, this is horrible coding practice.
@@ -758,7 +749,7 @@ alloc_big_arrays (int  extra_small_samples, int  extra_small_blocks,
     }
   }
 
-  for (bptr = big_barray_list; bptr != NULL; bptr = bptr->next) {
+  for (bptr = methods->big_barray_list; bptr != NULL; bptr = bptr->next) {
     if (bptr->mem_buffer == NULL) { /* if not realized yet */
       unitheights = (bptr->rows_in_array + bptr->unitheight - 1L)
 		    / bptr->unitheight;
@@ -768,12 +759,12 @@ alloc_big_arrays (int  extra_small_samples, int  extra_small_blocks,
       } else {
 	/* It doesn't fit in memory, create backing store. */
 	bptr->rows_in_mem = max_unitheights * bptr->unitheight;
-	jopen_backing_store(& bptr->b_s_info,
+	jopen_backing_store(methods, & bptr->b_s_info,
 			    (int ) (bptr->rows_in_array *
 				    bptr->blocksperrow * SIZEOF(JBLOCK)));
 	bptr->b_s_open = TRUE;
       }
-      bptr->mem_buffer = alloc_small_barray(bptr->blocksperrow,
+      bptr->mem_buffer = alloc_small_barray(methods, bptr->blocksperrow,
 					    bptr->rows_in_mem);
       /* Reach into the small_barray header and get the rowsperchunk field. */
       bptr->rowsperchunk =
@@ -786,7 +777,7 @@ alloc_big_arrays (int  extra_small_samples, int  extra_small_blocks,
 
 
 LOCAL void
-do_sarray_io (big_sarray_ptr ptr, boolean writing)
+do_sarray_io (external_methods_ptr methods, big_sarray_ptr ptr, boolean writing)
 /* Do backing store read or write of a "big" sample array */
 {
   int  bytesperrow, file_offset, byte_count, rows, i;
@@ -816,7 +807,7 @@ do_sarray_io (big_sarray_ptr ptr, boolean writing)
 
 
 LOCAL void
-do_barray_io (big_barray_ptr ptr, boolean writing)
+do_barray_io (external_methods_ptr methods, big_barray_ptr ptr, boolean writing)
 /* Do backing store read or write of a "big" coefficient-block array */
 {
   int  bytesperrow, file_offset, byte_count, rows, i;
@@ -846,7 +837,7 @@ do_barray_io (big_barray_ptr ptr, boolean writing)
 
 
 METHODDEF JSAMPARRAY
-access_big_sarray (big_sarray_ptr ptr, int  start_row, boolean writable)
+access_big_sarray (external_methods_ptr methods, big_sarray_ptr ptr, int  start_row, boolean writable)
 /* Access the part of a "big" sample array starting at start_row */
 /* and extending for ptr->unitheight rows.  writable is true if  */
 /* caller intends to modify the accessed area. */
@@ -863,7 +854,7 @@ access_big_sarray (big_sarray_ptr ptr, int  start_row, boolean writable)
       ERREXIT(methods, "Virtual array controller messed up");
     /* Flush old buffer contents if necessary */
     if (ptr->dirty) {
-      do_sarray_io(ptr, TRUE);
+      do_sarray_io(methods, ptr, TRUE);
       ptr->dirty = FALSE;
     }
     /* Decide what part of virtual array to access.
@@ -885,7 +876,7 @@ access_big_sarray (big_sarray_ptr ptr, int  start_row, boolean writable)
      * since the access sequence constraints ensure it would be garbage.
      */
     if (! writable) {
-      do_sarray_io(ptr, FALSE);
+      do_sarray_io(methods, ptr, FALSE);
     }
   }
   /* Flag the buffer dirty if caller will write in it */
@@ -897,7 +888,7 @@ access_big_sarray (big_sarray_ptr ptr, int  start_row, boolean writable)
 
 
 METHODDEF JBLOCKARRAY
-access_big_barray (big_barray_ptr ptr, int  start_row, boolean writable)
+access_big_barray (external_methods_ptr methods, big_barray_ptr ptr, int  start_row, boolean writable)
 /* Access the part of a "big" coefficient-block array starting at start_row */
 /* and extending for ptr->unitheight rows.  writable is true if  */
 /* caller intends to modify the accessed area. */
@@ -914,7 +905,7 @@ access_big_barray (big_barray_ptr ptr, int  start_row, boolean writable)
       ERREXIT(methods, "Virtual array controller messed up");
     /* Flush old buffer contents if necessary */
     if (ptr->dirty) {
-      do_barray_io(ptr, TRUE);
+      do_barray_io(methods, ptr, TRUE);
       ptr->dirty = FALSE;
     }
     /* Decide what part of virtual array to access.
@@ -936,7 +927,7 @@ access_big_barray (big_barray_ptr ptr, int  start_row, boolean writable)
      * since the access sequence constraints ensure it would be garbage.
      */
     if (! writable) {
-      do_barray_io(ptr, FALSE);
+      do_barray_io(methods, ptr, FALSE);
     }
   }
   /* Flag the buffer dirty if caller will write in it */
@@ -948,13 +939,13 @@ access_big_barray (big_barray_ptr ptr, int  start_row, boolean writable)
 
 
 METHODDEF void
-free_big_sarray (big_sarray_ptr ptr)
+free_big_sarray (external_methods_ptr methods, big_sarray_ptr ptr)
 /* Free a "big" (virtual-memory) 2-D sample array */
 {
   big_sarray_ptr * llink;
 
   /* Remove item from list -- linear search is fast enough */
-  llink = &big_sarray_list;
+  llink = &methods->big_sarray_list;
   while (*llink != ptr) {
     if (*llink == NULL)
       ERREXIT(methods, "Bogus free_big_sarray request");
@@ -966,20 +957,20 @@ free_big_sarray (big_sarray_ptr ptr)
     (*ptr->b_s_info.close_backing_store) (& ptr->b_s_info);
 
   if (ptr->mem_buffer != NULL)	/* just in case never realized */
-    free_small_sarray(ptr->mem_buffer);
+    free_small_sarray(methods, ptr->mem_buffer);
 
-  free_small((void *) ptr);	/* free the control block too */
+  free_small(methods, (void *) ptr);	/* free the control block too */
 }
 
 
 METHODDEF void
-free_big_barray (big_barray_ptr ptr)
+free_big_barray (external_methods_ptr methods, big_barray_ptr ptr)
 /* Free a "big" (virtual-memory) 2-D coefficient-block array */
 {
   big_barray_ptr * llink;
 
   /* Remove item from list -- linear search is fast enough */
-  llink = &big_barray_list;
+  llink = &methods->big_barray_list;
   while (*llink != ptr) {
     if (*llink == NULL)
       ERREXIT(methods, "Bogus free_big_barray request");
@@ -991,9 +982,9 @@ free_big_barray (big_barray_ptr ptr)
     (*ptr->b_s_info.close_backing_store) (& ptr->b_s_info);
 
   if (ptr->mem_buffer != NULL)	/* just in case never realized */
-    free_small_barray(ptr->mem_buffer);
+    free_small_barray(methods, ptr->mem_buffer);
 
-  free_small((void *) ptr);	/* free the control block too */
+  free_small(methods, (void *) ptr);	/* free the control block too */
 }
 
 
@@ -1002,25 +993,25 @@ free_big_barray (big_barray_ptr ptr)
  */
 
 METHODDEF void
-free_all (void)
+free_all (external_methods_ptr methods)
 {
   /* First free any open "big" arrays -- these may release small arrays */
-  while (big_sarray_list != NULL)
-    free_big_sarray(big_sarray_list);
-  while (big_barray_list != NULL)
-    free_big_barray(big_barray_list);
+  while (methods->big_sarray_list != NULL)
+    free_big_sarray(methods, methods->big_sarray_list);
+  while (methods->big_barray_list != NULL)
+    free_big_barray(methods, methods->big_barray_list);
   /* Free any open small arrays -- these may release small objects */
   /* +1's are because we must pass a pointer to the data, not the header */
-  while (small_sarray_list != NULL)
-    free_small_sarray((JSAMPARRAY) (small_sarray_list + 1));
-  while (small_barray_list != NULL)
-    free_small_barray((JBLOCKARRAY) (small_barray_list + 1));
+  while (methods->small_sarray_list != NULL)
+    free_small_sarray(methods, (JSAMPARRAY) (methods->small_sarray_list + 1));
+  while (methods->small_barray_list != NULL)
+    free_small_barray(methods, (JBLOCKARRAY) (methods->small_barray_list + 1));
   /* Free any remaining small objects */
-  while (small_list != NULL)
-    free_small((void *) (small_list + 1));
+  while (methods->small_list != NULL)
+    free_small(methods, (void *) (methods->small_list + 1));
 #ifdef NEED_ALLOC_MEDIUM
-  while (medium_list != NULL)
-    free_medium((void FAR *) (medium_list + 1));
+  while (methods->medium_list != NULL)
+    free_medium(methods, (void FAR *) (methods->medium_list + 1));
 #endif
 
   jmem_term();			/* system-dependent cleanup */
@@ -1041,8 +1032,6 @@ free_all (void)
 GLOBAL void
 jselmemmgr (external_methods_ptr emethods)
 {
-  methods = emethods;		/* save struct addr for error exit access */
-
   emethods->alloc_small = alloc_small;
   emethods->free_small = free_small;
 #ifdef NEED_ALLOC_MEDIUM
@@ -1066,14 +1055,14 @@ jselmemmgr (external_methods_ptr emethods)
   emethods->free_all = free_all;
 
   /* Initialize list headers to empty */
-  small_list = NULL;
+  emethods->small_list = NULL;
 #ifdef NEED_ALLOC_MEDIUM
-  medium_list = NULL;
+  emethods->medium_list = NULL;
 #endif
-  small_sarray_list = NULL;
-  small_barray_list = NULL;
-  big_sarray_list = NULL;
-  big_barray_list = NULL;
+  emethods->small_sarray_list = NULL;
+  emethods->small_barray_list = NULL;
+  emethods->big_sarray_list = NULL;
+  emethods->big_barray_list = NULL;
 
   jmem_init(emethods);		/* system-dependent initialization */
 
@@ -211,7 +211,8 @@ close_backing_store (backing_store_ptr info)
 
 
 GLOBAL void
-jopen_backing_store (backing_store_ptr info, int  total_bytes_needed)
+jopen_backing_store (external_methods_ptr emethods, backing_store_ptr info,
+		     int  total_bytes_needed)
 {
   char tracemsg[TEMP_NAME_LENGTH+40];
 
@@ -219,14 +220,14 @@ jopen_backing_store (backing_store_ptr info, int  total_bytes_needed)
   if ((info->temp_file = fopen(info->temp_name, RW_BINARY)) == NULL) {
     /* hack to get around ERREXIT's inability to handle string parameters */
     sprintf(tracemsg, "Failed to create temporary file %s", info->temp_name);
-    ERREXIT(methods, tracemsg);
+    ERREXIT(emethods, tracemsg);
   }
   info->read_backing_store = read_backing_store;
   info->write_backing_store = write_backing_store;
   info->close_backing_store = close_backing_store;
   /* hack to get around TRACEMS' inability to handle string parameters */
   sprintf(tracemsg, "Using temp file %s", info->temp_name);
-  TRACEMS(methods, 1, tracemsg);
+  TRACEMS(emethods, 1, tracemsg);
 }
 
 
@@ -26,9 +26,6 @@ extern void free PP((void *ptr));
 #endif
 
 
-static external_methods_ptr methods; /* saved for access to error_exit */
-
-
 /*
  * Memory allocation and freeing are controlled by the regular library
  * routines malloc() and free().
@@ -70,9 +67,10 @@ jmem_available (int  min_bytes_needed, int  max_bytes_needed)
  */
 
 GLOBAL void
-jopen_backing_store (backing_store_ptr info, int  total_bytes_needed)
+jopen_backing_store (external_methods_ptr emethods, backing_store_ptr info,
+		     int  total_bytes_needed)
 {
-  ERREXIT(methods, "Backing store not supported");
+  ERREXIT(emethods, "Backing store not supported");
 }
 
 
@@ -85,7 +83,6 @@ jopen_backing_store (backing_store_ptr info, int  total_bytes_needed)
 GLOBAL void
 jmem_init (external_methods_ptr emethods)
 {
-  methods = emethods;		/* save struct addr for error exit access */
   emethods->max_memory_to_use = 0;
 }
 
@@ -106,10 +106,12 @@ typedef struct backing_store_struct {
  * read/write/close pointers in the object.  The read/write routines
  * may take an error exit if the specified maximum file size is exceeded.
  * (If jmem_available always returns a large value, this routine can just
- * take an error exit.)
+ * take an error exit.)  The methods struct of the caller is passed in so
+ * that the error exit goes to the right compression or decompression.
  */
 
-EXTERN void jopen_backing_store PP((backing_store_ptr info,
+EXTERN void jopen_backing_store PP((external_methods_ptr emethods,
+				    backing_store_ptr info,
 				    int  total_bytes_needed));
 
 
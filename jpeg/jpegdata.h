@@ -325,6 +325,30 @@ struct Compress_info_struct {
 	JCOEF last_dc_diff[MAX_COMPS_IN_SCAN]; /* last DC diff for each comp */
 	UINT16 restarts_to_go;	/* MCUs left in this restart interval */
 	short next_restart_num;	/* # of next RSTn marker (0..7) */
+
+/*
+ * Working state of the individual compression modules.  This is kept here
+ * rather than in file-level statics so that several compressions can run
+ * at once, each with its own Compress_info_struct.
+ */
+	/* these fields are private data for the color converter (jccolor.c) */
+	JSAMPARRAY color_pixel_row; /* workspace for a pixel row in input format */
+	INT32 * rgb_ycc_tab;	/* => table for RGB to YCbCr conversion */
+
+	/* these fields are private data for the Huffman encoder (jchuff.c) */
+	INT32 huff_put_buffer;	/* current bit-accumulation buffer */
+	int huff_put_bits;	/* # of bits now in it */
+	char * huff_output_buffer; /* output buffer */
+	int huff_bytes_in_buffer; /* # of bytes now in it */
+	int * dc_count_ptrs[NUM_HUFF_TBLS]; /* symbol counts for optimization */
+	int * ac_count_ptrs[NUM_HUFF_TBLS];
+
+	/* these fields are private data for the pipeline controller (jcpipe.c) */
+	struct big_barray_control * whole_scan_MCUs; /* MCUs saved for a scan */
+	int MCUs_in_big_row;	/* # of MCUs in each row of whole_scan_MCUs */
+	int next_whole_row;	/* next row to access in whole_scan_MCUs */
+	int next_MCU_index;	/* next MCU in current row */
+	JBLOCKARRAY MCU_rowptr;	/* current row of whole_scan_MCUs */
 };
 
 typedef struct Compress_info_struct * compress_info_ptr;
@@ -472,6 +496,33 @@ struct Decompress_info_struct {
 	JCOEF last_dc_diff[MAX_COMPS_IN_SCAN]; /* last DC diff for each comp */
 	UINT16 restarts_to_go;	/* MCUs left in this restart interval */
 	short next_restart_num;	/* # of next RSTn marker (0..7) */
+
+/*
+ * Working state of the individual decompression modules.  This is kept here
+ * rather than in file-level statics so that several decompressions can run
+ * at once, each with its own Decompress_info_struct.
+ */
+	/* these fields are private data for the Huffman decoder (jdhuff.c) */
+	INT32 huff_get_buffer;	/* current bit-extraction buffer */
+	int huff_bits_left;	/* # of unused bits in it */
+	boolean printed_eod;	/* flag to suppress multiple end-of-data msgs */
+
+	/* these fields are private data for the color converter (jdcolor.c) */
+	int * Cr_r_tab;		/* => table for Cr to R conversion */
+	int * Cb_b_tab;		/* => table for Cb to B conversion */
+	INT32 * Cr_g_tab;	/* => table for Cr to G conversion */
+	INT32 * Cb_g_tab;	/* => table for Cb to G conversion */
+
+	/* these fields are private data for the pipeline controller (jdpipe.c) */
+	int rows_in_mem;	/* # of sample rows in full-size buffers */
+	JSAMPIMAGE output_workspace; /* color conversion output buffer */
+	struct big_sarray_control ** fullsize_image; /* full-image buffers */
+	JSAMPIMAGE fullsize_ptrs; /* workspace for access_big_sarray() result */
+
+	/* private data for the color quantizers (jquant1.c, jquant2.c); */
+	/* their layout is known only to the quantizer module itself */
+	struct quant1_private_struct * quant1_private;
+	struct quant2_private_struct * quant2_private;
 };
 
 typedef struct Decompress_info_struct * decompress_info_ptr;
@@ -565,8 +616,10 @@ struct External_methods_struct {
 	 * can be substituted easily.  This will not be done until all the
 	 * code is in place, so that we know what messages are needed.
 	 */
-	METHOD(void, error_exit, (const char *msgtext));
-	METHOD(void, trace_message, (const char *msgtext));
+	METHOD(void, error_exit, (external_methods_ptr emethods,
+				  const char *msgtext));
+	METHOD(void, trace_message, (external_methods_ptr emethods,
+				     const char *msgtext));
 
 	/* Working data for error/trace facility */
 	/* See macros below for the usage of these variables */
@@ -587,57 +640,83 @@ struct External_methods_struct {
 	/* Memory management */
 	/* NB: alloc routines never return NULL. They exit to */
 	/* error_exit if not successful. */
-	METHOD(void *, alloc_small, (size_t sizeofobject));
-	METHOD(void, free_small, (void *ptr));
-	METHOD(void FAR *, alloc_medium, (size_t sizeofobject));
-	METHOD(void, free_medium, (void FAR *ptr));
-	METHOD(JSAMPARRAY, alloc_small_sarray, (int  samplesperrow,
+	METHOD(void *, alloc_small, (external_methods_ptr emethods,
+				     size_t sizeofobject));
+	METHOD(void, free_small, (external_methods_ptr emethods,
+				  void *ptr));
+	METHOD(void FAR *, alloc_medium, (external_methods_ptr emethods,
+					  size_t sizeofobject));
+	METHOD(void, free_medium, (external_methods_ptr emethods,
+				   void FAR *ptr));
+	METHOD(JSAMPARRAY, alloc_small_sarray, (external_methods_ptr emethods,
+						int  samplesperrow,
 						int  numrows));
-	METHOD(void, free_small_sarray, (JSAMPARRAY ptr));
-	METHOD(JBLOCKARRAY, alloc_small_barray, (int  blocksperrow,
+	METHOD(void, free_small_sarray, (external_methods_ptr emethods,
+					 JSAMPARRAY ptr));
+	METHOD(JBLOCKARRAY, alloc_small_barray, (external_methods_ptr emethods,
+						 int  blocksperrow,
 						 int  numrows));
-	METHOD(void, free_small_barray, (JBLOCKARRAY ptr));
-	METHOD(big_sarray_ptr, request_big_sarray, (int  samplesperrow,
+	METHOD(void, free_small_barray, (external_methods_ptr emethods,
+					 JBLOCKARRAY ptr));
+	METHOD(big_sarray_ptr, request_big_sarray, (external_methods_ptr emethods,
+						    int  samplesperrow,
 						    int  numrows,
 						    int  unitheight));
-	METHOD(big_barray_ptr, request_big_barray, (int  blocksperrow,
+	METHOD(big_barray_ptr, request_big_barray, (external_methods_ptr emethods,
+						    int  blocksperrow,
 						    int  numrows,
 						    int  unitheight));
-	METHOD(void, alloc_big_arrays, (int  extra_small_samples,
+	METHOD(void, alloc_big_arrays, (external_methods_ptr emethods,
+					int  extra_small_samples,
 					int  extra_small_blocks,
 					int  extra_medium_space));
-	METHOD(JSAMPARRAY, access_big_sarray, (big_sarray_ptr ptr,
+	METHOD(JSAMPARRAY, access_big_sarray, (external_methods_ptr emethods,
+					       big_sarray_ptr ptr,
 					       int  start_row,
 					       boolean writable));
-	METHOD(JBLOCKARRAY, access_big_barray, (big_barray_ptr ptr,
+	METHOD(JBLOCKARRAY, access_big_barray, (external_methods_ptr emethods,
+						big_barray_ptr ptr,
 						int  start_row,
 						boolean writable));
-	METHOD(void, free_big_sarray, (big_sarray_ptr ptr));
-	METHOD(void, free_big_barray, (big_barray_ptr ptr));
-	METHOD(void, free_all, (void));
+	METHOD(void, free_big_sarray, (external_methods_ptr emethods,
+				       big_sarray_ptr ptr));
+	METHOD(void, free_big_barray, (external_methods_ptr emethods,
+				       big_barray_ptr ptr));
+	METHOD(void, free_all, (external_methods_ptr emethods));
 
 	int  max_memory_to_use;	/* maximum amount of memory to use */
+
+	/* Private state of the memory manager (jmemmgr.c).  It is kept here,
+	 * rather than in statics, so that separate compressions and
+	 * decompressions each have their own allocation lists.
+	 */
+	union small_struct * small_list;
+	union medium_struct FAR * medium_list;
+	struct small_sarray_struct * small_sarray_list;
+	struct small_barray_struct * small_barray_list;
+	big_sarray_ptr big_sarray_list;
+	big_barray_ptr big_barray_list;
 };
 
 /* Macros to simplify using the error and trace message stuff */
 /* The first parameter is generally cinfo->emethods */
 
 /* Fatal errors (print message and exit) */
-#define ERREXIT(emeth,msg)		((*(emeth)->error_exit) (msg))
+#define ERREXIT(emeth,msg)		((*(emeth)->error_exit) ((emeth), msg))
 #define ERREXIT1(emeth,msg,p1)		((emeth)->message_parm[0] = (p1), \
-					 (*(emeth)->error_exit) (msg))
+					 (*(emeth)->error_exit) ((emeth), msg))
 #define ERREXIT2(emeth,msg,p1,p2)	((emeth)->message_parm[0] = (p1), \
 					 (emeth)->message_parm[1] = (p2), \
-					 (*(emeth)->error_exit) (msg))
+					 (*(emeth)->error_exit) ((emeth), msg))
 #define ERREXIT3(emeth,msg,p1,p2,p3)	((emeth)->message_parm[0] = (p1), \
 					 (emeth)->message_parm[1] = (p2), \
 					 (emeth)->message_parm[2] = (p3), \
-					 (*(emeth)->error_exit) (msg))
+					 (*(emeth)->error_exit) ((emeth), msg))
 #define ERREXIT4(emeth,msg,p1,p2,p3,p4) ((emeth)->message_parm[0] = (p1), \
 					 (emeth)->message_parm[1] = (p2), \
 					 (emeth)->message_parm[2] = (p3), \
 					 (emeth)->message_parm[3] = (p4), \
-					 (*(emeth)->error_exit) (msg))
+					 (*(emeth)->error_exit) ((emeth), msg))
 
 #define MAKESTMT(stuff)		do { stuff } while (0)
 
@@ -646,48 +725,48 @@ struct External_methods_struct {
 #define WARNMS(emeth,msg)    \
   MAKESTMT( if ((emeth)->trace_level >= ((emeth)->num_warnings++ ? \
 		(emeth)->more_warning_level : (emeth)->first_warning_level)){ \
-		(*(emeth)->trace_message) (msg); } )
+		(*(emeth)->trace_message) ((emeth), msg); } )
 #define WARNMS1(emeth,msg,p1)    \
   MAKESTMT( if ((emeth)->trace_level >= ((emeth)->num_warnings++ ? \
 		(emeth)->more_warning_level : (emeth)->first_warning_level)){ \
 		(emeth)->message_parm[0] = (p1); \
-		(*(emeth)->trace_message) (msg); } )
+		(*(emeth)->trace_message) ((emeth), msg); } )
 #define WARNMS2(emeth,msg,p1,p2)    \
   MAKESTMT( if ((emeth)->trace_level >= ((emeth)->num_warnings++ ? \
 		(emeth)->more_warning_level : (emeth)->first_warning_level)){ \
 		(emeth)->message_parm[0] = (p1); \
 		(emeth)->message_parm[1] = (p2); \
-		(*(emeth)->trace_message) (msg); } )
+		(*(emeth)->trace_message) ((emeth), msg); } )
 
 /* Informational/debugging messages */
 #define TRACEMS(emeth,lvl,msg)    \
   MAKESTMT( if ((emeth)->trace_level >= (lvl)) { \
-		(*(emeth)->trace_message) (msg); } )
+		(*(emeth)->trace_message) ((emeth), msg); } )
 #define TRACEMS1(emeth,lvl,msg,p1)    \
   MAKESTMT( if ((emeth)->trace_level >= (lvl)) { \
 		(emeth)->message_parm[0] = (p1); \
-		(*(emeth)->trace_message) (msg); } )
+		(*(emeth)->trace_message) ((emeth), msg); } )
 #define TRACEMS2(emeth,lvl,msg,p1,p2)    \
   MAKESTMT( if ((emeth)->trace_level >= (lvl)) { \
 		(emeth)->message_parm[0] = (p1); \
 		(emeth)->message_parm[1] = (p2); \
-		(*(emeth)->trace_message) (msg); } )
+		(*(emeth)->trace_message) ((emeth), msg); } )
 #define TRACEMS3(emeth,lvl,msg,p1,p2,p3)    \
   MAKESTMT( if ((emeth)->trace_level >= (lvl)) { \
 		int * _mp = (emeth)->message_parm; \
 		*_mp++ = (p1); *_mp++ = (p2); *_mp = (p3); \
-		(*(emeth)->trace_message) (msg); } )
+		(*(emeth)->trace_message) ((emeth), msg); } )
 #define TRACEMS4(emeth,lvl,msg,p1,p2,p3,p4)    \
   MAKESTMT( if ((emeth)->trace_level >= (lvl)) { \
 		int * _mp = (emeth)->message_parm; \
 		*_mp++ = (p1); *_mp++ = (p2); *_mp++ = (p3); *_mp = (p4); \
-		(*(emeth)->trace_message) (msg); } )
+		(*(emeth)->trace_message) ((emeth), msg); } )
 #define TRACEMS8(emeth,lvl,msg,p1,p2,p3,p4,p5,p6,p7,p8)    \
   MAKESTMT( if ((emeth)->trace_level >= (lvl)) { \
 		int * _mp = (emeth)->message_parm; \
 		*_mp++ = (p1); *_mp++ = (p2); *_mp++ = (p3); *_mp++ = (p4); \
 		*_mp++ = (p5); *_mp++ = (p6); *_mp++ = (p7); *_mp = (p8); \
-		(*(emeth)->trace_message) (msg); } )
+		(*(emeth)->trace_message) ((emeth), msg); } )
 
 
 /* Methods used during JPEG compression. */
@@ -63,22 +63,6 @@
 
 #define MAX_COMPONENTS 4	/* max components I can handle */
 
-static JSAMPARRAY colormap;	/* The actual color map */
-/* colormap[i][j] = value of i'th color component for output pixel value j */
-
-static JSAMPARRAY colorindex;	/* Precomputed mapping for speed */
-/* colorindex[i][j] = index of color closest to pixel value j in component i,
- * premultiplied as described above.  Since colormap indexes must fit into
- * JSAMPLEs, the entries of this array will too.
- */
-
-static JSAMPARRAY input_buffer;	/* color conversion workspace */
-/* Since our input data is presented in the JPEG colorspace, we have to call
- * color_convert to get it into the output colorspace.  input_buffer is a
- * one-row-high workspace for the result of color_convert.
- */
-
-
 /* Declarations for Floyd-Steinberg dithering.
  *
  * Errors are accumulated into the arrays evenrowerrs[] and oddrowerrs[].
@@ -110,9 +94,37 @@ typedef INT32 FSERROR;		/* may need more than 16 bits? */
 
 typedef FSERROR FAR *FSERRPTR;	/* pointer to error array (in FAR storage!) */
 
-static FSERRPTR evenrowerrs[MAX_COMPONENTS]; /* errors for even rows */
-static FSERRPTR oddrowerrs[MAX_COMPONENTS];  /* errors for odd rows */
-static boolean on_odd_row;	/* flag to remember which row we are on */
+
+
+/* Working state of the quantizer.  One of these is allocated per
+ * decompression by color_quant_init and hung off cinfo->quant1_private.
+ */
+
+typedef struct quant1_private_struct {
+	JSAMPARRAY colormap;	/* The actual color map */
+	/* colormap[i][j] = value of i'th color component for output pixel
+	 * value j
+	 */
+
+	JSAMPARRAY colorindex;	/* Precomputed mapping for speed */
+	/* colorindex[i][j] = index of color closest to pixel value j in
+	 * component i, premultiplied as described above.  Since colormap
+	 * indexes must fit into JSAMPLEs, the entries of this array will too.
+	 */
+
+	JSAMPARRAY input_buffer; /* color conversion workspace */
+	/* Since our input data is presented in the JPEG colorspace, we have
+	 * to call color_convert to get it into the output colorspace.
+	 * input_buffer is a one-row-high workspace for the result of
+	 * color_convert.
+	 */
+
+	FSERRPTR evenrowerrs[MAX_COMPONENTS]; /* errors for even rows */
+	FSERRPTR oddrowerrs[MAX_COMPONENTS];  /* errors for odd rows */
+	boolean on_odd_row;	/* flag to remember which row we are on */
+} quant1_private;
+
+typedef quant1_private * quant1_ptr;
 
 
 /*
@@ -271,6 +283,7 @@ color_quant_init (decompress_info_ptr cinfo)
   int total_colors;		/* Number of distinct output colors */
   int Ncolors[MAX_COMPONENTS];	/* # of values alloced to each component */
   int i,j,k, nci, blksize, blkdist, ptr, val;
+  quant1_ptr qp;
 
   /* Make sure my internal arrays won't overflow */
   if (cinfo->num_components > MAX_COMPONENTS ||
@@ -292,14 +305,19 @@ color_quant_init (decompress_info_ptr cinfo)
   else
     TRACEMS1(cinfo->emethods, 1, "Quantizing to %d colors", total_colors);
 
+  /* Allocate the private working state */
+  qp = (quant1_ptr) (*cinfo->emethods->alloc_small)
+				(cinfo->emethods, SIZEOF(quant1_private));
+  cinfo->quant1_private = qp;
+
   /* Allocate and fill in the colormap and color index. */
   /* The colors are ordered in the map in standard row-major order, */
   /* i.e. rightmost (highest-indexed) color changes most rapidly. */
 
-  colormap = (*cinfo->emethods->alloc_small_sarray)
-		((int ) total_colors, (int ) cinfo->color_out_comps);
-  colorindex = (*cinfo->emethods->alloc_small_sarray)
-		((int ) (MAXJSAMPLE+1), (int ) cinfo->color_out_comps);
+  qp->colormap = (*cinfo->emethods->alloc_small_sarray)
+		(cinfo->emethods, (int ) total_colors, (int ) cinfo->color_out_comps);
+  qp->colorindex = (*cinfo->emethods->alloc_small_sarray)
+		(cinfo->emethods, (int ) (MAXJSAMPLE+1), (int ) cinfo->color_out_comps);
 
   /* blksize is number of adjacent repeated entries for a component */
   /* blkdist is distance between groups of identical entries for a component */
@@ -316,7 +334,7 @@ color_quant_init (decompress_info_ptr cinfo)
       for (ptr = j * blksize; ptr < total_colors; ptr += blkdist) {
 	/* fill in blksize entries beginning at ptr */
 	for (k = 0; k < blksize; k++)
-	  colormap[i][ptr+k] = (JSAMPLE) val;
+	  qp->colormap[i][ptr+k] = (JSAMPLE) val;
       }
     }
     blkdist = blksize;		/* blksize of this color is blkdist of next */
@@ -330,31 +348,33 @@ color_quant_init (decompress_info_ptr cinfo)
       while (j > k)		/* advance val if past boundary */
 	k = largest_input_value(cinfo, i, ++val, nci-1);
       /* premultiply so that no multiplication needed in main processing */
-      colorindex[i][j] = (JSAMPLE) (val * blksize);
+      qp->colorindex[i][j] = (JSAMPLE) (val * blksize);
     }
   }
 
   /* Pass the colormap to the output module. */
   /* NB: the output module may continue to use the colormap until shutdown. */
-  cinfo->colormap = colormap;
+  cinfo->colormap = qp->colormap;
   cinfo->actual_number_of_colors = total_colors;
-  (*cinfo->methods->put_color_map) (cinfo, total_colors, colormap);
+  (*cinfo->methods->put_color_map) (cinfo, total_colors, qp->colormap);
 
   /* Allocate workspace to hold one row of color-converted data */
-  input_buffer = (*cinfo->emethods->alloc_small_sarray)
-			(cinfo->image_width, (int ) cinfo->color_out_comps);
+  qp->input_buffer = (*cinfo->emethods->alloc_small_sarray)
+			(cinfo->emethods, cinfo->image_width, (int ) cinfo->color_out_comps);
 
   /* Allocate Floyd-Steinberg workspace if necessary */
   if (cinfo->use_dithering) {
     size_t arraysize = (size_t) ((cinfo->image_width + 2L) * SIZEOF(FSERROR));
 
     for (i = 0; i < cinfo->color_out_comps; i++) {
-      evenrowerrs[i] = (FSERRPTR) (*cinfo->emethods->alloc_medium) (arraysize);
-      oddrowerrs[i]  = (FSERRPTR) (*cinfo->emethods->alloc_medium) (arraysize);
+      qp->evenrowerrs[i] = (FSERRPTR) (*cinfo->emethods->alloc_medium)
+					(cinfo->emethods, arraysize);
+      qp->oddrowerrs[i]  = (FSERRPTR) (*cinfo->emethods->alloc_medium)
+					(cinfo->emethods, arraysize);
       /* we only need to zero the forward contribution for current row. */
-      jzero_far((void FAR *) evenrowerrs[i], arraysize);
+      jzero_far((void FAR *) qp->evenrowerrs[i], arraysize);
     }
-    on_odd_row = FALSE;
+    qp->on_odd_row = FALSE;
   }
 }
 
@@ -371,6 +391,7 @@ do_color_conversion (decompress_info_ptr cinfo, JSAMPIMAGE input_data, int row)
 /* at fairly low cost. */
 {
   short ci;
+  quant1_ptr qp = cinfo->quant1_private;
   JSAMPARRAY input_hack[MAX_COMPONENTS];
   JSAMPARRAY output_hack[MAX_COMPONENTS];
 
@@ -379,7 +400,7 @@ do_color_conversion (decompress_info_ptr cinfo, JSAMPIMAGE input_data, int row)
     input_hack[ci] = input_data[ci] + row;
   /* Create JSAMPIMAGE pointing at input_buffer */
   for (ci = 0; ci < cinfo->color_out_comps; ci++)
-    output_hack[ci] = &(input_buffer[ci]);
+    output_hack[ci] = &(qp->input_buffer[ci]);
 
   (*cinfo->methods->color_convert) (cinfo, 1, cinfo->image_width,
 				    input_hack, output_hack);
@@ -396,6 +417,7 @@ color_quantize (decompress_info_ptr cinfo, int num_rows,
 /* General case, no dithering */
 {
   register int pixcode, ci;
+  quant1_ptr qp = cinfo->quant1_private;
   register JSAMPROW ptrout;
   register int  col;
   int row;
@@ -408,8 +430,8 @@ color_quantize (decompress_info_ptr cinfo, int num_rows,
     for (col = 0; col < width; col++) {
       pixcode = 0;
       for (ci = 0; ci < nc; ci++) {
-	pixcode += GETJSAMPLE(colorindex[ci]
-			      [GETJSAMPLE(input_buffer[ci][col])]);
+	pixcode += GETJSAMPLE(qp->colorindex[ci]
+			      [GETJSAMPLE(qp->input_buffer[ci][col])]);
       }
       *ptrout++ = (JSAMPLE) pixcode;
     }
@@ -423,6 +445,7 @@ color_quantize3 (decompress_info_ptr cinfo, int num_rows,
 /* Fast path for color_out_comps==3, no dithering */
 {
   register int pixcode;
+  quant1_ptr qp = cinfo->quant1_private;
   register JSAMPROW ptr0, ptr1, ptr2, ptrout;
   register int  col;
   int row;
@@ -430,14 +453,14 @@ color_quantize3 (decompress_info_ptr cinfo, int num_rows,
 
   for (row = 0; row < num_rows; row++) {
     do_color_conversion(cinfo, input_data, row);
-    ptr0 = input_buffer[0];
-    ptr1 = input_buffer[1];
-    ptr2 = input_buffer[2];
+    ptr0 = qp->input_buffer[0];
+    ptr1 = qp->input_buffer[1];
+    ptr2 = qp->input_buffer[2];
     ptrout = output_data[row];
     for (col = width; col > 0; col--) {
-      pixcode  = GETJSAMPLE(colorindex[0][GETJSAMPLE(*ptr0++)]);
-      pixcode += GETJSAMPLE(colorindex[1][GETJSAMPLE(*ptr1++)]);
-      pixcode += GETJSAMPLE(colorindex[2][GETJSAMPLE(*ptr2++)]);
+      pixcode  = GETJSAMPLE(qp->colorindex[0][GETJSAMPLE(*ptr0++)]);
+      pixcode += GETJSAMPLE(qp->colorindex[1][GETJSAMPLE(*ptr1++)]);
+      pixcode += GETJSAMPLE(qp->colorindex[2][GETJSAMPLE(*ptr2++)]);
       *ptrout++ = (JSAMPLE) pixcode;
     }
   }
@@ -450,6 +473,7 @@ color_quantize_dither (decompress_info_ptr cinfo, int num_rows,
 /* General case, with Floyd-Steinberg dithering */
 {
   register FSERROR val;
+  quant1_ptr qp = cinfo->quant1_private;
   FSERROR two_val;
   register FSERRPTR thisrowerr, nextrowerr;
   register JSAMPROW input_ptr;
@@ -472,23 +496,23 @@ color_quantize_dither (decompress_info_ptr cinfo, int num_rows,
     jzero_far((void FAR *) output_data[row],
 	      (size_t) (width * SIZEOF(JSAMPLE)));
     for (ci = 0; ci < nc; ci++) {
-      if (on_odd_row) {
+      if (qp->on_odd_row) {
 	/* work right to left in this row */
 	dir = -1;
-	input_ptr = input_buffer[ci] + (width-1);
+	input_ptr = qp->input_buffer[ci] + (width-1);
 	output_ptr = output_data[row] + (width-1);
-	thisrowerr = oddrowerrs[ci] + 1;
-	nextrowerr = evenrowerrs[ci] + width;
+	thisrowerr = qp->oddrowerrs[ci] + 1;
+	nextrowerr = qp->evenrowerrs[ci] + width;
       } else {
 	/* work left to right in this row */
 	dir = 1;
-	input_ptr = input_buffer[ci];
+	input_ptr = qp->input_buffer[ci];
 	output_ptr = output_data[row];
-	thisrowerr = evenrowerrs[ci] + 1;
-	nextrowerr = oddrowerrs[ci] + width;
+	thisrowerr = qp->evenrowerrs[ci] + 1;
+	nextrowerr = qp->oddrowerrs[ci] + width;
       }
-      colorindex_ci = colorindex[ci];
-      colormap_ci = colormap[ci];
+      colorindex_ci = qp->colorindex[ci];
+      colormap_ci = qp->colormap[ci];
       *nextrowerr = 0;		/* need only initialize this one entry */
       for (col_counter = width; col_counter > 0; col_counter--) {
 	/* Get accumulated error for this component, round to integer.
@@ -523,7 +547,7 @@ color_quantize_dither (decompress_info_ptr cinfo, int num_rows,
 	nextrowerr--;		/* next-row error ptr advances to left */
       }
     }
-    on_odd_row = (on_odd_row ? FALSE : TRUE);
+    qp->on_odd_row = (qp->on_odd_row ? FALSE : TRUE);
   }
 }
 
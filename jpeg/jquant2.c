@@ -109,7 +109,35 @@ typedef histcell hist1d[HIST_C_ELEMS]; /* typedefs for the array */
 typedef hist1d FAR * hist2d;	/* type for the Y-level pointers */
 typedef hist2d * hist3d;	/* type for top-level pointer */
 
-static hist3d histogram;	/* pointer to the histogram */
+
+/* Error values for Floyd-Steinberg dithering (see pass2_dither below) */
+
+#ifdef EIGHT_BIT_SAMPLES
+typedef INT16 FSERROR;		/* 16 bits should be enough */
+#else
+typedef INT32 FSERROR;		/* may need more than 16 bits? */
+#endif
+
+typedef FSERROR FAR *FSERRPTR;	/* pointer to error array (in FAR storage!) */
+
+
+/* Working state of the quantizer.  One of these is allocated per
+ * decompression by color_quant_init and hung off cinfo->quant2_private.
+ */
+
+typedef struct quant2_private_struct {
+	hist3d histogram;	/* pointer to the histogram */
+
+	struct box_struct * boxlist; /* array with room for desired # of boxes */
+	int numboxes;		/* number of boxes currently in boxlist */
+
+	JSAMPARRAY my_colormap;	/* the finished colormap (in YCbCr space) */
+
+	FSERRPTR evenrowerrs, oddrowerrs; /* current-row and next-row errors */
+	boolean on_odd_row;	/* flag to remember which row we are on */
+} quant2_private;
+
+typedef quant2_private * quant2_ptr;
 
 
 /*
@@ -124,6 +152,7 @@ METHODDEF void
 color_quant_prescan (decompress_info_ptr cinfo, int num_rows,
 		     JSAMPIMAGE image_data, JSAMPARRAY workspace)
 {
+  quant2_ptr qp = cinfo->quant2_private;
   register JSAMPROW ptr0, ptr1, ptr2;
   register histptr histp;
   register int c0, c1, c2;
@@ -140,7 +169,7 @@ color_quant_prescan (decompress_info_ptr cinfo, int num_rows,
       c0 = GETJSAMPLE(*ptr0++) >> Y_SHIFT;
       c1 = GETJSAMPLE(*ptr1++) >> C_SHIFT;
       c2 = GETJSAMPLE(*ptr2++) >> C_SHIFT;
-      histp = & histogram[c0][c1][c2];
+      histp = & qp->histogram[c0][c1][c2];
       /* increment, check for overflow and undo increment if so. */
       /* We assume unsigned representation here! */
       if (++(*histp) == 0)
@@ -157,7 +186,7 @@ color_quant_prescan (decompress_info_ptr cinfo, int num_rows,
  * subset of the input color space (to histogram precision).
  */
 
-typedef struct {
+typedef struct box_struct {
 	/* The bounds of the box (inclusive); expressed as histogram indexes */
 	int c0min, c0max;
 	int c1min, c1max;
@@ -167,23 +196,18 @@ typedef struct {
       } box;
 typedef box * boxptr;
 
-static boxptr boxlist;		/* array with room for desired # of boxes */
-static int numboxes;		/* number of boxes currently in boxlist */
-
-static JSAMPARRAY my_colormap;	/* the finished colormap (in YCbCr space) */
-
-
 LOCAL boxptr
-find_biggest_color_pop (void)
+find_biggest_color_pop (decompress_info_ptr cinfo)
 /* Find the splittable box with the largest color population */
 /* Returns NULL if no splittable boxes remain */
 {
+  quant2_ptr qp = cinfo->quant2_private;
   register boxptr boxp;
   register int i;
   register int  max = 0;
   boxptr which = NULL;
   
-  for (i = 0, boxp = boxlist; i < numboxes; i++, boxp++) {
+  for (i = 0, boxp = qp->boxlist; i < qp->numboxes; i++, boxp++) {
     if (boxp->colorcount > max) {
       if (boxp->c0max > boxp->c0min || boxp->c1max > boxp->c1min ||
 	  boxp->c2max > boxp->c2min) {
@@ -197,10 +221,11 @@ find_biggest_color_pop (void)
 
 
 LOCAL boxptr
-find_biggest_volume (void)
+find_biggest_volume (decompress_info_ptr cinfo)
 /* Find the splittable box with the largest (scaled) volume */
 /* Returns NULL if no splittable boxes remain */
 {
+  quant2_ptr qp = cinfo->quant2_private;
   register boxptr boxp;
   register int i;
   register INT32 max = 0;
@@ -216,7 +241,7 @@ find_biggest_volume (void)
    * Note norm > 0 iff box is splittable, so need not check separately.
    */
   
-  for (i = 0, boxp = boxlist; i < numboxes; i++, boxp++) {
+  for (i = 0, boxp = qp->boxlist; i < qp->numboxes; i++, boxp++) {
     c0 = (boxp->c0max - boxp->c0min) * Y_SCALE;
     c1 = (boxp->c1max - boxp->c1min) << (HIST_Y_BITS-HIST_C_BITS);
     c2 = (boxp->c2max - boxp->c2min) << (HIST_Y_BITS-HIST_C_BITS);
@@ -231,10 +256,11 @@ find_biggest_volume (void)
 
 
 LOCAL void
-update_box (boxptr boxp)
+update_box (decompress_info_ptr cinfo, boxptr boxp)
 /* Shrink the min/max bounds of a box to enclose only nonzero elements, */
 /* and recompute its population */
 {
+  quant2_ptr qp = cinfo->quant2_private;
   histptr histp;
   int c0,c1,c2;
   int c0min,c0max,c1min,c1max,c2min,c2max;
@@ -247,7 +273,7 @@ update_box (boxptr boxp)
   if (c0max > c0min)
     for (c0 = c0min; c0 <= c0max; c0++)
       for (c1 = c1min; c1 <= c1max; c1++) {
-	histp = & histogram[c0][c1][c2min];
+	histp = & qp->histogram[c0][c1][c2min];
 	for (c2 = c2min; c2 <= c2max; c2++)
 	  if (*histp++ != 0) {
 	    boxp->c0min = c0min = c0;
@@ -258,7 +284,7 @@ update_box (boxptr boxp)
   if (c0max > c0min)
     for (c0 = c0max; c0 >= c0min; c0--)
       for (c1 = c1min; c1 <= c1max; c1++) {
-	histp = & histogram[c0][c1][c2min];
+	histp = & qp->histogram[c0][c1][c2min];
 	for (c2 = c2min; c2 <= c2max; c2++)
 	  if (*histp++ != 0) {
 	    boxp->c0max = c0max = c0;
@@ -269,7 +295,7 @@ update_box (boxptr boxp)
   if (c1max > c1min)
     for (c1 = c1min; c1 <= c1max; c1++)
       for (c0 = c0min; c0 <= c0max; c0++) {
-	histp = & histogram[c0][c1][c2min];
+	histp = & qp->histogram[c0][c1][c2min];
 	for (c2 = c2min; c2 <= c2max; c2++)
 	  if (*histp++ != 0) {
 	    boxp->c1min = c1min = c1;
@@ -280,7 +306,7 @@ update_box (boxptr boxp)
   if (c1max > c1min)
     for (c1 = c1max; c1 >= c1min; c1--)
       for (c0 = c0min; c0 <= c0max; c0++) {
-	histp = & histogram[c0][c1][c2min];
+	histp = & qp->histogram[c0][c1][c2min];
 	for (c2 = c2min; c2 <= c2max; c2++)
 	  if (*histp++ != 0) {
 	    boxp->c1max = c1max = c1;
@@ -291,7 +317,7 @@ update_box (boxptr boxp)
   if (c2max > c2min)
     for (c2 = c2min; c2 <= c2max; c2++)
       for (c0 = c0min; c0 <= c0max; c0++) {
-	histp = & histogram[c0][c1min][c2];
+	histp = & qp->histogram[c0][c1min][c2];
 	for (c1 = c1min; c1 <= c1max; c1++, histp += HIST_C_ELEMS)
 	  if (*histp != 0) {
 	    boxp->c2min = c2min = c2;
@@ -302,7 +328,7 @@ update_box (boxptr boxp)
   if (c2max > c2min)
     for (c2 = c2max; c2 >= c2min; c2--)
       for (c0 = c0min; c0 <= c0max; c0++) {
-	histp = & histogram[c0][c1min][c2];
+	histp = & qp->histogram[c0][c1min][c2];
 	for (c1 = c1min; c1 <= c1max; c1++, histp += HIST_C_ELEMS)
 	  if (*histp != 0) {
 	    boxp->c2max = c2max = c2;
@@ -315,7 +341,7 @@ update_box (boxptr boxp)
   ccount = 0;
   for (c0 = c0min; c0 <= c0max; c0++)
     for (c1 = c1min; c1 <= c1max; c1++) {
-      histp = & histogram[c0][c1][c2min];
+      histp = & qp->histogram[c0][c1][c2min];
       for (c2 = c2min; c2 <= c2max; c2++, histp++)
 	if (*histp != 0) {
 	  ccount++;
@@ -326,24 +352,25 @@ update_box (boxptr boxp)
 
 
 LOCAL void
-median_cut (int desired_colors)
+median_cut (decompress_info_ptr cinfo, int desired_colors)
 /* Repeatedly select and split the largest box until we have enough boxes */
 {
+  quant2_ptr qp = cinfo->quant2_private;
   int n,lb;
   int c0,c1,c2,cmax;
   register boxptr b1,b2;
 
-  while (numboxes < desired_colors) {
+  while (qp->numboxes < desired_colors) {
     /* Select box to split */
     /* Current algorithm: by population for first half, then by volume */
-    if (numboxes*2 <= desired_colors) {
-      b1 = find_biggest_color_pop();
+    if (qp->numboxes*2 <= desired_colors) {
+      b1 = find_biggest_color_pop(cinfo);
     } else {
-      b1 = find_biggest_volume();
+      b1 = find_biggest_volume(cinfo);
     }
     if (b1 == NULL)		/* no splittable boxes left! */
       break;
-    b2 = &boxlist[numboxes];	/* where new box will go */
+    b2 = &qp->boxlist[qp->numboxes];	/* where new box will go */
     /* Copy the color bounds to the new box. */
     b2->c0max = b1->c0max; b2->c1max = b1->c1max; b2->c2max = b1->c2max;
     b2->c0min = b1->c0min; b2->c1min = b1->c1min; b2->c2min = b1->c2min;
@@ -381,17 +408,18 @@ median_cut (int desired_colors)
       break;
     }
     /* Update stats for boxes */
-    update_box(b1);
-    update_box(b2);
-    numboxes++;
+    update_box(cinfo, b1);
+    update_box(cinfo, b2);
+    qp->numboxes++;
   }
 }
 
 
 LOCAL void
-compute_color (boxptr boxp, int icolor)
+compute_color (decompress_info_ptr cinfo, boxptr boxp, int icolor)
 /* Compute representative color for a box, put it in my_colormap[icolor] */
 {
+  quant2_ptr qp = cinfo->quant2_private;
   /* Current algorithm: mean weighted by pixels (not colors) */
   /* Note it is important to get the rounding correct! */
   histptr histp;
@@ -409,7 +437,7 @@ compute_color (boxptr boxp, int icolor)
   
   for (c0 = c0min; c0 <= c0max; c0++)
     for (c1 = c1min; c1 <= c1max; c1++) {
-      histp = & histogram[c0][c1][c2min];
+      histp = & qp->histogram[c0][c1][c2min];
       for (c2 = c2min; c2 <= c2max; c2++) {
 	if ((count = *histp++) != 0) {
 	  total += count;
@@ -420,9 +448,9 @@ compute_color (boxptr boxp, int icolor)
       }
     }
   
-  my_colormap[0][icolor] = (JSAMPLE) ((c0total + (total>>1)) / total);
-  my_colormap[1][icolor] = (JSAMPLE) ((c1total + (total>>1)) / total);
-  my_colormap[2][icolor] = (JSAMPLE) ((c2total + (total>>1)) / total);
+  qp->my_colormap[0][icolor] = (JSAMPLE) ((c0total + (total>>1)) / total);
+  qp->my_colormap[1][icolor] = (JSAMPLE) ((c1total + (total>>1)) / total);
+  qp->my_colormap[2][icolor] = (JSAMPLE) ((c2total + (total>>1)) / total);
 }
 
 
@@ -430,6 +458,7 @@ LOCAL void
 remap_colormap (decompress_info_ptr cinfo)
 /* Remap the internal colormap to the output colorspace */
 {
+  quant2_ptr qp = cinfo->quant2_private;
   /* This requires a little trickery since color_convert expects to
    * deal with 3-D arrays (a 2-D sample array for each component).
    * We must promote the colormaps into one-row 3-D arrays.
@@ -439,7 +468,7 @@ remap_colormap (decompress_info_ptr cinfo)
   JSAMPARRAY output_hack[10];	/* assume no more than 10 output components */
 
   for (ci = 0; ci < 3; ci++)
-    input_hack[ci] = &(my_colormap[ci]);
+    input_hack[ci] = &(qp->my_colormap[ci]);
   for (ci = 0; ci < cinfo->color_out_comps; ci++)
     output_hack[ci] = &(cinfo->colormap[ci]);
 
@@ -453,33 +482,35 @@ LOCAL void
 select_colors (decompress_info_ptr cinfo)
 /* Master routine for color selection */
 {
+  quant2_ptr qp = cinfo->quant2_private;
   int desired = cinfo->desired_number_of_colors;
   int i;
 
   /* Allocate workspace for box list */
-  boxlist = (boxptr) (*cinfo->emethods->alloc_small) (desired * SIZEOF(box));
+  qp->boxlist = (boxptr) (*cinfo->emethods->alloc_small)
+				(cinfo->emethods, desired * SIZEOF(box));
   /* Initialize one box containing whole space */
-  numboxes = 1;
-  boxlist[0].c0min = 0;
-  boxlist[0].c0max = MAXJSAMPLE >> Y_SHIFT;
-  boxlist[0].c1min = 0;
-  boxlist[0].c1max = MAXJSAMPLE >> C_SHIFT;
-  boxlist[0].c2min = 0;
-  boxlist[0].c2max = MAXJSAMPLE >> C_SHIFT;
+  qp->numboxes = 1;
+  qp->boxlist[0].c0min = 0;
+  qp->boxlist[0].c0max = MAXJSAMPLE >> Y_SHIFT;
+  qp->boxlist[0].c1min = 0;
+  qp->boxlist[0].c1max = MAXJSAMPLE >> C_SHIFT;
+  qp->boxlist[0].c2min = 0;
+  qp->boxlist[0].c2max = MAXJSAMPLE >> C_SHIFT;
   /* Shrink it to actually-used volume and set its statistics */
-  update_box(& boxlist[0]);
+  update_box(cinfo, & qp->boxlist[0]);
   /* Perform median-cut to produce final box list */
-  median_cut(desired);
+  median_cut(cinfo, desired);
   /* Compute the representative color for each box, fill my_colormap[] */
-  for (i = 0; i < numboxes; i++)
-    compute_color(& boxlist[i], i);
-  cinfo->actual_number_of_colors = numboxes;
+  for (i = 0; i < qp->numboxes; i++)
+    compute_color(cinfo, & qp->boxlist[i], i);
+  cinfo->actual_number_of_colors = qp->numboxes;
   /* Produce an output colormap in the desired output colorspace */
   remap_colormap(cinfo);
   TRACEMS1(cinfo->emethods, 1, "Selected %d colors for quantization",
-	   numboxes);
+	   qp->numboxes);
   /* Done with the box list */
-  (*cinfo->emethods->free_small) ((void *) boxlist);
+  (*cinfo->emethods->free_small) (cinfo->emethods, (void *) qp->boxlist);
 }
 
 
@@ -575,6 +606,7 @@ find_nearby_colors (decompress_info_ptr cinfo, int minc0, int minc1, int minc2,
  * the colors that need further consideration.
  */
 {
+  quant2_ptr qp = cinfo->quant2_private;
   int numcolors = cinfo->actual_number_of_colors;
   int maxc0, maxc1, maxc2;
   int centerc0, centerc1, centerc2;
@@ -608,7 +640,7 @@ find_nearby_colors (decompress_info_ptr cinfo, int minc0, int minc1, int minc2,
 
   for (i = 0; i < numcolors; i++) {
     /* We compute the squared-c0-distance term, then add in the other two. */
-    x = GETJSAMPLE(my_colormap[0][i]);
+    x = GETJSAMPLE(qp->my_colormap[0][i]);
     if (x < minc0) {
       tdist = (x - minc0) * Y_SCALE;
       min_dist = tdist*tdist;
@@ -631,7 +663,7 @@ find_nearby_colors (decompress_info_ptr cinfo, int minc0, int minc1, int minc2,
       }
     }
 
-    x = GETJSAMPLE(my_colormap[1][i]);
+    x = GETJSAMPLE(qp->my_colormap[1][i]);
     if (x < minc1) {
       tdist = x - minc1;
       min_dist += tdist*tdist;
@@ -653,7 +685,7 @@ find_nearby_colors (decompress_info_ptr cinfo, int minc0, int minc1, int minc2,
       }
     }
 
-    x = GETJSAMPLE(my_colormap[2][i]);
+    x = GETJSAMPLE(qp->my_colormap[2][i]);
     if (x < minc2) {
       tdist = x - minc2;
       min_dist += tdist*tdist;
@@ -703,6 +735,7 @@ find_best_colors (decompress_info_ptr cinfo, int minc0, int minc1, int minc2,
  * find the distance from a colormap entry to successive cells in the box.
  */
 {
+  quant2_ptr qp = cinfo->quant2_private;
   int ic0, ic1, ic2;
   int i, icolor;
   register INT32 * bptr;	/* pointer into bestdist[] array */
@@ -733,11 +766,11 @@ find_best_colors (decompress_info_ptr cinfo, int minc0, int minc1, int minc2,
   for (i = 0; i < numcolors; i++) {
     icolor = GETJSAMPLE(colorlist[i]);
     /* Compute (square of) distance from minc0/c1/c2 to this color */
-    inc0 = (minc0 - (int) GETJSAMPLE(my_colormap[0][icolor])) * Y_SCALE;
+    inc0 = (minc0 - (int) GETJSAMPLE(qp->my_colormap[0][icolor])) * Y_SCALE;
     dist0 = inc0*inc0;
-    inc1 = minc1 - (int) GETJSAMPLE(my_colormap[1][icolor]);
+    inc1 = minc1 - (int) GETJSAMPLE(qp->my_colormap[1][icolor]);
     dist0 += inc1*inc1;
-    inc2 = minc2 - (int) GETJSAMPLE(my_colormap[2][icolor]);
+    inc2 = minc2 - (int) GETJSAMPLE(qp->my_colormap[2][icolor]);
     dist0 += inc2*inc2;
     /* Form the initial difference increments */
     inc0 = inc0 * (2 * STEP_Y) + STEP_Y * STEP_Y;
@@ -779,6 +812,7 @@ fill_inverse_cmap (decompress_info_ptr cinfo, int c0, int c1, int c2)
 /* histogram cell c0/c1/c2.  (Only that one cell MUST be filled, but */
 /* we can fill as many others as we wish.) */
 {
+  quant2_ptr qp = cinfo->quant2_private;
   int minc0, minc1, minc2;	/* lower left corner of update box */
   int ic0, ic1, ic2;
   register JSAMPLE * cptr;	/* pointer into bestcolor[] array */
@@ -818,7 +852,7 @@ fill_inverse_cmap (decompress_info_ptr cinfo, int c0, int c1, int c2)
   cptr = bestcolor;
   for (ic0 = 0; ic0 < BOX_Y_ELEMS; ic0++) {
     for (ic1 = 0; ic1 < BOX_C_ELEMS; ic1++) {
-      cachep = & histogram[c0+ic0][c1+ic1][c2];
+      cachep = & qp->histogram[c0+ic0][c1+ic1][c2];
       for (ic2 = 0; ic2 < BOX_C_ELEMS; ic2++) {
 	*cachep++ = (histcell) (GETJSAMPLE(*cptr++) + 1);
       }
@@ -841,6 +875,7 @@ pass2_nodither (decompress_info_ptr cinfo, int num_rows,
 		JSAMPIMAGE image_data, JSAMPARRAY output_workspace)
 /* This version performs no dithering */
 {
+  quant2_ptr qp = cinfo->quant2_private;
   register JSAMPROW ptr0, ptr1, ptr2, outptr;
   register histptr cachep;
   register int c0, c1, c2;
@@ -859,7 +894,7 @@ pass2_nodither (decompress_info_ptr cinfo, int num_rows,
       c0 = GETJSAMPLE(*ptr0++) >> Y_SHIFT;
       c1 = GETJSAMPLE(*ptr1++) >> C_SHIFT;
       c2 = GETJSAMPLE(*ptr2++) >> C_SHIFT;
-      cachep = & histogram[c0][c1][c2];
+      cachep = & qp->histogram[c0][c1][c2];
       /* If we have not seen this color before, find nearest colormap entry */
       /* and update the cache */
       if (*cachep == 0)
@@ -896,16 +931,6 @@ pass2_nodither (decompress_info_ptr cinfo, int num_rows,
  * segment to hold the error arrays; so they are allocated with alloc_medium.
  */
 
-#ifdef EIGHT_BIT_SAMPLES
-typedef INT16 FSERROR;		/* 16 bits should be enough */
-#else
-typedef INT32 FSERROR;		/* may need more than 16 bits? */
-#endif
-
-typedef FSERROR FAR *FSERRPTR;	/* pointer to error array (in FAR storage!) */
-
-static FSERRPTR evenrowerrs, oddrowerrs; /* current-row and next-row errors */
-static boolean on_odd_row;	/* flag to remember which row we are on */
 
 
 METHODDEF void
@@ -913,6 +938,7 @@ pass2_dither (decompress_info_ptr cinfo, int num_rows,
 	      JSAMPIMAGE image_data, JSAMPARRAY output_workspace)
 /* This version performs Floyd-Steinberg dithering */
 {
+  quant2_ptr qp = cinfo->quant2_private;
 #ifdef EIGHT_BIT_SAMPLES
   register int c0, c1, c2;
   int two_val;
@@ -929,9 +955,9 @@ pass2_dither (decompress_info_ptr cinfo, int num_rows,
   int  col;
   int  width = cinfo->image_width;
   JSAMPLE *range_limit = cinfo->sample_range_limit;
-  JSAMPROW colormap0 = my_colormap[0];
-  JSAMPROW colormap1 = my_colormap[1];
-  JSAMPROW colormap2 = my_colormap[2];
+  JSAMPROW colormap0 = qp->my_colormap[0];
+  JSAMPROW colormap1 = qp->my_colormap[1];
+  JSAMPROW colormap2 = qp->my_colormap[2];
   SHIFT_TEMPS
 
   /* Convert data to colormap indexes, which we save in output_workspace */
@@ -940,22 +966,22 @@ pass2_dither (decompress_info_ptr cinfo, int num_rows,
     ptr1 = image_data[1][row];
     ptr2 = image_data[2][row];
     outptr = output_workspace[row];
-    if (on_odd_row) {
+    if (qp->on_odd_row) {
       /* work right to left in this row */
       ptr0 += width - 1;
       ptr1 += width - 1;
       ptr2 += width - 1;
       outptr += width - 1;
       dir = -1;
-      thisrowerr = oddrowerrs + 3;
-      nextrowerr = evenrowerrs + width*3;
-      on_odd_row = FALSE;	/* flip for next time */
+      thisrowerr = qp->oddrowerrs + 3;
+      nextrowerr = qp->evenrowerrs + width*3;
+      qp->on_odd_row = FALSE;	/* flip for next time */
     } else {
       /* work left to right in this row */
       dir = 1;
-      thisrowerr = evenrowerrs + 3;
-      nextrowerr = oddrowerrs + width*3;
-      on_odd_row = TRUE;	/* flip for next time */
+      thisrowerr = qp->evenrowerrs + 3;
+      nextrowerr = qp->oddrowerrs + width*3;
+      qp->on_odd_row = TRUE;	/* flip for next time */
     }
     /* need only initialize this one entry in nextrowerr */
     nextrowerr[0] = nextrowerr[1] = nextrowerr[2] = 0;
@@ -975,7 +1001,7 @@ pass2_dither (decompress_info_ptr cinfo, int num_rows,
       c1 = GETJSAMPLE(range_limit[c1]);
       c2 = GETJSAMPLE(range_limit[c2]);
       /* Index into the cache with adjusted pixel value */
-      cachep = & histogram[c0 >> Y_SHIFT][c1 >> C_SHIFT][c2 >> C_SHIFT];
+      cachep = & qp->histogram[c0 >> Y_SHIFT][c1 >> C_SHIFT][c2 >> C_SHIFT];
       /* If we have not seen this color before, find nearest colormap */
       /* entry and update the cache */
       if (*cachep == 0)
@@ -1034,6 +1060,7 @@ pass2_dither (decompress_info_ptr cinfo, int num_rows,
 METHODDEF void
 color_quant_init (decompress_info_ptr cinfo)
 {
+  quant2_ptr qp;
   int i;
 
   /* Lower bound on # of colors ... somewhat arbitrary as int  as > 0 */
@@ -1044,24 +1071,30 @@ color_quant_init (decompress_info_ptr cinfo)
     ERREXIT1(cinfo->emethods, "Cannot request more than %d quantized colors",
 	     MAXNUMCOLORS);
 
+  /* Allocate the private working state */
+  qp = (quant2_ptr) (*cinfo->emethods->alloc_small)
+				(cinfo->emethods, SIZEOF(quant2_private));
+  cinfo->quant2_private = qp;
+
   /* Allocate and zero the histogram */
-  histogram = (hist3d) (*cinfo->emethods->alloc_small)
-				(HIST_Y_ELEMS * SIZEOF(hist2d));
+  qp->histogram = (hist3d) (*cinfo->emethods->alloc_small)
+				(cinfo->emethods, HIST_Y_ELEMS * SIZEOF(hist2d));
   for (i = 0; i < HIST_Y_ELEMS; i++) {
-    histogram[i] = (hist2d) (*cinfo->emethods->alloc_medium)
-				(HIST_C_ELEMS*HIST_C_ELEMS * SIZEOF(histcell));
-    jzero_far((void FAR *) histogram[i],
+    qp->histogram[i] = (hist2d) (*cinfo->emethods->alloc_medium)
+				(cinfo->emethods,
+				 HIST_C_ELEMS*HIST_C_ELEMS * SIZEOF(histcell));
+    jzero_far((void FAR *) qp->histogram[i],
 	      HIST_C_ELEMS*HIST_C_ELEMS * SIZEOF(histcell));
   }
 
   /* Allocate storage for the internal and external colormaps. */
   /* We do this now since it is FAR storage and may affect the memory */
   /* manager's space calculations. */
-  my_colormap = (*cinfo->emethods->alloc_small_sarray)
-			((int ) cinfo->desired_number_of_colors,
+  qp->my_colormap = (*cinfo->emethods->alloc_small_sarray)
+			(cinfo->emethods, (int ) cinfo->desired_number_of_colors,
 			 (int ) 3);
   cinfo->colormap = (*cinfo->emethods->alloc_small_sarray)
-			((int ) cinfo->desired_number_of_colors,
+			(cinfo->emethods, (int ) cinfo->desired_number_of_colors,
 			 (int ) cinfo->color_out_comps);
 
   /* Allocate Floyd-Steinberg workspace if necessary */
@@ -1069,11 +1102,13 @@ color_quant_init (decompress_info_ptr cinfo)
   if (cinfo->use_dithering) {
     size_t arraysize = (size_t) ((cinfo->image_width + 2L) * 3L * SIZEOF(FSERROR));
 
-    evenrowerrs = (FSERRPTR) (*cinfo->emethods->alloc_medium) (arraysize);
-    oddrowerrs  = (FSERRPTR) (*cinfo->emethods->alloc_medium) (arraysize);
+    qp->evenrowerrs = (FSERRPTR) (*cinfo->emethods->alloc_medium)
+					(cinfo->emethods, arraysize);
+    qp->oddrowerrs  = (FSERRPTR) (*cinfo->emethods->alloc_medium)
+					(cinfo->emethods, arraysize);
     /* we only need to zero the forward contribution for current row. */
-    jzero_far((void FAR *) evenrowerrs, arraysize);
-    on_odd_row = FALSE;
+    jzero_far((void FAR *) qp->evenrowerrs, arraysize);
+    qp->on_odd_row = FALSE;
   }
 
   /* Indicate number of passes needed, excluding the prescan pass. */
@@ -1094,6 +1129,7 @@ color_quant_init (decompress_info_ptr cinfo)
 METHODDEF void
 color_quant_doit (decompress_info_ptr cinfo, quantize_caller_ptr source_method)
 {
+  quant2_ptr qp = cinfo->quant2_private;
   int i;
 
   /* Select the representative colors */
@@ -1104,7 +1140,7 @@ color_quant_doit (decompress_info_ptr cinfo, quantize_caller_ptr source_method)
 				    cinfo->colormap);
   /* Re-zero the histogram so pass 2 can use it as nearest-color cache */
   for (i = 0; i < HIST_Y_ELEMS; i++) {
-    jzero_far((void FAR *) histogram[i],
+    jzero_far((void FAR *) qp->histogram[i],
 	      HIST_C_ELEMS*HIST_C_ELEMS * SIZEOF(histcell));
   }
   /* Perform pass 2 */
@@ -374,7 +374,7 @@ input_init (compress_info_ptr cinfo)
 
   /* Allocate space to store the colormap */
   colormap = (*cinfo->emethods->alloc_small_sarray)
-		((int ) MAXCOLORMAPSIZE, (int ) NUMCOLORS);
+		(cinfo->emethods, (int ) MAXCOLORMAPSIZE, (int ) NUMCOLORS);
 
   /* Read and verify GIF Header */
   if (! ReadOK(cinfo->input_file, hdrbuf, 6))
@@ -453,11 +453,11 @@ input_init (compress_info_ptr cinfo)
 
   /* Prepare to read selected image: first initialize LZW decompressor */
   symbol_head = (UINT16 FAR *) (*cinfo->emethods->alloc_medium)
-				(LZW_TABLE_SIZE * SIZEOF(UINT16));
+				(cinfo->emethods, LZW_TABLE_SIZE * SIZEOF(UINT16));
   symbol_tail = (UINT8 FAR *) (*cinfo->emethods->alloc_medium)
-				(LZW_TABLE_SIZE * SIZEOF(UINT8));
+				(cinfo->emethods, LZW_TABLE_SIZE * SIZEOF(UINT8));
   symbol_stack = (UINT8 FAR *) (*cinfo->emethods->alloc_medium)
-				(LZW_TABLE_SIZE * SIZEOF(UINT8));
+				(cinfo->emethods, LZW_TABLE_SIZE * SIZEOF(UINT8));
   InitLZWCode();
 
   /*
@@ -472,7 +472,7 @@ input_init (compress_info_ptr cinfo)
      * of get_input_row.
      */
     interlaced_image = (*cinfo->emethods->request_big_sarray)
-		((int ) width, (int ) height, 1L);
+		(cinfo->emethods, (int ) width, (int ) height, 1L);
     cinfo->methods->get_input_row = load_interlaced_image;
     cinfo->total_passes++;	/* count file reading as separate pass */
   }
@@ -532,7 +532,7 @@ load_interlaced_image (compress_info_ptr cinfo, JSAMPARRAY pixel_row)
   for (row = 0; row < cinfo->image_height; row++) {
     (*cinfo->methods->progress_monitor) (cinfo, row, cinfo->image_height);
     image_ptr = (*cinfo->emethods->access_big_sarray)
-			(interlaced_image, row, TRUE);
+			(cinfo->emethods, interlaced_image, row, TRUE);
     sptr = image_ptr[0];
     for (col = cinfo->image_width; col > 0; col--) {
       *sptr++ = (JSAMPLE) LZWReadByte(cinfo);
@@ -584,7 +584,7 @@ get_interlaced_row (compress_info_ptr cinfo, JSAMPARRAY pixel_row)
     break;
   }
   image_ptr = (*cinfo->emethods->access_big_sarray)
-			(interlaced_image, irow, FALSE);
+			(cinfo->emethods, interlaced_image, irow, FALSE);
   /* Scan the row, expand colormap, and output */
   sptr = image_ptr[0];
   ptr0 = pixel_row[0];
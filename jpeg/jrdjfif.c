@@ -204,7 +204,7 @@ get_dht (decompress_info_ptr cinfo)
       ERREXIT1(cinfo->emethods, "Bogus DHT index %d", index);
 
     if (*htblptr == NULL)
-      *htblptr = (HUFF_TBL *) (*cinfo->emethods->alloc_small) (SIZEOF(HUFF_TBL));
+      *htblptr = (HUFF_TBL *) (*cinfo->emethods->alloc_small) (cinfo->emethods, SIZEOF(HUFF_TBL));
   
     MEMCOPY((*htblptr)->bits, bits, SIZEOF((*htblptr)->bits));
     MEMCOPY((*htblptr)->huffval, huffval, SIZEOF((*htblptr)->huffval));
@@ -269,7 +269,7 @@ get_dqt (decompress_info_ptr cinfo)
       
     if (cinfo->quant_tbl_ptrs[n] == NULL)
       cinfo->quant_tbl_ptrs[n] = (QUANT_TBL_PTR)
-	(*cinfo->emethods->alloc_small) (SIZEOF(QUANT_TBL));
+	(*cinfo->emethods->alloc_small) (cinfo->emethods, SIZEOF(QUANT_TBL));
     quant_ptr = cinfo->quant_tbl_ptrs[n];
 
     for (i = 0; i < DCTSIZE2; i++) {
@@ -407,7 +407,7 @@ get_sof (decompress_info_ptr cinfo, int code)
     ERREXIT(cinfo->emethods, "Bogus SOF length");
 
   cinfo->comp_info = (jpeg_component_info *) (*cinfo->emethods->alloc_small)
-			(cinfo->num_components * SIZEOF(jpeg_component_info));
+			(cinfo->emethods, cinfo->num_components * SIZEOF(jpeg_component_info));
   
   for (ci = 0; ci < cinfo->num_components; ci++) {
     compptr = &cinfo->comp_info[ci];
@@ -381,7 +381,7 @@ input_init (compress_info_ptr cinfo)
 #ifndef USE_GETC_INPUT
     /* allocate space for row buffer: 1 byte/pixel */
     row_buffer = (U_CHAR *) (*cinfo->emethods->alloc_small)
-			((size_t) (SIZEOF(U_CHAR) * (int ) w));
+			(cinfo->emethods, (size_t) (SIZEOF(U_CHAR) * (int ) w));
 #endif
     TRACEMS2(cinfo->emethods, 1, "%ux%u PGM image", w, h);
     break;
@@ -396,7 +396,7 @@ input_init (compress_info_ptr cinfo)
 #ifndef USE_GETC_INPUT
     /* allocate space for row buffer: 3 bytes/pixel */
     row_buffer = (U_CHAR *) (*cinfo->emethods->alloc_small)
-			((size_t) (3 * SIZEOF(U_CHAR) * (int ) w));
+			(cinfo->emethods, (size_t) (3 * SIZEOF(U_CHAR) * (int ) w));
 #endif
     TRACEMS2(cinfo->emethods, 1, "%ux%u PPM image", w, h);
     break;
@@ -415,7 +415,7 @@ input_init (compress_info_ptr cinfo)
 
     /* On 16-bit-int machines we have to be careful of maxval = 65535 */
     rescale = (JSAMPLE *) (*cinfo->emethods->alloc_small)
-			((size_t) (((int ) maxval + 1L) * SIZEOF(JSAMPLE)));
+			(cinfo->emethods, (size_t) (((int ) maxval + 1L) * SIZEOF(JSAMPLE)));
     half_maxval = maxval / 2;
     for (val = 0; val <= (INT32) maxval; val++) {
       /* The multiplication here must be done in 32 bits to avoid overflow */
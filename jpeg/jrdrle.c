@@ -137,22 +137,22 @@ input_init (compress_info_ptr cinfo)
   switch (visual) {
   case GRAYSCALE:
     /* request one big array to hold the grayscale image */
-    image = (*cinfo->emethods->request_big_sarray) (width, height, 1L);
+    image = (*cinfo->emethods->request_big_sarray) (cinfo->emethods, width, height, 1L);
     cinfo->in_color_space   = CS_GRAYSCALE;
     cinfo->input_components = 1;
     break;
   case PSEUDOCOLOR:
     /* request one big array to hold the pseudocolor image */
-    image = (*cinfo->emethods->request_big_sarray) (width, height, 1L);
+    image = (*cinfo->emethods->request_big_sarray) (cinfo->emethods, width, height, 1L);
     cinfo->in_color_space   = CS_RGB;
     cinfo->input_components = 3;
     break;
   case TRUECOLOR:
   case DIRECTCOLOR:
     /* request three big arrays to hold the RGB channels */
-    red_channel   = (*cinfo->emethods->request_big_sarray) (width, height, 1L);
-    green_channel = (*cinfo->emethods->request_big_sarray) (width, height, 1L);
-    blue_channel  = (*cinfo->emethods->request_big_sarray) (width, height, 1L);
+    red_channel   = (*cinfo->emethods->request_big_sarray) (cinfo->emethods, width, height, 1L);
+    green_channel = (*cinfo->emethods->request_big_sarray) (cinfo->emethods, width, height, 1L);
+    blue_channel  = (*cinfo->emethods->request_big_sarray) (cinfo->emethods, width, height, 1L);
     cinfo->in_color_space   = CS_RGB;
     cinfo->input_components = 3;
     break;
@@ -178,7 +178,7 @@ get_grayscale_row (compress_info_ptr cinfo, JSAMPARRAY pixel_row)
   cur_row_number--;		/* work down in array */
   
   inputrows[0] = *((*cinfo->emethods->access_big_sarray)
-			(image, cur_row_number, FALSE));
+			(cinfo->emethods, image, cur_row_number, FALSE));
 
   jcopy_sample_rows(inputrows, 0, pixel_row, 0, 1, cinfo->image_width);
 }
@@ -195,7 +195,7 @@ get_pseudocolor_row (compress_info_ptr cinfo, JSAMPARRAY pixel_row)
   cur_row_number--;		/* work down in array */
   
   image_ptr = *((*cinfo->emethods->access_big_sarray)
-		(image, cur_row_number, FALSE));
+		(cinfo->emethods, image, cur_row_number, FALSE));
 
   ptr0 = pixel_row[0];
   ptr1 = pixel_row[1];
@@ -221,11 +221,11 @@ get_truecolor_row (compress_info_ptr cinfo, JSAMPARRAY pixel_row)
   cur_row_number--;		/* work down in array */
   
   red_ptr   = *((*cinfo->emethods->access_big_sarray)
-		(red_channel, cur_row_number, FALSE));
+		(cinfo->emethods, red_channel, cur_row_number, FALSE));
   green_ptr = *((*cinfo->emethods->access_big_sarray)
-		(green_channel, cur_row_number, FALSE));
+		(cinfo->emethods, green_channel, cur_row_number, FALSE));
   blue_ptr  = *((*cinfo->emethods->access_big_sarray)
-		(blue_channel, cur_row_number, FALSE));
+		(cinfo->emethods, blue_channel, cur_row_number, FALSE));
   
   ptr0 = pixel_row[0];
   ptr1 = pixel_row[1];
@@ -248,11 +248,11 @@ get_directcolor_row (compress_info_ptr cinfo, JSAMPARRAY pixel_row)
   cur_row_number--;		/* work down in array */
   
   inputrows[0] = *((*cinfo->emethods->access_big_sarray)
-			(red_channel, cur_row_number, FALSE));
+			(cinfo->emethods, red_channel, cur_row_number, FALSE));
   inputrows[1] = *((*cinfo->emethods->access_big_sarray)
-			(green_channel, cur_row_number, FALSE));
+			(cinfo->emethods, green_channel, cur_row_number, FALSE));
   inputrows[2] = *((*cinfo->emethods->access_big_sarray)
-			(blue_channel, cur_row_number, FALSE));
+			(cinfo->emethods, blue_channel, cur_row_number, FALSE));
 
   jcopy_sample_rows(inputrows, 0, pixel_row, 0, 3, cinfo->image_width);
 }
@@ -290,7 +290,7 @@ load_image (compress_info_ptr cinfo, JSAMPARRAY pixel_row)
        * Too bad this doesn't seem to return any indication of errors :-(.
        */
       rle_row[0] = (rle_pixel *) *((*cinfo->emethods->access_big_sarray)
-					(image, row, TRUE));
+					(cinfo->emethods, image, row, TRUE));
       rle_getrow(&header, rle_row);
     }
     break;
@@ -303,11 +303,11 @@ load_image (compress_info_ptr cinfo, JSAMPARRAY pixel_row)
        * Too bad this doesn't seem to return any indication of errors :-(.
        */
       rle_row[0] = (rle_pixel *) *((*cinfo->emethods->access_big_sarray)
-					(red_channel, row, TRUE));
+					(cinfo->emethods, red_channel, row, TRUE));
       rle_row[1] = (rle_pixel *) *((*cinfo->emethods->access_big_sarray)
-					(green_channel, row, TRUE));
+					(cinfo->emethods, green_channel, row, TRUE));
       rle_row[2] = (rle_pixel *) *((*cinfo->emethods->access_big_sarray)
-					(blue_channel, row, TRUE));
+					(cinfo->emethods, blue_channel, row, TRUE));
       rle_getrow(&header, rle_row);
     }
     break;
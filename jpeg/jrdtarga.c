@@ -271,7 +271,7 @@ get_memory_row (compress_info_ptr cinfo, JSAMPARRAY pixel_row)
 
   /* Fetch that row from virtual array */
   image_ptr = (*cinfo->emethods->access_big_sarray)
-		(whole_image, source_row * cinfo->input_components, FALSE);
+		(cinfo->emethods, whole_image, source_row * cinfo->input_components, FALSE);
 
   jcopy_sample_rows(image_ptr, 0, pixel_row, 0,
 		    cinfo->input_components, cinfo->image_width);
@@ -296,7 +296,7 @@ preload_image (compress_info_ptr cinfo, JSAMPARRAY pixel_row)
   for (row = 0; row < cinfo->image_height; row++) {
     (*cinfo->methods->progress_monitor) (cinfo, row, cinfo->image_height);
     image_ptr = (*cinfo->emethods->access_big_sarray)
-			(whole_image, row * cinfo->input_components, TRUE);
+			(cinfo->emethods, whole_image, row * cinfo->input_components, TRUE);
     (*get_pixel_row) (cinfo, image_ptr);
   }
   cinfo->completed_passes++;
@@ -407,7 +407,7 @@ input_init (compress_info_ptr cinfo)
 
   if (is_bottom_up) {
     whole_image = (*cinfo->emethods->request_big_sarray)
-			((int ) width, (int ) height * components,
+			(cinfo->emethods, (int ) width, (int ) height * components,
 			 (int ) components);
     cinfo->methods->get_input_row = preload_image;
     cinfo->total_passes++;	/* count file reading as separate pass */
@@ -424,7 +424,7 @@ input_init (compress_info_ptr cinfo)
       ERREXIT(cinfo->emethods, "Colormap too large");
     /* Allocate space to store the colormap */
     colormap = (*cinfo->emethods->alloc_small_sarray)
-			((int ) maplen, 3L);
+			(cinfo->emethods, (int ) maplen, 3L);
     /* and read it from the file */
     read_colormap(cinfo, (int) maplen, UCH(targaheader[7]));
   } else {
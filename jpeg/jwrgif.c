@@ -386,11 +386,11 @@ output_init (decompress_info_ptr cinfo)
     ERREXIT(cinfo->emethods, "GIF output got confused");
   /* Allocate space for hash table */
   hash_code = (code_int FAR *) (*cinfo->emethods->alloc_medium)
-				(HSIZE * SIZEOF(code_int));
+				(cinfo->emethods, HSIZE * SIZEOF(code_int));
   hash_prefix = (code_int FAR *) (*cinfo->emethods->alloc_medium)
-				(HSIZE * SIZEOF(code_int));
+				(cinfo->emethods, HSIZE * SIZEOF(code_int));
   hash_suffix = (UINT8 FAR *) (*cinfo->emethods->alloc_medium)
-				(HSIZE * SIZEOF(UINT8));
+				(cinfo->emethods, HSIZE * SIZEOF(UINT8));
   /*
    * If we aren't quantizing, put_color_map won't be called,
    * so emit the header now.  This only happens with gray scale output.
@@ -60,7 +60,7 @@ output_init (decompress_info_ptr cinfo)
 #ifndef USE_PUTC_OUTPUT
     /* allocate space for row buffer: 1 byte/pixel */
     row_buffer = (char *) (*cinfo->emethods->alloc_small)
-			((size_t) (SIZEOF(char) * cinfo->image_width));
+			(cinfo->emethods, (size_t) (SIZEOF(char) * cinfo->image_width));
 #endif
   } else if (cinfo->out_color_space == CS_RGB) {
     /* emit header for raw PPM format */
@@ -69,7 +69,7 @@ output_init (decompress_info_ptr cinfo)
 #ifndef USE_PUTC_OUTPUT
     /* allocate space for row buffer: 3 bytes/pixel */
     row_buffer = (char *) (*cinfo->emethods->alloc_small)
-			((size_t) (3 * SIZEOF(char) * cinfo->image_width));
+			(cinfo->emethods, (size_t) (3 * SIZEOF(char) * cinfo->image_width));
 #endif
   } else {
     ERREXIT(cinfo->emethods, "PPM output must be grayscale or RGB");
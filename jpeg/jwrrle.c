@@ -81,7 +81,7 @@ output_init (decompress_info_ptr cinfo)
   
   for (ci = 0; ci < cinfo->final_out_comps; ci++) {
     channels[ci] = (*cinfo->emethods->request_big_sarray)
-			(cinfo->image_width, cinfo->image_height, 1L);
+			(cinfo->emethods, cinfo->image_width, cinfo->image_height, 1L);
   }
   
   output_colormap = NULL;	/* No output colormap as yet */
@@ -109,7 +109,7 @@ put_pixel_rows (decompress_info_ptr cinfo, int num_rows,
   for (row = 0; row < num_rows; row++) {
     for (ci = 0; ci < cinfo->final_out_comps; ci++) {
       outputrow[0] = *((*cinfo->emethods->access_big_sarray)
-			(channels[ci], cur_output_row, TRUE));
+			(cinfo->emethods, channels[ci], cur_output_row, TRUE));
       jcopy_sample_rows(pixel_data[ci], row, outputrow, 0,
 			1, cinfo->image_width);
     }
@@ -137,7 +137,7 @@ put_color_map (decompress_info_ptr cinfo, int num_colors, JSAMPARRAY colormap)
 
   /* Allocate storage for RLE-style cmap, zero any extra entries */
   cmapsize = cinfo->color_out_comps * CMAPLENGTH * SIZEOF(rle_map);
-  output_colormap = (rle_map *) (*cinfo->emethods->alloc_small) (cmapsize);
+  output_colormap = (rle_map *) (*cinfo->emethods->alloc_small) (cinfo->emethods, cmapsize);
   MEMZERO(output_colormap, cmapsize);
 
   /* Save away data in RLE format --- note 8-bit left shift! */
@@ -198,7 +198,7 @@ output_term (decompress_info_ptr cinfo)
 					 cinfo->image_height);
     for (ci = 0; ci < cinfo->final_out_comps; ci++) {
       output_rows[ci] = (rle_pixel *) *((*cinfo->emethods->access_big_sarray)
-					(channels[ci], row, FALSE));
+					(cinfo->emethods, channels[ci], row, FALSE));
     }
     rle_putrow(output_rows, (int) cinfo->image_width, &header);
   }
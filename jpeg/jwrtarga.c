@@ -102,7 +102,7 @@ output_init (decompress_info_ptr cinfo)
 #ifndef USE_PUTC_OUTPUT
     /* allocate space for row buffer: 1 byte/pixel */
     row_buffer = (char *) (*cinfo->emethods->alloc_small)
-			((size_t) (SIZEOF(char) * cinfo->image_width));
+			(cinfo->emethods, (size_t) (SIZEOF(char) * cinfo->image_width));
 #endif
   } else if (cinfo->out_color_space == CS_RGB) {
     /* For quantized output, defer writing header until put_color_map time. */
@@ -111,7 +111,7 @@ output_init (decompress_info_ptr cinfo)
 #ifndef USE_PUTC_OUTPUT
     /* allocate space for row buffer: 3 bytes/pixel */
     row_buffer = (char *) (*cinfo->emethods->alloc_small)
-			((size_t) (3 * SIZEOF(char) * cinfo->image_width));
+			(cinfo->emethods, (size_t) (3 * SIZEOF(char) * cinfo->image_width));
 #endif
   } else {
     ERREXIT(cinfo->emethods, "Targa output must be grayscale or RGB");
@@ -2666,6 +2666,7 @@ omfErr_t omfsObjectDelete(
 	{
 		if (obj)
 		{
+			file->editCount++;
 			CMDeleteObject((CMObject) obj);
 			XASSERT(!file->BentoErrorRaised, OM_ERR_BENTO_PROBLEM);
 		}
@@ -3072,6 +3073,9 @@ omfErr_t omfsWriteClassID(
 		else
 			RAISE(OM_ERR_FILEREV_NOT_SUPP);
 			
+		/* Forget any class omfsIsTypeOf() has cached for the object */
+		CMSetObjectRefCon((CMObject)obj, NULL);
+		
 		/* stop recursion in checks */
 		file->semanticCheckEnable = saveCheckStatus;
 /*		file->semanticCheckEnable = TRUE;	 */
@@ -1690,8 +1690,22 @@ struct omfiFileChecker
 {
 	 omfHdl_t		file;
 	 omTable_t	*classTable;
+	 omfInt32		partIndex;		/* Check only this slice of the */
+	 omfInt32		numParts;		/* objects and mobs (see omfsFileCheckSetPartition) */
 };
 
+/* Object or mob number itemNum (0-based) of numItems is in the checker's
+ * part if it falls in the part'th of numParts contiguous slices, and is
+ * past it if it falls in a later slice.
+ */
+#define InCheckPart(hdl, itemNum, numItems) \
+	((hdl)->numParts <= 1 || \
+	 (((itemNum) >= ((hdl)->partIndex * (numItems)) / (hdl)->numParts) && \
+	  ((itemNum) < (((hdl)->partIndex + 1) * (numItems)) / (hdl)->numParts)))
+#define PastCheckPart(hdl, itemNum, numItems) \
+	((hdl)->numParts > 1 && \
+	 ((itemNum) >= (((hdl)->partIndex + 1) * (numItems)) / (hdl)->numParts))
+
 struct callbackData
 {
 	FILE	*textOut;
@@ -1748,6 +1762,8 @@ omfErr_t omfsFileCheckInit(omfHdl_t file, omfFileCheckHdl_t *resultPtr)
 		if(result == NULL)
 			RAISE(OM_ERR_NOMEMORY);
 		result->file = file;
+		result->partIndex = 0;
+		result->numParts = 1;
 
 	 	CHECK(omfsNewClassIDTable(file, 100, &result->classTable));
 		CHECK(omfsSetTableDispose(result->classTable, internClassDispose));
@@ -1849,6 +1865,45 @@ omfErr_t omfsFileCheckCleanup(omfFileCheckHdl_t hdl)
 	return(OM_ERR_NONE);
 }
 
+/************************
+ * Function: omfsFileCheckSetPartition
+ *
+ * 		Part of the semantic checker API.
+ *		Restrict the checks made through the handle to one of numParts
+ *		contiguous slices of the objects (omfsFileCheckObjectIntegrity),
+ *		mobs (omfsFileCheckMobData), and file mobs 
+ *		(omfsFileCheckMediaIntegrity) of the file.  Checks which are made
+ *		once per file are made by part 0.
+ *
+ *		Because the slices are taken in the order the checks visit the
+ *		objects and mobs, checking every part of a file through separate
+ *		handles (or separate processes) and concatenating the text output
+ *		of each check in part order gives the same output as checking the
+ *		whole file through one handle.
+ *
+ * Argument Notes:
+ *		partIndex - Which slice to check, from 0 to numParts-1.
+ *		numParts - How many slices the file is divided into.  A numParts
+ *			of 1 checks the whole file (the default).
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		OM_ERR_BADINDEX -- partIndex is not within numParts.
+ */
+omfErr_t omfsFileCheckSetPartition(
+			omfFileCheckHdl_t hdl,
+			omfInt32		partIndex,
+			omfInt32		numParts)
+{
+	if((numParts < 1) || (partIndex < 0) || (partIndex >= numParts))
+		return(OM_ERR_BADINDEX);
+	hdl->partIndex = partIndex;
+	hdl->numParts = numParts;
+	return(OM_ERR_NONE);
+}
+
 static void	internClassDispose(void *valuePtr)
 {
 	classCheckInfo	*info = (classCheckInfo *)valuePtr;
@@ -1896,7 +1951,7 @@ omfErr_t omfsFileCheckObjectIntegrity(
 	omfType_t type;
 	omfUniqueName_t currName;
 	omfClassID_t objClass, refClass; 
-	omfInt32 loop, numObjs;
+	omfInt32 loop, numObjs, objNum, totalObjs = 0;
 	omfUInt32 reqmask = 0, optmask = 0;
 	char buf[32];
 	omfHdl_t	file = handle->file;
@@ -1921,10 +1976,37 @@ omfErr_t omfsFileCheckObjectIntegrity(
 		else
 			idProp = OMOOBJObjClass;
 
+		/* Count the objects so that they can be divided between parts */
+		if (handle->numParts > 1)
+		  {
+			omfError = omfiGetNextObject(objIter, &obj);
+			while ((omfError == OM_ERR_NONE) && obj)
+			  {
+				totalObjs++;
+				omfError = omfiGetNextObject(objIter, &obj);
+			  }
+			if ((omfError != OM_ERR_NONE) && (omfError != OM_ERR_NO_MORE_OBJECTS))
+				RAISE(omfError);
+			CHECK(omfiIteratorClear(file, objIter));
+			omfError = OM_ERR_NONE;
+		  }
+
 		/* Iterate over all of the objects in the file using Bento */
+		objNum = -1;
 		CHECK(omfiGetNextObject(objIter, &obj));
 		while (obj)
 		{
+			objNum++;
+			if (PastCheckPart(handle, objNum, totalObjs))
+				break;
+			if (!InCheckPart(handle, objNum, totalObjs))
+			  {
+				omfError = omfiGetNextObject(objIter, &obj);
+				if ((omfError != OM_ERR_NONE) && (omfError != OM_ERR_NO_MORE_OBJECTS))
+					RAISE(omfError);
+				continue;
+			  }
+
 		    omfError = omfsReadClassID(file, obj, idProp, objClass);
 
 			/* Look for MC bug: CLSD ObjID property missing */
@@ -2182,6 +2264,7 @@ omfErr_t omfsFileCheckMediaIntegrity(
 	omfObject_t	fileMob;
 	omfErr_t		omfError = OM_ERR_NONE;
  	omfSearchCrit_t searchCrit;
+	omfInt32		mobNum = 0, numFileMobs = 0;
 			
 	*numErrors = 0;
 	*numWarnings = 0;
@@ -2192,9 +2275,19 @@ omfErr_t omfsFileCheckMediaIntegrity(
 		 searchCrit.tags.mobKind = kFileMob;
 
 		CHECK(omfiIteratorAlloc(file, &mobIter));
+		if (handle->numParts > 1)
+		  {
+			CHECK(omfiGetNumMobs(file, kFileMob, &numFileMobs));
+		  }
 
 		while (omfiGetNextMob(mobIter, &searchCrit, &fileMob) == OM_ERR_NONE)
 		{
+			mobNum++;
+			if (PastCheckPart(handle, mobNum-1, numFileMobs))
+				break;
+			if (!InCheckPart(handle, mobNum-1, numFileMobs))
+				continue;
+
 			/*********
 			 *  Now call the semantic check routine for the media
 			 */
@@ -2316,18 +2409,21 @@ omfErr_t omfsFileCheckMobData(
 		cbData.numWarnings = 0;
 
 		/* First check for duplicate mobs and bail if we find any */
-		CHECK(omfiIteratorAlloc(file, &dupIter));
-		omfError = omfiFileGetNextDupMobs(dupIter, &mobID, 
-										  &numMatches, &mobList);
-		if (numMatches > 0)
+		if (handle->partIndex == 0)
 		  {
-			fprintf(textOut, 
-					"*** ERROR: Duplicate mob found in file: %ld.%ld.%ld\n", 
-					mobID);
-			(*numErrors)++;
+			CHECK(omfiIteratorAlloc(file, &dupIter));
+			omfError = omfiFileGetNextDupMobs(dupIter, &mobID, 
+											  &numMatches, &mobList);
+			if (numMatches > 0)
+			  {
+				fprintf(textOut, 
+						"*** ERROR: Duplicate mob found in file: %ld.%ld.%ld\n", 
+						mobID);
+				(*numErrors)++;
+			  }
+			CHECK(omfiIteratorDispose(file, dupIter));
+			dupIter = NULL;
 		  }
-		CHECK(omfiIteratorDispose(file, dupIter));
-		dupIter = NULL;
 
 		CHECK(omfiIteratorAlloc(file, &mobIter));
 		CHECK(omfiGetNumMobs(file, kAllMob, &numMobs));
@@ -2340,6 +2436,10 @@ omfErr_t omfsFileCheckMobData(
 			  break;
 			else if (omfError != OM_ERR_NONE)
 			  RAISE(omfError);
+			if (PastCheckPart(handle, loop-1, numMobs))
+			  break;
+			if (!InCheckPart(handle, loop-1, numMobs))
+			  continue;
 
 			/* Call VerifyMobTree() on each object in the mob */ 
 		    CHECK(omfiMobMatchAndExecute(file, mob, 0, /* level*/
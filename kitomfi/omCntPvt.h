@@ -42,6 +42,7 @@ extern          "C"
 #include "TOCEnts.h"
 #include "Containr.h"
 #include "XHandlrs.h" /* Interface to handlers is same for different streams */
+#include "Values.h"   /* For cmReadPropertyValue() */
 
 #if OMFI_MACSF_STREAM || OMFI_MACFSSPEC_STREAM
 	typedef omfErr_t  (*omfsTypedOpenFileFunc_t)(omfSessionHdl_t, omfInt16, 
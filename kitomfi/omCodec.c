@@ -915,6 +915,7 @@ omfErr_t codecWriteBlocks(
 		parms.spc.mediaXfer.xfer = xferBlock;
 		parms.spc.mediaXfer.numXfers = xferBlockCount;
 		parms.spc.mediaXfer.inter = inter;
+		parms.spc.mediaXfer.numWorkers = 1;
 	
 #ifdef OMF_CODEC_COMPAT
 		if(media->pvt->codecInfo.rev >= CODEC_REV_3)
@@ -953,7 +954,8 @@ omfErr_t codecReadBlocks(
 			omfMediaHdl_t	media,
 			omfDeinterleave_t inter,
 			omfInt16			xferBlockCount,
-			omfmMultiXfer_t *xferBlock)
+			omfmMultiXfer_t *xferBlock,
+			omfInt32			numWorkers)
 {
 	omfHdl_t        main;
 	omfCodecParms_t parms;
@@ -970,6 +972,7 @@ omfErr_t codecReadBlocks(
 		parms.spc.mediaXfer.xfer = xferBlock;
 		parms.spc.mediaXfer.numXfers = xferBlockCount;
 		parms.spc.mediaXfer.inter = inter;
+		parms.spc.mediaXfer.numWorkers = numWorkers;
 		
 #ifdef OMF_CODEC_COMPAT
 		if(media->pvt->codecInfo.rev >= CODEC_REV_3)
@@ -1820,6 +1823,91 @@ omfErr_t codecPassThrough(
 	return (OM_ERR_NONE);
 }
 
+/************************
+ * codecGetScratchBuffer
+ *
+ * 	Return a codec's per-media scratch buffer, growing it if it is
+ *		smaller than the requested size.  The buffer is kept until
+ *		codecFreeScratchBuffer, so that steady-state reads and writes
+ *		don't allocate.
+ *
+ * Argument Notes:
+ *		The contents are NOT preserved when the buffer grows.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		OM_ERR_NOMEMORY -- The buffer could not be grown.
+ */
+omfErr_t codecGetScratchBuffer(
+			omfHdl_t			main,		/* IN -- */
+			codecScratch_t		*scratch,	/* IN/OUT -- */
+			omfUInt32			size,		/* IN -- */
+			char				**buf)		/* OUT -- */
+{
+	if(size > scratch->len)
+	{
+		if(scratch->buf != NULL)
+			omOptFree(main, scratch->buf);
+		scratch->len = 0;
+		scratch->buf = (char *)omOptMalloc(main, size);
+		if(scratch->buf == NULL)
+			return(OM_ERR_NOMEMORY);
+		scratch->len = size;
+	}
+	*buf = scratch->buf;
+
+	return(OM_ERR_NONE);
+}
+
+/************************
+ * codecAddScratchSize
+ *
+ * 	Add room for count items of itemSize bytes to a running scratch
+ *		buffer size, rounded up so that the next piece stays aligned.
+ *
+ * Argument Notes:
+ *		*total is left alone on error.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		OM_ERR_NOMEMORY -- The size will not fit in 32 bits.
+ */
+omfErr_t codecAddScratchSize(
+			omfUInt32			*total,		/* IN/OUT -- */
+			omfUInt32			count,		/* IN -- */
+			omfUInt32			itemSize)	/* IN -- */
+{
+	omfUInt32	bytes;
+	
+	if(itemSize != 0 && count > 0xFFFFFFF8 / itemSize)
+		return(OM_ERR_NOMEMORY);
+	bytes = (count * itemSize + 7) & ~(omfUInt32)7;
+	if(bytes > 0xFFFFFFFF - *total)
+		return(OM_ERR_NOMEMORY);
+	*total += bytes;
+
+	return(OM_ERR_NONE);
+}
+
+/************************
+ * codecFreeScratchBuffer
+ *
+ * 	Release a codec's scratch buffer.  Safe to call on an empty one.
+ */
+void codecFreeScratchBuffer(
+			omfHdl_t			main,		/* IN -- */
+			codecScratch_t		*scratch)	/* IN/OUT -- */
+{
+	if(scratch->buf != NULL)
+		omOptFree(main, scratch->buf);
+	scratch->buf = NULL;
+	scratch->len = 0;
+}
+
 #if OMFI_CODEC_DIAGNOSTICS
 /************************
  * name
@@ -83,6 +83,20 @@
 /* Moved math.h down here to make NEXT's compiler happy */
 #include <math.h>
 
+#if PORT_USE_NATIVE64
+/* omCvt.h expands these inline for native 64-bit builds; define the
+ * exported versions below under their own names.
+ */
+#undef omfsAddInt32toInt64
+#undef omfsAddInt64toInt64
+#undef omfsSubInt64fromInt64
+#undef omfsSubInt32fromInt64
+#undef omfsMultInt32byInt64
+#undef omfsInt64AndInt64
+#undef omfsTruncInt64toInt32
+#undef omfsTruncInt64toUInt32
+#endif
+
 static omfInt32 nondropTbl[] = { 
   1L, 10L, FPSEC, FPSEC*10, FPMIN, FPMIN*10, FPHR, FPHR*10 };
 static omfInt32 dropTbl[] = { 
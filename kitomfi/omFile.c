@@ -73,6 +73,11 @@
 
 #define DEFAULT_STACK_TRACE_SIZE		2048L
 
+#define DEFAULT_READCACHE_BLOCKSIZE	(64L * 1024L)
+#define DEFAULT_READCACHE_BLOCKS		4
+#define DEFAULT_READCACHE_READAHEAD	1
+#define DEFAULT_MEDIAFILE_CACHE		8
+
 /* Private function definitions */
 omfErr_t InitFileHandle(omfSessionHdl_t session,
 								omfFileFormat_t fmt, omfHdl_t *result);
@@ -83,7 +88,9 @@ static omfErr_t BuildDatakindCache(omfHdl_t file, omfInt32 defTableSize,
 			omTable_t **dest);
 static omfErr_t BuildEffectDefCache(omfHdl_t file, omfInt32 defTableSize,
 			omTable_t **dest);
-static omfErr_t BuildMediaCache(omfHdl_t file);
+static omfErr_t BuildMediaCache(omfHdl_t file, omfBool lazy);
+static omfErr_t FillMediaCache(omfHdl_t file);
+static omfErr_t FillMobTable(omfHdl_t file);
 static omfErr_t omfsInternOpenFile(fileHandleType stream,
 			omfSessionHdl_t session, CMContainerUseMode useMode,
 			openType_t type, omfHdl_t *result);
@@ -201,6 +208,20 @@ omfErr_t omfsBeginSession(
 		sess->codecMDES = NULL;
 		sess->openCB = NULL;
 		sess->closeSessCB = NULL;
+		sess->readCacheBlockSize = DEFAULT_READCACHE_BLOCKSIZE;
+		sess->readCacheNumBlocks = DEFAULT_READCACHE_BLOCKS;
+		sess->readCacheReadAhead = DEFAULT_READCACHE_READAHEAD;
+		sess->readCacheHits = 0;
+		sess->readCacheMisses = 0;
+		sess->mediaFiles = NULL;
+		sess->mediaFileCacheSize = DEFAULT_MEDIAFILE_CACHE;
+		sess->mediaFileClock = 0;
+		sess->lazyOpen = FALSE;
+		sess->nextClassIndex = 0;
+		sess->classAncestryWords = 0;
+		sess->classAncestry1X = NULL;
+		sess->classAncestry2X = NULL;
+		sess->classAncestryValid = FALSE;
 		
 		/********************* Class definitions ***************************/
 		CHECK(omfsNewClass(sess, kClsRequired, kOmfTstRev1x, OMClassCPNT, 
@@ -1239,6 +1260,144 @@ omfErr_t omfsSetSessionIOHandlers( omfSessionHdl_t session,
 	return OM_ERR_NONE;
 }
 
+/************************
+ * Function: omfsSetReadCacheSize
+ *
+ * 	Sets the geometry of the read cache used by the standard (ANSI)
+ *		container handler.  The new settings apply to files opened or
+ *		created after the call.
+ *
+ * Argument Notes:
+ *		blockSize - The size of each cache block in bytes.  Reads of
+ *			this size or larger bypass the cache.
+ *		numBlocks - The number of blocks per file, or 0 to turn off
+ *			the cache.
+ *		readAhead - The number of extra blocks to read when a miss
+ *			continues a sequential scan (0 for no read-ahead).  Must be
+ *			less than numBlocks.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ *		OM_ERR_BAD_SESSION - The session ptr was not valid.
+ *		OM_ERR_INVALID_CACHE_SIZE - The cache parameters are out of range.
+ */
+omfErr_t omfsSetReadCacheSize(
+			omfSessionHdl_t	session,		/* IN - For this session */
+			omfInt32			blockSize,	/* IN - use blocks of this size */
+			omfInt32			numBlocks,	/* IN - and this many of them */
+			omfInt32			readAhead)	/* IN - reading this many extra when sequential */
+{
+	if ((session == NULL) || (session->cookie != SESSION_COOKIE))
+		return (OM_ERR_BAD_SESSION);
+	if ((numBlocks < 0) || (readAhead < 0))
+		return (OM_ERR_INVALID_CACHE_SIZE);
+	if ((numBlocks != 0) && ((blockSize < 512) || (readAhead >= numBlocks)))
+		return (OM_ERR_INVALID_CACHE_SIZE);
+
+	session->readCacheBlockSize = blockSize;
+	session->readCacheNumBlocks = numBlocks;
+	session->readCacheReadAhead = readAhead;
+
+	return (OM_ERR_NONE);
+}
+
+/************************
+ * Function: omfsGetReadCacheStats
+ *
+ * 	Returns the number of block lookups which hit and missed in the
+ *		container read cache, totalled over all files in the session.
+ *		The counters may optionally be cleared.  The counts are kept per
+ *		file, so a file being read by another thread at the time adds in
+ *		whatever it had counted so far.
+ *
+ * Argument Notes:
+ *		hits, misses - May be NULL if the value is not needed.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ *		OM_ERR_BAD_SESSION - The session ptr was not valid.
+ */
+omfErr_t omfsGetReadCacheStats(
+			omfSessionHdl_t	session,		/* IN - For this session */
+			omfUInt32		*hits,		/* OUT - return the # of hits */
+			omfUInt32		*misses,		/* OUT - and the # of misses */
+			omfBool			reset)		/* IN - and optionally clear them */
+{
+	omfHdl_t	file;
+	omfUInt32	totalHits, totalMisses;
+
+	if ((session == NULL) || (session->cookie != SESSION_COOKIE))
+		return (OM_ERR_BAD_SESSION);
+
+	totalHits = session->readCacheHits;
+	totalMisses = session->readCacheMisses;
+	for (file = session->topFile; file != NULL; file = file->prevFile)
+	{
+		totalHits += file->readCacheHits;
+		totalMisses += file->readCacheMisses;
+	}
+	if (hits != NULL)
+		*hits = totalHits;
+	if (misses != NULL)
+		*misses = totalMisses;
+	if (reset)
+	{
+		session->readCacheHits = 0;
+		session->readCacheMisses = 0;
+		for (file = session->topFile; file != NULL; file = file->prevFile)
+		{
+			file->readCacheHits = 0;
+			file->readCacheMisses = 0;
+		}
+	}
+
+	return (OM_ERR_NONE);
+}
+
+/************************
+ * Function: omfsSetLazyOpen
+ *
+ * 	Selects whether files opened read-only (omfsOpenFile) build their
+ *		tables of mobs and media data objects while opening, or wait
+ *		until the first lookup by mob ID or iteration over the mobs.
+ *		Lazy open makes opening a file with many mobs nearly constant
+ *		time, when only the header or a few mobs are needed.  Files
+ *		opened for modify always build the tables while opening.
+ *		The setting applies to files opened after the call.
+ *
+ * Argument Notes:
+ *		lazy - TRUE to defer building the tables, FALSE (the default)
+ *			to build them while opening.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ *		OM_ERR_BAD_SESSION - The session ptr was not valid.
+ *
+ * NOTE: With lazy open, a badly formed mob index is found on first
+ *		use instead of failing the open, and lookups then behave as if
+ *		the mobs past the bad entry were not in the file.
+ */
+omfErr_t omfsSetLazyOpen(
+			omfSessionHdl_t	session,		/* IN - For this session */
+			omfBool			lazy)			/* IN - defer building the tables */
+{
+	if ((session == NULL) || (session->cookie != SESSION_COOKIE))
+		return (OM_ERR_BAD_SESSION);
+
+	session->lazyOpen = lazy;
+
+	return (OM_ERR_NONE);
+}
+
 
 
 /************************
@@ -1338,12 +1497,20 @@ omfErr_t omfsEndSession(
 	
 		if(session->ident)
 			omOptFree(NULL, session->ident);
+		if(session->classAncestry1X != NULL)
+			omOptFree(NULL, session->classAncestry1X);
+		if(session->classAncestry2X != NULL)
+			omOptFree(NULL, session->classAncestry2X);
 		omOptFree(NULL, session);
 	}
 	XEXCEPT
 	{
 		if(session->ident)
 			omOptFree(NULL, session->ident);
+		if(session->classAncestry1X != NULL)
+			omOptFree(NULL, session->classAncestry1X);
+		if(session->classAncestry2X != NULL)
+			omOptFree(NULL, session->classAncestry2X);
 		omOptFree(NULL, session);
 	}
 	XEND
@@ -2306,12 +2473,16 @@ omfErr_t omfsCloseFile(omfHdl_t file)
 			omfsTableDisposeAll(file->propReverse);
 		  if (file->typeReverse)
 			omfsTableDisposeAll(file->typeReverse);
+		  ompvtDisposeIDCaches(file);
+		  ompvtDisposeMobIndex(file);
 		  if (file->mobs)
 			{
 			  omfsTableDisposeAll(file->mobs);
 			}
 		  if (file->dataObjs)
 			omfsTableDispose(file->dataObjs);
+		  if (file->sequIndexes)
+			omfsTableDisposeAll(file->sequIndexes);
 		  if (file->datakinds)
 			omfsTableDispose(file->datakinds);
 		  if (file->effectDefs)
@@ -2321,6 +2492,7 @@ omfErr_t omfsCloseFile(omfHdl_t file)
 		{
 			if(file->rawFileDesc != NULL)
 				omOptFree(NULL, file->rawFileDesc);
+			ompvtDisposeStreamIOLock(file);
 		}
 
 #ifdef OMFI_ERROR_TRACE
@@ -2464,11 +2636,9 @@ static omfErr_t omfsInternOpenFile(fileHandleType stream,
 	ContainerPtr		bentoCntPtr;
 	omfObject_t     	head;
 	omfErr_t      		status, finalStatus = OM_ERR_NONE;
-	omfInt32				mobTableSize, n, siz, errnum;
-	omfObject_t			obj;
-	omfUID_t				uid;
-	omfObjIndexElement_t elem;
+	omfInt32				mobTableSize, errnum;
 	omfProperty_t		prop;
+	omfBool				lazy;
 	
 	if (session == NULL)
 	  return(OM_ERR_BAD_SESSION);	
@@ -2685,41 +2855,17 @@ static omfErr_t omfsInternOpenFile(fileHandleType stream,
 		CHECK(omfsNewUIDTable(file, mobTableSize, &(file->mobs)));
 		CHECK(omfsSetTableDispose(file->mobs, &MobDisposeMap1X));
 
-		if(file->setrev == kOmfRev2x)
+		/* Read-only files may defer reading the mob IDs (and the 1.x
+		 * track mappings) until the table is first searched.
+		 */
+		lazy = session->lazyOpen && (type == kOmOpenRead);
+		if(lazy)
 		{
-			siz = omfsLengthObjRefArray(file, head, OMHEADMobs);
-			for(n = 1; n <= siz; n++)
-			{
-				CHECK(omfsGetNthObjRefArray(file, head, OMHEADMobs, &obj, n));
-				CHECK(omfsReadUID(file, obj, OMMOBJMobID, &uid));
-				CHECK(AddMobTableEntry(file, obj, uid, kOmTableDupAddDup));
-			}
+			CHECK(omfsSetTableFill(file->mobs, &FillMobTable));
 		}
 		else
 		{
-			siz = omfsLengthObjIndex(file, head, OMCompositionMobs);
-			for(n = 1; n <= siz; n++)
-			{
-				CHECK(omfsGetNthObjIndex(file, head, OMCompositionMobs, 
-										 &elem, n));
-				CHECK(AddMobTableEntry(file, elem.Mob, elem.ID, 
-									   kOmTableDupAddDup));
-				if((file->setrev == kOmfRev1x) || (file->setrev == kOmfRevIMA))
-				{
-					CHECK(ReadTrackMapping(file, elem.Mob));
-				}
-			}
-			siz = omfsLengthObjIndex(file, head, OMSourceMobs);
-			for(n = 1; n <= siz; n++)
-			{
-				CHECK(omfsGetNthObjIndex(file, head, OMSourceMobs, &elem, n) );
-				CHECK(AddMobTableEntry(file, elem.Mob, elem.ID, 
-									   kOmTableDupAddDup));
-				if((file->setrev == kOmfRev1x) || (file->setrev == kOmfRevIMA))
-				{
-					CHECK(ReadTrackMapping(file, elem.Mob));
-				}
-			}
+			CHECK(FillMobTable(file));
 		}
 
 		/* Register any other properties and types in the file in the cache */
@@ -2730,7 +2876,7 @@ static omfErr_t omfsInternOpenFile(fileHandleType stream,
 			CHECK((*file->session->openCB)(file));
 		}
 
-		CHECK(BuildMediaCache(file));
+		CHECK(BuildMediaCache(file, lazy));
 		*result = file;
 	}
 	XEXCEPT
@@ -2749,12 +2895,16 @@ static omfErr_t omfsInternOpenFile(fileHandleType stream,
 			 omfsTableDisposeAll(file->propReverse);
 		  if (file->typeReverse)
 			 omfsTableDisposeAll(file->typeReverse);
+		  ompvtDisposeIDCaches(file);
+		  ompvtDisposeMobIndex(file);
 		  if (file->mobs)
 			 {
 				omfsTableDisposeAll(file->mobs);
 			 }
 		  if (file->dataObjs)
 			 omfsTableDispose(file->dataObjs);
+		  if (file->sequIndexes)
+			 omfsTableDisposeAll(file->sequIndexes);
 		  if (file->datakinds)
 			 omfsTableDispose(file->datakinds);
 		  if (file->effectDefs)
@@ -2790,6 +2940,76 @@ static omfErr_t omfsInternOpenFile(fileHandleType stream,
 }
 
 
+/************************
+ * Function: FillMobTable (INTERNAL)
+ *
+ * 		Adds every source and composition mob in the file to the mob
+ *		table, reading the track mapping of each one for 1.x files.
+ *		Called while opening the file, or on the first search of the
+ *		table if the session uses lazy open (see omfsSetLazyOpen).
+ *
+ * Argument Notes:
+ *		<none>.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ */
+static omfErr_t FillMobTable(omfHdl_t file)
+{
+	omfInt32					siz, n;
+	omfObject_t				obj;
+	omfUID_t					uid;
+	omfObjIndexElement_t	elem;
+	
+	XPROTECT(file)
+	{
+		if(file->setrev == kOmfRev2x)
+		{
+			siz = omfsLengthObjRefArray(file, file->head, OMHEADMobs);
+			for(n = 1; n <= siz; n++)
+			{
+				CHECK(omfsGetNthObjRefArray(file, file->head, OMHEADMobs, &obj, n));
+				CHECK(omfsReadUID(file, obj, OMMOBJMobID, &uid));
+				CHECK(AddMobTableEntry(file, obj, uid, kOmTableDupAddDup));
+			}
+		}
+		else
+		{
+			siz = omfsLengthObjIndex(file, file->head, OMCompositionMobs);
+			for(n = 1; n <= siz; n++)
+			{
+				CHECK(omfsGetNthObjIndex(file, file->head, OMCompositionMobs, 
+										 &elem, n));
+				CHECK(AddMobTableEntry(file, elem.Mob, elem.ID, 
+									   kOmTableDupAddDup));
+				if((file->setrev == kOmfRev1x) || (file->setrev == kOmfRevIMA))
+				{
+					CHECK(ReadTrackMapping(file, elem.Mob));
+				}
+			}
+			siz = omfsLengthObjIndex(file, file->head, OMSourceMobs);
+			for(n = 1; n <= siz; n++)
+			{
+				CHECK(omfsGetNthObjIndex(file, file->head, OMSourceMobs, &elem, n) );
+				CHECK(AddMobTableEntry(file, elem.Mob, elem.ID, 
+									   kOmTableDupAddDup));
+				if((file->setrev == kOmfRev1x) || (file->setrev == kOmfRevIMA))
+				{
+					CHECK(ReadTrackMapping(file, elem.Mob));
+				}
+			}
+		}
+	}
+	XEXCEPT
+	XEND
+	
+	return(OM_ERR_NONE);
+}
+
+
 /************************
  * Function: BuildMediaCache (INTERNAL)
  *
@@ -2799,6 +3019,50 @@ static omfErr_t omfsInternOpenFile(fileHandleType stream,
  *		own in the opaque file handle.
  *
  * Argument Notes:
+ *		lazy - Create the table empty, and fill it on first use.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ */
+static omfErr_t BuildMediaCache(omfHdl_t file, omfBool lazy)
+{
+	omfInt32						siz, dataObjTableSize;
+	
+	XPROTECT(file)
+	{
+		if(file->setrev == kOmfRev2x)
+		   siz = omfsLengthObjRefArray(file, file->head, OMHEADMediaData);
+		else
+			siz = omfsLengthObjIndex(file, file->head, OMMediaData);
+		dataObjTableSize = (siz < DEFAULT_NUM_DATAOBJ ? 
+								  DEFAULT_NUM_DATAOBJ : siz);
+		CHECK(omfsNewUIDTable(file, dataObjTableSize, &(file->dataObjs)));
+		if(lazy)
+		{
+			CHECK(omfsSetTableFill(file->dataObjs, &FillMediaCache));
+		}
+		else
+		{
+			CHECK(FillMediaCache(file));
+		}
+	}
+	XEXCEPT
+	XEND
+	
+	return(OM_ERR_NONE);
+}
+
+
+/************************
+ * Function: FillMediaCache (INTERNAL)
+ *
+ * 		Adds every media data object in the file to the data object
+ *		table.
+ *
+ * Argument Notes:
  *		<none>.
  *
  * ReturnValue:
@@ -2807,9 +3071,9 @@ static omfErr_t omfsInternOpenFile(fileHandleType stream,
  * Possible Errors:
  *		Standard errors (see top of file).
  */
-static omfErr_t BuildMediaCache(omfHdl_t file)
+static omfErr_t FillMediaCache(omfHdl_t file)
 {
-	omfInt32						siz, n, dataObjTableSize;
+	omfInt32						siz, n;
 	omfObject_t				obj;
 	omfUID_t					uid;
 	omfObjIndexElement_t	elem;
@@ -2819,9 +3083,6 @@ static omfErr_t BuildMediaCache(omfHdl_t file)
 		if(file->setrev == kOmfRev2x)
 		{
 		   siz = omfsLengthObjRefArray(file, file->head, OMHEADMediaData);
-			dataObjTableSize = (siz < DEFAULT_NUM_DATAOBJ ? 
-									  DEFAULT_NUM_DATAOBJ : siz);
-			CHECK(omfsNewUIDTable(file, dataObjTableSize, &(file->dataObjs)));
 			for(n = 1; n <= siz; n++)
 			  {
 				 CHECK(omfsGetNthObjRefArray(file, file->head, OMHEADMediaData, 
@@ -2833,9 +3094,6 @@ static omfErr_t BuildMediaCache(omfHdl_t file)
 		else
 		{
 			siz = omfsLengthObjIndex(file, file->head, OMMediaData);
-			dataObjTableSize = (siz < DEFAULT_NUM_DATAOBJ ? 
-									  DEFAULT_NUM_DATAOBJ : siz);
-			CHECK(omfsNewUIDTable(file, dataObjTableSize, &(file->dataObjs)));
 			for(n = 1; n <= siz; n++)
 					{
 				CHECK(omfsGetNthObjIndex(file, file->head, OMMediaData, &elem, n));
@@ -2944,8 +3202,21 @@ omfErr_t InitFileHandle(
 		file->types = NULL;
 		file->propReverse = NULL;
 		file->typeReverse = NULL;
+		file->typeCache = NULL;
+		file->typeCacheSize = 0;
+		file->propCache = NULL;
+		file->propCacheSize = 0;
 		file->mobs = NULL;
 		file->dataObjs = NULL;
+		file->readCacheHits = 0;
+		file->readCacheMisses = 0;
+		file->sequIndexes = NULL;
+		file->sequIndexEdits = 0;
+		file->editCount = 0;
+		file->mobIndex = NULL;
+		file->mobIndexEdits = 0;
+		file->mobEditCount = 0;
+		file->streamIOLock = NULL;
 		file->datakinds = NULL;
 		file->effectDefs = NULL;
 		file->byteOrderProp = 0;
@@ -3039,6 +3310,7 @@ static omfErr_t BuildPropIDCache(omfHdl_t file)
 			bentoID = CvtPropertyToBento(file, prop);
 			CHECK(omfsTableAddProperty(destTable, prop, &bentoID,
 									sizeof(bentoID), kOmTableDupError));
+			CHECK(ompvtCachePropertyID(file, prop, bentoID));
 			CHECK(omfsTableAddValueBlock(file->propReverse, &bentoID, sizeof(bentoID), &prop,
 									sizeof(prop), kOmTableDupError));
 		
@@ -3123,6 +3395,7 @@ static omfErr_t BuildTypeIDCache(omfHdl_t file)
 			typeCache.bentoID = CvtTypeToBento(file, type, &typeCache.swab);
 			CHECK(omfsTableAddType(destTable, type, &typeCache,
 									sizeof(typeCache)));
+			CHECK(ompvtCacheTypeID(file, type, typeCache.bentoID, typeCache.swab));
 			CHECK(omfsTableAddValueBlock(file->typeReverse,
 									&typeCache.bentoID, sizeof(typeCache.bentoID),
 									&type, sizeof(type), kOmTableDupError));
@@ -3133,6 +3406,9 @@ static omfErr_t BuildTypeIDCache(omfHdl_t file)
 			file->byteOrderType = CvtTypeToBento(file, OMInt16, NULL);
 		file->objTagType1x = CvtTypeToBento(file, OMObjectTag, NULL);
 		file->objClassType2x = CvtTypeToBento(file, OMClassID, NULL);
+		/* Object tags & class IDs are byte arrays, and are never swabbed */
+		CHECK(ompvtCacheTypeID(file, OMObjectTag, file->objTagType1x, kNeverSwab));
+		CHECK(ompvtCacheTypeID(file, OMClassID, file->objClassType2x, kNeverSwab));
 		
 		/* NOW link the table into the file handle so that it may be used
 		 * for lookups
@@ -3662,6 +3938,9 @@ static omfErr_t UpdateLocalCLSD(
 										  tstRev, classID, superclassID));
 			  }
 		 } /* for */
+		 
+		/* Precompute the class ancestry used by omfsIsTypeOf() */
+		CHECK(omfsBuildClassAncestry(file->session));
 	 }
 	XEXCEPT
 	{
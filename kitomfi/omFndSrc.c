@@ -106,6 +106,37 @@
 #define TRACE 0
 #define SCOPEBLOCKS 10
 
+/* Offset index of one sequence, used by MobFindCpntByPosition.  Holds
+ * every component with its offset as returned by omfiSequenceGetNextCpnt,
+ * and the searchable segments in sequence order, with their lengths
+ * already shortened by any incoming transition.
+ */
+typedef struct
+{
+	omfObject_t		cpnt;
+	omfPosition_t	offset;
+} sequCpnt_t;
+
+typedef struct
+{
+	omfInt32			cpntIndex;	/* Into cpnts[] */
+	omfPosition_t	start;		/* Relative to the start of the sequence */
+	omfPosition_t	end;
+	omfLength_t		length;
+	omfPosition_t	tranOffset;	/* Position into clip if tran before */
+} sequSeg_t;
+
+typedef struct
+{
+	omfInt32			numCpnts;
+	omfInt32			numSegs;
+	omfBool			sorted;		/* Segment ends never decrease */
+	sequCpnt_t		*cpnts;
+	sequSeg_t		*segs;
+} sequIndex_t;
+
+#define ALIGN_SEQU_INDEX(n) (((n) + 7) & ~(size_t)7)
+
 /*******************************/
 /* Static Function Definitions */
 /*******************************/
@@ -148,6 +179,11 @@ static omfErr_t IteratorCopy(
 	omfIterHdl_t inIter,   /* IN - Iterator to copy */ 
     omfIterHdl_t *outIter);  /* IN - Iterator to copy to */
 
+static omfErr_t GetSequenceIndex(
+	omfHdl_t file,           /* IN - File Handle */
+	omfObject_t sequence,    /* IN - Sequence to index */
+	sequIndex_t **result);   /* OUT - Index, owned by the file */
+
 static omfErr_t MobFindLeaf( 
 					 omfHdl_t file,
 					 omfMobObj_t mob,
@@ -2508,6 +2544,185 @@ omfErr_t SequencePeekNextCpnt(omfIterHdl_t iterHdl,
   return(OM_ERR_NONE);
 }
 
+/*************************************************************************
+ * Private Function: GetSequenceIndex()
+ *
+ *      Returns the offset index of a sequence, building it on first use.
+ *      The segments are found the same way as walking the sequence with
+ *      omfiSequenceGetNextCpnt(): zero-length components are skipped,
+ *      a segment following a transition is shortened by the transition
+ *      length, and a segment completely covered by one is dropped.
+ *
+ *      Indexes are kept in a per-file table keyed by the sequence object,
+ *      and are all thrown away as soon as anything in the file is
+ *      written or deleted.
+ *
+ * Argument Notes:
+ *      The index is owned by the file.  Don't hold onto it across calls
+ *      which may modify the file.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ *      OM_ERR_NOMEMORY - Couldn't allocate the index.
+ *************************************************************************/
+static omfInt32 SequIndexMap(void *temp)
+{
+  return((omfInt32)((size_t)(*(omfObject_t *)temp) >> 3));
+}
+
+static omfBool SequIndexCompare(void *temp1, void *temp2)
+{
+  return((*(omfObject_t *)temp1 == *(omfObject_t *)temp2) ? TRUE : FALSE);
+}
+
+static void SequIndexDispose(void *valuePtr)
+{
+  /* The index is a single block, freed by the table */
+}
+
+static omfErr_t GetSequenceIndex(
+	omfHdl_t file,           /* IN - File Handle */
+	omfObject_t sequence,    /* IN - Sequence to index */
+	sequIndex_t **result)    /* OUT - Index, owned by the file */
+{
+  omfIterHdl_t sequIter = NULL;
+  sequIndex_t *index = NULL;
+  sequSeg_t *seg;
+  omfInt32 loop, numCpnt;
+  omfLength_t cpntLen, tranLen, zeroLen;
+  omfPosition_t sequOffset;
+  omfPosition_t sclpTranOffset;
+  omfObject_t cpnt;
+  omfBool prevTran = FALSE;
+  size_t cpntsOffset, segsOffset;
+  omfErr_t omfError = OM_ERR_NONE;
+
+  *result = NULL;
+  omfsCvtInt32toInt64(0, &zeroLen);
+  omfsCvtInt32toInt64(0, &tranLen);
+  omfsCvtInt32toPosition(0, sclpTranOffset);
+
+  XPROTECT(file)
+	{
+	  if ((file->sequIndexes != NULL) && 
+		  (file->sequIndexEdits != file->editCount))
+		{
+		  CHECK(omfsTableDisposeItems(file->sequIndexes));
+		}
+	  file->sequIndexEdits = file->editCount;
+
+	  if (file->sequIndexes == NULL)
+		{
+		  CHECK(omfsNewTable(file, sizeof(omfObject_t), SequIndexMap,
+							 SequIndexCompare, 16, &file->sequIndexes));
+		  CHECK(omfsSetTableDispose(file->sequIndexes, SequIndexDispose));
+		}
+	  else
+		{
+		  *result = (sequIndex_t *)omfsTableLookupPtr(file->sequIndexes,
+													  &sequence);
+		  if (*result != NULL)
+			return(OM_ERR_NONE);
+		}
+
+	  CHECK(omfiSequenceGetNumCpnts(file, sequence, &numCpnt));
+	  segsOffset = ALIGN_SEQU_INDEX(sizeof(sequIndex_t));
+	  cpntsOffset = segsOffset + 
+		ALIGN_SEQU_INDEX(numCpnt * sizeof(sequSeg_t));
+	  index = (sequIndex_t *)omOptMalloc(file, 
+							cpntsOffset + numCpnt * sizeof(sequCpnt_t));
+	  if (index == NULL)
+		RAISE(OM_ERR_NOMEMORY);
+	  index->numCpnts = numCpnt;
+	  index->numSegs = 0;
+	  index->sorted = TRUE;
+	  index->segs = (sequSeg_t *)((char *)index + segsOffset);
+	  index->cpnts = (sequCpnt_t *)((char *)index + cpntsOffset);
+
+	  CHECK(omfiIteratorAlloc(file, &sequIter));
+	  for (loop = 0; loop < numCpnt; loop++)
+		{
+		  CHECK(omfiSequenceGetNextCpnt(sequIter, sequence, NULL, 
+										&sequOffset, &cpnt));
+		  index->cpnts[loop].cpnt = cpnt;
+		  index->cpnts[loop].offset = sequOffset;
+
+		  CHECK(omfiComponentGetLength(file, cpnt, &cpntLen));
+		  /* Handle zero-length clips */
+		  if (omfsInt64Equal(cpntLen, zeroLen))
+			continue;
+
+		  /* Is there was a previous transition, calculate the new
+		   * length for the outgoing segment.
+		   */
+		  if (prevTran)
+			{
+			  CHECK(omfsSubInt64fromInt64(tranLen, &cpntLen));
+			  prevTran = FALSE;
+
+			  /* If the transition completely consumes the outgoing 
+			   * segment, it can never be found.
+			   */
+			  if (omfsInt64Equal(cpntLen, zeroLen))
+				{
+				  omfsCvtInt32toInt64(0, &tranLen); /* Reset */
+				  continue;
+				}
+			  else
+				{
+				  CHECK(omfsAddInt64toInt64(tranLen, &sclpTranOffset));
+				  omfsCvtInt32toInt64(0, &tranLen); /* Reset */
+				}
+			}
+		  else
+			{
+			  omfsCvtInt32toPosition(0, sclpTranOffset);  /* Reset */
+			}
+
+		  /* Transitions are found through the segment before them */
+		  if (omfiIsATransition(file, cpnt, &omfError))
+			{
+			  tranLen = cpntLen;
+			  prevTran = TRUE;
+			  continue;
+			}
+
+		  seg = &index->segs[index->numSegs];
+		  seg->cpntIndex = loop;
+		  seg->start = sequOffset;
+		  seg->end = sequOffset;
+		  CHECK(omfsAddInt64toInt64(cpntLen, &seg->end));
+		  seg->length = cpntLen;
+		  seg->tranOffset = sclpTranOffset;
+		  if ((index->numSegs != 0) && 
+			  omfsInt64Less(seg->end, index->segs[index->numSegs-1].end))
+			index->sorted = FALSE;
+		  index->numSegs++;
+		}
+	  CHECK(omfiIteratorDispose(file, sequIter));
+	  sequIter = NULL;
+
+	  CHECK(omfsTableAddValuePtr(file->sequIndexes, &sequence, 
+								 sizeof(omfObject_t), index, 
+								 kOmTableDupReplace));
+	}
+  XEXCEPT
+	{
+	  if (sequIter)
+		omfiIteratorDispose(file, sequIter);
+	  if (index)
+		omOptFree(file, index);
+	  return(XCODE());
+	}
+  XEND;
+
+  *result = index;
+  return(OM_ERR_NONE);
+}
+
 /*************************************************************************
  * Private Function: MobFindCpntByPosition()
  *
@@ -2517,6 +2732,8 @@ omfErr_t SequencePeekNextCpnt(omfIterHdl_t iterHdl,
  *      rendering if it exists.  For selectors, it follows the selected slot.
  *      For a media group, it uses the media criteria to select a slot.
  *      For nested scopes, it follows the "value slot" (last slot).
+ *      Components of a sequence are found by a binary search of the
+ *      sequence's offset index (see GetSequenceIndex()).
  *      NOTE: this function currently does not handle scope references.
  *
  *      If the object is not found, the error OM_ERR_TRAVERSAL_NOT_POSS will 
@@ -2549,17 +2766,17 @@ omfErr_t MobFindCpntByPosition(
                                          in case segment was incoming or
                                          outgoing segment of a transition */
 {
-  omfIterHdl_t sequIter = NULL;
-  omfInt32 loop, numCpnt;
-  omfLength_t tranLen, shortLen, zeroLen, nextLen;
-  omfPosition_t sequOffset, tranPos, segEnd;
+  sequIndex_t *sequIndex;
+  sequSeg_t *sequSeg;
+  omfInt32 lo, hi, mid;
+  omfLength_t shortLen, nextLen;
+  omfPosition_t relPos, tranPos;
   omfObject_t cpnt = NULL, render = NULL, effect = NULL;
-  omfBool prevTran = FALSE;
   omfPosition_t sclpTranOffset; /* Position into clip if tran before */
 
   omfInt32 numSlots;
   omfLength_t cpntLen, tmpLength;
-  omfPosition_t currPos, endPos, zeroPos;
+  omfPosition_t currPos, endPos;
   omfObject_t seg = NULL, selected = NULL;
   omfObject_t sourceClip = NULL, tmpFound = NULL;
   omfObject_t tmpSlot = NULL, nextCpnt = NULL;
@@ -2568,10 +2785,7 @@ omfErr_t MobFindCpntByPosition(
 	
   *foundObj = NULL;
   omfsCvtInt32toInt64(0, diffPos);
-  omfsCvtInt32toPosition(0, zeroPos);
   omfsCvtInt32toPosition(0, sclpTranOffset); 
-  omfsCvtInt32toInt64(0, &tranLen);
-  omfsCvtInt32toInt64(0, &zeroLen);
   omfsCvtInt32toInt64(0, &shortLen);
   omfAssertValidFHdl(file);
   omfAssert((rootObj != NULL), file, OM_ERR_NULLOBJECT);
@@ -2612,149 +2826,118 @@ omfErr_t MobFindCpntByPosition(
 		  CHECK(omfiComponentGetLength(file, rootObj, foundLen));
 		}
 
-	  /* If sequence, iterate through until find the CPNT at offset */
+	  /* If sequence, look up the CPNT at offset in the sequence's index */
 	  else if (omfiIsASequence(file, rootObj, &omfError))
 		{
-		  CHECK(omfiIteratorAlloc(file, &sequIter));
-		  CHECK(omfiSequenceGetNumCpnts(file, rootObj, &numCpnt));
-		  for (loop = 1; loop <= numCpnt; loop++)
-			{
-			  CHECK(omfiSequenceGetNextCpnt(sequIter, rootObj, NULL, 
-											&sequOffset, &cpnt));
+		  CHECK(GetSequenceIndex(file, rootObj, &sequIndex));
 
-			  CHECK(omfiComponentGetLength(file, cpnt, &cpntLen));
-			  /* Handle zero-length clips */
-			  if(omfsInt64Equal(cpntLen, zeroPos))	
-			  	continue;
-
-			  /* Set the current position to the startPos (position of 
-			   * the beginning of the sequence in the track), then add
-			   * the position of sequence's current component 
-			   */
-			  currPos = startPos;
-			  omfsAddInt64toInt64(sequOffset, &currPos);
-
-			  /* Is there was a previous transition, calculate the new
-			   * length for the outgoing segment.
-			   */
-			  if (prevTran)
+		  /* Find the first segment which ends after the position */
+		  relPos = position;
+		  CHECK(omfsSubInt64fromInt64(startPos, &relPos));
+		  if (sequIndex->sorted)
+			{
+			  lo = 0;
+			  hi = sequIndex->numSegs;
+			  while (lo < hi)
 				{
-				  CHECK(omfsSubInt64fromInt64(tranLen, &cpntLen));
-				  prevTran = FALSE;
-
-				  /* If the transition completely consumes the outgoing 
-				   * segment, get the next segment.
-				   */
-				  if (omfsInt64Equal(cpntLen, zeroLen))
-					{
-					  omfsCvtInt32toInt64(0, &tranLen); /* Reset */
-					  continue;
-					}
-				  else 	/* Else, continue searching through sequence below */
-					{
-					  CHECK(omfsAddInt64toInt64(tranLen, &sclpTranOffset));
-					  omfsCvtInt32toInt64(0, &tranLen); /* Reset */
-					}
+				  mid = (lo + hi) / 2;
+				  if (omfsInt64Less(relPos, sequIndex->segs[mid].end))
+					hi = mid;
+				  else
+					lo = mid + 1;
 				}
-			  else
+			}
+		  else
+			{
+			  for (lo = 0; lo < sequIndex->numSegs; lo++)
 				{
-				  omfsCvtInt32toPosition(0, sclpTranOffset);  /* Reset */
+				  if (omfsInt64Less(relPos, sequIndex->segs[lo].end))
+					break;
 				}
+			}
+
+		  if (lo < sequIndex->numSegs)
+			{
+			  sequSeg = &sequIndex->segs[lo];
+			  cpnt = sequIndex->cpnts[sequSeg->cpntIndex].cpnt;
+			  currPos = startPos;
+			  CHECK(omfsAddInt64toInt64(sequSeg->start, &currPos));
+			  cpntLen = sequSeg->length;
+			  shortLen = cpntLen;
+			  sclpTranOffset = sequSeg->tranOffset;
 
-			  /* If this is a transition, skip.  The case where the requested
-			   * position falls in a transition is handled below (by looking
-			   * ahead, if the position falls in a segment that may have
-			   * an overlapping transition in it.  
+			  /* If the next component is a transition, see if the
+			   * requested position points into the Transition.
 			   */
-			  if (omfiIsATransition(file, cpnt, &omfError))
+			  nextCpnt = NULL;
+			  omfsCvtInt32toPosition(0, tranPos);
+			  if (sequSeg->cpntIndex + 1 < sequIndex->numCpnts)
 				{
-				  tranLen = cpntLen;
-				  prevTran = TRUE;
-				  continue;  /* Skip to next component in sequence */
+				  nextCpnt = sequIndex->cpnts[sequSeg->cpntIndex + 1].cpnt;
+				  tranPos = sequIndex->cpnts[sequSeg->cpntIndex + 1].offset;
 				}
-
-			  segEnd = currPos;
-			  CHECK(omfsAddInt64toInt64(cpntLen, &segEnd));
-			  shortLen = cpntLen;
-			  if (omfsInt64Less(position, segEnd))
+			  if (omfiIsATransition(file, nextCpnt, &omfError))
 				{
-				  /* If the next component is a transition, see if the
-				   * requested position points into the Transition.
-				   */
-				  nextCpnt = NULL;
-				  omfError = SequencePeekNextCpnt(sequIter, rootObj, &nextCpnt,
-											 &tranPos);
-				  if (omfiIsATransition(file, nextCpnt, &omfError))
-					{
-					  CHECK(omfiTransitionGetInfo(file, nextCpnt, NULL, 
+				  CHECK(omfiTransitionGetInfo(file, nextCpnt, NULL, 
 											  &nextLen, NULL, &effect));
 
-					  /* omfiSequenceGetNextCpnt() already figured out the 
-					   * transition's offset into the track for us.
-					   * If position falls in shortened segment, return
-					   * segment, else return rendered source clip.
-					   */
-					  if (omfsInt64Less(position, tranPos))
-						{
-						  CHECK(omfsSubInt64fromInt64(nextLen, &shortLen));
-						}
-					  else /* Falls within TRAN */
+				  /* The index holds the transition's offset into the
+				   * sequence, as found by omfiSequenceGetNextCpnt().
+				   * If position falls in shortened segment, return
+				   * segment, else return rendered source clip.
+				   */
+				  if (omfsInt64Less(position, tranPos))
+					{
+					  CHECK(omfsSubInt64fromInt64(nextLen, &shortLen));
+					}
+				  else /* Falls within TRAN */
+					{
+					  /* The next component will be the final rendering */
+					  if ((file->setrev == kOmfRev1x) || 
+						  file->setrev == kOmfRevIMA)
 						{
-						  /* The next component will be the final rendering */
-						  if ((file->setrev == kOmfRev1x) || 
-							  file->setrev == kOmfRevIMA)
-							{
-							  omfError = omfsReadObjRef(file, nextCpnt, 
-											   OMCPNTPrecomputed, &render);
-							  if (omfError != OM_ERR_NONE)
-								{
-								  cpntLen = nextLen;
-								  RAISE(OM_ERR_RENDER_NOT_FOUND);
-								}
-							}
-						  else /* kOmfRev2x */
+						  omfError = omfsReadObjRef(file, nextCpnt, 
+										   OMCPNTPrecomputed, &render);
+						  if (omfError != OM_ERR_NONE)
 							{
-							  CHECK(omfiEffectGetFinalRender(file, effect, 
-															 &render));
+							  cpntLen = nextLen;
+							  RAISE(OM_ERR_RENDER_NOT_FOUND);
 							}
-						  if (render)
-							{
-							  cpnt = render;
-							  currPos = tranPos;
-							}
-						} /* Position falls within a transition */
-					} /* If Transition */
+						}
+					  else /* kOmfRev2x */
+						{
+						  CHECK(omfiEffectGetFinalRender(file, effect, 
+														 &render));
+						}
+					  if (render)
+						{
+						  cpnt = render;
+						  currPos = tranPos;
+						}
+					} /* Position falls within a transition */
+				} /* If Transition */
 
-				  /* If in this segment, we're found it */
-				  CHECK(MobFindCpntByPosition(file, mob, trackID, cpnt, 
-											  currPos, position, mediaCrit, 
-											  diffPos, &tmpFound, &tmpLength));
-				  if (tmpFound)
-					{
-					  CHECK(omfsAddInt64toInt64(sclpTranOffset, diffPos));
-					  *foundObj = tmpFound;
-					  /* If segment shortened by transition, return
-					   * shortened length 
-					   */
-					  if (omfsInt64Less(shortLen, tmpLength))
-						*foundLen = shortLen;
-					  else
-						*foundLen = tmpLength;
-					  break;
-					}
+			  /* If in this segment, we're found it */
+			  CHECK(MobFindCpntByPosition(file, mob, trackID, cpnt, 
+										  currPos, position, mediaCrit, 
+										  diffPos, &tmpFound, &tmpLength));
+			  if (tmpFound)
+				{
+				  CHECK(omfsAddInt64toInt64(sclpTranOffset, diffPos));
+				  *foundObj = tmpFound;
+				  /* If segment shortened by transition, return
+				   * shortened length 
+				   */
+				  if (omfsInt64Less(shortLen, tmpLength))
+					*foundLen = shortLen;
 				  else
-					{
-					  RAISE(OM_ERR_TRAVERSAL_NOT_POSS);
-					}
-				} /* Not in this segment */
-			  else 
+					*foundLen = tmpLength;
+				}
+			  else
 				{
-				  omfsAddInt64toInt64(cpntLen, &currPos);
+				  RAISE(OM_ERR_TRAVERSAL_NOT_POSS);
 				}
-
-			} /* for loop */
-		  CHECK(omfiIteratorDispose(file, sequIter));
-		  sequIter = NULL;
+			}
 		}
 
 	  /* If 1.0 MASK object, return this object.  FindSource will
@@ -2903,8 +3086,6 @@ omfErr_t MobFindCpntByPosition(
 
   XEXCEPT
 	{
-	  if (sequIter)
-		omfiIteratorDispose(file, sequIter);
 	  /* At least try and return length if we can */
 	  *foundLen = cpntLen;
 	  return(XCODE());
@@ -75,13 +75,23 @@
 
 #include <setjmp.h>
 
-/* These static variables are needed by the error routines. */
-static jmp_buf setjmp_buffer;	/* for return to caller */
-static external_methods_ptr emethods; /* needed for access to message_parm */
+/*
+ * Per-call state needed by the error routines and the source/destination
+ * managers.  One of these lives on the stack of each compress/decompress
+ * call, so several samples may be coded at once.  The JPEG code only sees
+ * the embedded external methods struct, so it must come first.
+ */
+typedef struct
+{
+	struct External_methods_struct e_methods;
+	jmp_buf         setjmp_buffer;	/* for return to caller */
+	int             visited;
+	char            errorString[512];
+	int             errorRaised;
+	omfErr_t        status;
+} omJPEGContext_t;
 
-static char            OMJPEGErrorString[512];
-static int             OMJPEGErrorRaised = 0;
-static omfErr_t        localJPEGStatus =	OM_ERR_NONE;
+#define JPEG_CONTEXT(info)	((omJPEGContext_t *) (info)->emethods)
 
 #define HI4(num)  ((num) >> 4)
 #define LOW4(num) ((num) & 0x0f)
@@ -108,8 +118,8 @@ static void emit_byte(compress_info_ptr cinfo, char data)
 	functionJPEGStatus = omcWriteStream(media->stream, 1, &data);
 	if (functionJPEGStatus !=	OM_ERR_NONE)
 	{
-		if  (localJPEGStatus == OM_ERR_NONE)
-			localJPEGStatus = functionJPEGStatus;
+		if  (JPEG_CONTEXT(cinfo)->status == OM_ERR_NONE)
+			JPEG_CONTEXT(cinfo)->status = functionJPEGStatus;
 	}
 
 }
@@ -579,8 +589,8 @@ write_jpeg_data (compress_info_ptr cinfo, char *dataptr, int datacount)
 	functionJPEGStatus = omcWriteStream(media->stream, datacount, dataptr);
 	if (functionJPEGStatus !=	OM_ERR_NONE)
 	{
-		if  (localJPEGStatus == OM_ERR_NONE)
-			localJPEGStatus = functionJPEGStatus;
+		if  (JPEG_CONTEXT(cinfo)->status == OM_ERR_NONE)
+			JPEG_CONTEXT(cinfo)->status = functionJPEGStatus;
 	}
 }
 
@@ -659,29 +669,29 @@ METHODDEF int
 	functionJPEGStatus = omcGetLength(media->stream, &length);
 	if (functionJPEGStatus !=	OM_ERR_NONE)
 	{
-		if  (localJPEGStatus == OM_ERR_NONE)
-			localJPEGStatus = functionJPEGStatus;
+		if  (JPEG_CONTEXT(dinfo)->status == OM_ERR_NONE)
+			JPEG_CONTEXT(dinfo)->status = functionJPEGStatus;
 	}
 
 	functionJPEGStatus = omcGetStreamPosition(media->stream, &offset);
 	if (functionJPEGStatus !=	OM_ERR_NONE)
 	{
-		if  (localJPEGStatus == OM_ERR_NONE)
-			localJPEGStatus = functionJPEGStatus;
+		if  (JPEG_CONTEXT(dinfo)->status == OM_ERR_NONE)
+			JPEG_CONTEXT(dinfo)->status = functionJPEGStatus;
 	}
 
 	functionJPEGStatus = omfsSubInt64fromInt64(offset, &length);
 	if (functionJPEGStatus !=	OM_ERR_NONE)
 	{
-		if  (localJPEGStatus == OM_ERR_NONE)
-			localJPEGStatus = functionJPEGStatus;
+		if  (JPEG_CONTEXT(dinfo)->status == OM_ERR_NONE)
+			JPEG_CONTEXT(dinfo)->status = functionJPEGStatus;
 	}
 
 	functionJPEGStatus = omfsTruncInt64toUInt32(length, &toRead);	/* OK MAXREAD */
 	if (functionJPEGStatus !=	OM_ERR_NONE)
 	{
-		if  (localJPEGStatus == OM_ERR_NONE)
-			localJPEGStatus = functionJPEGStatus;
+		if  (JPEG_CONTEXT(dinfo)->status == OM_ERR_NONE)
+			JPEG_CONTEXT(dinfo)->status = functionJPEGStatus;
 	}
 
 
@@ -690,8 +700,8 @@ METHODDEF int
 	functionJPEGStatus = omcReadStream(media->stream, toRead, (dinfo->next_input_byte), &bytesRead);
 	if (functionJPEGStatus !=	OM_ERR_NONE)
 	{
-		if  (localJPEGStatus == OM_ERR_NONE)
-			localJPEGStatus = functionJPEGStatus;
+		if  (JPEG_CONTEXT(dinfo)->status == OM_ERR_NONE)
+			JPEG_CONTEXT(dinfo)->status = functionJPEGStatus;
 	}
 	dinfo->bytes_in_buffer = bytesRead;
 
@@ -705,6 +715,37 @@ METHODDEF int
 	return JGETC(dinfo);
 }
 
+/*
+ * Same as omjpeg_read_jpeg_data, but for a frame which the codec has
+ * already read into parms->compressedBuffer.  This touches nothing but
+ * the parms and dinfo, so may be used from a worker thread.
+ */
+
+METHODDEF int
+                omjpeg_read_buffered_jpeg_data(decompress_info_ptr dinfo)
+{
+	JPEG_MediaParms_t   *parms = (JPEG_MediaParms_t *)dinfo->input_file;
+	omfUInt32     		toRead;
+	
+	dinfo->next_input_byte = dinfo->input_buffer + MIN_UNGET;
+
+	toRead = parms->compressedLength - parms->compressedIndex;
+	if(toRead > JPEG_BUF_SIZE)
+		toRead = JPEG_BUF_SIZE;
+	memcpy(dinfo->next_input_byte, parms->compressedBuffer + parms->compressedIndex, toRead);
+	parms->compressedIndex += toRead;
+	dinfo->bytes_in_buffer = toRead;
+
+	if (dinfo->bytes_in_buffer <= 0)
+	{
+		WARNMS(dinfo->emethods, "Premature EOF in JPEG file");
+		dinfo->next_input_byte[0] = (unsigned char) 0xFF;
+		dinfo->next_input_byte[1] = (unsigned char) M_EOI;
+		dinfo->bytes_in_buffer = 2;
+	}
+	return JGETC(dinfo);
+}
+
 LOCAL INT32
 get_2bytes (decompress_info_ptr cinfo)
 /* Get a 2-byte unsigned integer (e.g., a marker parameter length field) */
@@ -782,7 +823,7 @@ get_dht (decompress_info_ptr cinfo)
       ERREXIT1(cinfo->emethods, "Bogus DHT index %d", index);
 
     if (*htblptr == NULL)
-      *htblptr = (HUFF_TBL *) (*cinfo->emethods->alloc_small) (SIZEOF(HUFF_TBL));
+      *htblptr = (HUFF_TBL *) (*cinfo->emethods->alloc_small) (cinfo->emethods, SIZEOF(HUFF_TBL));
   
     MEMCOPY((*htblptr)->bits, bits, SIZEOF((*htblptr)->bits));
     MEMCOPY((*htblptr)->huffval, huffval, SIZEOF((*htblptr)->huffval));
@@ -813,7 +854,7 @@ get_dqt (decompress_info_ptr cinfo)
       
     if (cinfo->quant_tbl_ptrs[n] == NULL)
       cinfo->quant_tbl_ptrs[n] = (QUANT_TBL_PTR)
-	(*cinfo->emethods->alloc_small) (SIZEOF(QUANT_TBL));
+	(*cinfo->emethods->alloc_small) (cinfo->emethods, SIZEOF(QUANT_TBL));
     quant_ptr = cinfo->quant_tbl_ptrs[n];
 
     for (i = 0; i < DCTSIZE2; i++) {
@@ -1020,7 +1061,7 @@ get_sof (decompress_info_ptr cinfo, int code)
     ERREXIT(cinfo->emethods, "Bogus SOF length");
 
   cinfo->comp_info = (jpeg_component_info *) (*cinfo->emethods->alloc_small)
-			(cinfo->num_components * SIZEOF(jpeg_component_info));
+			(cinfo->emethods, cinfo->num_components * SIZEOF(jpeg_component_info));
   
   for (ci = 0; ci < cinfo->num_components; ci++) {
     compptr = &cinfo->comp_info[ci];
@@ -1467,15 +1508,17 @@ read_file_trailer (decompress_info_ptr cinfo)
  */
 
 METHODDEF void
-trace_message (const char *msgtext)
+trace_message (external_methods_ptr emethods, const char *msgtext)
 {
-	sprintf(OMJPEGErrorString, msgtext,
+	omJPEGContext_t *ctx = (omJPEGContext_t *) emethods;
+
+	sprintf(ctx->errorString, msgtext,
 	  emethods->message_parm[0], emethods->message_parm[1],
 	  emethods->message_parm[2], emethods->message_parm[3],
 	  emethods->message_parm[4], emethods->message_parm[5],
 	  emethods->message_parm[6], emethods->message_parm[7]);
 #ifdef JPEG_TRACE
-	fprintf(stderr, "%s\n", OMJPEGErrorString);	/* there is no \n in the */
+	fprintf(stderr, "%s\n", ctx->errorString);	/* there is no \n in the */
 #endif
 }
 
@@ -1502,22 +1545,24 @@ trace_message (const char *msgtext)
  */
 
 METHODDEF void
-error_exit (const char *msgtext)
+error_exit (external_methods_ptr emethods, const char *msgtext)
 {
-  trace_message(msgtext);	/* report the error message */
+  omJPEGContext_t *ctx = (omJPEGContext_t *) emethods;
 
-  (*emethods->free_all) ();	/* clean up memory allocation & temp files */
+  trace_message(emethods, msgtext);	/* report the error message */
+
+  (*emethods->free_all) (emethods);	/* clean up memory allocation & temp files */
 	/*
 	 * Set OMFI error code to signal a JPEG failure, unless set
 	 * previously
 	 */
-	if (localJPEGStatus == OM_ERR_NONE)
-		localJPEGStatus = OM_ERR_JPEGPROBLEM;
+	if (ctx->status == OM_ERR_NONE)
+		ctx->status = OM_ERR_JPEGPROBLEM;
 
-	OMJPEGErrorRaised = 1;	/* indicate that the message string is an
+	ctx->errorRaised = 1;	/* indicate that the message string is an
 				 * error message */
 
-  longjmp(setjmp_buffer, 1);	/* return control to outer routine */
+  longjmp(ctx->setjmp_buffer, 1);	/* return control to outer routine */
 }
 
 
@@ -1580,8 +1625,8 @@ input_init (compress_info_ptr cinfo)
 	functionJPEGStatus = omfmGetVideoInfo(media, &layout, &fieldWidth, &fieldHeight, NULL, &bitsPerPixel, &memFmt);
 	if (functionJPEGStatus !=	OM_ERR_NONE)
 	{
-		if  (localJPEGStatus == OM_ERR_NONE)
-			localJPEGStatus = functionJPEGStatus;
+		if  (JPEG_CONTEXT(cinfo)->status == OM_ERR_NONE)
+			JPEG_CONTEXT(cinfo)->status = functionJPEGStatus;
 	}
 
 	cinfo->image_width = fieldWidth;	/* width in pixels */
@@ -1607,8 +1652,8 @@ input_init (compress_info_ptr cinfo)
 	functionJPEGStatus = omfmGetVideoInfoArray(media, oplist);
 	if (functionJPEGStatus !=	OM_ERR_NONE)
 	{
-		if  (localJPEGStatus == OM_ERR_NONE)
-			localJPEGStatus = functionJPEGStatus;
+		if  (JPEG_CONTEXT(cinfo)->status == OM_ERR_NONE)
+			JPEG_CONTEXT(cinfo)->status = functionJPEGStatus;
 	}
 	cinfo->data_precision = (short) oplist[0].operand.expInt32;	/* bits per pixel component value */
   /* In the current JPEG software, data_precision must be set equal to
@@ -1930,7 +1975,8 @@ output_term (decompress_info_ptr cinfo)
  * Initialize and read the file header (everything through the SOF marker).
  */
 
-static void     loadCompressionTable(omfMediaHdl_t media, jpeg_tables * table, omfInt32 n)
+static void     loadCompressionTable(omfMediaHdl_t media, jpeg_tables * table, omfInt32 n,
+									 omfErr_t *status)
 {
 	omfJPEGTables_t aTable;
 	omfInt16 m;
@@ -1940,8 +1986,8 @@ static void     loadCompressionTable(omfMediaHdl_t media, jpeg_tables * table, o
 	functionJPEGStatus = codecGetInfo(media, kJPEGTables, media->pictureKind, sizeof(omfJPEGTables_t), &aTable);
 	if (functionJPEGStatus !=	OM_ERR_NONE)
 	{
-		if  (localJPEGStatus == OM_ERR_NONE)
-			localJPEGStatus = functionJPEGStatus;
+		if  (*status == OM_ERR_NONE)
+			*status = functionJPEGStatus;
 	}
 	table->Qlen = aTable.QTableSize;
 	table->Q16len = aTable.QTableSize;
@@ -2014,13 +2060,21 @@ omfmJFIFDecompressSample (JPEG_MediaParms_t *parms)
    */
   struct Decompress_info_struct dinfo;
   struct Decompress_methods_struct dc_methods;
-  struct External_methods_struct e_methods;
+  omJPEGContext_t ctx;	/* error recovery and external methods */
   	omfMediaHdl_t	media = parms->media;
   	omfUInt32		i, range, offset, upper;
+  	omfHdl_t		errFile;
   	
 
 	omfAssertMediaHdl(media);
-	XPROTECT(media->mainFile)
+	ctx.status = OM_ERR_NONE;
+	ctx.errorRaised = 0;
+
+	/* Frames decoded from memory may be on a worker thread, so leave the
+	 * file's error trace alone.
+	 */
+	errFile = (parms->compressedBuffer != NULL ? NULL : media->mainFile);
+	XPROTECT(errFile)
 	{
   /* Select the input and output files.
    * In this example we want to open the input file before doing anything else,
@@ -2036,20 +2090,19 @@ omfmJFIFDecompressSample (JPEG_MediaParms_t *parms)
 
   /* Initialize the system-dependent method pointers. */
   dinfo.methods = &dc_methods;	/* links to method structs */
-  dinfo.emethods = &e_methods;
+  dinfo.emethods = &ctx.e_methods;
   /* Here we supply our own error handler; compare to use of standard error
    * handler in the previous write_JPEG_file example.
    */
-  emethods = &e_methods;	/* save struct addr for possible access */
-  e_methods.error_exit = error_exit; /* supply error-exit routine */
-  e_methods.trace_message = trace_message; /* supply trace-message routine */
-  e_methods.trace_level = 0;	/* default = no tracing */
-  e_methods.num_warnings = 0;	/* no warnings emitted yet */
-  e_methods.first_warning_level = 0; /* display first corrupt-data warning */
-  e_methods.more_warning_level = 3; /* but suppress additional ones */
+  ctx.e_methods.error_exit = error_exit; /* supply error-exit routine */
+  ctx.e_methods.trace_message = trace_message; /* supply trace-message routine */
+  ctx.e_methods.trace_level = 0;	/* default = no tracing */
+  ctx.e_methods.num_warnings = 0;	/* no warnings emitted yet */
+  ctx.e_methods.first_warning_level = 0; /* display first corrupt-data warning */
+  ctx.e_methods.more_warning_level = 3; /* but suppress additional ones */
 
   /* prepare setjmp context for possible exit from error_exit */
-  if (setjmp(setjmp_buffer)) {
+  if (setjmp(ctx.setjmp_buffer)) {
     /* If we get here, the JPEG code has signaled an error.
      * Memory allocation has already been cleaned up (see free_all call in
      * error_exit), but we need to close the input file before returning.
@@ -2062,12 +2115,12 @@ omfmJFIFDecompressSample (JPEG_MediaParms_t *parms)
    * In some cases you might want to replace the memory manager, or at
    * least the system-dependent part of it, with your own code.
    */
-  jselmemmgr(&e_methods);	/* select std memory allocation routines */
+  jselmemmgr(&ctx.e_methods);	/* select std memory allocation routines */
   /* If the decompressor requires full-image buffers (for two-pass color
    * quantization or a noninterleaved JPEG file), it will create temporary
    * files for anything that doesn't fit within the maximum-memory setting.
    * You can change the default maximum-memory setting by changing
-   * e_methods.max_memory_to_use after jselmemmgr returns.
+   * ctx.e_methods.max_memory_to_use after jselmemmgr returns.
    * On some systems you may also need to set up a signal handler to
    * ensure that temporary files are deleted if the program is interrupted.
    * (This is most important if you are on MS-DOS and use the jmemdos.c
@@ -2100,7 +2153,10 @@ omfmJFIFDecompressSample (JPEG_MediaParms_t *parms)
   dinfo.methods->read_file_header = read_file_header;
   dinfo.methods->read_scan_header = read_scan_header;
   /* For JFIF/raw-JPEG format, the user interface supplies read_jpeg_data. */
-  dinfo.methods->read_jpeg_data = omjpeg_read_jpeg_data;
+  if (parms->compressedBuffer != NULL)
+    dinfo.methods->read_jpeg_data = omjpeg_read_buffered_jpeg_data;
+  else
+    dinfo.methods->read_jpeg_data = omjpeg_read_jpeg_data;
   dinfo.methods->resync_to_restart = resync_to_restart;
   dinfo.methods->read_scan_trailer = read_scan_trailer;
   dinfo.methods->read_file_trailer = read_file_trailer;
@@ -2111,7 +2167,7 @@ omfmJFIFDecompressSample (JPEG_MediaParms_t *parms)
 	{ 
 		offset = parms->blackLevel;
 		range = (parms->whiteLevel+1)-parms->blackLevel;
-		dinfo.CCIRLumaOutMap = (JSAMPLE *) (*dinfo.emethods->alloc_small) (256 * SIZEOF(JCOEF));
+		dinfo.CCIRLumaOutMap = (JSAMPLE *) (*dinfo.emethods->alloc_small) (dinfo.emethods, 256 * SIZEOF(JCOEF));
 		for (i = 0; i < 256; i++)
 		{
 			if(i <= parms->blackLevel) 
@@ -2125,7 +2181,7 @@ omfmJFIFDecompressSample (JPEG_MediaParms_t *parms)
 		offset = 128 - (parms->colorRange/2);
 		range = parms->colorRange;
 		upper = offset + range;
-		dinfo.CCIRChromaOutMap = (JSAMPLE *) (*dinfo.emethods->alloc_small) (256 * SIZEOF(JCOEF));
+		dinfo.CCIRChromaOutMap = (JSAMPLE *) (*dinfo.emethods->alloc_small) (dinfo.emethods, 256 * SIZEOF(JCOEF));
 		for (i = 0; i < 256; i++)
 		{
 			if(i <= offset) 
@@ -2143,7 +2199,10 @@ omfmJFIFDecompressSample (JPEG_MediaParms_t *parms)
 	jpeg_decompress(&dinfo);
 
 	/* back out the remaining compressed bytes */
-	omcSeekStreamRelative(media->stream, -1 * dinfo.bytes_in_buffer);
+	if (parms->compressedBuffer != NULL)
+		parms->compressedIndex -= dinfo.bytes_in_buffer;
+	else
+		omcSeekStreamRelative(media->stream, -1 * dinfo.bytes_in_buffer);
 
   /* That's it, son.  Nothin' else to do, except close files. */
   /* Here we assume only the input file need be closed. */
@@ -2151,7 +2210,7 @@ omfmJFIFDecompressSample (JPEG_MediaParms_t *parms)
 	XEXCEPT
 	XEND
 
-  /* You might want to test e_methods.num_warnings to see if bad data was
+  /* You might want to test ctx.e_methods.num_warnings to see if bad data was
    * detected.  In this example, we just blindly forge ahead.
    */
 	return OM_ERR_NONE;	/* indicate success */
@@ -2179,7 +2238,7 @@ omfmJFIFCompressSample (JPEG_MediaParms_t *parms, omfBool customTables, omfInt32
    */
   struct Compress_info_struct cinfo;
   struct Compress_methods_struct c_methods;
-  struct External_methods_struct e_methods;
+  omJPEGContext_t ctx;	/* error recovery and external methods */
   omfInt16           bitsPerPixel, n;
   omfInt32 fieldHeight, fieldWidth;
   	omfMediaHdl_t	media = parms->media;
@@ -2198,41 +2257,43 @@ omfmJFIFCompressSample (JPEG_MediaParms_t *parms, omfBool customTables, omfInt32
 	omfErr_t			functionJPEGStatus =	OM_ERR_NONE;
 
 	omfAssertMediaHdl(media);
+	ctx.status = OM_ERR_NONE;
+	ctx.errorRaised = 0;
 	functionJPEGStatus = omfmGetVideoInfo(media, &layout, &fieldWidth, &fieldHeight, NULL, &bitsPerPixel, &memFmt);
 	if (functionJPEGStatus !=	OM_ERR_NONE)
 	{
-		if  (localJPEGStatus == OM_ERR_NONE)
-			localJPEGStatus = functionJPEGStatus;
+		if  (ctx.status == OM_ERR_NONE)
+			ctx.status = functionJPEGStatus;
 	}
 
-/*	localJPEGStatus = codecGetInfo(media, kCompressionParms, media->pictureKind, sizeof(omfJPEGInfo_t), &info);
+/*	ctx.status = codecGetInfo(media, kCompressionParms, media->pictureKind, sizeof(omfJPEGInfo_t), &info);
       ROGER--- cut this piece when I'm sure it is not needed    
  */
 	if(customTables)
 	{
 		for (n = 0; n < 3; n++)
-			loadCompressionTable(media, compressionTables + n, n);
+			loadCompressionTable(media, compressionTables + n, n, &ctx.status);
 	}
 
   /* Initialize the system-dependent method pointers. */
   cinfo.methods = &c_methods;	/* links to method structs */
-  cinfo.emethods = &e_methods;
+  cinfo.emethods = &ctx.e_methods;
   /* Here we use the default JPEG error handler, which will just print
    * an error message on stderr and call exit().  See the second half of
    * this file for an example of more graceful error recovery.
    */
-  jselerror(&e_methods);	/* select std error/trace message routines */
+  jselerror(&ctx.e_methods);	/* select std error/trace message routines */
   /* Here we use the standard memory manager provided with the JPEG code.
    * In some cases you might want to replace the memory manager, or at
    * least the system-dependent part of it, with your own code.
    */
-  jselmemmgr(&e_methods);	/* select std memory allocation routines */
+  jselmemmgr(&ctx.e_methods);	/* select std memory allocation routines */
   /* If the compressor requires full-image buffers (for entropy-coding
    * optimization or a noninterleaved JPEG file), it will create temporary
    * files for anything that doesn't fit within the maximum-memory setting.
    * (Note that temp files are NOT needed if you use the default parameters.)
    * You can change the default maximum-memory setting by changing
-   * e_methods.max_memory_to_use after jselmemmgr returns.
+   * ctx.e_methods.max_memory_to_use after jselmemmgr returns.
    * On some systems you may also need to set up a signal handler to
    * ensure that temporary files are deleted if the program is interrupted.
    * (This is most important if you are on MS-DOS and use the jmemdos.c
@@ -2258,7 +2319,7 @@ omfmJFIFCompressSample (JPEG_MediaParms_t *parms, omfBool customTables, omfInt32
    * commercial JPEG implementations may choke on non-baseline JPEG files.
    * If you want to force baseline compatibility, pass TRUE instead of FALSE.
    * (If non-baseline files are fine, but you could do without that warning
-   * message, set e_methods.trace_level to -1.)
+   * message, set ctx.e_methods.trace_level to -1.)
    */
 
   /* At this point you can modify the default parameters set by j_c_defaults
@@ -2279,7 +2340,7 @@ omfmJFIFCompressSample (JPEG_MediaParms_t *parms, omfBool customTables, omfInt32
 	
 	
 		if (cinfo.quant_tbl_ptrs[0] == NULL)
-			cinfo.quant_tbl_ptrs[0] = (QUANT_TBL_PTR) (*cinfo.emethods->alloc_small) (SIZEOF(QUANT_TBL));
+			cinfo.quant_tbl_ptrs[0] = (QUANT_TBL_PTR) (*cinfo.emethods->alloc_small) (cinfo.emethods, SIZEOF(QUANT_TBL));
 		quant_ptr = cinfo.quant_tbl_ptrs[0];
 		table_ptr = customTables ? compressionTables[0].Q : STD_QT_PTR[0];
 	
@@ -2287,7 +2348,7 @@ omfmJFIFCompressSample (JPEG_MediaParms_t *parms, omfBool customTables, omfInt32
 			quant_ptr[i] = table_ptr[i];
 	
 		if (cinfo.quant_tbl_ptrs[1] == NULL)
-			cinfo.quant_tbl_ptrs[1] = (QUANT_TBL_PTR) (*cinfo.emethods->alloc_small) (SIZEOF(QUANT_TBL));
+			cinfo.quant_tbl_ptrs[1] = (QUANT_TBL_PTR) (*cinfo.emethods->alloc_small) (cinfo.emethods, SIZEOF(QUANT_TBL));
 		quant_ptr = cinfo.quant_tbl_ptrs[1];
 		table_ptr = customTables ? compressionTables[1].Q : STD_QT_PTR[1];
 	
@@ -2318,7 +2379,7 @@ omfmJFIFCompressSample (JPEG_MediaParms_t *parms, omfBool customTables, omfInt32
 			htblptr = &cinfo.dc_huff_tbl_ptrs[ci];
 	
 			if (*htblptr == NULL)
-				*htblptr = (HUFF_TBL *) (*cinfo.emethods->alloc_small) (SIZEOF(HUFF_TBL));
+				*htblptr = (HUFF_TBL *) (*cinfo.emethods->alloc_small) (cinfo.emethods, SIZEOF(HUFF_TBL));
 	
 			MEMCOPY((*htblptr)->bits, bits, SIZEOF((*htblptr)->bits));
 			MEMCOPY((*htblptr)->huffval, huffval, SIZEOF((*htblptr)->huffval));
@@ -2343,7 +2404,7 @@ omfmJFIFCompressSample (JPEG_MediaParms_t *parms, omfBool customTables, omfInt32
 			htblptr = &cinfo.ac_huff_tbl_ptrs[ci];
 	
 			if (*htblptr == NULL)
-				*htblptr = (HUFF_TBL *) (*cinfo.emethods->alloc_small) (SIZEOF(HUFF_TBL));
+				*htblptr = (HUFF_TBL *) (*cinfo.emethods->alloc_small) (cinfo.emethods, SIZEOF(HUFF_TBL));
 	
 			MEMCOPY((*htblptr)->bits, bits, SIZEOF((*htblptr)->bits));
 			MEMCOPY((*htblptr)->huffval, huffval, SIZEOF((*htblptr)->huffval));
@@ -2353,12 +2414,12 @@ omfmJFIFCompressSample (JPEG_MediaParms_t *parms, omfBool customTables, omfInt32
      */
     if((parms->blackLevel != 0) || (parms->whiteLevel != 255) || (parms->colorRange < 254))
     { 
-		cinfo.CCIRLumaInMap = (JSAMPLE *) (*cinfo.emethods->alloc_small) (256 * SIZEOF(JCOEF));
+		cinfo.CCIRLumaInMap = (JSAMPLE *) (*cinfo.emethods->alloc_small) (cinfo.emethods, 256 * SIZEOF(JCOEF));
 		for (i = 0; i < 256; i++)
 			cinfo.CCIRLumaInMap[i] = (omfUInt8)((i * ((parms->whiteLevel+1)-parms->blackLevel) / 256)
 												+ parms->blackLevel);
 		
-		cinfo.CCIRChromaInMap = (JSAMPLE *) (*cinfo.emethods->alloc_small) (256 * SIZEOF(JCOEF));
+		cinfo.CCIRChromaInMap = (JSAMPLE *) (*cinfo.emethods->alloc_small) (cinfo.emethods, 256 * SIZEOF(JCOEF));
 		for (i = 0; i < 256; i++)
 			cinfo.CCIRChromaInMap[i] = (omfUInt8)(((i * parms->colorRange) / 256)
 												+ (128-(parms->colorRange/2)));
@@ -2377,7 +2438,7 @@ omfmJFIFCompressSample (JPEG_MediaParms_t *parms, omfBool customTables, omfInt32
 	cinfo.output_file = (FILE *) parms;
 
 	/* Here we go! */
-	if (setjmp(setjmp_buffer) == 0)
+	if (setjmp(ctx.setjmp_buffer) == 0)
 	{
 		jpeg_compress(&cinfo);
 	}
@@ -2391,15 +2452,15 @@ omfmJFIFCompressSample (JPEG_MediaParms_t *parms, omfBool customTables, omfInt32
 	 * data structures allocated in j_c_defaults are freed upon exit from
 	 * jpeg_compress.
 	 */
-	if (localJPEGStatus == OM_ERR_NONE)
+	if (ctx.status == OM_ERR_NONE)
 		*sampleSize = fieldWidth * fieldHeight * (bitsPerPixel / 8);
 	else
 		*sampleSize = 0;
 
 	XPROTECT(media->mainFile)
 	{
-		if (localJPEGStatus != OM_ERR_NONE)
-			RAISE(localJPEGStatus);
+		if (ctx.status != OM_ERR_NONE)
+			RAISE(ctx.status);
 	}
 	XEXCEPT
 	XEND
@@ -78,6 +78,9 @@ typedef struct
 	omfPosition_t	frameSizePatch;
 	omfBool			isAvidJFIF;
 	omfInt32		JPEGTableID;
+	char			*compressedBuffer;	/* JPEG 2.0 codec only: if not NULL,  */
+	omfUInt32		compressedLength;	/* decompress from this buffer instead */
+	omfUInt32		compressedIndex;	/* of media->stream (omJFIF.c)		   */
 } JPEG_MediaParms_t;		/* Used to pass parameters to the JPEG software codec */
 
 #define JPEG_QT_16 1
@@ -26,6 +26,11 @@
 
 #include "masterhd.h"
 #include <string.h>
+#include <stdlib.h>
+#if PORT_SYS_UNIX
+#include <sys/types.h>
+#include <sys/stat.h>
+#endif
 
 #include "omPublic.h"
 #include "omMedia.h" 
@@ -59,22 +64,85 @@
 omfErr_t        openLocator(omfHdl_t file, omfObject_t aLoc, omfFileFormat_t fmt, omfHdl_t * refFile)
 {
 	char            filename[256];
-	omfClassID_t  locTag;
 	omfInt16           vref = 0;
 	omfInt32           DirID = 0;
 	
 	omfAssertValidFHdl(file);
 	XPROTECT(file)
 	{
-		CHECK(omfmLocatorGetInfo(file, aLoc, locTag, sizeof(filename), filename));
+		CHECK(locatorGetFileName(file, aLoc, sizeof(filename), filename,
+										 &vref, &DirID));
+		CHECK(openLocatorFile(file, filename, vref, DirID, fmt, refFile));
+	}
+	XEXCEPT
+	XEND
+	
+	return (OM_ERR_NONE);
+}
+
+/************************
+ * Function: locatorGetFileName
+ *
+ * 		Returns the name of the file referenced by a locator, along
+ *		with the volume and directory for Mac locators.  The results can
+ *		be passed to openLocatorFile().
+ *
+ * Argument Notes:
+ *		vref, DirID - Set to 0 unless this is a MACL locator.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ */
+omfErr_t        locatorGetFileName(omfHdl_t file, omfObject_t aLoc,
+								omfInt32 nameSize, char *filename,
+								omfInt16 *vref, omfInt32 *DirID)
+{
+	omfClassID_t  locTag;
+	
+	omfAssertValidFHdl(file);
+	*vref = 0;
+	*DirID = 0;
+	XPROTECT(file)
+	{
+		CHECK(omfmLocatorGetInfo(file, aLoc, locTag, nameSize, filename));
 		if (streq(locTag, "MACL"))
 		{
-			CHECK(omfmMacLocatorGetInfo(file, aLoc, &vref, &DirID));
+			CHECK(omfmMacLocatorGetInfo(file, aLoc, vref, DirID));
 		}
+	}
+	XEXCEPT
+	XEND
+	
+	return (OM_ERR_NONE);
+}
+
+/************************
+ * Function: openLocatorFile
+ *
+ * 		Opens a file named by locatorGetFileName(), through the session
+ *		IO handlers for the given format.
+ *
+ * Argument Notes:
+ *		<none>.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ */
+omfErr_t        openLocatorFile(omfHdl_t file, char *filename,
+								omfInt16 vref, omfInt32 DirID,
+								omfFileFormat_t fmt, omfHdl_t * refFile)
+{
+	omfAssertValidFHdl(file);
+	XPROTECT(file)
+	{
 		if (fmt == kOmfiMedia)
 		{
-
-
 #if OMFI_MACSF_STREAM || OMFI_MACFSSPEC_STREAM
 			CHECK((*file->session->ioFuncs.typedOpenFileFunc)(file->session, vref, DirID, filename, refFile));
 #else
@@ -95,6 +163,59 @@ omfErr_t        openLocator(omfHdl_t file, omfObject_t aLoc, omfFileFormat_t fmt
 	return (OM_ERR_NONE);
 }
 
+/************************
+ * Function: locatorFileIdentity
+ *
+ * 		Returns a key which identifies the file named by a locator
+ *		independent of how the name was spelled, and a stamp which
+ *		changes when the file is modified or replaced.  Used by the media
+ *		layer to decide whether an already open handle can be shared.
+ *
+ * Argument Notes:
+ *		key - Filled in even when no stamp is available (with the
+ *			unresolved name if nothing better is known).
+ *
+ * ReturnValue:
+ *		TRUE if the stamp is valid, FALSE if the file can't be checked
+ *		on this platform (or doesn't exist).
+ *
+ * Possible Errors:
+ *		<none>.
+ */
+omfBool         locatorFileIdentity(char *filename, omfInt16 vref,
+								omfInt32 DirID, omfInt32 keySize, char *key,
+								omfLocatorStamp_t *stamp)
+{
+#if PORT_SYS_UNIX && !OMFI_MACSF_STREAM && !OMFI_MACFSSPEC_STREAM
+	struct stat	st;
+	char			*resolved;
+#endif
+
+	strncpy(key, filename, keySize);
+	key[keySize-1] = '\0';
+	stamp->modTime = 0;
+	stamp->size = 0;
+	stamp->fileID = 0;
+
+#if PORT_SYS_UNIX && !OMFI_MACSF_STREAM && !OMFI_MACFSSPEC_STREAM
+	resolved = realpath(filename, NULL);
+	if(resolved != NULL)
+	{
+		if(strlen(resolved) < (size_t)keySize)
+			strcpy(key, resolved);
+		free(resolved);
+	}
+	if(stat(filename, &st) != 0)
+		return(FALSE);
+	stamp->modTime = (omfUInt32)st.st_mtime;
+	stamp->size = (omfUInt32)st.st_size;
+	stamp->fileID = (omfUInt32)st.st_ino;
+	return(TRUE);
+#else
+	return(FALSE);
+#endif
+}
+
 /* INDENT OFF */
 /*
 ;;; Local Variables: ***
@@ -36,11 +36,42 @@ extern          "C"
 {
 #endif
 
+/* Identifies a version of a file, so that open handles can be dropped
+ * once the file changes underneath them.
+ */
+typedef struct
+{
+	omfUInt32	modTime;
+	omfUInt32	size;
+	omfUInt32	fileID;
+} omfLocatorStamp_t;
+
 OMF_EXPORT omfErr_t openLocator(omfHdl_t file, 
                                 omfObject_t obj, 
 					            omfFileFormat_t fmt, 
 					            omfHdl_t * refFile);
 
+OMF_EXPORT omfErr_t locatorGetFileName(omfHdl_t file,
+                                omfObject_t obj,
+                                omfInt32 nameSize,
+                                char *filename,
+                                omfInt16 *vref,
+                                omfInt32 *DirID);
+
+OMF_EXPORT omfErr_t openLocatorFile(omfHdl_t file,
+                                char *filename,
+                                omfInt16 vref,
+                                omfInt32 DirID,
+                                omfFileFormat_t fmt,
+                                omfHdl_t * refFile);
+
+OMF_EXPORT omfBool locatorFileIdentity(char *filename,
+                                omfInt16 vref,
+                                omfInt32 DirID,
+                                omfInt32 keySize,
+                                char *key,
+                                omfLocatorStamp_t *stamp);
+
 #if PORT_LANG_CPLUSPLUS
 }
 #endif
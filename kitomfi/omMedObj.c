@@ -736,6 +736,7 @@ omfErr_t omfsFindSourceMobByID(
 	
 	XPROTECT(file)
 	{
+		CHECK(omfsTableFill(file->mobs));
 		entry = (mobTableEntry_t *)omfsTableUIDLookupPtr(file->mobs, mobID);
 		if (entry == NULL)
 			RAISE(OM_ERR_MOB_NOT_FOUND);
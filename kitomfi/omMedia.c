@@ -55,6 +55,30 @@ static omfErr_t FindTrackByID(omfHdl_t file, omfObject_t masterMob,
 										omfTrackID_t trackID,
 										omfMSlotObj_t	*trackRtn);
 
+/* One external OMFI media file held open by the session.  Handles are
+ * shared by all media opened from the same file (and the same version of
+ * the file), and kept open while idle up to the session's limit.
+ */
+struct omfMediaFileEntry
+{
+	struct omfMediaFileEntry	*next;
+	omfHdl_t				file;
+	char					key[256];
+	omfInt16				vref;
+	omfInt32				DirID;
+	omfBool				hasStamp;
+	omfLocatorStamp_t	stamp;
+	omfBool				stale;
+	omfInt32				refCount;
+	omfUInt32			lastUse;
+};
+
+static omfErr_t OpenMediaFile(omfHdl_t refFile, omfObject_t aLoc,
+						omfFileFormat_t fmt, omfHdl_t *dataFile);
+static omfErr_t CloseMediaFileEntry(omfSessionHdl_t session,
+						struct omfMediaFileEntry *entry);
+static omfErr_t TrimMediaFileCache(omfSessionHdl_t session);
+
 #define MAX_DEF_AUDIO	8
 /* A 75-column ruler
          111111111122222222223333333333444444444455555555556666666666777777
@@ -1201,7 +1225,7 @@ omfErr_t omfmReadRawData(
 		xfer.bytesXfered = 0;
 		xfer.samplesXfered = 0;
 	
-		CHECK(codecReadBlocks(media, leaveInterleaved, 1, &xfer));
+		CHECK(codecReadBlocks(media, leaveInterleaved, 1, &xfer, 1));
 		*bytesRead = xfer.bytesXfered;
 		*samplesRead = xfer.samplesXfered;
 	}
@@ -1408,7 +1432,7 @@ omfErr_t omfmMediaClose(
 		 * If the data is in the current file, leave it open.
 		 */
 		if ((media->dataFile != main) && (media->dataFile != NULL))
-			CHECK(omfsCloseFile(media->dataFile));
+			CHECK(ReleaseMediaFile(media->dataFile));
 
 		if(media->channels != NULL)
 		{
@@ -1635,6 +1659,44 @@ omfErr_t omfmLocatorFailureCallback(
 }
 
 
+/************************
+ * Function: omfmSetMediaFileCacheSize
+ *
+ * 		Sets the number of external media files which the session keeps
+ *		open after the last media handle using them is closed, so that
+ *		later opens of media in the same files don't need to reopen and
+ *		parse them again.  The least recently used files are closed first.
+ *
+ *		Files in use by open media are always shared, whatever the limit.
+ *		An idle file is closed rather than reused if it has changed since
+ *		it was opened.
+ *
+ * Argument Notes:
+ *		maxIdleFiles - 0 closes each file when its last media handle
+ *			is closed.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ *		OM_ERR_BAD_SESSION - Session handle was NULL or invalid.
+ *		OM_ERR_INVALID_CACHE_SIZE - maxIdleFiles must be >= 0.
+ */
+omfErr_t omfmSetMediaFileCacheSize(
+			omfSessionHdl_t	sess,				/* IN -- For this session */
+			omfInt32			maxIdleFiles)	/* IN -- keep this many unused files open */
+{
+	if ((sess == NULL) || (sess->cookie != SESSION_COOKIE))
+		return (OM_ERR_BAD_SESSION);
+	if (maxIdleFiles < 0)
+		return (OM_ERR_INVALID_CACHE_SIZE);
+
+	sess->mediaFileCacheSize = maxIdleFiles;
+	return (TrimMediaFileCache(sess));
+}
+
+
 /************************************************************************
  *
  * Routines for reading media data
@@ -2508,6 +2570,40 @@ omfErr_t omfmReadDataSamples(
 			omfInt32			buflen,		/* IN -- */
 			void			*buffer,		/* IN/OUT -- */
 			omfUInt32		*bytesRead)	/* OUT -- */
+{
+	return (omfmReadDataSamplesParallel(media, nSamples, 1, buflen,
+										buffer, bytesRead));
+}
+
+/************************
+ * Function: omfmReadDataSamplesParallel
+ *
+ * 	Version of omfmReadDataSamples which lets the codec decompress
+ *		several samples at once on a pool of threads.  The compressed
+ *		data is still read from the file in order on the calling thread.
+ *
+ *		Only the JPEG codec (JPEG, AVR and Avid JFIF media) decodes in
+ *		parallel, and only on systems with threads.  Other codecs read
+ *		the samples exactly as omfmReadDataSamples does.
+ *
+ * Argument Notes:
+ *		numWorkers is the number of samples which may be decompressed at
+ *		once, counting the calling thread.  Values less than 2 decode on
+ *		the calling thread only.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ */
+omfErr_t omfmReadDataSamplesParallel(
+			omfMediaHdl_t media,		/* IN -- */
+			omfInt32			nSamples,	/* IN -- */
+			omfInt32			numWorkers,	/* IN -- */
+			omfInt32			buflen,		/* IN -- */
+			void			*buffer,		/* IN/OUT -- */
+			omfUInt32		*bytesRead)	/* OUT -- */
 {
 	omfmMultiXfer_t xfer;
 	omfInt64		one;
@@ -2522,6 +2618,9 @@ omfErr_t omfmReadDataSamples(
 	if(omfsInt64Greater(media->pvt->repeatCount, one))
 	  omfmGotoShortFrameNumber(media, 1);
 
+	if(numWorkers < 1)
+		numWorkers = 1;
+
 	XPROTECT(media->mainFile)
 	{
 		xfer.subTrackNum = media->physicalOutChanOpen;
@@ -2530,7 +2629,7 @@ omfErr_t omfmReadDataSamples(
 		xfer.buffer = buffer;
 		xfer.bytesXfered = 0;
 	
-		CHECK(codecReadBlocks(media, deinterleave, 1, &xfer));
+		CHECK(codecReadBlocks(media, deinterleave, 1, &xfer, numWorkers));
 	}
 	XEXCEPT
 	{
@@ -2572,7 +2671,7 @@ omfErr_t omfmReadMultiSamples(
 	omfAssertMediaInitComplete(media->mainFile);
 	omfAssert(xferArray != NULL, media->mainFile, OM_ERR_NULL_PARAM);
 
-	return (codecReadBlocks(media, deinterleave, elemCount, xferArray));
+	return (codecReadBlocks(media, deinterleave, elemCount, xferArray, 1));
 }
 
 /************************
@@ -3084,7 +3183,7 @@ omfErr_t omfmGetCriteriaSourceClip(
 			if(dataFile == NULL)
 				continue;
 			if(dataFile != file)
-				omfsCloseFile(dataFile);
+				ReleaseMediaFile(dataFile);
 
 			score = 0;
 			switch(criteria->type)
@@ -3804,6 +3903,7 @@ static omfErr_t InitMediaHandle(
 		
 #ifdef OMFI_ENABLE_STREAM_CACHE
 		media->stream->cachePtr = NULL;
+		media->stream->asyncIO = NULL;
 #endif
 		media->stream->procData = NULL;
 		
@@ -3818,6 +3918,242 @@ static omfErr_t InitMediaHandle(
 	return (OM_ERR_NONE);
 }
 
+/************************
+ * Function: OpenMediaFile (INTERNAL)
+ *
+ * 	Open the file referenced by the given locator, reusing the session's
+ *		handle to the file if it is already open and hasn't changed since.
+ *		Each successful call must be balanced by a ReleaseMediaFile().
+ *
+ *		Only OMFI files are shared.  A raw file handle carries the
+ *		position of the single stream reading it, so those are opened
+ *		fresh each time as before.
+ *
+ * Argument Notes:
+ *		refFile - The file holding the composition which has the locator.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ *		OM_ERR_NOMEMORY - Couldn't allocate the cache entry.
+ */
+static omfErr_t OpenMediaFile(
+			omfHdl_t			refFile,		/* IN -- */
+			omfObject_t		aLoc,			/* IN -- */
+			omfFileFormat_t fmt,			/* IN -- */
+			omfHdl_t			*dataFile)	/* OUT -- */
+{
+	omfSessionHdl_t				session;
+	struct omfMediaFileEntry	*entry;
+	char								filename[256], key[256];
+	omfInt16							vref;
+	omfInt32							DirID;
+	omfBool							hasStamp;
+	omfLocatorStamp_t				stamp;
+	
+	*dataFile = NULL;
+	session = refFile->session;
+	XPROTECT(refFile)
+	{
+		if(fmt != kOmfiMedia)
+		{
+			CHECK(openLocator(refFile, aLoc, fmt, dataFile));
+		}
+		else
+		{
+			CHECK(locatorGetFileName(refFile, aLoc, sizeof(filename), filename,
+											 &vref, &DirID));
+			hasStamp = locatorFileIdentity(filename, vref, DirID, sizeof(key),
+													 key, &stamp);
+			for(entry = session->mediaFiles; entry != NULL; entry = entry->next)
+			{
+				if(entry->stale || (entry->vref != vref) ||
+					(entry->DirID != DirID) || (strcmp(entry->key, key) != 0))
+					continue;
+				if(!hasStamp && !entry->hasStamp)
+					break;
+				if(hasStamp && entry->hasStamp &&
+					(entry->stamp.modTime == stamp.modTime) &&
+					(entry->stamp.size == stamp.size) &&
+					(entry->stamp.fileID == stamp.fileID))
+					break;
+				/* The file has changed since this handle was opened, so let
+				 * the handle go once its current users are done with it.
+				 */
+				entry->stale = TRUE;
+			}
+			
+			if(entry == NULL)
+			{
+				CHECK(TrimMediaFileCache(session));
+				CHECK(openLocatorFile(refFile, filename, vref, DirID, fmt,
+											 dataFile));
+				entry = (struct omfMediaFileEntry *)
+					omOptMalloc(NULL, sizeof(struct omfMediaFileEntry));
+				if(entry == NULL)
+				{
+					(void) omfsCloseFile(*dataFile);
+					*dataFile = NULL;
+					RAISE(OM_ERR_NOMEMORY);
+				}
+				entry->file = *dataFile;
+				strcpy(entry->key, key);
+				entry->vref = vref;
+				entry->DirID = DirID;
+				entry->hasStamp = hasStamp;
+				entry->stamp = stamp;
+				entry->stale = FALSE;
+				entry->refCount = 0;
+				entry->next = session->mediaFiles;
+				session->mediaFiles = entry;
+			}
+			else
+				*dataFile = entry->file;
+			
+			entry->refCount++;
+			entry->lastUse = ++session->mediaFileClock;
+		}
+	}
+	XEXCEPT
+	XEND
+	
+	return(OM_ERR_NONE);
+}
+
+/************************
+ * Function: ReleaseMediaFile (INTERNAL)
+ *
+ * 	Release a data file found by LocateMediaFile.  Shared files are
+ *		closed when the last user releases them, unless the session is
+ *		allowed to keep them open while idle.  Any other file (a raw file,
+ *		or one returned by the locator failure callback) is closed.
+ *
+ * Argument Notes:
+ *		<none>.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ */
+omfErr_t ReleaseMediaFile(
+			omfHdl_t			dataFile)	/* IN -- */
+{
+	omfSessionHdl_t				session;
+	struct omfMediaFileEntry	*entry;
+
+	omfAssertValidFHdl(dataFile);
+	session = dataFile->session;
+	for(entry = session->mediaFiles; entry != NULL; entry = entry->next)
+	{
+		if(entry->file == dataFile)
+			break;
+	}
+	if(entry == NULL)
+		return(omfsCloseFile(dataFile));
+	
+	entry->refCount--;
+	entry->lastUse = ++session->mediaFileClock;
+	return(TrimMediaFileCache(session));
+}
+
+/************************
+ * Function: CloseMediaFileEntry (INTERNAL)
+ *
+ * 	Unlink an unused entry from the session's media file list, and
+ *		close its file.
+ *
+ * Argument Notes:
+ *		<none>.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ */
+static omfErr_t CloseMediaFileEntry(
+			omfSessionHdl_t				session,	/* IN -- */
+			struct omfMediaFileEntry	*entry)	/* IN -- */
+{
+	struct omfMediaFileEntry	**prev;
+	omfHdl_t							file;
+	
+	for(prev = &session->mediaFiles; *prev != NULL; prev = &(*prev)->next)
+	{
+		if(*prev == entry)
+		{
+			*prev = entry->next;
+			break;
+		}
+	}
+	file = entry->file;
+	omOptFree(NULL, entry);
+	
+	return(omfsCloseFile(file));
+}
+
+/************************
+ * Function: TrimMediaFileCache (INTERNAL)
+ *
+ * 	Close unused media files which can't be reused (stale, or with no
+ *		way to check for changes), then close the least recently used
+ *		ones until no more than mediaFileCacheSize remain idle.
+ *
+ * Argument Notes:
+ *		<none>.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ */
+static omfErr_t TrimMediaFileCache(
+			omfSessionHdl_t	session)	/* IN -- */
+{
+	struct omfMediaFileEntry	*entry, *next, *oldest;
+	omfInt32							numIdle;
+	omfErr_t							status, totalStatus;
+	
+	totalStatus = OM_ERR_NONE;
+	numIdle = 0;
+	for(entry = session->mediaFiles; entry != NULL; entry = next)
+	{
+		next = entry->next;
+		if(entry->refCount != 0)
+			continue;
+		if(entry->stale || !entry->hasStamp)
+		{
+			status = CloseMediaFileEntry(session, entry);
+			if(status != OM_ERR_NONE)
+				totalStatus = status;
+		}
+		else
+			numIdle++;
+	}
+	
+	while(numIdle > session->mediaFileCacheSize)
+	{
+		oldest = NULL;
+		for(entry = session->mediaFiles; entry != NULL; entry = entry->next)
+		{
+			if((entry->refCount == 0) &&
+				((oldest == NULL) || (entry->lastUse < oldest->lastUse)))
+				oldest = entry;
+		}
+		status = CloseMediaFileEntry(session, oldest);
+		if(status != OM_ERR_NONE)
+			totalStatus = status;
+		numIdle--;
+	}
+	
+	return(totalStatus);
+}
+
 /************************
  * Function: TrialOpenFile (INTERNAL)
  *
@@ -3852,14 +4188,14 @@ static omfErr_t TrialOpenFile(
 
 	XPROTECT(refFile)
 	{
-		CHECK(openLocator(refFile, aLoc, fmt, dataFile));
+		CHECK(OpenMediaFile(refFile, aLoc, fmt, dataFile));
 		if(omfmIsMediaDataPresent(*dataFile, fileMobUid, fmt))
 			*found = TRUE;
 	}
 	XEXCEPT
 	{
 		if ((*dataFile != NULL) && (*dataFile != refFile))
-			(void) omfsCloseFile(*dataFile);
+			(void) ReleaseMediaFile(*dataFile);
 		NO_PROPAGATE();
 	}
 	XEND
@@ -3914,20 +4250,24 @@ omfErr_t     LocateMediaFile(
 	omfObject_t     aLoc, mdes;
 	omfHdl_t        refFile;
 	omfErr_t			status;
+	omfBool			opened;
 	
 	omfAssertValidFHdl(file);
 	refFile = file;
+	opened = FALSE;
 	XPROTECT(file)
 	{
 		CHECK(omfmMobGetMediaDescription(file, fileMob, &mdes));
 		CHECK(omfsReadUID(file, fileMob, OMMOBJMobID, &uid));
 	
 		found = FALSE;
+		CHECK(omfsTableFill(file->dataObjs));
 		/* MCX/NT Hack! */
 		if(omfsTableIncludesUID(file->dataObjs, uid))
 		{
 			*dataFile = file;
 			*isOMFI = TRUE;
+			opened = TRUE;
 			found = omfmIsMediaDataPresent(file, uid, kOmfiMedia);
 		}
 		else if(uid.prefix == 444)
@@ -3935,6 +4275,7 @@ omfErr_t     LocateMediaFile(
 			uid.prefix = 1;
 			*dataFile = file;
 			*isOMFI = TRUE;
+			opened = TRUE;
 			found = omfmIsMediaDataPresent(file, uid, kOmfiMedia);
 		}
 		
@@ -3959,11 +4300,19 @@ omfErr_t     LocateMediaFile(
 
 				/* Release Bento reference, so the useCount is decremented */
 				CMReleaseObject((CMObject)aLoc);
+				
+				/* Don't hold onto files which don't have the media */
+				opened = (*dataFile != NULL);
+				if(opened && !found)
+				{
+					CHECK(ReleaseMediaFile(*dataFile));
+					*dataFile = NULL;
+				}
 			}
 		}
 	
 		if (!found &&
-			(*dataFile == NULL) &&
+			!opened &&
 			(file->locatorFailureCallback != NULL))
 		{
 			refFile = (*file->locatorFailureCallback) (file, mdes);
@@ -4458,9 +4807,22 @@ omfErr_t DisposeCodecPersist(omfSessionHdl_t sess)
 	omfBool				more;
 	omTableIterate_t	iter;
 	codecTable_t		codec_table;
+	struct omfMediaFileEntry	*entry;
 	
 	XPROTECT(NULL)
 	{
+		/* Close the idle media files.  Files still used by open media
+		 * are closed along with the rest of the session's files.
+		 */
+		sess->mediaFileCacheSize = 0;
+		(void) TrimMediaFileCache(sess);
+		while(sess->mediaFiles != NULL)
+		{
+			entry = sess->mediaFiles;
+			sess->mediaFiles = entry->next;
+			omOptFree(NULL, entry);
+		}
+		
 		CHECK(omfsTableFirstEntry(sess->codecID, &iter, &more));
 		while(more)
 		{
@@ -664,6 +664,7 @@ omfErr_t omfiMobSetIdentity(
 		if (hasMobID)
 		  {
 			CHECK(omfsTableRemoveUID(file->mobs, oldMobID));
+			file->mobEditCount++;	/* Drops the mob indexes */
 
 			/* If 1.x, take the old Mob out of the mob index, and add
 			 * a new entry with a new mob ID
@@ -3793,6 +3794,7 @@ omfErr_t AddMobTableEntry(
 		  }
 	
 		CHECK(omfsTableAddUID(file->mobs, mobID, entry, dup));
+		file->mobEditCount++;		/* Drops the mob indexes */
 	  }
 	XEXCEPT
 	  {
@@ -784,6 +784,7 @@ omfErr_t omfiMobDelete(
 				if (entry)
 				  CMReleaseObject((CMObject)(entry->mob));
 				CHECK(omfsTableRemoveUID(file->mobs, mobID));
+				file->mobEditCount++;	/* Drops the mob indexes */
 
 				/* Remove from Mobs index */
 				CHECK(omfsGetHeadObject(file, &head));
@@ -2145,6 +2146,9 @@ omfBool omfiIsMobInFile(
 	omfAssertValidFHdlBool(file, omfError, FALSE);
 
 	/* Get the mob out of the mob hash table */
+	*omfError = omfsTableFill(file->mobs);
+	if (*omfError != OM_ERR_NONE)
+	  return(FALSE);
 	entry = (mobTableEntry_t *)omfsTableUIDLookupPtr(file->mobs, mobID);
 	if (entry != NULL)
 	  {
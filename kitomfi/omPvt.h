@@ -103,6 +103,7 @@ typedef struct
 	omfValidRev_t   revs;
 	omfClassID_t  	itsSuperClass;
 	omfObject_t		clsd;		/* During close, contains the clsd object */
+	omfInt32		index;		/* Session-wide class number (ancestry bit) */
 }               OMClassDef;
 
 typedef struct
@@ -161,6 +162,39 @@ struct omfiSession
 
 	struct omfiBentoIOFuncs ioFuncs;
 
+	/* Read cache used by the ANSI container handler, applied to files
+	 * opened after it is set (see omfsSetReadCacheSize).  The hit and
+	 * miss counts are for files already closed, each open file keeps its
+	 * own (see omfsGetReadCacheStats).
+	 */
+	omfInt32		readCacheBlockSize;
+	omfInt32		readCacheNumBlocks;
+	omfInt32		readCacheReadAhead;
+	omfUInt32		readCacheHits;
+	omfUInt32		readCacheMisses;
+
+	/* External media files opened through locators, shared between
+	 * media handles and kept open for reuse (see omfmSetMediaFileCacheSize).
+	 */
+	struct omfMediaFileEntry	*mediaFiles;
+	omfInt32		mediaFileCacheSize;
+	omfUInt32		mediaFileClock;
+
+	/* Defer building the mob and media data tables of files opened
+	 * read-only until they are first used (see omfsSetLazyOpen).
+	 */
+	omfBool			lazyOpen;
+
+	/* Class ancestry bitsets, one row of classAncestryWords words per
+	 * class index, with a bit set for the class and each of its
+	 * superclasses (see omfsBuildClassAncestry).  Rebuilt after new
+	 * classes are added.
+	 */
+	omfInt32		nextClassIndex;
+	omfInt32		classAncestryWords;
+	omfUInt32		*classAncestry1X;
+	omfUInt32		*classAncestry2X;
+	omfBool			classAncestryValid;
 };
 
 /************************************************************
@@ -214,6 +248,9 @@ struct omfiIterate
 											 will free everything on this
 											 chain */
 		omTableIterate_t *tableIter; /* Used by duplication MobID iterator */
+		omfObject_t   *mobList;    /* Mobs matched from the mob indexes */
+		omfInt32      mobListSize; /* by omfiGetNextMob(), and the next */
+		omfInt32      mobListNext; /* one to return */
 };
 
 /************************************************************
@@ -281,6 +318,13 @@ struct omfiFile
 		/* Reverse lookup tables to get from Bento -> Avid numbers */
 		omTable_t	    *typeReverse;	     /* Either 1.x OR 2.x, but not both */
 		omTable_t	    *propReverse; /* Either 1.x OR 2.x, but not both */
+		/* Direct-indexed copies of the types & properties tables, indexed
+		 * by omfType_t / omfProperty_t.  A NULL bentoID means "not cached".
+		 */
+		OMTypeCache	    *typeCache;
+		omfInt32	    typeCacheSize;
+		CMProperty	    *propCache;
+		omfInt32	    propCacheSize;
 		omTable_t       *datakinds;
 		omTable_t       *effectDefs;
 
@@ -301,6 +345,35 @@ struct omfiFile
 		omTable_t       *mobs;
 		omTable_t       *dataObjs;
 
+		/* Read cache hits and misses on this file's container, added
+		 * into the session's totals when the container is closed.  Only
+		 * the thread reading the container touches them.
+		 */
+		omfUInt32		readCacheHits;
+		omfUInt32		readCacheMisses;
+
+		/* Offset index for each sequence searched by position.  All of
+		 * them are dropped when editCount (bumped by every property write
+		 * or object delete) no longer matches sequIndexEdits.
+		 */
+		omTable_t       *sequIndexes;
+		omfUInt32		sequIndexEdits;
+		omfUInt32		editCount;
+
+		/* Mobs of each kind and mobs by name, for omfiGetNextMob().
+		 * Dropped when mobEditCount (bumped by mob table changes and by
+		 * writes of mob name and kind properties) no longer matches
+		 * mobIndexEdits.
+		 */
+		struct omfMobIndex	*mobIndex;
+		omfUInt32		mobIndexEdits;
+		omfUInt32		mobEditCount;
+
+		/* Raw files only: serializes the stream funcs while any stream
+		 * on the file has a read-ahead or write-behind thread.
+		 */
+		struct omfStreamIOLock	*streamIOLock;
+
 		omfLocatorFailureCB locatorFailureCallback;
 		omfBool			customStreamFuncsExist;
 		struct omfCodecStreamFuncs streamFuncs;
@@ -315,6 +388,8 @@ struct omfiFile
 
 omfErr_t clearBentoErrors(omfHdl_t file);	/* IN -- For this omf file */
 omfErr_t omfsInit(void);
+void stdCodecInitColorTables(void);
+omfErr_t omfsBuildClassAncestry(omfSessionHdl_t session);
 
 /************************************************************
  *
@@ -458,7 +533,8 @@ OMF_EXPORT omfErr_t        codecWriteBlocks(omfMediaHdl_t media,
 OMF_EXPORT omfErr_t        codecReadBlocks(omfMediaHdl_t media, 
 								omfDeinterleave_t inter,
 								omfInt16 xferBlockCount, 
-								omfmMultiXfer_t * xferBlock);
+								omfmMultiXfer_t * xferBlock,
+								omfInt32 numWorkers);
 OMF_EXPORT omfErr_t        codecWriteLines(omfMediaHdl_t media, 
 								omfInt32 nLines, 
 								void *buffer, 
@@ -532,6 +608,25 @@ OMF_EXPORT omfErr_t codecPassThrough(
 			omfHdl_t			main,
 			void				*clientPData);
 
+typedef struct
+{
+	char			*buf;
+	omfUInt32		len;
+} codecScratch_t;
+
+OMF_EXPORT omfErr_t codecGetScratchBuffer(
+			omfHdl_t			main,		/* IN -- */
+			codecScratch_t		*scratch,	/* IN/OUT -- */
+			omfUInt32			size,		/* IN -- */
+			char				**buf);		/* OUT -- */
+OMF_EXPORT omfErr_t codecAddScratchSize(
+			omfUInt32			*total,		/* IN/OUT -- */
+			omfUInt32			count,		/* IN -- */
+			omfUInt32			itemSize);	/* IN -- */
+OMF_EXPORT void codecFreeScratchBuffer(
+			omfHdl_t			main,		/* IN -- */
+			codecScratch_t		*scratch);	/* IN/OUT -- */
+
 /************************************************************
  *
  * Mob Table Management Functions
@@ -612,6 +707,27 @@ OMF_EXPORT omfType_t		CvtTypeFromBento(omfHdl_t file,
 								 CMType srchProp, 
 								 omfBool *found);
 
+OMF_EXPORT omfErr_t ompvtCachePropertyID(
+			omfHdl_t 		file,		/* IN -- For this omf file */
+			omfProperty_t	prop,		/* IN -- cache this property */
+			CMProperty		bentoID);	/* IN -- as this Bento property */
+
+OMF_EXPORT omfErr_t ompvtCacheTypeID(
+			omfHdl_t 		file,		/* IN -- For this omf file */
+			omfType_t		type,		/* IN -- cache this type */
+			CMType			bentoID,	/* IN -- as this Bento type */
+			omfSwabCheck_t	swab);		/* IN -- with this swab setting */
+
+OMF_EXPORT void ompvtDisposeIDCaches(
+			omfHdl_t 		file);		/* IN -- For this omf file */
+
+OMF_EXPORT omfBool ompvtIsMobIndexProp(
+			omfProperty_t	prop);		/* IN -- Property being written */
+OMF_EXPORT void ompvtDisposeMobIndex(
+			omfHdl_t 		file);		/* IN -- For this omf file */
+OMF_EXPORT void ompvtDisposeStreamIOLock(
+			omfHdl_t 		file);		/* IN -- For this raw file */
+
 OMF_EXPORT omfBool ompvtIsForeignByteOrder(
 			omfHdl_t 	file,		/* IN -- For this omf file */
 			omfObject_t obj);		/* IN -- is this object foreign byte order? */
@@ -760,6 +876,9 @@ OMF_EXPORT omfErr_t LocateMediaFile(
 			omfHdl_t			*dataFile,
 			omfBool			*isOMFI);
 
+OMF_EXPORT omfErr_t ReleaseMediaFile(
+			omfHdl_t			dataFile);	/* IN */
+
 OMF_EXPORT omfErr_t InitFileHandle(
 			omfSessionHdl_t	session, 
 			omfFileFormat_t 	fmt, 
@@ -44,6 +44,9 @@
 #include <string.h>
 #include <ctype.h>
 #include <stdio.h>
+#ifdef OMFI_SELF_TEST
+#include <time.h>
+#endif
 
 #include "omPublic.h"
 #include "omTable.h"
@@ -52,7 +55,25 @@
 #define TABLE_COOKIE		0x5461626C
 #define TABLE_ITER_COOKIE	0x54424C49
 
-#define _lookup(table,key) 	( (table->map ? (omfUInt32)table->map(key) : (omfUInt32)key) % table->hashTableSize)
+/*
+ * The table is open-addressed with linear probing.  Each slot holds the
+ * newest entry for a key, older entries with the same key hang off of
+ * entry->dup.  Entries are also kept in an insertion-ordered list, which
+ * is what the iterators walk, so growing the slot array never disturbs
+ * an iteration in progress.  Removing an entry leaves a hole in the list,
+ * the holes are squeezed out when the slots are rebuilt.  An iterator
+ * that sees the list has been compacted finds its place again from the
+ * serial number of the last entry it returned.
+ */
+#define TABLE_MIN_SLOTS		16
+#define TABLE_LOAD_NUM		3		/* Grow when slots are more than 3/4 full */
+#define TABLE_LOAD_DEN		4
+#define TABLE_SLAB_SIZE		8192	/* Entries are carved from blocks this size */
+#define TABLE_SLAB_GRAIN	8
+#define TABLE_SLAB_CLASSES	32		/* Entries over 256 bytes are malloced */
+#define TABLE_NO_CLASS		-1
+
+#define SLOT_DELETED		((tableLink_t *)&deletedSlotMarker)
 
 typedef enum
 {
@@ -61,30 +82,72 @@ typedef enum
 
 struct omfTableLink
 {
-	tableLink_t			*link;
-	tableLink_t			*dup;
+	tableLink_t			*dup;		/* Next older entry for this key, or free list */
 	void				*data;
-	omfInt16			keyLen;
 	omfInt32			valueLen;
+	omfInt32			index;		/* Position in table->entries */
+	omfUInt32			serial;		/* Insertion order, kept across compaction */
+	omfInt16			keyLen;
+	omfInt16			sizeClass;	/* Slab size class, or TABLE_NO_CLASS */
 	valueType_t			type;
 	char				local[1];
 };
 
+typedef struct
+{
+	omfUInt32			hash;
+	tableLink_t			*entry;		/* NULL if empty, SLOT_DELETED if removed */
+} tableSlot_t;
+
+typedef struct tableSlab
+{
+	struct tableSlab	*next;
+} tableSlab_t;
+
 struct omTable
 {
 	omfHdl_t			file;			/* Optional: If set omOptMalloc/Free calls will optimize */
 	omfInt32			cookie;
 	omfInt16			defaultSize;	/* default size of keys */
-	tableLink_t		**hashTable;
-	omfInt32			hashTableSize;
+	tableSlot_t			*slots;
+	omfInt32			numSlots;		/* Always a power of 2 */
+	omfInt32			slotsUsed;		/* Live keys */
+	omfInt32			slotsDeleted;	/* Tombstones */
+	tableLink_t			**entries;		/* All entries, in insertion order */
+	omfInt32			numEntries;		/* Including holes left by removal */
+	omfInt32			maxEntries;
 	omfInt32			numItems;
+	omfUInt32			nextSerial;
+	omfUInt32			compactions;	/* Bumped each time entries[] is compacted */
+	tableSlab_t			*slabs;
+	char				*slabPtr;
+	omfInt32			slabLeft;
+	tableLink_t			*freeEntries[TABLE_SLAB_CLASSES];
 				
 	omTblMapProc		map;			/* the mapping function			*/
+	omTblMapProc		mixedMap;		/* kOmTableHashMixed mapping	*/
+	omTblMapProc		simpleMap;		/* kOmTableHashSimple mapping	*/
 	omTblCompareProc	compare;		/* the comparison function		*/
 	omTblDisposeProc	entryDispose;
+	omTblFillProc		fill;			/* Populates the table on first use */
+	omfBool				filling;		/* The fill proc is running */
+	omfErr_t			fillStatus;		/* Error from a fill which failed */
 };
+
+static char deletedSlotMarker;
 	
 static omfErr_t DisposeList(omTable_t *table, omfBool itemsAlso);
+static omfUInt32 HashKey(omTable_t *table, void *key);
+static tableSlot_t *FindSlot(omTable_t *table, void *key, omfUInt32 hash);
+static omfErr_t AddEntry(omTable_t *table, void *key, tableLink_t *entry);
+static omfErr_t ResizeSlots(omTable_t *table, omfInt32 newSize, omfBool rehash);
+static void CompactEntries(omTable_t *table);
+static void SetSimpleMap(omTable_t *table, omTblMapProc simpleMap);
+static omfUInt32 MixWord(omfUInt32 hash, omfUInt32 word);
+static tableLink_t *AllocEntry(omTable_t *table, omfInt32 size);
+static void FreeEntry(omTable_t *table, tableLink_t *entry);
+static void DisposeEntryData(omTable_t *table, tableLink_t *entry);
+static omfErr_t FillTable(omTable_t *table);
 
 /************************************************************************
  *
@@ -103,7 +166,8 @@ static omfErr_t DisposeList(omTable_t *table, omfBool itemsAlso);
  * 		WhatIt(Internal)Does
  *
  * Argument Notes:
- *		StuffNeededBeyondNotesInDefinition.
+ *		numBuckets is only a sizing hint, the table grows as
+ *		entries are added.
  *
  * ReturnValue:
  *		Error code (see below).
@@ -120,26 +184,32 @@ omfErr_t omfsNewTable(
 			omTable_t **resultPtr)
 {
 	omTable_t	*result;
+	omfInt32	size;
 	
 	XPROTECT(NULL)
 	{
 		result = (omTable_t *)omOptMalloc(file, sizeof(omTable_t));
 		XASSERT(result != NULL, OM_ERR_NOMEMORY);
+		memset(result, 0, sizeof(omTable_t));
 		
 		result->cookie = TABLE_COOKIE;
 		result->file = file;
 		result->map = myMap;
+		result->mixedMap = myMap;
+		result->simpleMap = myMap;
 		result->compare = myCompare;
 		result->entryDispose = NULL;
+		result->fill = NULL;
+		result->filling = FALSE;
+		result->fillStatus = OM_ERR_NONE;
 		result->defaultSize = initKeySize;
-		result->hashTableSize = numBuckets;
-		result->hashTable = (tableLink_t **)omOptMalloc(file, result->hashTableSize * sizeof(tableLink_t *));
-		if (result->hashTable == NULL)
+		for(size = TABLE_MIN_SLOTS; size < numBuckets; size <<= 1)
+			;
+		if (ResizeSlots(result, size, FALSE) != OM_ERR_NONE)
 		{
+			omOptFree(file, result);
 			RAISE(OM_ERR_NOMEMORY);
 		}
-		memset(result->hashTable, 0, result->hashTableSize * sizeof(tableLink_t *));
-		result->numItems = 0;
 	}
 	XEXCEPT
 	{
@@ -166,6 +236,175 @@ omfErr_t omfsSetTableDispose(omTable_t *table, omTblDisposeProc proc)
 	return(OM_ERR_NONE);
 }
 
+/************************
+ * name
+ *
+ * 		Selects the hash function used by one of the specialized tables
+ *		below.  The mixed functions (the default) spread sequential and
+ *		near-identical keys across the table, the simple functions are
+ *		the original sums and shifts, which are cheaper to compute.
+ *		Entries already in the table are rehashed.
+ *
+ * Argument Notes:
+ *		Tables made by calling omfsNewTable directly have only the one
+ *		map function, and are unaffected.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ */
+omfErr_t omfsSetTableHash(
+			omTable_t *table,
+			omTableHash_t hash)
+{
+	omTblMapProc	newMap;
+
+	XPROTECT(NULL)
+	{
+		XASSERT((table != NULL) && (table->cookie == TABLE_COOKIE), 
+				OM_ERR_TABLE_BAD_HDL);
+		newMap = (hash == kOmTableHashSimple ? table->simpleMap : table->mixedMap);
+		if(newMap != table->map)
+		{
+			table->map = newMap;
+			CHECK(ResizeSlots(table, table->numSlots, TRUE));
+		}
+	}
+	XEXCEPT
+	XEND
+	
+	return(OM_ERR_NONE);
+}
+
+/************************
+ * name
+ *
+ * 		Defers populating a table until it is first used.  The fill
+ *		proc is called once, before the first add, remove, lookup or
+ *		iteration, and may add its entries through the normal calls.
+ *		If it fails, the table is left partly filled, so the error is
+ *		kept and returned by every later call which would have run the
+ *		fill.  Disposing of the table does not call it.
+ *
+ * Argument Notes:
+ *		The table must have been created with a file handle, which is
+ *		passed to the proc.  A NULL proc cancels a pending fill.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ */
+omfErr_t omfsSetTableFill(
+			omTable_t *table,
+			omTblFillProc proc)
+{
+	XPROTECT(NULL)
+	{
+		XASSERT((table != NULL) && (table->cookie == TABLE_COOKIE), 
+				OM_ERR_TABLE_BAD_HDL);
+		XASSERT(table->file != NULL, OM_ERR_NULL_PARAM);
+		table->fill = proc;
+		table->fillStatus = OM_ERR_NONE;
+	}
+	XEXCEPT
+	XEND
+	
+	return(OM_ERR_NONE);
+}
+
+/************************
+ * name
+ *
+ * 		Runs a pending fill proc now (see omfsSetTableFill).  Callers of
+ *		omfsTableIncludesKey and omfsTableLookupPtr, which cannot return
+ *		an error, use this first on tables which may be filled lazily.
+ *
+ * Argument Notes:
+ *		<none>.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ *		Any error returned by the fill proc, now or on an earlier use.
+ */
+omfErr_t omfsTableFill(
+			omTable_t *table)
+{
+	XPROTECT(NULL)
+	{
+		XASSERT((table != NULL) && (table->cookie == TABLE_COOKIE), 
+				OM_ERR_TABLE_BAD_HDL);
+		CHECK(FillTable(table));
+	}
+	XEXCEPT
+	XEND
+	
+	return(OM_ERR_NONE);
+}
+
+/************************
+ * name
+ *
+ * 		Reports how well the keys are distributed.  histogram[n] is set
+ *		to the number of keys found on probe n+1 of a lookup, so a well
+ *		spread table has nearly everything in histogram[0].  Duplicates
+ *		of a key share one slot, and are counted once.
+ *
+ * Argument Notes:
+ *		The last bin also counts every key needing more than numBins
+ *		probes.  maxProbes (optional) returns the longest probe sequence.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ */
+omfErr_t omfsTableGetChainHistogram(
+			omTable_t *table,
+			omfInt32 numBins,
+			omfInt32 *histogram,
+			omfInt32 *maxProbes)
+{
+	omfInt32		n, probes, longest;
+	omfUInt32		mask;
+	tableSlot_t		*slot;
+
+	XPROTECT(NULL)
+	{
+		XASSERT((table != NULL) && (table->cookie == TABLE_COOKIE), 
+				OM_ERR_TABLE_BAD_HDL);
+		XASSERT((histogram != NULL) && (numBins > 0), OM_ERR_NULL_PARAM);
+		CHECK(FillTable(table));
+
+		memset(histogram, 0, numBins * sizeof(omfInt32));
+		mask = table->numSlots - 1;
+		longest = 0;
+		for(n = 0; n < table->numSlots; n++)
+		{
+			slot = table->slots + n;
+			if((slot->entry == NULL) || (slot->entry == SLOT_DELETED))
+				continue;
+			probes = ((n - (slot->hash & mask)) & mask) + 1;
+			if(probes > longest)
+				longest = probes;
+			histogram[(probes <= numBins ? probes : numBins) - 1]++;
+		}
+		if(maxProbes != NULL)
+			*maxProbes = longest;
+	}
+	XEXCEPT
+	XEND
+	
+	return(OM_ERR_NONE);
+}
+
 /************************
  * name
  *
@@ -187,14 +426,13 @@ omfErr_t omfsTableAddValuePtr(
 			void *value,
 			omTableDuplicate_t dup)
 {
-	tableLink_t		*entry, *srch;
-  	omfInt32			hash;
+	tableLink_t		*entry = NULL;
 				
 	XPROTECT(NULL)
 	{
 		XASSERT((table != NULL) && (table->cookie == TABLE_COOKIE), 
 				OM_ERR_TABLE_BAD_HDL);
-		entry = NULL;
+		CHECK(FillTable(table));
 	
 		if(keyLen == USE_DEFAULT)
 			keyLen = table->defaultSize;
@@ -206,39 +444,20 @@ omfErr_t omfsTableAddValuePtr(
 			CHECK(omfsTableRemove(table, key));
 		}
 			
-		entry = (tableLink_t *)omOptMalloc(table->file, keyLen + sizeof(tableLink_t) - 1);
+		entry = AllocEntry(table, keyLen + sizeof(tableLink_t) - 1);
 		XASSERT(entry != NULL, OM_ERR_NOMEMORY);
 	
-		hash = _lookup(table,key);
 		entry->type = valueIsPtr;
-		entry->dup = NULL;
-		/* Add to the head of the dup list for that key */
-		if(dup == kOmTableDupAddDup)
-		{
-			srch = table->hashTable[hash];
-			while(srch != NULL)
-			{
-				if(table->compare(key, srch->local))
-				{
-					entry->dup = srch;
-					break;
-				}
-			srch = srch->link;
-			}
-		}
-	
-		entry->link = table->hashTable[hash];
-		table->hashTable[hash] = entry;
-		
 		memcpy(entry->local, (char *)key, keyLen);
-	
 		entry->data = value;
 		entry->keyLen = keyLen;
 		entry->valueLen = 0;
-		table->numItems++;
+		CHECK(AddEntry(table, key, entry));
 	}
 	XEXCEPT
 	{
+		if(entry != NULL)
+			FreeEntry(table, entry);
 		return(XCODE());
 	}
 	XEND
@@ -268,14 +487,13 @@ omfErr_t omfsTableAddValueBlock(
 			omfInt32 valueLen,
 			omTableDuplicate_t dup)
 {
-	tableLink_t		*entry, *srch;
-  	omfInt32			hash;
+	tableLink_t		*entry = NULL;
 				
 	XPROTECT(NULL)
 	{
 		XASSERT((table != NULL) && (table->cookie == TABLE_COOKIE), 
 				OM_ERR_TABLE_BAD_HDL);
-		entry = NULL;
+		CHECK(FillTable(table));
 	
 		if(keyLen == USE_DEFAULT)
 			keyLen = table->defaultSize;
@@ -286,41 +504,21 @@ omfErr_t omfsTableAddValueBlock(
 		if((dup == kOmTableDupReplace) && omfsTableIncludesKey(table, key))
 			CHECK(omfsTableRemove(table, key));
 	
-		entry = (tableLink_t *)omOptMalloc(table->file, keyLen + valueLen + sizeof(tableLink_t) - 1);
+		entry = AllocEntry(table, keyLen + valueLen + sizeof(tableLink_t) - 1);
 		if(entry == NULL)
 			return(OM_ERR_NOMEMORY);
-		hash = _lookup(table,key);
 		entry->type = valueIsBlock;
-		entry->dup = NULL;
-		/* Add to the head of the dup list for that key */
-		
-		if(dup == kOmTableDupAddDup)
-		{
-			srch = table->hashTable[hash];
-			while(srch != NULL)
-			{
-				if(table->compare(key, srch->local))
-				{
-					entry->dup = srch;
-					break;
-				}
-				srch = srch->link;
-			}
-		}
-	
-		entry->link = table->hashTable[hash];
-		table->hashTable[hash] = entry;
-	
 		memcpy(entry->local, (char *)key, keyLen);
 		memcpy(entry->local+keyLen, (char *)value, valueLen);
-	
 		entry->data = NULL;
 		entry->keyLen = keyLen;
 		entry->valueLen = valueLen;
-		table->numItems++;
+		CHECK(AddEntry(table, key, entry));
 	}
 	XEXCEPT
 	{
+		if(entry != NULL)
+			FreeEntry(table, entry);
 		return(XCODE());
 	}
 	XEND
@@ -331,7 +529,7 @@ omfErr_t omfsTableAddValueBlock(
 /************************
  * name
  *
- * 		WhatIt(Internal)Does
+ * 		Removes the most recently added entry matching the key.
  *
  * Argument Notes:
  *		StuffNeededBeyondNotesInDefinition.
@@ -346,62 +544,42 @@ omfErr_t omfsTableRemove(
 			omTable_t *table,
 			void *key)
 {
-	omfInt32		index;
-	tableLink_t		*entry, *prevEntry = NULL;
-	char		    *tmpMem;
+	tableSlot_t		*slot;
+	tableLink_t		*entry;
 	
 	XPROTECT(NULL)
 	{
 	  XASSERT((table != NULL) && (table->cookie == TABLE_COOKIE), 
 		  OM_ERR_TABLE_BAD_HDL);
 	  XASSERT(table->compare != NULL, OM_ERR_TABLE_MISSING_COMPARE);
+	  CHECK(FillTable(table));
 	
-	  index = _lookup(table, key);	
-	  entry = table->hashTable[index];
-	
-	  /* Free ALL entries which match the key, even duplicates */
-	  while( entry != NULL)
+	  slot = FindSlot(table, key, HashKey(table, key));
+	  if(slot != NULL)
 	    {
-	      if( table->compare( key, entry->local))
-			{
-			  if( prevEntry)
-				prevEntry->link = entry->link;
-			  else
-				table->hashTable[index] = entry->link;
-		  
-			  /* Use entryDispose callback to free internal
-			   * entry data.
-			   */
-			  if (table->entryDispose != NULL)
-				{
-				  if(entry->type == valueIsPtr)
-					{
-					  (*table->entryDispose)(entry->data);
-					  if(entry->data != NULL)
-						omOptFree(table->file, entry->data);
-					}
-				  else
-					{
-					  tmpMem = (char *)omOptMalloc(table->file, entry->valueLen);
-						
-					  /* Force data alignment */
-					  memcpy(tmpMem, entry->local+
-							 entry->keyLen, entry->valueLen);
-					  (*table->entryDispose)(tmpMem);
-					  omOptFree(table->file, tmpMem);
-					}
-				}
-
-			  omOptFree(table->file, entry);
-
-			  table->numItems--;
-			  entry = NULL;
-			}
+	      entry = slot->entry;
+	      if(entry->dup != NULL)
+			slot->entry = entry->dup;
 	      else
 			{
-			  prevEntry = entry;
-			  entry = entry->link;
+			  slot->entry = SLOT_DELETED;
+			  table->slotsUsed--;
+			  table->slotsDeleted++;
 			}
+
+	      table->entries[entry->index] = NULL;
+	      while((table->numEntries > 0) && 
+			    (table->entries[table->numEntries-1] == NULL))
+			table->numEntries--;
+	  
+	      /* Use entryDispose callback to free internal
+	       * entry data.
+	       */
+	      if (table->entryDispose != NULL)
+			DisposeEntryData(table, entry);
+
+	      FreeEntry(table, entry);
+	      table->numItems--;
 	    }
 	}
 	XEXCEPT
@@ -431,30 +609,14 @@ omfBool omfsTableIncludesKey(
 			omTable_t *table,
 			void *key)
 {
-	omfInt32		n;
-	tableLink_t	*entry;
-	omfBool		result;
-	
 	if((table == NULL) || (table->cookie != TABLE_COOKIE))
 		return(FALSE);
 	if(table->compare == NULL)
 		return(FALSE);
+	if(FillTable(table) != OM_ERR_NONE)
+		return(FALSE);
 
-	result = FALSE;
-	n = _lookup(table, key);
-	entry = table->hashTable[n];
-	while(entry != NULL)
-	{
-		if (table->compare( key, entry->local))
-		{
-			result = TRUE;
-			break;
-		}
-
-		entry = entry->link;
-	}
-
-	return(result);
+	return(FindSlot(table, key, HashKey(table, key)) != NULL);
 }
 
 /************************
@@ -475,34 +637,20 @@ void *omfsTableLookupPtr(
 			omTable_t *table,
 			void *key)
 {
-	omfInt32		n;
-	tableLink_t	*entry;
-	void		*result;
+	tableSlot_t	*slot;
 	
 	if((table == NULL) || (table->cookie != TABLE_COOKIE))
 		return(NULL);
 	if(table->compare == NULL)
 		return(NULL);
+	if(FillTable(table) != OM_ERR_NONE)
+		return(NULL);
 
-	result = NULL;
-	n = _lookup(table, key);
-	entry = table->hashTable[n];
-	while(entry != NULL)
-	{
-		if (table->compare( key, entry->local))
-		{
-			if(entry->type == valueIsPtr)
-				result = entry->data;
-			else
-				return(NULL);
-			/* 	result = entry->local+entry->keyLen;	*/
-			break;
-		}
-
-		entry = entry->link;
-	}
+	slot = FindSlot(table, key, HashKey(table, key));
+	if((slot == NULL) || (slot->entry->type != valueIsPtr))
+		return(NULL);
 
-	return(result);
+	return(slot->entry->data);
 }
 
 /************************
@@ -526,8 +674,9 @@ omfErr_t omfsTableLookupBlock(
 			void *valuePtr,
 			omfBool *found)
 {
-  omfInt32		n;
+  tableSlot_t	*slot;
   tableLink_t	*entry;
+  omfErr_t		status;
 	
   if((table == NULL) || (table->cookie != TABLE_COOKIE))
     return(OM_ERR_TABLE_BAD_HDL);
@@ -535,22 +684,18 @@ omfErr_t omfsTableLookupBlock(
     return(OM_ERR_TABLE_MISSING_COMPARE);
 
   *found = FALSE;
-  n = _lookup(table, key);
-  entry = table->hashTable[n];
-  while((entry != NULL) && !(*found))
+  status = FillTable(table);
+  if(status != OM_ERR_NONE)
+    return(status);
+  slot = FindSlot(table, key, HashKey(table, key));
+  if(slot != NULL)
     {
-      if (table->compare( key, entry->local))
-	{
-	  if(entry->type == valueIsBlock)
-	    {
-	      memcpy(valuePtr, ((char *)entry->local)+entry->keyLen, valueLen);
-	      *found = TRUE;
-	    }
-	  /* 	result = entry->local+entry->keyLen;	*/
-	  break;
-	}
-
-      entry = entry->link;
+      entry = slot->entry;
+      if(entry->type == valueIsBlock)
+		{
+		  memcpy(valuePtr, ((char *)entry->local)+entry->keyLen, valueLen);
+		  *found = TRUE;
+		}
     }
 
   return(OM_ERR_NONE);
@@ -580,10 +725,13 @@ omfErr_t omfsTableFirstEntry(
       XASSERT((table != NULL) && (table->cookie == TABLE_COOKIE), 
 	      OM_ERR_TABLE_BAD_HDL);
       XASSERT(iter != NULL, OM_ERR_TABLE_BAD_ITER);
+      CHECK(FillTable(table));
       
       iter->cookie = TABLE_ITER_COOKIE;
       iter->table = table;
-      iter->curHash = -1;
+      iter->curHash = 0;
+      iter->lastSerial = 0;
+      iter->compactions = table->compactions;
       iter->nextEntry = NULL;
       iter->srch = kTableSrchAny;
       iter->srchKey = NULL;
@@ -615,16 +763,27 @@ omfErr_t omfsTableFirstEntryMatching(
 			void *key,
 			omfBool *found) 
 {
+	tableSlot_t		*slot;
+
 	XPROTECT(NULL)
 	{
 		XASSERT((table != NULL) && (table->cookie == TABLE_COOKIE), 
 				OM_ERR_TABLE_BAD_HDL);
 		XASSERT(iter != NULL, OM_ERR_TABLE_BAD_ITER);
+		CHECK(FillTable(table));
 	
 		iter->cookie = TABLE_ITER_COOKIE;
 		iter->table = table;
-		iter->curHash = _lookup(table, key);
-		iter->nextEntry = table->hashTable[iter->curHash];
+		iter->curHash = 0;
+		iter->lastSerial = 0;
+		iter->compactions = table->compactions;
+		iter->nextEntry = NULL;
+		if(table->compare != NULL)
+		{
+			slot = FindSlot(table, key, HashKey(table, key));
+			if(slot != NULL)
+				iter->nextEntry = slot->entry;
+		}
 		iter->srch = kTableSrchMatch;
 		iter->srchKey = key;
 		CHECK(omfsTableNextEntry(iter, found));
@@ -659,10 +818,13 @@ omfErr_t omfsTableFirstEntryUnique(
 		XASSERT((table != NULL) && (table->cookie == TABLE_COOKIE), 
 				OM_ERR_TABLE_BAD_HDL);
 		XASSERT(iter != NULL, OM_ERR_TABLE_BAD_ITER);
+		CHECK(FillTable(table));
 	
 		iter->cookie = TABLE_ITER_COOKIE;
 		iter->table = table;
-		iter->curHash = -1;
+		iter->curHash = 0;
+		iter->lastSerial = 0;
+		iter->compactions = table->compactions;
 		iter->nextEntry = NULL;
 		iter->srch = kTableSrchUnique;
 		iter->srchKey = NULL;
@@ -693,7 +855,7 @@ omfErr_t omfsTableNextEntry(
 			omfBool *foundPtr) 
 {
 	omTable_t		*table;
-	tableLink_t		*entry;
+	tableLink_t		*entry = NULL;
 	
 	XPROTECT(NULL)
 	{
@@ -708,48 +870,53 @@ omfErr_t omfsTableNextEntry(
 
 		if(iter->srch == kTableSrchMatch)
 		{
-			while(!*foundPtr && (iter->nextEntry != NULL))
+			/* Every entry on a dup chain matches the key */
+			if(iter->nextEntry != NULL)
 			{
 				entry = iter->nextEntry;
-				if (table->compare(iter->srchKey, entry->local))
-					*foundPtr = TRUE;
-				iter->nextEntry = entry->link;
+				*foundPtr = TRUE;
+				iter->nextEntry = entry->dup;
 			}
 		}
 		else
 		{
-			while(!*foundPtr && (iter->curHash < table->hashTableSize))
+			if(iter->compactions != table->compactions)
 			{
-				while(!*foundPtr && (iter->nextEntry != NULL))
-				{
-					entry = iter->nextEntry;
-					if (iter->srch == kTableSrchAny)
-						*foundPtr = TRUE;
-					/* NOTE: entry->dup will be != NULL for every duplicate entry EXCEPT the
-					 *			last entry, satisfying the one of each unique requirement
-					 */
-					else if((iter->srch == kTableSrchUnique) && (entry->dup == NULL))
-						*foundPtr = TRUE;
-					iter->nextEntry = entry->link;
-				}
-				if(!*foundPtr)
-				{
-					++iter->curHash;
-					if(iter->curHash < table->hashTableSize)
-						iter->nextEntry = table->hashTable[iter->curHash];
-					else
-						iter->nextEntry = NULL;
-				}
+				/* Entries only move down when compacted, so back up to
+				 * the first one not yet returned.
+				 */
+				if(iter->curHash > table->numEntries)
+					iter->curHash = table->numEntries;
+				while((iter->curHash > 0) &&
+					  ((table->entries[iter->curHash-1] == NULL) ||
+					   (table->entries[iter->curHash-1]->serial > iter->lastSerial)))
+					iter->curHash--;
+				iter->compactions = table->compactions;
+			}
+			while(!*foundPtr && (iter->curHash < table->numEntries))
+			{
+				entry = table->entries[iter->curHash++];
+				if(entry == NULL)
+					continue;
+				if (iter->srch == kTableSrchAny)
+					*foundPtr = TRUE;
+				/* NOTE: entry->dup will be != NULL for every duplicate entry EXCEPT the
+				 *			first one added, satisfying the one of each unique requirement
+				 */
+				else if((iter->srch == kTableSrchUnique) && (entry->dup == NULL))
+					*foundPtr = TRUE;
 			}
 		}
 		if(*foundPtr)
 		{
+			iter->lastSerial = entry->serial;
 			iter->valueLen = (entry->type == valueIsPtr ? sizeof(void *) : entry->valueLen);
 			if(entry->type == valueIsPtr)
 				iter->valuePtr = entry->data;
 			else
 				iter->valuePtr = entry->local + entry->keyLen;
 			iter->key = entry->local;
+			iter->keylen = entry->keyLen;
 		}
 	}
 	XEXCEPT
@@ -879,8 +1046,10 @@ omfErr_t omfsTableDispose(
 				OM_ERR_TABLE_BAD_HDL);
 		DisposeList(table, FALSE);
 	
-		if(table->hashTable != NULL)
-			omOptFree(table->file, table->hashTable);
+		if(table->slots != NULL)
+			omOptFree(table->file, table->slots);
+		if(table->entries != NULL)
+			omOptFree(table->file, table->entries);
 
 		omOptFree(table->file, table);
 	}
@@ -968,58 +1137,439 @@ static omfErr_t DisposeList(
 			omfBool itemsAlso)
 {
 	omfInt32		n;
-	tableLink_t	*entry, *entryNext;
-	char		*tmpMem;
+	tableLink_t	*entry;
+	tableSlab_t	*slab, *slabNext;
 
 	XPROTECT(NULL)
 	{
 		XASSERT((table != NULL) && (table->cookie == TABLE_COOKIE), 
 			OM_ERR_TABLE_BAD_HDL);
-		for (n = 0; n < table->hashTableSize; n++)
+		for (n = 0; n < table->numEntries; n++)
+		{
+			entry = table->entries[n];
+			if(entry == NULL)
+				continue;
+
+			/* Use entryDispose callback to free internal
+			 * entry data.
+			 */
+			if((table->entryDispose != NULL) && itemsAlso)
+				DisposeEntryData(table, entry);
+	
+			/* Slab entries all go at once below */
+			if(entry->sizeClass == TABLE_NO_CLASS)
+				omOptFree(table->file, entry);
+			table->entries[n] = NULL;
+		}
+		
+		for(slab = table->slabs; slab != NULL; slab = slabNext)
 		{
-			entry = table->hashTable[n];
-			while(entry != NULL)
+			slabNext = slab->next;
+			omOptFree(table->file, slab);
+		}
+		table->slabs = NULL;
+		table->slabPtr = NULL;
+		table->slabLeft = 0;
+		memset(table->freeEntries, 0, sizeof(table->freeEntries));
+
+		if(table->slots != NULL)
+			memset(table->slots, 0, table->numSlots * sizeof(tableSlot_t));
+		table->slotsUsed = 0;
+		table->slotsDeleted = 0;
+		table->numEntries = 0;
+		table->numItems = 0;
+	}
+	XEXCEPT
+	XEND
+	
+	return(OM_ERR_NONE);
+}
+
+/************************
+ * name
+ *
+ * 		Runs the caller's map function, and spreads the result across
+ *		all 32 bits so that masking off the low bits to pick a slot
+ *		still depends upon the whole key.
+ */
+static omfUInt32 HashKey(
+			omTable_t *table,
+			void *key)
+{
+	omfUInt32	hash;
+
+	hash = (table->map ? (omfUInt32)table->map(key) : (omfUInt32)(size_t)key);
+	hash ^= hash >> 16;
+	hash *= 0x85EBCA6B;
+	hash ^= hash >> 13;
+	hash *= 0xC2B2AE35;
+	hash ^= hash >> 16;
+	return(hash);
+}
+
+/************************
+ * name
+ *
+ * 		Returns the slot holding the key, or NULL if the key is not
+ *		in the table.
+ */
+static tableSlot_t *FindSlot(
+			omTable_t *table,
+			void *key,
+			omfUInt32 hash)
+{
+	omfUInt32	mask, n;
+	tableSlot_t	*slot;
+
+	if(table->compare == NULL)
+		return(NULL);
+
+	mask = table->numSlots - 1;
+	for(n = hash & mask; ; n = (n + 1) & mask)
+	{
+		slot = table->slots + n;
+		if(slot->entry == NULL)
+			return(NULL);
+		if((slot->entry != SLOT_DELETED) && (slot->hash == hash) &&
+		   table->compare(key, slot->entry->local))
+			return(slot);
+	}
+}
+
+/************************
+ * name
+ *
+ * 		Links a filled-in entry into the table, growing the slot array
+ *		and entry list as needed.
+ *
+ * Argument Notes:
+ *		Existing entries with the same key are kept on the dup chain of
+ *		the new entry, which becomes the one found by lookups.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		OM_ERR_NOMEMORY -- Couldn't grow the table.
+ */
+static omfErr_t AddEntry(
+			omTable_t *table,
+			void *key,
+			tableLink_t *entry)
+{
+	omfUInt32		hash, mask, n;
+	tableSlot_t		*slot, *avail;
+	tableLink_t		**newEntries;
+	omfInt32		newSize;
+
+	XPROTECT(NULL)
+	{
+		if((table->slotsUsed + table->slotsDeleted + 1) * TABLE_LOAD_DEN >
+		   table->numSlots * TABLE_LOAD_NUM)
+		{
+			/* Double if live keys are the problem, else just clear tombstones */
+			newSize = table->numSlots;
+			while((table->slotsUsed + 1) * 2 > newSize)
+				newSize <<= 1;
+			CHECK(ResizeSlots(table, newSize, FALSE));
+		}
+		
+		if((table->numEntries == table->maxEntries) &&
+		   (table->numItems < table->numEntries))
+			CompactEntries(table);
+		if(table->numEntries == table->maxEntries)
+		{
+			newSize = (table->maxEntries != 0 ? table->maxEntries * 2 : TABLE_MIN_SLOTS);
+			newEntries = (tableLink_t **)omOptMalloc(table->file, 
+										newSize * sizeof(tableLink_t *));
+			XASSERT(newEntries != NULL, OM_ERR_NOMEMORY);
+			if(table->entries != NULL)
 			{
-				entryNext = entry->link;
+				memcpy(newEntries, table->entries, 
+						table->numEntries * sizeof(tableLink_t *));
+				omOptFree(table->file, table->entries);
+			}
+			table->entries = newEntries;
+			table->maxEntries = newSize;
+		}
 
-				/* Use entryDispose callback to free internal
-				 * entry data.
-				 */
-				if((table->entryDispose != NULL) && itemsAlso)
+		hash = HashKey(table, key);
+		entry->dup = NULL;
+		slot = FindSlot(table, key, hash);
+		if(slot != NULL)
+		{
+			/* Add to the head of the dup list for that key.  Only
+			 * kOmTableDupAddDup (or replacing one of several dups)
+			 * gets here, the callers have checked the other modes.
+			 */
+			entry->dup = slot->entry;
+		}
+		else
+		{
+			mask = table->numSlots - 1;
+			avail = NULL;
+			for(n = hash & mask; avail == NULL; n = (n + 1) & mask)
+			{
+				if(table->slots[n].entry == NULL)
+					avail = table->slots + n;
+				else if((table->slots[n].entry == SLOT_DELETED))
 				{
-				  if(entry->type == valueIsPtr)
-				  {
-					(*table->entryDispose)(entry->data);
-					if(entry->data != NULL)
-					  omOptFree(table->file, entry->data);
-				  }
-				  else
-				    {
-				      tmpMem = (char *)omOptMalloc(table->file, 
-							  entry->valueLen);
-						
-				      /* Force data alignment */
-				      memcpy(tmpMem, entry->local+
-					     entry->keyLen, entry->valueLen);
-				      (*table->entryDispose)(tmpMem);
-				      omOptFree(table->file, tmpMem);
-				    }
+					avail = table->slots + n;
+					table->slotsDeleted--;
 				}
-	
-				omOptFree(table->file, entry);
-				entry = entryNext;
 			}
-			
-			table->hashTable[n] = NULL;
+			slot = avail;
+			slot->hash = hash;
+			table->slotsUsed++;
 		}
-		table->numItems = 0;
+		slot->entry = entry;
+
+		entry->index = table->numEntries;
+		entry->serial = ++table->nextSerial;
+		table->entries[table->numEntries++] = entry;
+		table->numItems++;
 	}
 	XEXCEPT
 	XEND
-	
+
+	return(OM_ERR_NONE);
+}
+
+/************************
+ * name
+ *
+ * 		Rebuilds the slot array at the given size (a power of 2), dropping
+ *		any tombstones, and squeezes the holes out of the entry list.  If
+ *		rehash is set, the stored hash values are recomputed (for a
+ *		changed map function).
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		OM_ERR_NOMEMORY -- Couldn't allocate the new slots.
+ */
+static omfErr_t ResizeSlots(
+			omTable_t *table,
+			omfInt32 newSize,
+			omfBool rehash)
+{
+	tableSlot_t		*newSlots, *oldSlots;
+	omfInt32		oldSize, n;
+	omfUInt32		mask, pos;
+
+	newSlots = (tableSlot_t *)omOptMalloc(table->file, newSize * sizeof(tableSlot_t));
+	if(newSlots == NULL)
+		return(OM_ERR_NOMEMORY);
+	memset(newSlots, 0, newSize * sizeof(tableSlot_t));
+
+	oldSlots = table->slots;
+	oldSize = table->numSlots;
+	mask = newSize - 1;
+	for(n = 0; n < oldSize; n++)
+	{
+		if((oldSlots[n].entry == NULL) || (oldSlots[n].entry == SLOT_DELETED))
+			continue;
+		if(rehash)
+			oldSlots[n].hash = HashKey(table, oldSlots[n].entry->local);
+		for(pos = oldSlots[n].hash & mask; newSlots[pos].entry != NULL; 
+			pos = (pos + 1) & mask)
+			;
+		newSlots[pos] = oldSlots[n];
+	}
+
+	if(oldSlots != NULL)
+		omOptFree(table->file, oldSlots);
+	table->slots = newSlots;
+	table->numSlots = newSize;
+	table->slotsDeleted = 0;
+	if(table->numItems < table->numEntries)
+		CompactEntries(table);
+
 	return(OM_ERR_NONE);
 }
 
+/************************
+ * name
+ *
+ * 		Closes up the holes left in the entry list by removals, keeping
+ *		the entries in insertion order.  Iterators notice the change of
+ *		table->compactions and reposition themselves by serial number.
+ */
+static void CompactEntries(
+			omTable_t *table)
+{
+	omfInt32		n, used;
+
+	for(n = 0, used = 0; n < table->numEntries; n++)
+	{
+		if(table->entries[n] == NULL)
+			continue;
+		table->entries[used] = table->entries[n];
+		table->entries[used]->index = used;
+		used++;
+	}
+	table->numEntries = used;
+	table->compactions++;
+}
+
+/************************
+ * name
+ *
+ * 		Allocates an entry of the given size.  Small entries are carved
+ *		out of slabs owned by the table, and recycled through a free
+ *		list per size class.
+ */
+static tableLink_t *AllocEntry(
+			omTable_t *table,
+			omfInt32 size)
+{
+	tableLink_t		*entry;
+	tableSlab_t		*slab;
+	omfInt16		sizeClass;
+	omfInt32		slabHdr;
+
+	size = (size + TABLE_SLAB_GRAIN - 1) & ~(TABLE_SLAB_GRAIN - 1);
+	sizeClass = (omfInt16)(size / TABLE_SLAB_GRAIN - 1);
+	if(sizeClass >= TABLE_SLAB_CLASSES)
+	{
+		entry = (tableLink_t *)omOptMalloc(table->file, size);
+		if(entry != NULL)
+			entry->sizeClass = TABLE_NO_CLASS;
+		return(entry);
+	}
+
+	entry = table->freeEntries[sizeClass];
+	if(entry != NULL)
+	{
+		table->freeEntries[sizeClass] = entry->dup;
+		return(entry);
+	}
+
+	if(table->slabLeft < size)
+	{
+		slab = (tableSlab_t *)omOptMalloc(table->file, TABLE_SLAB_SIZE);
+		if(slab == NULL)
+			return(NULL);
+		slab->next = table->slabs;
+		table->slabs = slab;
+		slabHdr = (sizeof(tableSlab_t) + TABLE_SLAB_GRAIN - 1) & ~(TABLE_SLAB_GRAIN - 1);
+		table->slabPtr = (char *)slab + slabHdr;
+		table->slabLeft = TABLE_SLAB_SIZE - slabHdr;
+	}
+	entry = (tableLink_t *)table->slabPtr;
+	table->slabPtr += size;
+	table->slabLeft -= size;
+	entry->sizeClass = sizeClass;
+
+	return(entry);
+}
+
+/************************
+ * name
+ *
+ * 		Returns an entry allocated by AllocEntry.
+ */
+static void FreeEntry(
+			omTable_t *table,
+			tableLink_t *entry)
+{
+	if(entry->sizeClass == TABLE_NO_CLASS)
+		omOptFree(table->file, entry);
+	else
+	{
+		entry->dup = table->freeEntries[entry->sizeClass];
+		table->freeEntries[entry->sizeClass] = entry;
+	}
+}
+
+/************************
+ * name
+ *
+ * 		Calls the entryDispose callback for an entry which is about to
+ *		be freed.
+ */
+static void DisposeEntryData(
+			omTable_t *table,
+			tableLink_t *entry)
+{
+	char		*tmpMem;
+
+	if(entry->type == valueIsPtr)
+	{
+		(*table->entryDispose)(entry->data);
+		if(entry->data != NULL)
+			omOptFree(table->file, entry->data);
+	}
+	else
+	{
+		tmpMem = (char *)omOptMalloc(table->file, entry->valueLen);
+		
+		/* Force data alignment */
+		memcpy(tmpMem, entry->local+entry->keyLen, entry->valueLen);
+		(*table->entryDispose)(tmpMem);
+		omOptFree(table->file, tmpMem);
+	}
+}
+
+/************************
+ * name
+ *
+ * 		Runs a pending fill proc (see omfsSetTableFill).  Calls made by
+ *		the proc itself do not run it again.  A fill which fails part way
+ *		is not retried, since the entries it added would be added twice;
+ *		its error is returned from then on instead.
+ */
+static omfErr_t FillTable(
+			omTable_t *table)
+{
+	omfErr_t		status;
+
+	if(table->filling)
+		return(OM_ERR_NONE);
+	if(table->fill == NULL)
+		return(table->fillStatus);
+
+	table->filling = TRUE;
+	status = (*table->fill)(table->file);
+	table->filling = FALSE;
+	table->fill = NULL;
+	table->fillStatus = status;
+
+	return(status);
+}
+
+/************************
+ * name
+ *
+ * 		Records the kOmTableHashSimple map function for one of the
+ *		specialized tables, which are created with the mixed one.
+ */
+static void SetSimpleMap(
+			omTable_t *table,
+			omTblMapProc simpleMap)
+{
+	table->simpleMap = simpleMap;
+}
+
+/************************
+ * name
+ *
+ * 		Folds one 32-bit word of a key into a running hash (the MurmurHash3
+ *		block step).  HashKey supplies the final avalanche.
+ */
+static omfUInt32 MixWord(
+			omfUInt32 hash,
+			omfUInt32 word)
+{
+	word *= 0xCC9E2D51;
+	word = (word << 15) | (word >> 17);
+	word *= 0x1B873593;
+	hash ^= word;
+	hash = (hash << 13) | (hash >> 19);
+	return(hash * 5 + 0xE6546B64);
+}
+
 /************************************************************************
  *
  * String Table Functions
@@ -1051,6 +1601,21 @@ static omfInt32 StrMap( void *temp1)
 	return(hashVal);
 }
 
+/* FNV-1a over the upper-cased string, so case-insensitive tables work */
+static omfInt32 StrMixMap( void *temp1)
+{
+	omfUInt32		hashVal;
+	unsigned char	*key = (unsigned char *)temp1;
+	
+	if (temp1 == NULL)
+		return(0);
+		
+	for(hashVal = 0x811C9DC5; *key != '\0'; key++)
+		hashVal = (hashVal ^ (omfUInt32)toupper(*key)) * 0x01000193;
+		
+	return((omfInt32)hashVal);
+}
+
 static omfBool cmpSensitive( void *temp1, void *temp2)
 {
 	char *a = (char *)temp1;
@@ -1097,10 +1662,15 @@ omfErr_t omfsNewStringTable(
 			omfInt32 numBuckets,
 			omTable_t **resultPtr)
 {
+	omfErr_t	status;
+
 	if(myCompare == NULL)
 		myCompare = (caseSensistive ? cmpSensitive : cmpInsensitive);
 
-	return(omfsNewTable(file, 0, StrMap, myCompare, numBuckets, resultPtr));
+	status = omfsNewTable(file, 0, StrMixMap, myCompare, numBuckets, resultPtr);
+	if(status == OM_ERR_NONE)
+		SetSimpleMap(*resultPtr, StrMap);
+	return(status);
 }	
 
 /************************
@@ -1174,6 +1744,17 @@ static omfInt32 MobMap(void *temp)
   return(key->prefix+key->major+key->minor);
 }
 
+static omfInt32 MobMixMap(void *temp)
+{
+  omfUID_t *key = (omfUID_t *)temp;
+  omfUInt32 hash;
+
+  hash = MixWord(0, (omfUInt32)key->prefix);
+  hash = MixWord(hash, key->major);
+  hash = MixWord(hash, key->minor);
+  return((omfInt32)hash);
+}
+
 static omfBool	MobCompare(void *temp1, void *temp2)
 {
   omfUID_t *key1 = (omfUID_t *)temp1;
@@ -1202,8 +1783,13 @@ omfErr_t omfsNewUIDTable(
 			 omfInt32 numBuckets,
 			 omTable_t **result)
 {
-  return(omfsNewTable(file, sizeof(omfUID_t), MobMap, MobCompare, numBuckets, 
-		      result));
+  omfErr_t	status;
+
+  status = omfsNewTable(file, sizeof(omfUID_t), MobMixMap, MobCompare, 
+			numBuckets, result);
+  if(status == OM_ERR_NONE)
+    SetSimpleMap(*result, MobMap);
+  return(status);
 }	
 
 /************************
@@ -1312,6 +1898,11 @@ static omfInt32 ClassIDMap(void *temp)
   return(key1);
 }
 
+static omfInt32 ClassIDMixMap(void *temp)
+{
+  return((omfInt32)MixWord(0, (omfUInt32)ClassIDMap(temp)));
+}
+
 static omfBool	ClassIDCompare(void *temp1, void *temp2)
 {
   omfInt16	n;
@@ -1346,8 +1937,13 @@ omfErr_t omfsNewClassIDTable(
 			omfInt32 numBuckets,
 			omTable_t **result)
 {
-  return(omfsNewTable(file, sizeof(omfClassID_t), ClassIDMap, ClassIDCompare, 
-		      numBuckets, result));
+  omfErr_t	status;
+
+  status = omfsNewTable(file, sizeof(omfClassID_t), ClassIDMixMap, 
+			ClassIDCompare, numBuckets, result);
+  if(status == OM_ERR_NONE)
+    SetSimpleMap(*result, ClassIDMap);
+  return(status);
 }	
 
 /************************
@@ -1416,6 +2012,11 @@ static omfInt32 TrackIDMap(void *temp)
   return(key1);
 }
 
+static omfInt32 TrackIDMixMap(void *temp)
+{
+  return((omfInt32)MixWord(0, *((omfUInt32 *)temp)));
+}
+
 static omfBool	TrackIDCompare(void *temp1, void *temp2)
 {
   omfInt32 key1 = *((omfInt32 *)temp1);
@@ -1443,8 +2044,13 @@ omfErr_t omfsNewTrackIDTable(
 			omfInt32 numBuckets,
 			omTable_t **result)
 {
-  return(omfsNewTable(file, sizeof(omfTrackID_t), TrackIDMap, TrackIDCompare, 
-		      numBuckets, result));
+  omfErr_t	status;
+
+  status = omfsNewTable(file, sizeof(omfTrackID_t), TrackIDMixMap, 
+			TrackIDCompare, numBuckets, result);
+  if(status == OM_ERR_NONE)
+    SetSimpleMap(*result, TrackIDMap);
+  return(status);
 }	
 
 /************************
@@ -1513,6 +2119,13 @@ static omfInt32 PropertyMap(void *temp)
   return((omfInt32)*key1);
 }
 
+static omfInt32 PropertyMixMap(void *temp)
+{
+  omfProperty_t *key1 = (omfProperty_t *)temp;
+  
+  return((omfInt32)MixWord(0, (omfUInt32)*key1));
+}
+
 static omfBool	PropertyCompare(void *temp1, void *temp2)
 {
   omfProperty_t *key1 = (omfProperty_t *)temp1;
@@ -1540,8 +2153,13 @@ omfErr_t omfsNewPropertyTable(
 			omfInt32 numBuckets,
 			omTable_t **result)
 {
-  return(omfsNewTable(file, sizeof(omfProperty_t), PropertyMap, PropertyCompare, 
-		      numBuckets, result));
+  omfErr_t	status;
+
+  status = omfsNewTable(file, sizeof(omfProperty_t), PropertyMixMap, 
+			PropertyCompare, numBuckets, result);
+  if(status == OM_ERR_NONE)
+    SetSimpleMap(*result, PropertyMap);
+  return(status);
 }	
 
 /************************
@@ -1611,6 +2229,13 @@ static omfInt32 TypeMap(void *temp)
   return((omfInt32)*key1);
 }
 
+static omfInt32 TypeMixMap(void *temp)
+{
+  omfType_t *key1 = (omfType_t *)temp;
+
+  return((omfInt32)MixWord(0, (omfUInt32)*key1));
+}
+
 static omfBool TypeCompare(void *temp1, void *temp2)
 {
   omfType_t *key1 = (omfType_t *)temp1;
@@ -1638,8 +2263,13 @@ omfErr_t omfsNewTypeTable(
 			omfInt32 numBuckets,
 			omTable_t **result)
 {
-  return(omfsNewTable(file, sizeof(omfType_t), TypeMap, TypeCompare, numBuckets, 
-		      result));
+  omfErr_t	status;
+
+  status = omfsNewTable(file, sizeof(omfType_t), TypeMixMap, TypeCompare, 
+			numBuckets, result);
+  if(status == OM_ERR_NONE)
+    SetSimpleMap(*result, TypeMap);
+  return(status);
 }	
 
 /************************
@@ -1715,7 +2345,12 @@ omfErr_t omfsNewDefTable(
 			omfInt32 numBuckets,
 			omTable_t **result)
 {
-  return(omfsNewTable(file, 0, StrMap, cmpSensitive, numBuckets, result));
+  omfErr_t	status;
+
+  status = omfsNewTable(file, 0, StrMixMap, cmpSensitive, numBuckets, result);
+  if(status == OM_ERR_NONE)
+    SetSimpleMap(*result, StrMap);
+  return(status);
 }	
 
 /************************
@@ -1787,6 +2422,8 @@ void testOmTable(void)
   omTableIterate_t	iter;
   char				name[4];
   char				*keys[4] = { "foo", "bar", "baz", "foo" };
+  omfUID_t			uid;
+  omfInt32			hist[4];
 	
   printf("OMTable Tests\n");
 
@@ -1897,8 +2534,154 @@ void testOmTable(void)
   if(strcmp(name, "foo") != 0)
     printf("Failed key test #4\n");
   
+  omfsTableDispose(test);
+  
+  /******************************/
+  printf("    Testing growth past the initial size\n");
+  omfsNewUIDTable(NULL, 4, &test);
+  uid.prefix = 42;
+  uid.major = 0x12345678;
+  for(n = 0; n < 5000; n++)
+    {
+      uid.minor = n;
+      omfsTableAddUID(test, uid, (void *)(size_t)(n+1), kOmTableDupError);
+    }
+  for(n = 0; n < 5000; n += 2)
+    {
+      uid.minor = n;
+      omfsTableRemoveUID(test, uid);
+    }
+  for(n = 0; n < 5000; n++)
+    {
+      uid.minor = n;
+      if((omfsTableUIDLookupPtr(test, uid) != NULL) != (n & 1))
+	printf("Bad lookup after grow/remove #%ld\n", n);
+    }
+  omfsTableFirstEntry(test, &iter, &found);
+  for(val = 0; found; val++)
+    omfsTableNextEntry(&iter, &found);
+  if(val != 2500)
+    printf("Iterated %ld entries after remove, expected 2500\n", val);
+  omfsTableDispose(test);
+  
+  /******************************/
+  printf("    Testing iteration across compaction\n");
+  omfsNewUIDTable(NULL, 4, &test);
+  for(n = 0; n < 1000; n++)
+    {
+      uid.minor = n;
+      omfsTableAddUID(test, uid, (void *)(size_t)(n+1), kOmTableDupError);
+    }
+  omfsTableFirstEntry(test, &iter, &found);
+  for(val = 1; found && (val < 100); val++)
+    omfsTableNextEntry(&iter, &found);
+  /* Churn until the holes are squeezed out, under the open iterator */
+  for(n = 0; n < 900; n++)
+    {
+      uid.minor = n;
+      omfsTableRemoveUID(test, uid);
+      uid.minor = n + 1000;
+      omfsTableAddUID(test, uid, (void *)(size_t)(n+1001), kOmTableDupError);
+    }
+  /* 1-900 are gone, so the iterator should pick up at 901 */
+  for(val = 901, found = TRUE; found; val++)
+    {
+      omfsTableNextEntry(&iter, &found);
+      if(found && (iter.valuePtr != (void *)(size_t)val))
+	{
+	  printf("Iterator out of place after compaction (%ld)\n", val);
+	  break;
+	}
+    }
+  if(val != 1902)
+    printf("Iterated to %ld across compaction, expected 1900\n", val-2);
+  omfsTableDispose(test);
+  
+  /******************************/
+  printf("    Testing omfsSetTableHash/omfsTableGetChainHistogram\n");
+  omfsNewUIDTable(NULL, 1024, &test);
+  for(n = 0; n < 500; n++)
+    {
+      /* Every ID has the same prefix+major+minor */
+      uid.major = 0x10000 - n;
+      uid.minor = n;
+      omfsTableAddUID(test, uid, (void *)(size_t)(n+1), kOmTableDupError);
+    }
+  omfsTableGetChainHistogram(test, 4, hist, &val);
+  if(val > 16)
+    printf("Mixed UID hash probes too long (%ld)\n", val);
+  omfsSetTableHash(test, kOmTableHashSimple);
+  omfsTableGetChainHistogram(test, 4, hist, &val);
+  if((val != 500) || (hist[0] != 1) || (hist[3] != 497))
+    printf("Simple UID hash histogram wrong (%ld)\n", val);
+  for(n = 0; n < 500; n++)
+    {
+      uid.major = 0x10000 - n;
+      uid.minor = n;
+      if(omfsTableUIDLookupPtr(test, uid) != (void *)(size_t)(n+1))
+	printf("Bad lookup after rehash #%ld\n", n);
+    }
+  omfsTableDispose(test);
+  
   printf("Finished OMTable tests\n");
 }
+
+/************************
+ * name
+ *
+ * 		Times adds, lookups and a full iteration of a UID table holding
+ *		numMobs sequential mob IDs, the pattern seen in large files.
+ *
+ * Argument Notes:
+ *		numBuckets is passed on to omfsNewUIDTable, use a small value to
+ *		see the cost of growing.
+ */
+void benchOmTable(omfInt32 numMobs, omfInt32 numBuckets)
+{
+  omTable_t			*test;
+  omfUID_t			uid;
+  omfInt32			n, misses, hist[4], longest;
+  omfBool			found;
+  omTableIterate_t	iter;
+  clock_t			start, addTime, lookupTime, iterTime;
+  
+  printf("OMTable benchmark: %ld mobs, %ld initial buckets\n", numMobs, numBuckets);
+  omfsNewUIDTable(NULL, numBuckets, &test);
+  uid.prefix = 42;
+  uid.major = 0x3A5B0C10;
+
+  start = clock();
+  for(n = 0; n < numMobs; n++)
+    {
+      uid.minor = n;
+      omfsTableAddUID(test, uid, (void *)(size_t)(n+1), kOmTableDupError);
+    }
+  addTime = clock() - start;
+
+  start = clock();
+  misses = 0;
+  for(n = 0; n < numMobs; n++)
+    {
+      uid.minor = n;
+      if(omfsTableUIDLookupPtr(test, uid) == NULL)
+	misses++;
+    }
+  lookupTime = clock() - start;
+  
+  start = clock();
+  omfsTableFirstEntry(test, &iter, &found);
+  while(found)
+    omfsTableNextEntry(&iter, &found);
+  iterTime = clock() - start;
+  omfsTableGetChainHistogram(test, 4, hist, &longest);
+  omfsTableDispose(test);
+
+  printf("    add %8.3f  lookup %8.3f  iterate %8.3f seconds (%ld misses)\n",
+	 (double)addTime / CLOCKS_PER_SEC, (double)lookupTime / CLOCKS_PER_SEC,
+	 (double)iterTime / CLOCKS_PER_SEC, misses);
+  printf("    probes 1: %ld  2: %ld  3: %ld  4+: %ld  (longest %ld)\n",
+	 hist[0], hist[1], hist[2], hist[3], longest);
+}
 #endif
 
 /* INDENT OFF */
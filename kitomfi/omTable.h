@@ -44,6 +44,12 @@ typedef enum
 	kOmTableDupAddDup
 } omTableDuplicate_t;
 
+typedef enum
+{
+	kOmTableHashMixed,		/* Default, well spread for sequential keys */
+	kOmTableHashSimple		/* Cheaper, original sum-of-fields hashes */
+} omTableHash_t;
+
 typedef enum
 {
 	kTableSrchAny,
@@ -54,6 +60,7 @@ typedef enum
 typedef omfInt32	(*omTblMapProc)( void *key);
 typedef omfBool	(*omTblCompareProc)( void *key1, void *key2);
 typedef void	(*omTblDisposeProc)(void *valuePtr);
+typedef omfErr_t	(*omTblFillProc)(omfHdl_t file);
 
 typedef struct omTable omTable_t;
 typedef struct omfTableLink tableLink_t;
@@ -63,6 +70,8 @@ typedef struct
 	omfInt32				cookie;		/* Private */
 	omTable_t			*table;		/* Private */
 	omfInt32				curHash;	/* Private */
+	omfUInt32			lastSerial;	/* Private */
+	omfUInt32			compactions;	/* Private */
 	tableLink_t			*nextEntry;	/* Private */
 	omTableSearch_t		srch;		/* Private */
 	void				*srchKey;	/* Private */
@@ -96,6 +105,23 @@ omfErr_t omfsSetTableDispose(
 			omTable_t *table,
 			omTblDisposeProc proc);
 			
+omfErr_t omfsSetTableHash(
+			omTable_t *table,
+			omTableHash_t hash);
+			
+omfErr_t omfsSetTableFill(
+			omTable_t *table,
+			omTblFillProc proc);
+			
+omfErr_t omfsTableFill(
+			omTable_t *table);
+			
+OMF_EXPORT omfErr_t omfsTableGetChainHistogram(
+			omTable_t *table,
+			omfInt32 numBins,
+			omfInt32 *histogram,
+			omfInt32 *maxProbes);
+			
 omfErr_t omfsTableAddValuePtr(
 			omTable_t *table,
 			void *key,
@@ -346,6 +372,7 @@ void *omfsTableDefLookup(
 
 #ifdef OMFI_SELF_TEST
 void testOmTable(void);
+void benchOmTable(omfInt32 numMobs, omfInt32 numBuckets);
 #endif
 
 #if PORT_LANG_CPLUSPLUS
@@ -803,6 +803,8 @@ omfErr_t omfsNewClass(
 	{
 		def.type = type;
 		def.revs = revs;
+		def.clsd = NULL;
+		def.index = session->nextClassIndex;
 		strncpy(def.aClass, aClass, 4);
 		strncpy(def.itsSuperClass, itsSuperclass, 4);
 		if((revs == kOmfTstRev1x) || (revs == kOmfTstRevEither))
@@ -813,6 +815,8 @@ omfErr_t omfsNewClass(
 		{
 			CHECK(omfsTableAddClassID(session->classDefs2X, aClass, &def, sizeof(def)));
 		}
+		session->nextClassIndex++;
+		session->classAncestryValid = FALSE;
 	}
 	XEXCEPT
 	{
@@ -855,6 +859,7 @@ omfErr_t omfsRegisterType(
 	char           *header = TYPE_HDR_BENTO;
 	omfHdl_t			file;
 	CMType			bentoID;
+	OMTypeCache		typeCache;
 	
 	session->BentoErrorNumber = 0;
 	session->BentoErrorRaised = FALSE;
@@ -881,9 +886,11 @@ omfErr_t omfsRegisterType(
 		 */
 		for(file = session->topFile; file != NULL; file = file->prevFile)
 		{
-			bentoID = CvtTypeToBento(file, aType, NULL);
-			CHECK(omfsTableAddType(file->types, aType, &bentoID,
-									sizeof(bentoID)));
+			typeCache.bentoID = CvtTypeToBento(file, aType, &typeCache.swab);
+			CHECK(omfsTableAddType(file->types, aType, &typeCache,
+									sizeof(typeCache)));
+			CHECK(ompvtCacheTypeID(file, aType, typeCache.bentoID, typeCache.swab));
+			bentoID = typeCache.bentoID;
 			CHECK(omfsTableAddValueBlock(file->typeReverse, &bentoID,
 									sizeof(bentoID), &aType,
 									sizeof(aType), kOmTableDupReplace)); /* !!!Needed by Parallax */
@@ -1012,6 +1019,7 @@ omfErr_t omfsRegisterProp(
 			bentoID = CvtPropertyToBento(file, aProp);
 			CHECK(omfsTableAddProperty(file->properties, aProp, &bentoID,
 									sizeof(bentoID), kOmTableDupError));
+			CHECK(ompvtCachePropertyID(file, aProp, bentoID));
 			CHECK(omfsTableAddValueBlock(file->propReverse, &bentoID, sizeof(bentoID), &aProp,
 									sizeof(aProp), kOmTableDupError));
 		}
@@ -1663,7 +1671,7 @@ omfErr_t OMReadProp(
 	CMValue         val;
 	CMProperty      cprop;
 	CMType          ctype;
-	omfBool         swab;
+	CMSize32        bytesRead;
 	omfPosition_t	endOffset;
 	omfLength_t		objectSize;
 #if OMFI_ENABLE_SEMCHECK
@@ -1696,46 +1704,43 @@ omfErr_t OMReadProp(
 		}
 #endif
 
-		if (CMCountValues((CMObject) obj, cprop, ctype))
+		/* A type whose swab setting doesn't match is an error, but a missing
+		 * property takes precedence.
+		 */
+		if (existingSwabType != swabType)
 		{
-			XASSERT(existingSwabType == swabType, OM_ERR_BAD_TYPE);
-			if ((dataSize > 1) && (swabType == kSwabIfNeeded))
-			{
-				swab = ompvtIsForeignByteOrder(file, obj);
-			}
-			else
-				swab = FALSE;
-	
-			val = CMUseValue((CMObject) obj, cprop, ctype);
-	
-			if (file->BentoErrorRaised)
-				RAISE(OM_ERR_BENTO_PROBLEM);
-	
-			/* if(offset+dataSize > (omfInt32)CMGetValueSize(val))		 */
-	
-			objectSize = CMGetValueSize(val);
-			if (omfsInt64Greater(offset, objectSize))	/* If completely off of the end, read nothing */
-				RAISE(OM_ERR_END_OF_DATA);
-	
-			(void) CMReadValueData(val, (CMPtr) data, offset, dataSize);
-			if (swab)
-			{
-				if (dataSize == sizeof(omfInt16))
-					omfsFixShort((omfInt16 *) data);
-				else if (dataSize == sizeof(omfInt32))
-					omfsFixLong((omfInt32 *) data);
-				else if (dataSize == sizeof(omfInt64))
-					omfsFixLong64((omfInt64 *) data);
-				else
-					RAISE(OM_ERR_SWAB);
-			}
+			if (CMCountValues((CMObject) obj, cprop, ctype))
+				RAISE(OM_ERR_BAD_TYPE);
+			RAISE(OM_ERR_PROP_NOT_PRESENT);
+		}
 
-			endOffset = offset;
-			omfsAddInt32toInt64(dataSize, &endOffset);
-			if (omfsInt64Greater(endOffset, objectSize))		/* If partly off of the end, read & return error */
-				RAISE(OM_ERR_END_OF_DATA);
-		} else
+		/* Find, size, and read the value with a single Bento lookup */
+		val = cmReadPropertyValue((CMObject) obj, cprop, ctype, (CMPtr) data,
+										offset, dataSize, &objectSize, &bytesRead);
+		if (file->BentoErrorRaised)
+			RAISE(OM_ERR_BENTO_PROBLEM);
+		if (val == NULL)
 			RAISE(OM_ERR_PROP_NOT_PRESENT);
+		if (omfsInt64Greater(offset, objectSize))	/* If completely off of the end, nothing was read */
+			RAISE(OM_ERR_END_OF_DATA);
+
+		if ((dataSize > 1) && (swabType == kSwabIfNeeded) &&
+			ompvtIsForeignByteOrder(file, obj))
+		{
+			if (dataSize == sizeof(omfInt16))
+				omfsFixShort((omfInt16 *) data);
+			else if (dataSize == sizeof(omfInt32))
+				omfsFixLong((omfInt32 *) data);
+			else if (dataSize == sizeof(omfInt64))
+				omfsFixLong64((omfInt64 *) data);
+			else
+				RAISE(OM_ERR_SWAB);
+		}
+
+		endOffset = offset;
+		omfsAddInt32toInt64(dataSize, &endOffset);
+		if (omfsInt64Greater(endOffset, objectSize))		/* If partly off of the end, read & return error */
+			RAISE(OM_ERR_END_OF_DATA);
 	
 		if (file->BentoErrorRaised)
 			RAISE(OM_ERR_BENTO_PROBLEM);
@@ -1871,6 +1876,9 @@ omfErr_t OMWriteProp(
 	omfAssert((cprop != NULL), file, OM_ERR_BAD_PROP);
 	omfAssert((ctype != NULL), file, OM_ERR_BAD_TYPE);
 
+	file->editCount++;
+	if (ompvtIsMobIndexProp(prop))
+		file->mobEditCount++;
 	XPROTECT(file)
 	{
 #if OMFI_ENABLE_SEMCHECK
@@ -2160,7 +2168,6 @@ omfErr_t omfsGetArrayLength(
 			omfInt32			dataSize,	/* IN -- with entries of this size */
 			omfInt32			*length)		/* OUT - return the number of elements */
 {
-	omfBool         Swab;
 	CMProperty      cprop;
 	CMType          ctype;
 	CMValue         val;
@@ -2182,18 +2189,13 @@ omfErr_t omfsGetArrayLength(
 
 	XPROTECT(file)
 	{
-		if (CMCountValues((CMObject) obj, cprop, ctype))
+		val = cmReadPropertyValue((CMObject) obj, cprop, ctype, NULL, zero, 0,
+										&siz, &siz32);
+		if (file->BentoErrorRaised)
+			RAISE(OM_ERR_BENTO_PROBLEM);
+		if (val != NULL)
 		{
-			Swab = ompvtIsForeignByteOrder(file, obj);
-			val = CMUseValue((CMObject) obj, cprop, ctype);
-	
-			if (file->BentoErrorRaised)
-				RAISE(OM_ERR_BENTO_PROBLEM);
-	
-			siz = CMGetValueSize(val);
 			CHECK(omfsTruncInt64toUInt32(siz, &siz32)); /* OK FRAMEOFFSET */
-			if (file->BentoErrorRaised)
-				RAISE(OM_ERR_BENTO_PROBLEM);
 			if(siz32 < sizeof(omfInt16))
 				*length = 0;
 			else
@@ -2259,6 +2261,9 @@ omfErr_t OMPutNthPropHdr(
 	omfAssert((cprop != NULL), file, OM_ERR_BAD_PROP);
 	omfAssert((ctype != NULL), file, OM_ERR_BAD_TYPE);
 
+	file->editCount++;
+	if (ompvtIsMobIndexProp(prop))
+		file->mobEditCount++;
 	XPROTECT(file)
 	{
 		omfsCvtInt32toInt64(0, outOffset);
@@ -2348,7 +2353,6 @@ omfErr_t OMGetNthPropHdr(
 {
 	omfInt32        NElements;
 	CMCount         Offset;
-	CMValue         val;
 	CMProperty      cprop;
 	CMType          ctype;
 
@@ -2366,8 +2370,6 @@ omfErr_t OMGetNthPropHdr(
 		omfsCvtInt32toInt64(0, outOffset);
 		if (CMCountValues((CMObject) obj, cprop, ctype))
 		{
-			val = CMUseValue((CMObject) obj, cprop, ctype);
-		
 			CHECK(omfsGetArrayLength(file, obj, prop, dataType, dataSize, &NElements));
 		
 			if (index > NElements)
@@ -2386,6 +2388,112 @@ omfErr_t OMGetNthPropHdr(
 	return (OM_ERR_NONE);
 }
 
+/************************
+ * Function: omfsReadArrayBlock
+ *
+ * 	Read a run of consecutive elements from an arrayed OMFI object
+ *		with a single Bento read, instead of one OMGetNthPropHdr/OMReadProp
+ *		pair per element.  Used when loading large arrays (ie: frame
+ *		indexes) at media open time.
+ *
+ * Argument Notes:
+ *		dataType - The type of the property (ie: OMPosition32Array), as
+ *						opposed to the type of the data within.
+ *		dataSize - The size of an individual element in the array.  Must
+ *						be 2, 4, or 8 if the data is to be swabbed.
+ *		first - 1-based index of the first element to read.
+ *		count - Number of elements to read.  Elements first through
+ *						(first+count-1) must all exist.
+ *		swabType - kSwabIfNeeded swabs each element when the object was
+ *						written in the foreign byte order.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ *		OM_ERR_BADINDEX - Range is out of bounds.
+ *		OM_ERR_PROP_NOT_PRESENT - The property is missing.
+ *		OM_ERR_SWAB -- Unable to byte swap the given data type.
+ */
+omfErr_t omfsReadArrayBlock(
+			omfHdl_t			file,			/* IN -- For this omf file */
+			omfObject_t		obj,			/* IN -- in this object */
+			omfProperty_t	prop,			/* IN -- and this property */
+			omfType_t		dataType,	/* IN -- of this data type */
+			omfInt32			dataSize,	/* IN -- with entries of this size */
+			omfInt32			first,		/* IN -- starting at this element */
+			omfInt32			count,		/* IN -- read this many elements */
+			omfSwabCheck_t	swabType,	/* IN -- Swab the data (optional) */
+			void				*data)		/* OUT - into this buffer */
+{
+	CMValue         val;
+	CMProperty      cprop;
+	CMType          ctype;
+	CMCount         offset;
+	CMSize32        bytes;
+	omfInt32        numElements, n;
+	omfBool         swab;
+	char            *elem;
+
+	clearBentoErrors(file);
+	omfAssertValidFHdl(file);
+	omfAssertIsOMFI(file);
+	omfAssert((obj != NULL), file, OM_ERR_NULLOBJECT);
+	omfAssert((data != NULL), file, OM_ERR_BADDATAADDRESS);
+
+	cprop = CvtPropertyToBento(file, prop);
+	ctype = CvtTypeToBento(file, dataType, NULL);
+	omfAssert((cprop != NULL), file, OM_ERR_BAD_PROP);
+	omfAssert((ctype != NULL), file, OM_ERR_BAD_TYPE);
+
+	XPROTECT(file)
+	{
+		if (!CMCountValues((CMObject) obj, cprop, ctype))
+			RAISE(OM_ERR_PROP_NOT_PRESENT);
+
+		CHECK(omfsGetArrayLength(file, obj, prop, dataType, dataSize, &numElements));
+		if ((first < 1) || (count < 0) || (first - 1 + count > numElements))
+			RAISE(OM_ERR_BADINDEX);
+
+		if (count != 0)
+		{
+			swab = (swabType == kSwabIfNeeded) && ompvtIsForeignByteOrder(file, obj);
+			if (swab && (dataSize != sizeof(omfInt16)) &&
+				(dataSize != sizeof(omfInt32)) && (dataSize != sizeof(omfInt64)))
+				RAISE(OM_ERR_SWAB);
+
+			val = CMUseValue((CMObject) obj, cprop, ctype);
+			if (file->BentoErrorRaised)
+				RAISE(OM_ERR_BENTO_PROBLEM);
+
+			omfsCvtInt32toInt64(2 + ((first - 1) * dataSize), &offset);
+			bytes = (CMSize32)count * dataSize;
+			if (CMReadValueData(val, (CMPtr) data, offset, bytes) != bytes)
+				RAISE(OM_ERR_END_OF_DATA);
+			if (file->BentoErrorRaised)
+				RAISE(OM_ERR_BENTO_PROBLEM);
+
+			if (swab)
+			{
+				for (n = 0, elem = (char *) data; n < count; n++, elem += dataSize)
+				{
+					if (dataSize == sizeof(omfInt16))
+						omfsFixShort((omfInt16 *) elem);
+					else if (dataSize == sizeof(omfInt32))
+						omfsFixLong((omfInt32 *) elem);
+					else
+						omfsFixLong64((omfInt64 *) elem);
+				}
+			}
+		}
+	}
+	XEXCEPT
+	XEND
+
+	return (OM_ERR_NONE);
+}
+
 
 /************************
  * Function: OMReadBaseProp
@@ -2486,12 +2594,16 @@ omfErr_t OMLengthProp(
 	CMValue         val;
 	CMProperty      cprop;
 	CMType          ctype;
+	CMSize          siz;
+	CMSize32        bytesRead;
+	omfInt64		zero;
 
 	clearBentoErrors(file);
 	omfAssertValidFHdl(file);
 	omfAssertIsOMFI(file);
 	omfAssert((length != NULL), file, OM_ERR_BADDATAADDRESS);
 	omfsCvtInt32toInt64(defaultVal, length);
+	omfsCvtInt32toInt64(0, &zero);
 
 	omfAssertIsOMFI(file);
 	omfAssert((obj != NULL), file, OM_ERR_NULLOBJECT);
@@ -2512,17 +2624,13 @@ omfErr_t OMLengthProp(
 		}
 #endif
 
-		if (CMCountValues((CMObject) obj, cprop, ctype))
-		{
-			val = CMUseValue((CMObject) obj, cprop, ctype);
-			if (file->BentoErrorRaised)
-				RAISE(OM_ERR_BENTO_PROBLEM);
-	
-			*length = CMGetValueSize(val);
-			if (file->BentoErrorRaised)
-				RAISE(OM_ERR_BENTO_PROBLEM);
-		} else
+		val = cmReadPropertyValue((CMObject) obj, cprop, ctype, NULL, zero, 0,
+										&siz, &bytesRead);
+		if (file->BentoErrorRaised)
+			RAISE(OM_ERR_BENTO_PROBLEM);
+		if (val == NULL)
 			RAISE(OM_ERR_PROP_NOT_PRESENT);
+		*length = siz;
 	}
 	XEXCEPT
 	XEND
@@ -2573,6 +2681,9 @@ omfErr_t OMRemovePropData(
 	omfAssert((cprop != NULL), file, OM_ERR_BAD_PROP);
 	omfAssert((ctype != NULL), file, OM_ERR_BAD_TYPE);
 
+	file->editCount++;
+	if (ompvtIsMobIndexProp(prop))
+		file->mobEditCount++;
 	XPROTECT(file)
 	{
 #if OMFI_ENABLE_SEMCHECK
@@ -2779,6 +2890,9 @@ omfErr_t OMRemoveNthArrayProp(
 	omfAssert((cprop != NULL), file, OM_ERR_BAD_PROP);
 	omfAssert((ctype != NULL), file, OM_ERR_BAD_TYPE);
 
+	file->editCount++;
+	if (ompvtIsMobIndexProp(prop))
+		file->mobEditCount++;
 	XPROTECT(file)
 	{
 		if (CMCountValues((CMObject) obj, cprop, ctype))
@@ -3114,6 +3228,159 @@ omfInt32 omfsGetBentoID(
 	return (((TOCObjectPtr) obj)->objectID);
 }
 
+/* Property and type codes are allocated densely from zero (see OMLASTPROP,
+ * OMLASTTYPE, and the dynamic ID counters in the session), so the per-file
+ * caches are plain arrays.  Codes past this limit are still found through
+ * the hashed tables.
+ */
+#define MAX_DIRECT_CACHE_ID		65536
+#define DIRECT_CACHE_SLACK		64
+
+/************************
+ * Function: GrowIDCache		(INTERNAL)
+ *
+ * 	Make sure that a direct-indexed ID cache has a slot for the given
+ *		ID, reallocating it if needed.  New slots are zero-filled, which
+ *		marks them as "not cached".
+ *
+ * Argument Notes:
+ *		entrySize - Size of an individual cache entry.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		OM_ERR_NOMEMORY -- Couldn't grow the cache.
+ */
+static omfErr_t GrowIDCache(
+			omfHdl_t	file,			/* IN -- For this omf file */
+			void		**cache,		/* IN/OUT -- Grow this cache */
+			omfInt32	*cacheSize,	/* IN/OUT -- of this many entries */
+			omfInt32	entrySize,	/* IN -- of this size each */
+			omfInt32	id)			/* IN -- to hold this ID */
+{
+	omfInt32	newSize;
+	char		*newCache;
+
+	if(id < *cacheSize)
+		return(OM_ERR_NONE);
+	newSize = id + DIRECT_CACHE_SLACK;
+	newCache = (char *)omOptMalloc(file, (size_t)newSize * entrySize);
+	if(newCache == NULL)
+		return(OM_ERR_NOMEMORY);
+	memset(newCache, 0, (size_t)newSize * entrySize);
+	if(*cache != NULL)
+	{
+		memcpy(newCache, *cache, (size_t)*cacheSize * entrySize);
+		omOptFree(file, *cache);
+	}
+	*cache = newCache;
+	*cacheSize = newSize;
+
+	return(OM_ERR_NONE);
+}
+
+/************************
+ * Function: ompvtCachePropertyID		(INTERNAL)
+ *
+ * 	Record the Bento property for a property code in the file's
+ *		direct-indexed property cache.
+ *
+ * Argument Notes:
+ *		Codes outside of the range of the direct cache are ignored.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		OM_ERR_NOMEMORY -- Couldn't grow the cache.
+ */
+omfErr_t ompvtCachePropertyID(
+			omfHdl_t 		file,		/* IN -- For this omf file */
+			omfProperty_t	prop,		/* IN -- cache this property */
+			CMProperty		bentoID)	/* IN -- as this Bento property */
+{
+	void		*cache;
+	omfErr_t	status;
+
+	if(((omfInt32)prop < 0) || ((omfInt32)prop >= MAX_DIRECT_CACHE_ID))
+		return(OM_ERR_NONE);
+	cache = file->propCache;
+	status = GrowIDCache(file, &cache, &file->propCacheSize,
+								sizeof(CMProperty), (omfInt32)prop);
+	file->propCache = (CMProperty *)cache;
+	if(status != OM_ERR_NONE)
+		return(status);
+	file->propCache[prop] = bentoID;
+
+	return(OM_ERR_NONE);
+}
+
+/************************
+ * Function: ompvtCacheTypeID		(INTERNAL)
+ *
+ * 	Record the Bento type and swab setting for a type code in the file's
+ *		direct-indexed type cache.
+ *
+ * Argument Notes:
+ *		Codes outside of the range of the direct cache are ignored.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		OM_ERR_NOMEMORY -- Couldn't grow the cache.
+ */
+omfErr_t ompvtCacheTypeID(
+			omfHdl_t 		file,		/* IN -- For this omf file */
+			omfType_t		type,		/* IN -- cache this type */
+			CMType			bentoID,	/* IN -- as this Bento type */
+			omfSwabCheck_t	swab)		/* IN -- with this swab setting */
+{
+	void		*cache;
+	omfErr_t	status;
+
+	if(((omfInt32)type < 0) || ((omfInt32)type >= MAX_DIRECT_CACHE_ID))
+		return(OM_ERR_NONE);
+	cache = file->typeCache;
+	status = GrowIDCache(file, &cache, &file->typeCacheSize,
+								sizeof(OMTypeCache), (omfInt32)type);
+	file->typeCache = (OMTypeCache *)cache;
+	if(status != OM_ERR_NONE)
+		return(status);
+	file->typeCache[type].bentoID = bentoID;
+	file->typeCache[type].swab = swab;
+
+	return(OM_ERR_NONE);
+}
+
+/************************
+ * Function: ompvtDisposeIDCaches		(INTERNAL)
+ *
+ * 	Free the direct-indexed property and type caches of a file.
+ *
+ * Argument Notes:
+ *		<none>.
+ *
+ * ReturnValue:
+ *		<none>.
+ *
+ * Possible Errors:
+ *		<none>.
+ */
+void ompvtDisposeIDCaches(
+			omfHdl_t 		file)		/* IN -- For this omf file */
+{
+	if(file->propCache != NULL)
+		omOptFree(file, file->propCache);
+	if(file->typeCache != NULL)
+		omOptFree(file, file->typeCache);
+	file->propCache = NULL;
+	file->propCacheSize = 0;
+	file->typeCache = NULL;
+	file->typeCacheSize = 0;
+}
+
 /************************
  * Function: CvtPropertyToBento		(INTERNAL)
  *
@@ -3144,17 +3411,14 @@ CMProperty CvtPropertyToBento(
 		return (NULL);
 	if (file->fmt != kOmfiMedia)
 		return (NULL);
+	if(((omfUInt32)prop < (omfUInt32)file->propCacheSize) &&
+		(file->propCache[prop] != NULL))
+		return(file->propCache[prop]);
 
 	XPROTECT(file)
 	{
 		if(file->properties != NULL)
 		{
-			/* These two properties account for a large percentage of total lookups */
-			if(prop == OMObjID)
-				return(file->objTagProp1x);
-			if(prop == OMOOBJObjClass)
-				return(file->objClassProp2x);
-				
 			CHECK(omfsTablePropertyLookup(file->properties, prop, sizeof(cacheResult), &cacheResult, &found));
 			if(found)
 				return (cacheResult);
@@ -3224,23 +3488,17 @@ CMType CvtTypeToBento(
 		return (NULL);
 	if(swab == NULL)
 	  swab = &local;
+	if(((omfUInt32)type < (omfUInt32)file->typeCacheSize) &&
+		(file->typeCache[type].bentoID != NULL))
+	{
+		*swab = file->typeCache[type].swab;
+		return(file->typeCache[type].bentoID);
+	}
 
 	XPROTECT(file)
 	{
 		if(file->types != NULL)
 		{
-			/* These two types account for a large percentage of total lookups */
-			if(type == OMObjectTag)
-			{
-				*swab = kNeverSwab;
-				return(file->objTagType1x);
-			}
-			if(type == OMClassID)
-			{
-				*swab = kNeverSwab;
-				return(file->objClassType2x);
-			}
-			
 			(void)omfsTableTypeLookup(file->types, type, sizeof(cacheResult), &cacheResult, &found);
 			if(found)
 			{
@@ -3455,6 +3713,7 @@ omfErr_t omfsInit(
 	if (!InitCalled)
 	{
 		omfsErrorInit();
+		stdCodecInitColorTables();
 	}
 	InitCalled = TRUE;
 
@@ -3498,12 +3757,140 @@ omfErr_t clearBentoErrors(
 	return (OM_ERR_NONE);
 }
 
+/* An object's class index is cached in its Bento refCon as index + 1, so
+ * that a NULL refCon means the class has not been resolved yet.
+ */
+#define ClassIndexToRefCon(index)	((CMRefCon)(size_t)((index) + 1))
+#define RefConToClassIndex(refCon)	((omfInt32)(size_t)(refCon) - 1)
+
+#define AncestryRow(ancestry, words, index)	((ancestry) + ((index) * (words)))
+#define AncestryHasBit(row, index) \
+	(((row)[(index) >> 5] & ((omfUInt32)1 << ((index) & 31))) != 0)
+
+/************************
+ * Function: BuildAncestryTable	(INTERNAL)
+ *
+ * 	Build the ancestry bitsets for the classes in one class definition
+ *		table.  The row for each class has the bit for the class itself
+ *		and for every superclass reachable through the table set.
+ *
+ * Argument Notes:
+ *		The row for a class index not in the table is left clear.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		OM_ERR_NOMEMORY -- not enough free memory to hold the bitsets.
+ */
+static omfErr_t BuildAncestryTable(
+			omfSessionHdl_t	session,		/* IN - For this session */
+			omTable_t			*table,		/* IN - Walk this class table */
+			omfUInt32			**ancestryPtr)	/* OUT - and return the bitsets here */
+{
+	omTableIterate_t	iter;
+	OMClassDef			*def, superDef;
+	omfClassID_t		superclassID;
+	omfUInt32			*ancestry, *row;
+	omfInt32				words, depth, index, rows;
+	omfBool				more, found;
+	
+	*ancestryPtr = NULL;
+	words = session->classAncestryWords;
+	rows = (session->nextClassIndex > 0 ? session->nextClassIndex : 1);
+	
+	XPROTECT(NULL)
+	{
+		ancestry = (omfUInt32 *)omOptMalloc(NULL, rows * words * sizeof(omfUInt32));
+		XASSERT(ancestry != NULL, OM_ERR_NOMEMORY);
+		memset(ancestry, 0, rows * words * sizeof(omfUInt32));
+		*ancestryPtr = ancestry;
+		
+		CHECK(omfsTableFirstEntry(table, &iter, &more));
+		while(more)
+		{
+			def = (OMClassDef *)iter.valuePtr;
+			row = AncestryRow(ancestry, words, def->index);
+			index = def->index;
+			strncpy(superclassID, def->itsSuperClass, 4);
+			
+			/* The depth limit guards against a cycle in a bad dictionary */
+			for(depth = 0; depth < session->nextClassIndex; depth++)
+			{
+				row[index >> 5] |= (omfUInt32)1 << (index & 31);
+				CHECK(omfsTableClassIDLookup(table, superclassID,
+								sizeof(superDef), &superDef, &found));
+				if(!found)
+					break;
+				index = superDef.index;
+				strncpy(superclassID, superDef.itsSuperClass, 4);
+			}
+			CHECK(omfsTableNextEntry(&iter, &more));
+		}
+	}
+	XEXCEPT
+	XEND
+	
+	return (OM_ERR_NONE);
+}
+
+/************************
+ * Function: omfsBuildClassAncestry
+ *
+ * 	(Re)build the per-class ancestry bitsets used by omfsIsTypeOf()
+ *		from the session class definition tables.  Called after a file's
+ *		class dictionary has been merged into the tables, and on demand
+ *		when classes have been added since the last build.
+ *
+ * Argument Notes:
+ *		<none>.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		OM_ERR_NOMEMORY -- not enough free memory to hold the bitsets.
+ */
+omfErr_t omfsBuildClassAncestry(
+			omfSessionHdl_t	session)		/* IN - For this session */
+{
+	XPROTECT(NULL)
+	{
+		if(session->classAncestry1X != NULL)
+			omOptFree(NULL, session->classAncestry1X);
+		if(session->classAncestry2X != NULL)
+			omOptFree(NULL, session->classAncestry2X);
+		session->classAncestry1X = NULL;
+		session->classAncestry2X = NULL;
+		session->classAncestryValid = FALSE;
+		session->classAncestryWords = (session->nextClassIndex + 31) / 32;
+		if(session->classAncestryWords == 0)
+			session->classAncestryWords = 1;
+			
+		CHECK(BuildAncestryTable(session, session->classDefs1X,
+										 &session->classAncestry1X));
+		CHECK(BuildAncestryTable(session, session->classDefs2X,
+										 &session->classAncestry2X));
+		session->classAncestryValid = TRUE;
+	}
+	XEXCEPT
+	XEND
+	
+	return (OM_ERR_NONE);
+}
+
 /************************
  * Function: omfsIsTypeOf	
  *
  * 	Test if an object is a member of the given class, or a member
  *		of one of its subclasses.
  *
+ *		When both the object's class and the given class are in the
+ *		session class tables, this is a test of one bit in the ancestry
+ *		bitset of the object's class.  The object's class index is
+ *		cached in its Bento refCon the first time it is resolved, so
+ *		the class ID property is only read once per object.
+ *
  * Argument Notes:
  *		This routine returns error status through a parameter.  The
  *		variable errRtn may be NULL, but error status will be lost.
@@ -3526,6 +3913,12 @@ omfBool omfsIsTypeOf(
 	omfBool         found;
 	omfErr_t        status;
 	omfProperty_t		idProp;
+	omfSessionHdl_t	session;
+	omTable_t			*table;
+	omfUInt32			*ancestry;
+	OMClassDef			classDef, objDef;
+	CMRefCon				refCon;
+	omfInt32				objIndex;
 	
 	if (errRtn == NULL)
 		errRtn = &status;
@@ -3534,10 +3927,51 @@ omfBool omfsIsTypeOf(
 
 	XPROTECT(file)
 	{
+		session = file->session;
 		if ((file->setrev == kOmfRev1x) || (file->setrev == kOmfRevIMA))
+		{
 			idProp = OMObjID;
+			table = session->classDefs1X;
+		}
 		else
+		{
 			idProp = OMOOBJObjClass;
+			table = session->classDefs2X;
+		}
+
+		if(!session->classAncestryValid)
+		{
+			CHECK(omfsBuildClassAncestry(session));
+		}
+		if (table == session->classDefs1X)
+			ancestry = session->classAncestry1X;
+		else
+			ancestry = session->classAncestry2X;
+
+		/* A class which is not in the table can still match the object's
+		 * class ID exactly, so it is left to the superclass walk below.
+		 */
+		CHECK(omfsTableClassIDLookup(table, aClass, sizeof(classDef), 
+											  &classDef, &found));
+		if (found)
+		{
+			refCon = CMGetObjectRefCon((CMObject)anObject);
+			if (refCon != NULL)
+				objIndex = RefConToClassIndex(refCon);
+			else
+			{
+				CHECK(omfsReadClassID(file, anObject, idProp, thisObjID));
+				CHECK(omfsTableClassIDLookup(table, thisObjID, sizeof(objDef), 
+													  &objDef, &found));
+				if (!found)
+					return (FALSE);
+				objIndex = objDef.index;
+				CMSetObjectRefCon((CMObject)anObject, ClassIndexToRefCon(objIndex));
+			}
+			
+			return (AncestryHasBit(AncestryRow(ancestry, 
+								session->classAncestryWords, objIndex), classDef.index));
+		}
 
 		CHECK(omfsReadClassID(file, anObject, idProp, thisObjID));
 		thisIDPtr = thisObjID;
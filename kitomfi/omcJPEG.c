@@ -92,6 +92,7 @@ typedef struct
 	omfInt16				bitsPerPixelAvg;
 	omfInt32				memBytesPerSample;
 	omfInt16				padBits;				/* pad Bits per PIXEL */
+	codecScratch_t		scratch;			/* Reused across reads & writes */
 }               userDataJPEG_t;
 
 static omfErr_t codecSetJPEGTables(omfCodecParms_t * info, omfHdl_t main, userDataJPEG_t * pdata);
@@ -131,6 +132,9 @@ omfErr_t omfsAppendFrameIndex(omfHdl_t file, omcJPEGPersistent_t *pers,
 								omfObject_t obj, omfPosition_t data);
 
 omfInt32 omfsLengthFrameIndex( omfHdl_t file, omcJPEGPersistent_t *pers, omfObject_t obj);
+
+omfErr_t omfsReadFrameIndex(omfHdl_t file, omcJPEGPersistent_t *pers,
+								omfObject_t obj, omfPosition_t *data, omfInt32 maxLen);
 static omfErr_t omfmJPEGGetMaxSampleSize(omfCodecParms_t * info,
 					                 omfMediaHdl_t media,
 					                 omfHdl_t main,
@@ -602,17 +606,12 @@ static omfErr_t codecWriteSamplesJPEG(omfCodecParms_t * info,
 
 				if((omfUInt32)xlateBytesPerSample > src.buflen)
 				{
-					tempBuf = (char *)omOptMalloc(main, xlateBytesPerSample);
-					if(tempBuf == NULL)
-						RAISE(OM_ERR_NOMEMORY);
+					CHECK(codecGetScratchBuffer(main, &pdata->scratch, xlateBytesPerSample, &tempBuf));
 					dest.buf = tempBuf;
 					dest.buflen = xlateBytesPerSample;
 				}
 				else
-				{
 					dest.buf = src.buf;
-					tempBuf = NULL;
-				}
 				
 				compressParms.pixelBuffer = (char *)dest.buf;
 				compressParms.pixelBufferIndex = 0;
@@ -629,11 +628,6 @@ static omfErr_t codecWriteSamplesJPEG(omfCodecParms_t * info,
 					CHECK(omfmJFIFCompressSample(&compressParms, pdata->customTables, &fieldLen));
 					xfer->bytesXfered += fieldLen;
 				}
-				if(tempBuf != NULL)
-				{
-					omOptFree(main, tempBuf);
-					tempBuf = NULL;
-				}
 				xfer->samplesXfered++;
 				/* Don't forget to update the global frame counter */
 				CHECK(omfsAddInt32toInt64(1, &media->channels[0].numSamples));
@@ -668,6 +662,323 @@ static omfErr_t codecWriteSamplesJPEG(omfCodecParms_t * info,
 	return (OM_ERR_NONE);
 }
 
+/************************
+ * Parallel frame decoding
+ *
+ * 	omfmReadDataSamplesParallel() asks for several frames at once.  The
+ *		compressed frames are contiguous in the stream, so they are read
+ *		with a single omcReadStream() on the calling thread, and then each
+ *		frame is decoded from memory by omfmJFIFDecompressSample(), which
+ *		keeps all of its state in the call.  On Unix the frames are shared
+ *		out to a pool of POSIX threads; elsewhere they are decoded in order
+ *		on the calling thread.  Swabbing into the caller's buffer is done
+ *		afterwards on the calling thread, since it uses the media stream.
+ */
+#if PORT_SYS_UNIX && !defined(OMFI_NO_THREADS)
+#define USE_DECODE_THREADS	1
+#else
+#define USE_DECODE_THREADS	0
+#endif
+
+#if USE_DECODE_THREADS
+#include <pthread.h>
+#endif
+
+#define MAX_DECODE_WORKERS	16
+
+typedef struct
+{
+	JPEG_MediaParms_t	parms;
+	omfBool				separateFields;
+	omfErr_t			status;
+}				jpegDecodeJob_t;
+
+typedef struct
+{
+	jpegDecodeJob_t		*jobs;
+	omfUInt32			numJobs;
+	omfUInt32			nextJob;
+#if USE_DECODE_THREADS
+	pthread_mutex_t		lock;
+#endif
+}				jpegDecodeBatch_t;
+
+/************************
+ * decodeBufferedFrame	(INTERNAL)
+ *
+ * 	Decodes one frame which has been read into memory.  If the frame
+ *		is stored as separate fields, the second field starts after the
+ *		restart marker following the first.
+ *
+ * Argument Notes:
+ *		Called from worker threads, so must not touch the media or file.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		OM_ERR_DECOMPRESS -- The JPEG data is bad.
+ */
+static omfErr_t decodeBufferedFrame(jpegDecodeJob_t *job)
+{
+	JPEG_MediaParms_t	*parms = &job->parms;
+	omfUInt32			pos;
+	omfUInt8			data;
+
+	if (omfmJFIFDecompressSample(parms) != OM_ERR_NONE)
+		return (OM_ERR_DECOMPRESS);
+
+	if (job->separateFields)
+	{
+		/*
+		 * look for a restart marker separating the
+		 * two fields
+		 */
+		if (parms->compressedIndex < 2)
+			return (OM_ERR_DECOMPRESS);
+		pos = parms->compressedIndex - 2;
+		data = (omfUInt8)parms->compressedBuffer[pos++];
+		while (data == 0xFF && pos < parms->compressedLength)
+			data = (omfUInt8)parms->compressedBuffer[pos++];
+		if ((0xD0 <= data && data <= 0xD7) || (data == 0xD9))	/* skip restart marker */
+			parms->compressedIndex = pos;
+
+		if (omfmJFIFDecompressSample(parms) != OM_ERR_NONE)
+			return (OM_ERR_DECOMPRESS);
+	}
+
+	return (OM_ERR_NONE);
+}
+
+/************************
+ * decodeWorker	(INTERNAL)
+ *
+ * 	Takes frames from the batch until there are none left.  Run by each
+ *		pool thread, and by the calling thread.
+ *
+ * Argument Notes:
+ *		arg -- The jpegDecodeBatch_t.
+ *
+ * ReturnValue:
+ *		NULL.  The status of each frame is left in its job.
+ *
+ * Possible Errors:
+ *		none.
+ */
+static void *decodeWorker(void *arg)
+{
+	jpegDecodeBatch_t	*batch = (jpegDecodeBatch_t *)arg;
+	omfUInt32			n;
+
+	for (;;)
+	{
+#if USE_DECODE_THREADS
+		pthread_mutex_lock(&batch->lock);
+#endif
+		n = batch->nextJob;
+		if (n < batch->numJobs)
+			batch->nextJob++;
+#if USE_DECODE_THREADS
+		pthread_mutex_unlock(&batch->lock);
+#endif
+		if (n >= batch->numJobs)
+			break;
+
+		batch->jobs[n].status = decodeBufferedFrame(&batch->jobs[n]);
+	}
+
+	return (NULL);
+}
+
+/************************
+ * decodeBatch	(INTERNAL)
+ *
+ * 	Decodes every frame in the batch, using up to numWorkers threads
+ *		counting the caller.  If a thread cannot be started, the threads
+ *		which did start (and the caller) do its share.
+ *
+ * Argument Notes:
+ *		<none>.
+ *
+ * ReturnValue:
+ *		<none>.  The status of each frame is left in its job.
+ *
+ * Possible Errors:
+ *		none.
+ */
+static void decodeBatch(jpegDecodeBatch_t *batch, omfInt32 numWorkers)
+{
+#if USE_DECODE_THREADS
+	pthread_t	threads[MAX_DECODE_WORKERS];
+	omfInt32	n, numThreads = 0;
+
+	if (numWorkers > MAX_DECODE_WORKERS)
+		numWorkers = MAX_DECODE_WORKERS;
+	if ((omfUInt32)numWorkers > batch->numJobs)
+		numWorkers = batch->numJobs;
+
+	pthread_mutex_init(&batch->lock, NULL);
+	for (n = 1; n < numWorkers; n++)
+	{
+		if (pthread_create(&threads[numThreads], NULL, decodeWorker, batch) != 0)
+			break;
+		numThreads++;
+	}
+	decodeWorker(batch);
+	for (n = 0; n < numThreads; n++)
+		pthread_join(threads[n], NULL);
+	pthread_mutex_destroy(&batch->lock);
+#else
+	decodeWorker(batch);
+#endif
+}
+
+/************************
+ * codecReadSamplesParallelJPEG	(INTERNAL)
+ *
+ * 	Reads xfer->numSamples consecutive compressed frames in one pass,
+ *		decodes them on up to numWorkers threads, and swabs them into the
+ *		caller's buffer.  Gives the same results as decoding the frames
+ *		one at a time in codecReadSamplesJPEG.
+ *
+ * Argument Notes:
+ *		The caller has checked that all of the frames are in the index.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ *		OM_ERR_SMALLBUF -- The buffer can't hold all of the frames.
+ *		OM_ERR_NOMEMORY -- The batch is too big for one scratch buffer.
+ *		OM_ERR_DECOMPRESS -- A frame could not be decoded.  Frames before
+ *			it have been transferred.
+ */
+static omfErr_t codecReadSamplesParallelJPEG(omfMediaHdl_t	media,
+										omfHdl_t			main,
+										userDataJPEG_t		*pdata,
+										omfmMultiXfer_t		*xfer,
+										omfInt32			numWorkers)
+{
+	jpegDecodeBatch_t	batch;
+	jpegDecodeJob_t		*job;
+	char				*scratch, *compBuf, *pixelBuf = NULL;
+	omfUInt32			n, spanBytes, rBytes, frameStart, frameEnd;
+	omfUInt32			totalBytes, compOffset, pixelOffset;
+	omfInt32			decompBytesPerSample;
+	omfLength_t			nBytes;
+	omfCStrmSwab_t		src, dest;
+	omfPosition_t		*index;
+
+	batch.jobs = NULL;
+	batch.numJobs = xfer->numSamples;
+	batch.nextJob = 0;
+	
+	XPROTECT(main)
+	{
+		if(((omfUInt32)pdata->memBytesPerSample * xfer->numSamples) > xfer->buflen)
+			RAISE(OM_ERR_SMALLBUF);
+
+		if(media->pvt->pixType == kOmfPixRGBA)
+			decompBytesPerSample = 	(omfInt32)pdata->imageWidth *
+								(omfInt32) pdata->imageLength *
+								(omfInt32) 3 * 	/*!!!*/
+								(pdata->fileLayout == kSeparateFields ? 2 : 1);
+		else
+			decompBytesPerSample = pdata->fileBytesPerSample;
+
+		/* The frames are back to back, so read them all at once */
+		index = pdata->frameIndex + pdata->currentIndex;
+		nBytes = index[xfer->numSamples];
+		CHECK(omfsSubInt64fromInt64(index[0], &nBytes));
+		CHECK(omfsTruncInt64toUInt32(nBytes, &spanBytes));	/* OK MAXREAD */
+
+		/* Jobs, compressed data & pixels all come from the scratch buffer,
+		 * with each piece rounded up to keep the next one aligned.
+		 */
+		totalBytes = 0;
+		CHECK(codecAddScratchSize(&totalBytes, batch.numJobs, sizeof(jpegDecodeJob_t)));
+		compOffset = totalBytes;
+		CHECK(codecAddScratchSize(&totalBytes, 1, spanBytes));
+		pixelOffset = totalBytes;
+		if(decompBytesPerSample > pdata->memBytesPerSample)
+			CHECK(codecAddScratchSize(&totalBytes, batch.numJobs, decompBytesPerSample));
+		CHECK(codecGetScratchBuffer(main, &pdata->scratch, totalBytes, &scratch));
+		batch.jobs = (jpegDecodeJob_t *)scratch;
+		compBuf = scratch + compOffset;
+		if(totalBytes != pixelOffset)
+			pixelBuf = scratch + pixelOffset;
+
+		CHECK(omcSeekStreamTo(media->stream, index[0]));
+		CHECK(omcReadStream(media->stream, spanBytes, compBuf, &rBytes));
+		if(rBytes != spanBytes)
+			RAISE(OM_ERR_END_OF_DATA);
+
+		frameStart = 0;
+		for(n = 0; n < batch.numJobs; n++)
+		{
+			job = &batch.jobs[n];
+			nBytes = index[n + 1];
+			CHECK(omfsSubInt64fromInt64(index[0], &nBytes));
+			CHECK(omfsTruncInt64toUInt32(nBytes, &frameEnd));
+			if(frameEnd < frameStart || frameEnd > spanBytes)
+				RAISE(OM_ERR_BADFRAMEOFFSET);
+
+			memset(&job->parms, 0, sizeof(job->parms));
+			job->parms.media = media;
+			job->parms.blackLevel = pdata->blackLevel;
+			job->parms.whiteLevel = pdata->whiteLevel;
+			job->parms.colorRange = pdata->colorRange;
+			job->parms.compressedBuffer = compBuf + frameStart;
+			job->parms.compressedLength = frameEnd - frameStart;
+			job->parms.compressedIndex = 0;
+			if(pixelBuf != NULL)
+				job->parms.pixelBuffer = pixelBuf + (n * decompBytesPerSample);
+			else
+				job->parms.pixelBuffer = (char *)xfer->buffer + (n * pdata->memBytesPerSample);
+			job->parms.pixelBufferIndex = 0;
+			job->parms.pixelBufferLength = decompBytesPerSample;
+			job->separateFields = (pdata->fileLayout == kSeparateFields);
+			job->status = OM_ERR_NONE;
+			frameStart = frameEnd;
+		}
+
+		decodeBatch(&batch, numWorkers);
+
+		/* Hand back the frames in order, up to the first bad one */
+		for(n = 0; n < batch.numJobs; n++)
+		{
+			job = &batch.jobs[n];
+			pdata->currentIndex++;
+			if(job->status != OM_ERR_NONE)
+				RAISE(job->status);
+
+			/* copyout JPEGTableID assuming it was set */
+			pdata->jpeg.JPEGTableID = job->parms.JPEGTableID;
+
+			src.fmt = media->stream->fileFormat;
+			src.buf = job->parms.pixelBuffer;
+			src.buflen = decompBytesPerSample;
+			dest.fmt = media->stream->memFormat;
+			dest.buf = (char *)xfer->buffer + (n * pdata->memBytesPerSample);
+			dest.buflen = pdata->memBytesPerSample;
+			CHECK(omcSwabData(media->stream, &src, &dest, media->stream->swapBytes));
+			xfer->bytesXfered += pdata->memBytesPerSample;
+			xfer->samplesXfered++;
+		}
+
+		/* A batch buffer is much larger than a single frame needs */
+		codecFreeScratchBuffer(main, &pdata->scratch);
+	}
+	XEXCEPT
+	{
+		codecFreeScratchBuffer(main, &pdata->scratch);
+	}
+	XEND
+
+	return (OM_ERR_NONE);
+}
+
 /************************
  * name
  *
@@ -732,6 +1043,16 @@ static omfErr_t codecReadSamplesJPEG(omfCodecParms_t * info,
 		{
 			omfInt32           compressOkay;
 
+			if (info->spc.mediaXfer.numWorkers > 1 && xfer->numSamples > 1 &&
+				pdata->frameIndex != NULL &&
+				(pdata->currentIndex + xfer->numSamples) <
+					(omfUInt32)omfsLengthFrameIndex(main, pers, media->dataObj))
+			{
+				CHECK(codecReadSamplesParallelJPEG(media, main, pdata, xfer,
+											info->spc.mediaXfer.numWorkers));
+				return (OM_ERR_NONE);
+			}
+
 			compressParms.blackLevel = pdata->blackLevel;
 			compressParms.whiteLevel = pdata->whiteLevel;
 			compressParms.colorRange = pdata->colorRange;
@@ -769,9 +1090,7 @@ static omfErr_t codecReadSamplesJPEG(omfCodecParms_t * info,
 					decompBytesPerSample = pdata->fileBytesPerSample;
 				if(decompBytesPerSample > pdata->memBytesPerSample)
 				{
-					tempBuf = (char *)omOptMalloc(main, decompBytesPerSample);
-					if(tempBuf == NULL)
-						RAISE(OM_ERR_NOMEMORY);
+					CHECK(codecGetScratchBuffer(main, &pdata->scratch, decompBytesPerSample, &tempBuf));
 					src.buf = tempBuf;
 					src.buflen = decompBytesPerSample;
 					compressParms.pixelBuffer = (char *)tempBuf;
@@ -824,11 +1143,6 @@ static omfErr_t codecReadSamplesJPEG(omfCodecParms_t * info,
 				}
 				
 				CHECK(omcSwabData(media->stream, &src, &dest, media->stream->swapBytes));
-				if(tempBuf != NULL)
-				{
-					omOptFree(main, tempBuf);
-					tempBuf = NULL;
-				}
 				xfer->bytesXfered += pdata->memBytesPerSample;
 				xfer->samplesXfered++;
 			}
@@ -863,10 +1177,6 @@ static omfErr_t codecReadSamplesJPEG(omfCodecParms_t * info,
 		}
 	}
 	XEXCEPT
-	{
-		if(tempBuf != NULL)
-			omOptFree(main, tempBuf);
-	}
 	XEND
 
 	return (OM_ERR_NONE);
@@ -1039,8 +1349,7 @@ static omfErr_t loadDescriptorData(omfCodecParms_t * info,
 	omfUInt32 				layout = 0;
 	omfUInt32 				bytesPerPixel = 0;
 	omfUInt32 				numFields = 0;
-	omfUInt32				indexSize, n;
-	omfPosition_t			indexVal;
+	omfUInt32				indexSize;
 	omcJPEGPersistent_t *pers = NULL;
 	omfPosition_t			zeroPos;
 	omfErr_t					status;
@@ -1240,12 +1549,8 @@ static omfErr_t loadDescriptorData(omfCodecParms_t * info,
 			RAISE(OM_ERR_NOMEMORY);
 
 		pdata->maxIndex = indexSize;
-		for(n = 1; n <= indexSize; n++)
-		{
-			CHECK(omfsGetNthFrameIndex(media->dataFile, pers, media->dataObj,
-											&indexVal, n));
-			pdata->frameIndex[n-1] = indexVal;
-		}
+		CHECK(omfsReadFrameIndex(media->dataFile, pers, media->dataObj,
+										pdata->frameIndex, indexSize));
 	}
 	XEXCEPT
 	XEND
@@ -1747,6 +2052,7 @@ static omfErr_t codecCloseJPEG(omfCodecParms_t *info,
 		
 	  	if(pdata->frameIndex != NULL)
 			omOptFree(main, pdata->frameIndex);
+		codecFreeScratchBuffer(main, &pdata->scratch);
 		omOptFree(main, media->userData);
 	}
 	XEXCEPT
@@ -2004,9 +2310,12 @@ static omfErr_t initUserData(userDataJPEG_t *pdata)
 	pdata->memBytesPerSample = 0;
 	pdata->padBits = 0;
 	pdata->memBitsPerPixel = 0;
+	pdata->scratch.buf = NULL;
+	pdata->scratch.len = 0;
 		
 	return(OM_ERR_NONE);
 }
+
 /************************
  * name
  *
@@ -2310,7 +2619,7 @@ omfErr_t omfsGetNthFrameIndex(
 		}
 		else
 		{
-			CHECK(OMGetNthPropHdr(file, obj, pers->omJPEGFrameIndexExt, i,
+			CHECK(OMGetNthPropHdr(file, obj, pers->omJPEGFrameIndexExt, i - baseIndexLen,
 										OMPosition64Array, sizeof(omfInt64), &offset));
 			CHECK(OMReadProp(file, obj, pers->omJPEGFrameIndexExt, offset,
 										kSwabIfNeeded, OMPosition64Array, sizeof(omfInt64),
@@ -2405,6 +2714,68 @@ omfInt32 omfsLengthFrameIndex(
 	return (length1+length2);
 }
 
+/************************
+ * omfsReadFrameIndex
+ *
+ * 	Load the entire frame index (the 32-bit entries followed by any
+ *		64-bit extension entries) with one read per property, instead
+ *		of one omfsGetNthFrameIndex call per frame.
+ *
+ * Argument Notes:
+ *		maxLen - The number of entries which will fit in data.  Must be
+ *			at least omfsLengthFrameIndex().
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ *		OM_ERR_BADINDEX - The index will not fit in maxLen entries.
+ */
+omfErr_t omfsReadFrameIndex(
+			omfHdl_t			file,		/* IN - From this file */
+			omcJPEGPersistent_t *pers,
+			omfObject_t		obj,		/* IN - and this object */
+			omfPosition_t	*data,	/* OUT - Read the index into here */
+			omfInt32			maxLen)	/* IN - which holds this many entries */
+{
+	omfInt32			baseIndexLen, extIndexLen, n;
+	omfUInt32		*base32;
+	
+	XPROTECT(file)
+	{
+		CHECK(omfsGetArrayLength(file, obj, pers->omJPEGFrameIndex,
+										OMPosition32Array, sizeof(omfUInt32), &baseIndexLen));
+		CHECK(omfsGetArrayLength(file, obj, pers->omJPEGFrameIndexExt,
+										OMPosition64Array, sizeof(omfInt64), &extIndexLen));
+		XASSERT(baseIndexLen + extIndexLen <= maxLen, OM_ERR_BADINDEX);
+
+		if(baseIndexLen != 0)
+		{
+			/* Read the 32-bit entries packed into the front of the buffer,
+			 * then widen them in place, working backwards so that no entry
+			 * is overwritten before it has been converted.
+			 */
+			base32 = (omfUInt32 *)data;
+			CHECK(omfsReadArrayBlock(file, obj, pers->omJPEGFrameIndex,
+									OMPosition32Array, sizeof(omfUInt32), 1, baseIndexLen,
+									kSwabIfNeeded, base32));
+			for(n = baseIndexLen-1; n >= 0; n--)
+				CHECK(omfsCvtUInt32toInt64(base32[n], &data[n]));
+		}
+		if(extIndexLen != 0)
+		{
+			CHECK(omfsReadArrayBlock(file, obj, pers->omJPEGFrameIndexExt,
+									OMPosition64Array, sizeof(omfInt64), 1, extIndexLen,
+									kSwabIfNeeded, data + baseIndexLen));
+		}
+	}
+	XEXCEPT
+	XEND
+
+	return (OM_ERR_NONE);
+}
+
 /************************
  * name
  *
@@ -55,6 +55,86 @@
 #define DEFAULT_SWAB_SIZE		(64L*1024L)
 #define DEFAULT_STREAMBUF_SIZE	(64L*1024L)
 
+/*
+ * Read-ahead and write-behind move the stream I/O onto a background
+ * thread, using extra buffers the size of the stream cache (which
+ * omcStrm.h turns on for these builds).  Only streams on raw (non-OMFI)
+ * files use them, since Bento containers are shared by the whole file
+ * and may not be touched from two threads.
+ */
+#if PORT_SYS_UNIX && !defined(OMFI_NO_THREADS)
+#define USE_STREAM_THREAD	1
+#else
+#define USE_STREAM_THREAD	0
+#endif
+
+#if USE_STREAM_THREAD
+#include <pthread.h>
+
+typedef enum
+{
+	kAsyncEmpty, kAsyncReadQueued, kAsyncReading, kAsyncReadDone,
+	kAsyncWriteQueued, kAsyncWriting
+} asyncSlotState_t;
+
+typedef struct
+{
+	char				*buf;
+	omfPosition_t		startOffset;	/* Reads only */
+	omfUInt32			length;			/* Bytes to read or write */
+	omfUInt32			bytesRead;		/* Bytes actually read */
+	omfUInt32			sequence;		/* Writes go out in this order */
+	omfErr_t			status;
+	asyncSlotState_t	state;
+} asyncSlot_t;
+
+struct omfStreamAsyncIO
+{
+	omfInt32			readSlots;		/* Slots to keep filled ahead (0 = off) */
+	omfInt32			writeSlots;		/* Slots to queue writes in (0 = off) */
+	omfInt32			numSlots;
+	omfUInt32			slotSize;
+	asyncSlot_t			*slots;
+	omfUInt32			nextSequence;
+	omfInt32			writesQueued;	/* Queued or being written */
+	omfErr_t			writeStatus;	/* First failed write, until reported */
+	omfBool				shutdown;
+	pthread_t			thread;
+	pthread_mutex_t		lock;			/* Guards everything above */
+	pthread_cond_t		changed;		/* Signalled when a slot changes */
+};
+
+/*
+ * Serializes calls to the stream funcs on one raw file while any of its
+ * streams has a stream I/O thread.  The threads go through the raw file's
+ * Bento handler, whose read cache and cache counters are also used by
+ * the caller's thread, and by the other streams on the same file.  Hung
+ * off the raw file's handle when its first thread starts, and freed when
+ * the file is closed.
+ */
+struct omfStreamIOLock
+{
+	pthread_mutex_t		lock;
+	omfInt32			asyncStreams;	/* Streams with a stream I/O thread */
+};
+
+static omfErr_t startAsyncIO(omfCodecStream_t *stream, omfInt32 readSlots,
+								omfInt32 writeSlots);
+static omfErr_t stopAsyncIO(omfCodecStream_t *stream);
+static omfErr_t configureAsyncIO(omfCodecStream_t *stream, omfInt32 readSlots,
+								omfInt32 writeSlots);
+static void cancelReadAhead(omfCodecStream_t *stream);
+static omfUInt32 fillFromReadAhead(omfCodecStream_t *stream, omfUInt32 want);
+static void scheduleReadAhead(omfCodecStream_t *stream, omfLength_t streamLen);
+static omfErr_t queueWriteBehind(omfCodecStream_t *stream);
+static omfErr_t takeWriteStatus(omfCodecStream_t *stream);
+static void lockStreamIO(omfCodecStream_t *stream);
+static void unlockStreamIO(omfCodecStream_t *stream);
+#else
+#define lockStreamIO(stream)
+#define unlockStreamIO(stream)
+#endif
+
 /*#define PERFORMANCE_TEST		1	*/
 
 /************************
@@ -236,6 +316,9 @@ omfErr_t omfmSetStreamCacheSize(
 			omfUInt32			cacheSize)		/* make the cache this big */
 {
 	omfCodecStream_t *stream;
+#if USE_STREAM_THREAD
+	omfInt32		readSlots = 0, writeSlots = 0;
+#endif
 	
 	omfAssertMediaHdl(media);
 	omfAssert(cacheSize >= 0, media->mainFile, OM_ERR_INVALID_CACHE_SIZE);
@@ -246,8 +329,21 @@ omfErr_t omfmSetStreamCacheSize(
 	{
 		if((stream->cachePtr == NULL) || (cacheSize != stream->cachePhysSize))
 		{
+#if USE_STREAM_THREAD
+			if(stream->asyncIO != NULL)
+			{
+				readSlots = stream->asyncIO->readSlots;
+				writeSlots = stream->asyncIO->writeSlots;
+				CHECK(stopAsyncIO(stream));
+			}
+#endif
 			if(stream->cachePtr != NULL)
+			{
+				/* Write out or drop what the old buffer holds */
+				if(stream->cookie == STREAM_COOKIE)
+					CHECK(omcFlushCache(stream));
 				omOptFree(media->mainFile, stream->cachePtr);
+			}
 			
 			stream->cachePtr = (char *)omOptMalloc(media->mainFile, cacheSize);
 			if(stream->cachePtr != NULL)
@@ -257,6 +353,9 @@ omfErr_t omfmSetStreamCacheSize(
 				stream->cachePhysSize = 0;
 				RAISE(OM_ERR_NOMEMORY);
 			}
+#if USE_STREAM_THREAD
+			CHECK(configureAsyncIO(stream, readSlots, writeSlots));
+#endif
 		}
 	}
 	XEXCEPT
@@ -266,12 +365,117 @@ omfErr_t omfmSetStreamCacheSize(
 	return(OM_ERR_NONE);
 }
 
+/************************
+ * omfmSetStreamReadAhead
+ *
+ * 		Keeps extra stream cache buffers filled ahead of the current
+ *		read position, so that sequential reads (ie: playback) find
+ *		their data already in memory.  The buffers are filled by a
+ *		background thread while the codec works on the current one.
+ *
+ *		Each buffer is the size set by omfmSetStreamCacheSize().  The
+ *		read-ahead is only done for media in raw (non-OMFI) files, and
+ *		only in Unix builds without OMFI_NO_THREADS.  Otherwise, the
+ *		call does nothing, returns OM_ERR_NONE, and the stream
+ *		keeps its single cache buffer.
+ *
+ * Argument Notes:
+ *		numBuffers is the total number of cache buffers, including the
+ *		one being read from.  Zero or one turns read-ahead off.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ *		OM_ERR_INVALID_CACHE_SIZE -- numBuffers must be >= 0.
+ *		OM_ERR_NOMEMORY -- Could not allocate the buffers.
+ */
+omfErr_t omfmSetStreamReadAhead(
+			omfMediaHdl_t	media,			/* on this media reference */
+			omfInt32			numBuffers)		/* cache buffers to keep filled */
+{
+	omfCodecStream_t *stream;
+	
+	omfAssertMediaHdl(media);
+	omfAssert(numBuffers >= 0, media->mainFile, OM_ERR_INVALID_CACHE_SIZE);
+	stream = media->stream;
+	omfAssert((stream->cookie == STREAM_COOKIE), media->mainFile, OM_ERR_STREAM_CLOSED);
+	
+#if USE_STREAM_THREAD
+	XPROTECT(media->mainFile)
+	{
+		CHECK(configureAsyncIO(stream, (numBuffers > 1 ? numBuffers - 1 : 0),
+					(stream->asyncIO != NULL ? stream->asyncIO->writeSlots : 0)));
+	}
+	XEXCEPT
+	XEND
+#endif
+
+	return(OM_ERR_NONE);
+}
+
+/************************
+ * omfmSetStreamWriteBehind
+ *
+ * 		Hands full stream cache buffers to a background thread to be
+ *		written, so that the caller (ie: a capture loop) can go on
+ *		filling the next buffer instead of waiting on the disk.  Writes
+ *		only block when all of the buffers are waiting to be written.
+ *
+ *		A failed background write is returned by the next write, seek
+ *		or close on the stream.  Writes queued behind it are dropped.
+ *
+ *		Each buffer is the size set by omfmSetStreamCacheSize().  The
+ *		write-behind is only done for media in raw (non-OMFI) files, and
+ *		only in Unix builds without OMFI_NO_THREADS.  Otherwise, the
+ *		call does nothing, returns OM_ERR_NONE, and the cache
+ *		is written synchronously as before.
+ *
+ * Argument Notes:
+ *		numBuffers is the total number of cache buffers, including the
+ *		one being written into.  Zero or one turns write-behind off.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ *		OM_ERR_INVALID_CACHE_SIZE -- numBuffers must be >= 0.
+ *		OM_ERR_NOMEMORY -- Could not allocate the buffers.
+ */
+omfErr_t omfmSetStreamWriteBehind(
+			omfMediaHdl_t	media,			/* on this media reference */
+			omfInt32			numBuffers)		/* cache buffers to queue */
+{
+	omfCodecStream_t *stream;
+	
+	omfAssertMediaHdl(media);
+	omfAssert(numBuffers >= 0, media->mainFile, OM_ERR_INVALID_CACHE_SIZE);
+	stream = media->stream;
+	omfAssert((stream->cookie == STREAM_COOKIE), media->mainFile, OM_ERR_STREAM_CLOSED);
+	
+#if USE_STREAM_THREAD
+	XPROTECT(media->mainFile)
+	{
+		CHECK(configureAsyncIO(stream,
+					(stream->asyncIO != NULL ? stream->asyncIO->readSlots : 0),
+					(numBuffers > 1 ? numBuffers - 1 : 0)));
+	}
+	XEXCEPT
+	XEND
+#endif
+
+	return(OM_ERR_NONE);
+}
+
 #if OMFI_ENABLE_STREAM_CACHE
 /************************
  * omcFlushCache
  *
  * 		Invalidates the cached data after a read, or writes the cache
- *		to secondary storage and invalidates after a write.
+ *		to secondary storage and invalidates after a write.  With
+ *		write-behind on, the write is queued instead.
  *
  * Argument Notes:
  *		<none>.
@@ -286,6 +490,7 @@ omfErr_t omfmSetStreamCacheSize(
 omfErr_t		omcFlushCache(omfCodecStream_t *stream)
 {
 	omfHdl_t	main;
+	omfErr_t	status;
 	
 	main = stream->mainFile;
 	omfAssert((stream->cookie == STREAM_COOKIE), main, OM_ERR_STREAM_CLOSED);
@@ -295,8 +500,20 @@ omfErr_t		omcFlushCache(omfCodecStream_t *stream)
 		if(stream->direction == omcCacheWrite)
 		{
 			XASSERT(stream->funcs.writeFunc != NULL, OM_ERR_NULL_STREAMPROC);
-			CHECK((*stream->funcs.writeFunc) (stream, stream->cacheLogicalSize,
-															stream->cachePtr));
+#if USE_STREAM_THREAD
+			if((stream->asyncIO != NULL) && (stream->asyncIO->writeSlots != 0))
+			{
+				CHECK(queueWriteBehind(stream));
+			}
+			else
+#endif
+			{
+				lockStreamIO(stream);
+				status = (*stream->funcs.writeFunc) (stream, stream->cacheLogicalSize,
+															stream->cachePtr);
+				unlockStreamIO(stream);
+				CHECK(status);
+			}
 		}
 		omfsCvtInt32toInt64(0, &stream->cacheStartOffset);
 		stream->cacheLogicalSize = 0;
@@ -308,6 +525,584 @@ omfErr_t		omcFlushCache(omfCodecStream_t *stream)
 }
 #endif
 
+#if USE_STREAM_THREAD
+/************************
+ * asyncIOWorker
+ *
+ * 		Body of the stream I/O thread.  Queued writes go out first, in
+ *		the order they were queued, then queued reads, lowest offset
+ *		first.  Runs until told to shut down.
+ */
+static void *asyncIOWorker(void *arg)
+{
+	omfCodecStream_t			*stream = (omfCodecStream_t *)arg;
+	struct omfStreamAsyncIO		*aio = stream->asyncIO;
+	struct omfStreamIOLock		*ioLock = stream->dataFile->streamIOLock;
+	asyncSlot_t					*slot, *write, *read;
+	omfInt32					n;
+	omfBool						skip;
+	omfErr_t					status;
+
+	pthread_mutex_lock(&aio->lock);
+	for(;;)
+	{
+		write = NULL;
+		read = NULL;
+		for(n = 0; n < aio->numSlots; n++)
+		{
+			slot = &aio->slots[n];
+			if((slot->state == kAsyncWriteQueued) &&
+			   ((write == NULL) || (slot->sequence < write->sequence)))
+				write = slot;
+			else if((slot->state == kAsyncReadQueued) &&
+			   ((read == NULL) || omfsInt64Less(slot->startOffset, read->startOffset)))
+				read = slot;
+		}
+		
+		if(write != NULL)
+		{
+			write->state = kAsyncWriting;
+			skip = (aio->writeStatus != OM_ERR_NONE);
+			pthread_mutex_unlock(&aio->lock);
+
+			status = OM_ERR_NONE;
+			if(!skip)
+			{
+				pthread_mutex_lock(&ioLock->lock);
+				status = (*stream->funcs.writeFunc) (stream, write->length, write->buf);
+				pthread_mutex_unlock(&ioLock->lock);
+			}
+
+			pthread_mutex_lock(&aio->lock);
+			if((status != OM_ERR_NONE) && (aio->writeStatus == OM_ERR_NONE))
+				aio->writeStatus = status;
+			write->state = kAsyncEmpty;
+			aio->writesQueued--;
+			pthread_cond_broadcast(&aio->changed);
+		}
+		else if(read != NULL)
+		{
+			read->state = kAsyncReading;
+			read->bytesRead = 0;
+			pthread_mutex_unlock(&aio->lock);
+
+			pthread_mutex_lock(&ioLock->lock);
+			status = (*stream->funcs.seekFunc) (stream, read->startOffset);
+			if(status == OM_ERR_NONE)
+				status = (*stream->funcs.readFunc) (stream, read->length, read->buf,
+													&read->bytesRead);
+			pthread_mutex_unlock(&ioLock->lock);
+
+			pthread_mutex_lock(&aio->lock);
+			read->status = status;
+			read->state = kAsyncReadDone;
+			pthread_cond_broadcast(&aio->changed);
+		}
+		else if(aio->shutdown)
+			break;
+		else
+			pthread_cond_wait(&aio->changed, &aio->lock);
+	}
+	pthread_mutex_unlock(&aio->lock);
+
+	return(NULL);
+}
+
+/************************
+ * freeAsyncIO
+ *
+ * 		Releases an async I/O block whose thread is not running.
+ */
+static void freeAsyncIO(omfHdl_t main, struct omfStreamAsyncIO *aio)
+{
+	omfInt32	n;
+	
+	for(n = 0; n < aio->numSlots; n++)
+	{
+		if(aio->slots[n].buf != NULL)
+			omOptFree(main, aio->slots[n].buf);
+	}
+	if(aio->slots != NULL)
+		omOptFree(main, aio->slots);
+	pthread_cond_destroy(&aio->changed);
+	pthread_mutex_destroy(&aio->lock);
+	omOptFree(main, aio);
+}
+
+/************************
+ * startAsyncIO
+ *
+ * 		Allocates buffers the size of the stream cache, and starts the
+ *		thread which reads ahead into them or writes them out.  The
+ *		two uses share one set of buffers.
+ *
+ * Argument Notes:
+ *		If the thread can't be started, the stream is left without
+ *		async I/O and no error is returned.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		OM_ERR_NOMEMORY -- Could not allocate the buffers.
+ */
+static omfErr_t startAsyncIO(omfCodecStream_t *stream, omfInt32 readSlots,
+								omfInt32 writeSlots)
+{
+	omfHdl_t					main = stream->mainFile;
+	struct omfStreamAsyncIO		*aio;
+	struct omfStreamIOLock		*ioLock;
+	omfInt32					n, numSlots;
+
+	numSlots = (readSlots > writeSlots ? readSlots : writeSlots);
+	aio = (struct omfStreamAsyncIO *)omOptMalloc(main, sizeof(struct omfStreamAsyncIO));
+	if(aio == NULL)
+		return(OM_ERR_NOMEMORY);
+	pthread_mutex_init(&aio->lock, NULL);
+	pthread_cond_init(&aio->changed, NULL);
+	aio->readSlots = readSlots;
+	aio->writeSlots = writeSlots;
+	aio->nextSequence = 0;
+	aio->writesQueued = 0;
+	aio->writeStatus = OM_ERR_NONE;
+	aio->shutdown = FALSE;
+	aio->slotSize = stream->cachePhysSize;
+	aio->numSlots = 0;
+	aio->slots = (asyncSlot_t *)omOptMalloc(main, numSlots * sizeof(asyncSlot_t));
+	if(aio->slots == NULL)
+	{
+		freeAsyncIO(main, aio);
+		return(OM_ERR_NOMEMORY);
+	}
+	
+	for(n = 0; n < numSlots; n++)
+	{
+		aio->slots[n].state = kAsyncEmpty;
+		aio->slots[n].buf = (char *)omOptMalloc(main, aio->slotSize);
+		aio->numSlots++;
+		if(aio->slots[n].buf == NULL)
+		{
+			freeAsyncIO(main, aio);
+			return(OM_ERR_NOMEMORY);
+		}
+	}
+
+	ioLock = stream->dataFile->streamIOLock;
+	if(ioLock == NULL)
+	{
+		ioLock = (struct omfStreamIOLock *)omOptMalloc(NULL, sizeof(struct omfStreamIOLock));
+		if(ioLock == NULL)
+		{
+			freeAsyncIO(main, aio);
+			return(OM_ERR_NOMEMORY);
+		}
+		pthread_mutex_init(&ioLock->lock, NULL);
+		ioLock->asyncStreams = 0;
+		stream->dataFile->streamIOLock = ioLock;
+	}
+
+	stream->asyncIO = aio;
+	ioLock->asyncStreams++;
+	if(pthread_create(&aio->thread, NULL, asyncIOWorker, stream) != 0)
+	{
+		ioLock->asyncStreams--;
+		stream->asyncIO = NULL;
+		freeAsyncIO(main, aio);
+	}
+
+	return(OM_ERR_NONE);
+}
+
+/************************
+ * stopAsyncIO
+ *
+ * 		Waits for queued writes to finish, then shuts down the stream
+ *		I/O thread and frees its buffers.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Any error from a queued write which hasn't been reported yet.
+ */
+static omfErr_t stopAsyncIO(omfCodecStream_t *stream)
+{
+	struct omfStreamAsyncIO		*aio = stream->asyncIO;
+	omfErr_t					status;
+
+	if(aio == NULL)
+		return(OM_ERR_NONE);
+	cancelReadAhead(stream);
+	pthread_mutex_lock(&aio->lock);
+	while(aio->writesQueued != 0)
+		pthread_cond_wait(&aio->changed, &aio->lock);
+	status = aio->writeStatus;
+	aio->shutdown = TRUE;
+	pthread_cond_broadcast(&aio->changed);
+	pthread_mutex_unlock(&aio->lock);
+	pthread_join(aio->thread, NULL);
+	stream->dataFile->streamIOLock->asyncStreams--;
+	stream->asyncIO = NULL;
+	freeAsyncIO(stream->mainFile, aio);
+
+	return(status);
+}
+
+/************************
+ * configureAsyncIO
+ *
+ * 		Restarts the stream I/O thread with the given number of read-ahead
+ *		and write-behind slots, or leaves it stopped if neither is wanted
+ *		or the stream can't use it.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		OM_ERR_NOMEMORY -- Could not allocate the buffers.
+ *		Any error from a queued write which hasn't been reported yet.
+ */
+static omfErr_t configureAsyncIO(omfCodecStream_t *stream, omfInt32 readSlots,
+								omfInt32 writeSlots)
+{
+	XPROTECT(stream->mainFile)
+	{
+		CHECK(stopAsyncIO(stream));
+		if(((readSlots != 0) || (writeSlots != 0)) && (stream->cachePhysSize != 0) &&
+		   (stream->dataFile->fmt != kOmfiMedia))
+		{
+			CHECK(startAsyncIO(stream, readSlots, writeSlots));
+		}
+	}
+	XEXCEPT
+	XEND
+
+	return(OM_ERR_NONE);
+}
+
+/************************
+ * cancelReadAhead
+ *
+ * 		Throws away all read-ahead data, waiting for any read in
+ *		progress to finish.  Queued writes are left alone.
+ */
+static void cancelReadAhead(omfCodecStream_t *stream)
+{
+	struct omfStreamAsyncIO		*aio = stream->asyncIO;
+	omfInt32					n;
+	omfBool						busy;
+
+	if(aio == NULL)
+		return;
+	pthread_mutex_lock(&aio->lock);
+	for(;;)
+	{
+		busy = FALSE;
+		for(n = 0; n < aio->numSlots; n++)
+		{
+			if(aio->slots[n].state == kAsyncReading)
+				busy = TRUE;
+			else if((aio->slots[n].state == kAsyncReadQueued) ||
+					(aio->slots[n].state == kAsyncReadDone))
+				aio->slots[n].state = kAsyncEmpty;
+		}
+		if(!busy)
+			break;
+		pthread_cond_wait(&aio->changed, &aio->lock);
+	}
+	pthread_mutex_unlock(&aio->lock);
+}
+
+/************************
+ * findReadAheadSlot
+ *
+ * 		Returns the read-ahead slot holding the given stream offset, or
+ *		NULL.  Called with the async I/O lock held.
+ */
+static asyncSlot_t *findReadAheadSlot(struct omfStreamAsyncIO *aio, omfPosition_t pos)
+{
+	asyncSlot_t		*slot;
+	omfPosition_t	end;
+	omfInt32		n;
+
+	for(n = 0; n < aio->numSlots; n++)
+	{
+		slot = &aio->slots[n];
+		if((slot->state != kAsyncReadQueued) && (slot->state != kAsyncReading) &&
+		   (slot->state != kAsyncReadDone))
+			continue;
+		end = slot->startOffset;
+		omfsAddInt32toInt64(slot->length, &end);
+		if(omfsInt64LessEqual(slot->startOffset, pos) && omfsInt64Less(pos, end))
+			return(slot);
+	}
+
+	return(NULL);
+}
+
+/************************
+ * fillFromReadAhead
+ *
+ * 		Copies up to "want" bytes at the current stream offset into the
+ *		cache buffer from the read-ahead slots, waiting for slots which
+ *		are still being read.  Slots are emptied once fully used.
+ *
+ * ReturnValue:
+ *		The number of bytes copied.  The caller reads the rest directly.
+ */
+static omfUInt32 fillFromReadAhead(omfCodecStream_t *stream, omfUInt32 want)
+{
+	struct omfStreamAsyncIO		*aio = stream->asyncIO;
+	asyncSlot_t					*slot;
+	omfPosition_t				pos, tmp;
+	omfUInt32					filled, slotOffset, n;
+
+	filled = 0;
+	pthread_mutex_lock(&aio->lock);
+	while(filled < want)
+	{
+		pos = stream->fileOffset;
+		omfsAddInt32toInt64(filled, &pos);
+		slot = findReadAheadSlot(aio, pos);
+		if(slot == NULL)
+			break;
+		while(slot->state != kAsyncReadDone)
+			pthread_cond_wait(&aio->changed, &aio->lock);
+		if((slot->status != OM_ERR_NONE) || (slot->bytesRead != slot->length))
+		{
+			slot->state = kAsyncEmpty;
+			break;
+		}
+
+		tmp = pos;
+		omfsSubInt64fromInt64(slot->startOffset, &tmp);
+		omfsTruncInt64toUInt32(tmp, &slotOffset);	/* OK MAXREAD */
+		n = slot->length - slotOffset;
+		if(n > want - filled)
+			n = want - filled;
+		memcpy(stream->cachePtr + filled, slot->buf + slotOffset, n);
+		filled += n;
+		if(slotOffset + n == slot->length)
+			slot->state = kAsyncEmpty;
+	}
+	pthread_mutex_unlock(&aio->lock);
+
+	return(filled);
+}
+
+/************************
+ * scheduleReadAhead
+ *
+ * 		Queues reads for the data following the cache buffer, up to
+ *		one buffer per read-ahead slot.  Data outside of that window
+ *		is dropped.
+ */
+static void scheduleReadAhead(omfCodecStream_t *stream, omfLength_t streamLen)
+{
+	struct omfStreamAsyncIO		*aio = stream->asyncIO;
+	asyncSlot_t					*slot;
+	omfPosition_t				pos, limit, end, tmp;
+	omfInt32					n, inUse;
+	omfUInt32					len;
+
+	pos = stream->cacheStartOffset;
+	omfsAddInt32toInt64(stream->cacheLogicalSize, &pos);
+	limit = pos;
+	for(n = 0; n < aio->readSlots; n++)
+		omfsAddInt32toInt64(aio->slotSize, &limit);
+
+	pthread_mutex_lock(&aio->lock);
+	inUse = 0;
+	for(n = 0; n < aio->numSlots; n++)
+	{
+		slot = &aio->slots[n];
+		if(slot->state == kAsyncReading)
+			inUse++;
+		if((slot->state != kAsyncReadQueued) && (slot->state != kAsyncReadDone))
+			continue;
+		end = slot->startOffset;
+		omfsAddInt32toInt64(slot->length, &end);
+		if(omfsInt64LessEqual(end, pos) || omfsInt64LessEqual(limit, slot->startOffset))
+			slot->state = kAsyncEmpty;
+		else
+			inUse++;
+	}
+
+	while(omfsInt64Less(pos, limit) && omfsInt64Less(pos, streamLen))
+	{
+		slot = findReadAheadSlot(aio, pos);
+		if(slot != NULL)
+		{
+			pos = slot->startOffset;
+			omfsAddInt32toInt64(slot->length, &pos);
+			continue;
+		}
+		if(inUse >= aio->readSlots)
+			break;
+		for(n = 0; n < aio->numSlots; n++)
+		{
+			if(aio->slots[n].state == kAsyncEmpty)
+				break;
+		}
+		if(n == aio->numSlots)
+			break;
+
+		slot = &aio->slots[n];
+		end = pos;
+		omfsAddInt32toInt64(aio->slotSize, &end);
+		len = aio->slotSize;
+		if(omfsInt64Less(streamLen, end))
+		{
+			tmp = streamLen;
+			omfsSubInt64fromInt64(pos, &tmp);
+			omfsTruncInt64toUInt32(tmp, &len);	/* OK MAXREAD */
+		}
+		slot->startOffset = pos;
+		slot->length = len;
+		slot->status = OM_ERR_NONE;
+		slot->state = kAsyncReadQueued;
+		inUse++;
+		omfsAddInt32toInt64(len, &pos);
+	}
+	pthread_cond_broadcast(&aio->changed);
+	pthread_mutex_unlock(&aio->lock);
+}
+
+/************************
+ * queueWriteBehind
+ *
+ * 		Hands the filled cache buffer to the stream I/O thread, and
+ *		gives the cache an empty buffer in its place.  Waits only when
+ *		every write-behind slot is still queued.
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Any error from an earlier queued write which hasn't been
+ *		reported yet.  The cache is not queued in that case.
+ */
+static omfErr_t queueWriteBehind(omfCodecStream_t *stream)
+{
+	struct omfStreamAsyncIO		*aio = stream->asyncIO;
+	asyncSlot_t					*slot;
+	omfInt32					n;
+	char						*emptyBuf;
+	omfErr_t					status;
+
+	if(stream->cacheLogicalSize == 0)
+		return(OM_ERR_NONE);
+	
+	pthread_mutex_lock(&aio->lock);
+	for(;;)
+	{
+		slot = NULL;
+		if(aio->writesQueued < aio->writeSlots)
+		{
+			for(n = 0; n < aio->numSlots; n++)
+			{
+				if((aio->slots[n].state == kAsyncEmpty) ||
+				   (aio->slots[n].state == kAsyncReadQueued) ||
+				   (aio->slots[n].state == kAsyncReadDone))
+				{
+					slot = &aio->slots[n];
+					break;
+				}
+			}
+		}
+		if((slot != NULL) || (aio->writeStatus != OM_ERR_NONE))
+			break;
+		pthread_cond_wait(&aio->changed, &aio->lock);
+	}
+	
+	status = aio->writeStatus;
+	aio->writeStatus = OM_ERR_NONE;
+	if(status == OM_ERR_NONE)
+	{
+		emptyBuf = slot->buf;
+		slot->buf = stream->cachePtr;
+		stream->cachePtr = emptyBuf;
+		slot->length = stream->cacheLogicalSize;
+		slot->sequence = aio->nextSequence++;
+		slot->state = kAsyncWriteQueued;
+		aio->writesQueued++;
+		pthread_cond_broadcast(&aio->changed);
+	}
+	pthread_mutex_unlock(&aio->lock);
+
+	return(status);
+}
+
+/************************
+ * takeWriteStatus
+ *
+ * 		Returns, and clears, the error from a failed queued write.
+ */
+static omfErr_t takeWriteStatus(omfCodecStream_t *stream)
+{
+	struct omfStreamAsyncIO		*aio = stream->asyncIO;
+	omfErr_t					status;
+
+	pthread_mutex_lock(&aio->lock);
+	status = aio->writeStatus;
+	aio->writeStatus = OM_ERR_NONE;
+	pthread_mutex_unlock(&aio->lock);
+
+	return(status);
+}
+
+/************************
+ * lockStreamIO / unlockStreamIO
+ *
+ * 		Bracket calls to the stream funcs on raw files, which stream I/O
+ *		threads may be using.  Queued writes are finished first, so that
+ *		the call sees the file as the caller wrote it.  No-ops unless a
+ *		stream on the same file has a stream I/O thread.
+ */
+static void lockStreamIO(omfCodecStream_t *stream)
+{
+	struct omfStreamAsyncIO		*aio = stream->asyncIO;
+	struct omfStreamIOLock		*ioLock = stream->dataFile->streamIOLock;
+
+	if(aio != NULL)
+	{
+		pthread_mutex_lock(&aio->lock);
+		while(aio->writesQueued != 0)
+			pthread_cond_wait(&aio->changed, &aio->lock);
+		pthread_mutex_unlock(&aio->lock);
+	}
+	if((ioLock != NULL) && (ioLock->asyncStreams != 0))
+		pthread_mutex_lock(&ioLock->lock);
+}
+
+static void unlockStreamIO(omfCodecStream_t *stream)
+{
+	struct omfStreamIOLock		*ioLock = stream->dataFile->streamIOLock;
+
+	if((ioLock != NULL) && (ioLock->asyncStreams != 0))
+		pthread_mutex_unlock(&ioLock->lock);
+}
+#endif
+
+/************************
+ * ompvtDisposeStreamIOLock
+ *
+ * 		Frees the stream I/O lock of a raw file, if any of its streams
+ *		ever had a stream I/O thread.  Called when the file is closed,
+ *		after all of its streams are.
+ */
+void ompvtDisposeStreamIOLock(omfHdl_t file)
+{
+#if USE_STREAM_THREAD
+	if(file->streamIOLock != NULL)
+	{
+		pthread_mutex_destroy(&file->streamIOLock->lock);
+		omOptFree(NULL, file->streamIOLock);
+		file->streamIOLock = NULL;
+	}
+#endif
+}
+
 /************************************************************************
  *
  * CODEC stream callback wrappers
@@ -375,6 +1170,7 @@ omfErr_t omcOpenStream(
 		stream->writeCacheHits = 0;
 		stream->totalReads = 0;
 		stream->readCacheHits = 0;
+		stream->asyncIO = NULL;
 		stream->cachePtr = (char *)omOptMalloc(mainFile, DEFAULT_STREAMBUF_SIZE);
 		if(stream->cachePtr != NULL)
 			stream->cachePhysSize = DEFAULT_STREAMBUF_SIZE;
@@ -419,10 +1215,11 @@ omfErr_t omcReadStream(
 {
 	omfHdl_t        		main;
 	omfUInt32          	junk;
+	omfErr_t			status;
 #if OMFI_ENABLE_STREAM_CACHE
-	omfUInt32          	actualCacheFillSize;
+	omfUInt32          	actualCacheFillSize, filled;
 	omfUInt32			cacheOffset, bytesLeft;
-	omfInt64			tmp, streamBytesLeft;
+	omfInt64			tmp, streamBytesLeft, streamLen;
 	omfBool			validOffset;
 #endif
 	
@@ -452,9 +1249,15 @@ omfErr_t omcReadStream(
 		CHECK(omfsTruncInt64toUInt32(tmp, &cacheOffset));	/* OK MAXREAD */
 		if(bufLength > stream->cachePhysSize)
 		{	/* read directly */
-			CHECK((*stream->funcs.seekFunc) (stream, stream->fileOffset));
+			lockStreamIO(stream);
+			status = (*stream->funcs.seekFunc) (stream, stream->fileOffset);
+			if(status == OM_ERR_NONE)
+#endif
+				status = (*stream->funcs.readFunc) (stream, bufLength, buffer, bytesRead);
+#if OMFI_ENABLE_STREAM_CACHE
+			unlockStreamIO(stream);
 #endif
-			CHECK((*stream->funcs.readFunc) (stream, bufLength, buffer, bytesRead));
+			CHECK(status);
 #if OMFI_ENABLE_STREAM_CACHE
 		}
 		else if(validOffset && (cacheOffset > 0) &&
@@ -468,17 +1271,42 @@ omfErr_t omcReadStream(
 		{
 			CHECK(omcFlushCache(stream));
 			stream->cacheLogicalSize = stream->cachePhysSize;
-			(*stream->funcs.lengthFunc)(stream, &streamBytesLeft);
+			omfsCvtInt32toInt64(0, &streamLen);
+			lockStreamIO(stream);
+			(*stream->funcs.lengthFunc)(stream, &streamLen);
+			unlockStreamIO(stream);
+			streamBytesLeft = streamLen;
 			CHECK(omfsSubInt64fromInt64(stream->fileOffset, &streamBytesLeft));
 			CHECK(omfsTruncInt64toUInt32(streamBytesLeft, &bytesLeft));	/* OK MAXREAD */
 	
 			if(bytesLeft < stream->cacheLogicalSize)
 				stream->cacheLogicalSize = bytesLeft;
 				
-			CHECK((*stream->funcs.seekFunc) (stream, stream->fileOffset));
-			CHECK((*stream->funcs.readFunc) (stream, stream->cacheLogicalSize,
-										stream->cachePtr, &actualCacheFillSize));
+#if USE_STREAM_THREAD
+			if((stream->asyncIO != NULL) && (stream->asyncIO->readSlots != 0))
+				filled = fillFromReadAhead(stream, stream->cacheLogicalSize);
+			else
+#endif
+				filled = 0;
+			actualCacheFillSize = filled;
+			if(filled < stream->cacheLogicalSize)
+			{
+				tmp = stream->fileOffset;
+				CHECK(omfsAddInt32toInt64(filled, &tmp));
+				lockStreamIO(stream);
+				status = (*stream->funcs.seekFunc) (stream, tmp);
+				if(status == OM_ERR_NONE)
+					status = (*stream->funcs.readFunc) (stream, stream->cacheLogicalSize - filled,
+										stream->cachePtr + filled, &actualCacheFillSize);
+				unlockStreamIO(stream);
+				actualCacheFillSize += filled;
+				CHECK(status);
+			}
 			stream->cacheStartOffset = stream->fileOffset;
+#if USE_STREAM_THREAD
+			if((stream->asyncIO != NULL) && (stream->asyncIO->readSlots != 0))
+				scheduleReadAhead(stream, streamLen);
+#endif
 			if(bufLength <= stream->cacheLogicalSize)
 			{
 				memcpy(buffer, stream->cachePtr, bufLength);
@@ -519,6 +1347,7 @@ static omfErr_t padStream(omfCodecStream_t *stream, omfUInt32 padLength)
 {
 	omfInt32			fillLeft, fillSize, fillBufLen, tryLen;
 	char			*zeroPtr;
+	omfErr_t		status;
 	omfHdl_t        main;
 	
 	main = stream->mainFile;
@@ -553,7 +1382,10 @@ static omfErr_t padStream(omfCodecStream_t *stream, omfUInt32 padLength)
 			fillSize = fillBufLen;
 			if(fillSize > fillLeft)
 				fillSize = fillLeft;
-			CHECK((*stream->funcs.writeFunc) (stream, fillSize, zeroPtr));
+			lockStreamIO(stream);
+			status = (*stream->funcs.writeFunc) (stream, fillSize, zeroPtr);
+			unlockStreamIO(stream);
+			CHECK(status);
 			fillLeft -= fillSize;
 		}
 #if OMFI_ENABLE_STREAM_CACHE
@@ -591,6 +1423,11 @@ omfErr_t omcWriteStream(
 {
 	omfHdl_t        main;
 	omfInt64			endpos, newEndpos;
+	omfErr_t		status;
+#if USE_STREAM_THREAD
+	omfUInt32		chunk;
+	char			*src;
+#endif
 
 	main = stream->mainFile;
 	omfAssert(stream->funcs.writeFunc != NULL, main, OM_ERR_NULL_STREAMPROC);
@@ -599,6 +1436,21 @@ omfErr_t omcWriteStream(
 
 	XPROTECT(main)
 	{
+#if USE_STREAM_THREAD
+		if(stream->asyncIO != NULL)
+		{
+			CHECK(takeWriteStatus(stream));
+			if((stream->asyncIO->readSlots != 0) && (stream->direction != omcCacheWrite))
+			{
+				/* The read-ahead thread moves the file position */
+				cancelReadAhead(stream);
+				lockStreamIO(stream);
+				status = (*stream->funcs.seekFunc) (stream, stream->fileOffset);
+				unlockStreamIO(stream);
+				CHECK(status);
+			}
+		}
+#endif
 #if OMFI_ENABLE_STREAM_CACHE
 		if(stream->direction == omcCacheRead)
 			CHECK(omcFlushCache(stream));
@@ -624,10 +1476,33 @@ omfErr_t omcWriteStream(
 			stream->direction = omcCacheWrite;
 		}
 		
+#if USE_STREAM_THREAD
+		if((bufLength > stream->cachePhysSize) && (stream->asyncIO != NULL) &&
+		   (stream->asyncIO->writeSlots != 0))
+		{	/* Pass big writes through the cache, so they get queued too */
+			for(src = (char *)buffer; src < (char *)buffer + bufLength; src += chunk)
+			{
+				chunk = stream->cachePhysSize - stream->cacheLogicalSize;
+				if(chunk > (omfUInt32)((char *)buffer + bufLength - src))
+					chunk = (omfUInt32)((char *)buffer + bufLength - src);
+				memcpy(stream->cachePtr + stream->cacheLogicalSize, src, chunk);
+				stream->cacheLogicalSize += chunk;
+				if(stream->cacheLogicalSize == stream->cachePhysSize)
+				{
+					CHECK(omcFlushCache(stream));
+					stream->direction = omcCacheWrite;
+				}
+			}
+		}
+		else
+#endif
 		if(bufLength > stream->cachePhysSize)		/* Write directly */
 		{
 #endif
-			CHECK((*stream->funcs.writeFunc) (stream, bufLength, buffer));
+			lockStreamIO(stream);
+			status = (*stream->funcs.writeFunc) (stream, bufLength, buffer);
+			unlockStreamIO(stream);
+			CHECK(status);
 #if OMFI_ENABLE_STREAM_CACHE
 		}
 		else
@@ -668,6 +1543,7 @@ omfErr_t omcSeekStreamTo(
 			omfInt64			offset)		/* IN -- Seek to this offset */
 {
 	omfHdl_t       	 main;
+	omfErr_t		status;
 #if OMFI_ENABLE_STREAM_CACHE
 	omfBool			validStart, validEnd;
 	omfInt64			tmp;
@@ -698,7 +1574,10 @@ omfErr_t omcSeekStreamTo(
 		}
 #endif
 			 
-		CHECK((*stream->funcs.seekFunc) (stream, offset));
+		lockStreamIO(stream);
+		status = (*stream->funcs.seekFunc) (stream, offset);
+		unlockStreamIO(stream);
+		CHECK(status);
 	}
 	XEXCEPT
 	XEND
@@ -736,7 +1615,9 @@ omfBool omcIsPosValid(
 		CHECK(omcGetLength(stream, &length));
 
 		omfsCvtInt32toInt64(0, &length);
+		lockStreamIO(stream);
 		(*stream->funcs.lengthFunc) (stream,  &length);
+		unlockStreamIO(stream);
 	}
 	XEXCEPT
 		return(FALSE);
@@ -767,7 +1648,9 @@ omfErr_t omcGetLength(
 	omfAssert((stream->cookie == STREAM_COOKIE), stream->mainFile, OM_ERR_STREAM_CLOSED);
 	
 	omfsCvtInt32toInt64(0, length);
+	lockStreamIO(stream);
 	(*stream->funcs.lengthFunc) (stream, length);
+	unlockStreamIO(stream);
 	
 	return(OM_ERR_NONE);
 }
@@ -824,7 +1707,9 @@ omfErr_t omcGetStreamFilePos(
 			omfInt64			*offset)	/* OUT - return position through here */
 {
 	omfAssert((stream->cookie == STREAM_COOKIE), stream->mainFile, OM_ERR_STREAM_CLOSED);
+	lockStreamIO(stream);
 	(*stream->funcs.filePosFunc) (stream,  offset);
+	unlockStreamIO(stream);
 	
 	return (OM_ERR_NONE);
 }
@@ -850,7 +1735,9 @@ omfErr_t omcGetStreamNumSegments(
 			omfInt32		*numseg)	/* OUT - return position through here */
 {
 	omfAssert((stream->cookie == STREAM_COOKIE), stream->mainFile, OM_ERR_STREAM_CLOSED);
+	lockStreamIO(stream);
 	(*stream->funcs.numsegFunc) (stream, numseg);
+	unlockStreamIO(stream);
 	
 	return (OM_ERR_NONE);
 }
@@ -884,7 +1771,9 @@ omfErr_t omcGetStreamSegmentInfo(
 			omfLength_t		*length)	/* OUT -- and how int  is it? */
 {
 	omfAssert((stream->cookie == STREAM_COOKIE), stream->mainFile, OM_ERR_STREAM_CLOSED);
+	lockStreamIO(stream);
 	(*stream->funcs.seginfoFunc) (stream,  index, startPos, length);
+	unlockStreamIO(stream);
 	
 	return (OM_ERR_NONE);
 }
@@ -908,6 +1797,9 @@ omfErr_t omcCloseStream(
 {
 	omfHdl_t        	main;
 	omfCodecSwabProc_t	*tmp;
+#if OMFI_ENABLE_STREAM_CACHE
+	omfErr_t			status;
+#endif
 	
 	main = stream->mainFile;
 	omfAssert(stream->funcs.closeFunc != NULL, main, OM_ERR_NULL_STREAMPROC);
@@ -924,7 +1816,14 @@ omfErr_t omcCloseStream(
 			printf("Read Cache percentage = %ld\n", (stream->readCacheHits * 100 / stream->totalReads));
 #endif
 
-		CHECK(omcFlushCache(stream));
+		status = omcFlushCache(stream);
+#if USE_STREAM_THREAD
+		if(status == OM_ERR_NONE)
+			status = stopAsyncIO(stream);
+		else
+			(void)stopAsyncIO(stream);
+#endif
+		CHECK(status);
 		if(stream->cachePtr != NULL)
 			omOptFree(main, stream->cachePtr);
 		stream->cachePtr = NULL;
@@ -137,6 +137,15 @@ typedef struct omfCodecSwabProc
 	struct omfCodecSwabProc	*next;
 } omfCodecSwabProc_t;
 	
+/*
+ * Stream read-ahead and write-behind are built on the stream cache, so
+ * Unix builds with threads turn the cache on even if the project does
+ * not.  Define OMFI_NO_THREADS to build without them.
+ */
+#if PORT_SYS_UNIX && !defined(OMFI_NO_THREADS) && !defined(OMFI_ENABLE_STREAM_CACHE)
+#define OMFI_ENABLE_STREAM_CACHE	1
+#endif
+
 struct omfCodecStream
 {
 	omfHdl_t				mainFile;
@@ -162,6 +171,7 @@ struct omfCodecStream
 	omfInt32				writeCacheHits;
 	omfInt32				totalReads;
 	omfInt32				readCacheHits;
+	struct omfStreamAsyncIO	*asyncIO;	/* NULL unless read-ahead or write-behind */
 #endif
 };
 
@@ -220,6 +230,14 @@ OMF_EXPORT omfErr_t omcCloseStream(
 OMF_EXPORT omfErr_t omfmSetStreamCacheSize(
 			omfMediaHdl_t	media,
 			omfUInt32			cacheSize);		/* make the cache this big */
+
+OMF_EXPORT omfErr_t omfmSetStreamReadAhead(
+			omfMediaHdl_t	media,
+			omfInt32			numBuffers);	/* cache buffers to keep filled */
+
+OMF_EXPORT omfErr_t omfmSetStreamWriteBehind(
+			omfMediaHdl_t	media,
+			omfInt32			numBuffers);	/* cache buffers to queue */
 	
 OMF_EXPORT omfErr_t omcSetMemoryFormat(
 			omfCodecStream_t *stream,
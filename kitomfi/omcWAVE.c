@@ -45,6 +45,11 @@ typedef struct
 
 #define MAX_FMT_OPS	32
 
+/* Largest interleaved block assembled in memory for a single
+ * omcWriteSwabbedStream() call when writing multiple channels.
+ */
+#define MAX_INTERLEAVE_BLOCK	(1024L * 1024L)
+
 typedef struct
 {
 	omfUInt16          fileBitsPerSample;
@@ -55,6 +60,8 @@ typedef struct
 	omfAudioMemOp_t	fmtOps[MAX_FMT_OPS+1];
 	omfAudioMemOp_t	fileFmt[8];
 	interleaveBuf_t	*interleaveBuf;
+	char			*blockBuf;		/* Interleaved write buffer */
+	omfUInt32		blockBufSize;
 }               userDataWAVE_t;
 
 static omfErr_t readWAVEHeader(omfHdl_t mainFile, omfCodecStream_t *stream,
@@ -88,6 +95,8 @@ static omfErr_t InitMDESProps(omfCodecParms_t * info,
 static omfErr_t setupStream(omfCodecStream_t *stream, omfDDefObj_t datakind, userDataWAVE_t * pdata);
 static omfErr_t InitWAVECodec(omfCodecParms_t *parmblk);
 static void SplitBuffers(void *original, omfInt32 srcSamples, omfInt16 sampleSize, omfInt16 numDest, interleaveBuf_t *destPtr);
+static void InterleaveBuffers(interleaveBuf_t *srcPtr, omfInt16 numSrc, omfInt16 sampleBytes, omfInt32 numSamples, char *dest);
+static void CopyStridedSamples(char *dest, omfInt32 destStride, char *src, omfInt32 srcStride, omfInt16 sampleBytes, omfInt32 numSamples);
 static omfErr_t codecImportRawWAVE(omfCodecParms_t *parmblk, omfMediaHdl_t media, omfHdl_t main);
 static omfErr_t codecSemCheckWAVE(omfCodecParms_t *parmblk, omfMediaHdl_t media, omfHdl_t main);
 static omfErr_t codecGetInfoWAVE(omfCodecParms_t * info,
@@ -307,6 +316,8 @@ static omfErr_t InitMDESProps(omfCodecParms_t * info,
 		initialPData.fmtOps[0].opcode = kOmfAFmtEnd;
 		initialPData.fileFmt[0].opcode = kOmfAFmtEnd;
 		initialPData.interleaveBuf = NULL;
+		initialPData.blockBuf = NULL;
+		initialPData.blockBufSize = 0;
 		CHECK(CreateWAVEheader(main, &streamData, &initialPData, 1, FALSE));
 		CHECK(omcCloseStream(&streamData));
 	}
@@ -597,6 +608,8 @@ static omfErr_t readWAVEHeader(omfHdl_t mainFile, omfCodecStream_t *stream,
 		
 	pdata->fmtOps[0].opcode = kOmfAFmtEnd;
 	pdata->interleaveBuf = NULL;
+	pdata->blockBuf = NULL;
+	pdata->blockBufSize = 0;
 	
 	XPROTECT(mainFile)
 	{
@@ -798,6 +811,8 @@ static omfErr_t codecCloseWAVE(omfCodecParms_t * parmblk, omfMediaHdl_t media, o
 
 		if(pdata->interleaveBuf != NULL)
 			omOptFree(main, pdata->interleaveBuf);
+		if(pdata->blockBuf != NULL)
+			omOptFree(main, pdata->blockBuf);
 		omOptFree(main, media->userData);
 	}
 	XEXCEPT
@@ -1197,13 +1212,12 @@ static omfErr_t codecReadBlocksWAVE(omfCodecParms_t * parmblk, omfMediaHdl_t med
 static omfErr_t codecWriteBlocksWAVE(omfCodecParms_t * parmblk, omfMediaHdl_t media, omfHdl_t main)
 {
 	omfUInt32      	fileBytes, memBytes, memBytesPerSample;
-	omfInt32      		bytesPerSample, n, ch, xfers, samp;
+	omfInt32      		bytesPerSample, n, ch, xfers;
 	omfUInt32			maxSamplesLeft;
 	userDataWAVE_t *pdata;
 	omfmMultiXfer_t *xfer;
 	interleaveBuf_t	*inter;
-	char					*destPtr;
-	char					sampleBuf[256];
+	omfUInt32				frameBytes, blockSize;
 
 	omfAssertMediaHdl(media);
 
@@ -1292,30 +1306,39 @@ static omfErr_t codecWriteBlocksWAVE(omfCodecParms_t * parmblk, omfMediaHdl_t me
 			
 			CHECK(omcComputeBufferSize(media->stream, bytesPerSample, omcComputeMemSize, &memBytesPerSample));
 
+			/* Interleave into a block of up to MAX_INTERLEAVE_BLOCK bytes, kept
+			 * with the media, so that large writes go through the swab and
+			 * write path a block at a time rather than a few samples at a time.
+			 */
+			frameBytes = memBytesPerSample * parmblk->spc.mediaXfer.numXfers;
+			if(maxSamplesLeft > MAX_INTERLEAVE_BLOCK / frameBytes)
+				blockSize = (MAX_INTERLEAVE_BLOCK / frameBytes) * frameBytes;
+			else
+				blockSize = maxSamplesLeft * frameBytes;
+			if(blockSize > pdata->blockBufSize)
+			{
+				if(pdata->blockBuf != NULL)
+					omOptFree(main, pdata->blockBuf);
+				pdata->blockBufSize = 0;
+				pdata->blockBuf = (char *)omOptMalloc(main, blockSize);
+				if(pdata->blockBuf == NULL)
+					RAISE(OM_ERR_NOMEMORY);
+				pdata->blockBufSize = blockSize;
+			}
+
 			while(maxSamplesLeft > 0)
 			{
-				xfers = sizeof(sampleBuf) / (memBytesPerSample * parmblk->spc.mediaXfer.numXfers);
+				xfers = pdata->blockBufSize / frameBytes;
 				if((omfUInt32) xfers > maxSamplesLeft)
 					xfers = (omfInt32) maxSamplesLeft;
 					
-				destPtr = sampleBuf;
-				for (samp = 0; samp < xfers; samp++)
-				{
-					for (n = 0; n < parmblk->spc.mediaXfer.numXfers; n++)
-					{
-						inter = pdata->interleaveBuf+n;
-						memcpy(destPtr, inter->buf, memBytesPerSample);
-						inter->buf = (char *)inter->buf + memBytesPerSample;
-						destPtr += memBytesPerSample;
-						inter->samplesLeft--;
-						inter->bytesXfered += memBytesPerSample;
-					}
-					maxSamplesLeft--;
-				}
+				InterleaveBuffers(pdata->interleaveBuf, parmblk->spc.mediaXfer.numXfers,
+									(omfInt16)memBytesPerSample, xfers, pdata->blockBuf);
+				maxSamplesLeft -= xfers;
 				
-				memBytes = xfers * memBytesPerSample * parmblk->spc.mediaXfer.numXfers;
+				memBytes = xfers * frameBytes;
 				CHECK(omcComputeBufferSize(media->stream, memBytes, omfComputeFileSize, &fileBytes));
-				CHECK(omcWriteSwabbedStream(media->stream, fileBytes, memBytes, sampleBuf));
+				CHECK(omcWriteSwabbedStream(media->stream, fileBytes, memBytes, pdata->blockBuf));
 			}
 			
 			for (n = 0; n < parmblk->spc.mediaXfer.numXfers; n++)
@@ -1528,6 +1551,8 @@ static omfErr_t codecCreateWAVE(omfCodecParms_t * parmblk, omfMediaHdl_t media,
 		pdata->fmtOps[0].opcode = kOmfAFmtEnd;
 		pdata->fileBitsPerSample = 0;
 		pdata->interleaveBuf = NULL;
+		pdata->blockBuf = NULL;
+		pdata->blockBufSize = 0;
 	
 		if(main->fmt == kOmfiMedia)
 		{
@@ -1801,52 +1826,146 @@ static omfErr_t setupStream(omfCodecStream_t *stream, omfDDefObj_t datakind, use
  */
 static void SplitBuffers(void *original, omfInt32 srcSamples, omfInt16 sampleSize, omfInt16 numDest, interleaveBuf_t *destPtr)
 {
-	omfInt16	*src16, *srcEnd16, *dest16;
-	char	*src8, *srcEnd8, *dest8;
-	omfInt16	n, x, sampleBytes;
+	char		*src;
+	omfInt32	frames, extra, count;
+	omfInt16	n, inPlace, sampleBytes;
 	
 	sampleBytes = (sampleSize + 7) / 8;
-	if(sampleSize == 16)
+	frames = srcSamples / numDest;
+	extra = srcSamples % numDest;
+	
+	/* Copy out one channel at a time.  A destination which is the source
+	 * buffer itself is done last, as it overwrites the interleaved data.
+	 */
+	inPlace = -1;
+	for(n = 0; n < numDest; n++)
 	{
-		src16 = (omfInt16 *)original;
-		srcEnd16 = src16 + srcSamples;
-		while(src16 < srcEnd16)
+		if(destPtr[n].buf == original)
+			inPlace = n;
+		else if(destPtr[n].buf != NULL)
 		{
-			for(n = 0; (n < numDest) && (src16 < srcEnd16) ; n++)
-			{
-				dest16 = (omfInt16 *)destPtr[n].buf;
-				if(dest16 != NULL)
-				{
-					destPtr[n].bytesXfered += sampleBytes;
-					*dest16++ = *src16++;
-				}
-				else
-					src16++;
-				destPtr[n].buf = (char *)dest16;
-			}
+			src = (char *)original + (n * sampleBytes);
+			count = frames + (n < extra ? 1 : 0);
+			CopyStridedSamples((char *)destPtr[n].buf, 1, src, numDest, sampleBytes, count);
+			destPtr[n].buf = (char *)destPtr[n].buf + (count * sampleBytes);
+			destPtr[n].bytesXfered += count * sampleBytes;
+			destPtr[n].samplesLeft -= count;
 		}
 	}
-	else
+	if(inPlace >= 0)
+	{
+		n = inPlace;
+		src = (char *)original + (n * sampleBytes);
+		count = frames + (n < extra ? 1 : 0);
+		CopyStridedSamples((char *)destPtr[n].buf, 1, src, numDest, sampleBytes, count);
+		destPtr[n].buf = (char *)destPtr[n].buf + (count * sampleBytes);
+		destPtr[n].bytesXfered += count * sampleBytes;
+		destPtr[n].samplesLeft -= count;
+	}
+}
+
+/************************
+ * InterleaveBuffers		(INTERNAL)
+ *
+ * 		The reverse of SplitBuffers().  Given an array of source buffers, merge
+ *		numSamples samples from each into dest in round-robin fashion, one channel
+ *		at a time.  The source buffer pointers are advanced past the data taken.
+ *
+ * Argument Notes:
+ *		All numSrc entries in srcPtr must be non-NULL, and dest must hold
+ *		numSamples * numSrc * sampleBytes bytes.
+ *
+ * ReturnValue:
+ *		<none>.
+ *
+ * Possible Errors:
+ *		<none>.
+ */
+static void InterleaveBuffers(
+			interleaveBuf_t	*srcPtr,
+			omfInt16			numSrc,
+			omfInt16			sampleBytes,
+			omfInt32			numSamples,
+			char				*dest)
+{
+	omfInt16	n;
+	
+	for(n = 0; n < numSrc; n++)
 	{
-		src8 = (char *)original;
-		srcEnd8 = src8 + srcSamples;
-		while(src8 < srcEnd8)
+		CopyStridedSamples(dest + (n * sampleBytes), numSrc, (char *)srcPtr[n].buf, 1,
+							sampleBytes, numSamples);
+		srcPtr[n].buf = (char *)srcPtr[n].buf + (numSamples * sampleBytes);
+		srcPtr[n].samplesLeft -= numSamples;
+		srcPtr[n].bytesXfered += numSamples * sampleBytes;
+	}
+}
+
+/************************
+ * CopyStridedSamples		(INTERNAL)
+ *
+ * 		Copy numSamples samples from src to dest, stepping each pointer by
+ *		the given number of samples.  Used to interleave or deinterleave a
+ *		single channel, with the common sample sizes copied a word at a time.
+ *
+ * Argument Notes:
+ *		Strides are in samples, not bytes.
+ *
+ * ReturnValue:
+ *		<none>.
+ *
+ * Possible Errors:
+ *		<none>.
+ */
+static void CopyStridedSamples(
+			char		*dest,
+			omfInt32	destStride,
+			char		*src,
+			omfInt32	srcStride,
+			omfInt16	sampleBytes,
+			omfInt32	numSamples)
+{
+	omfInt16	*src16, *dest16;
+	omfInt32	*src32, *dest32;
+	omfInt32	n;
+	
+	switch(sampleBytes)
+	{
+	case 1:
+		for(n = 0; n < numSamples; n++, dest += destStride, src += srcStride)
+			*dest = *src;
+		break;
+		
+	case 2:
+		src16 = (omfInt16 *)src;
+		dest16 = (omfInt16 *)dest;
+		for(n = 0; n < numSamples; n++, dest16 += destStride, src16 += srcStride)
+			*dest16 = *src16;
+		break;
+		
+	case 3:
+		destStride *= 3;
+		srcStride *= 3;
+		for(n = 0; n < numSamples; n++, dest += destStride, src += srcStride)
 		{
-			for(n = 0; (n < numDest) && (src8 < srcEnd8) ; n++, dest8++)
-			{
-				dest8 = (char *)destPtr[n].buf;
-				if(dest8 != NULL)
-				{
-					destPtr[n].bytesXfered += sampleBytes;
-					{	for(x = 0; x < sampleBytes; x++)
-							*dest8++ = *src8++;
-					}
-				}
-				else
-					src8++;
-				destPtr[n].buf = (char *)dest8;
-			}
+			dest[0] = src[0];
+			dest[1] = src[1];
+			dest[2] = src[2];
 		}
+		break;
+		
+	case 4:
+		src32 = (omfInt32 *)src;
+		dest32 = (omfInt32 *)dest;
+		for(n = 0; n < numSamples; n++, dest32 += destStride, src32 += srcStride)
+			*dest32 = *src32;
+		break;
+		
+	default:
+		destStride *= sampleBytes;
+		srcStride *= sampleBytes;
+		for(n = 0; n < numSamples; n++, dest += destStride, src += srcStride)
+			memcpy(dest, src, sampleBytes);
+		break;
 	}
 }
 
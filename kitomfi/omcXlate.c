@@ -84,6 +84,145 @@ static void videoFormatFromOpcodeList(omfVideoMemOp_t *ops, omfVideoMemInfo_t *o
 
 typedef enum { YUV422, YUV444, YUVOther } YUVType_t;
 
+/* Byte-aligned sample accessors for translateAlignedAudioSamples().  Samples
+ * are stored most significant byte first, exactly as the bit-packing loop
+ * in translateAudioSamples() reads and writes them.
+ */
+#define GET_SAMPLE8(p)	((omfUInt32)(p)[0])
+#define GET_SAMPLE16(p)	(((omfUInt32)(p)[0] << 8) | (omfUInt32)(p)[1])
+#define GET_SAMPLE24(p)	(((omfUInt32)(p)[0] << 16) | ((omfUInt32)(p)[1] << 8) | \
+							(omfUInt32)(p)[2])
+#define GET_SAMPLE32(p)	(((omfUInt32)(p)[0] << 24) | ((omfUInt32)(p)[1] << 16) | \
+							((omfUInt32)(p)[2] << 8) | (omfUInt32)(p)[3])
+
+#define PUT_SAMPLE8(p, v)	((p)[0] = (omfUInt8)(v))
+#define PUT_SAMPLE16(p, v)	((p)[0] = (omfUInt8)((v) >> 8), (p)[1] = (omfUInt8)(v))
+#define PUT_SAMPLE24(p, v)	((p)[0] = (omfUInt8)((v) >> 16), (p)[1] = (omfUInt8)((v) >> 8), \
+								(p)[2] = (omfUInt8)(v))
+#define PUT_SAMPLE32(p, v)	((p)[0] = (omfUInt8)((v) >> 24), (p)[1] = (omfUInt8)((v) >> 16), \
+								(p)[2] = (omfUInt8)((v) >> 8), (p)[3] = (omfUInt8)(v))
+
+/* One sample in, one sample out, for a fixed pair of sample sizes.  The loop
+ * body has no branches, so compilers are free to unroll or vectorize it.
+ */
+#define XLATE_ALIGNED_LOOP(GET, PUT) \
+	for(n = 0; n < numSamples; n++, in += srcBytes, out += destBytes) \
+	{ \
+		aSample = GET(in) + delta; \
+		PUT(out, aSample); \
+	}
+
+#define XLATE_ALIGNED_DEST(GET) \
+	switch(destBytes) \
+	{ \
+	case 1:	XLATE_ALIGNED_LOOP(GET, PUT_SAMPLE8);	break; \
+	case 2:	XLATE_ALIGNED_LOOP(GET, PUT_SAMPLE16);	break; \
+	case 3:	XLATE_ALIGNED_LOOP(GET, PUT_SAMPLE24);	break; \
+	default: XLATE_ALIGNED_LOOP(GET, PUT_SAMPLE32);	break; \
+	}
+
+/************************
+ * translateAlignedAudioSamples
+ *
+ * 		Fast path for translateAudioSamples() when the source and destination
+ *		sample sizes are both whole bytes (8, 16, 24 or 32 bits).  Produces
+ *		exactly the same output as the bit-packing loop: the source sample is
+ *		converted between offset-binary and signed if needed, and the low
+ *		destination-size bits of the result are stored.  A same-rate
+ *		conversion runs through a specialized loop for each pair of sizes,
+ *		and integral rate reductions are handled one sample at a time.
+ *
+ * Argument Notes:
+ *		numSamples - Number of samples to produce, which is the number of
+ *			samples in the source buffer (as in translateAudioSamples).
+ *		multiplier - Integral rate change, as reduced by the caller.  Only
+ *			rate reductions (numerator == 1) are handled here.
+ *
+ * ReturnValue:
+ *		TRUE if the samples were translated, FALSE if the caller must use
+ *		the bit-packing loop instead.
+ *
+ * Possible Errors:
+ *		<none>.
+ */
+static omfBool translateAlignedAudioSamples(omfCStrmSwab_t * src,
+				                 omfAudioMemInfo_t *srcInfo,
+				                 omfCStrmSwab_t * dest,
+				                 omfAudioMemInfo_t	*destInfo,
+				                 omfRational_t		multiplier,
+				                 omfUInt32			numSamples)
+{
+	omfUInt32			srcBytes, destBytes, n, srcIndex, delta, aSample;
+	omfUInt8			*in, *out;
+
+	if(((srcInfo->sampleSize % 8) != 0) || ((destInfo->sampleSize % 8) != 0) ||
+	   (srcInfo->sampleSize > 32) || (destInfo->sampleSize > 32) ||
+	   (srcInfo->sampleSize <= 0) || (destInfo->sampleSize <= 0))
+		return(FALSE);
+	if(multiplier.numerator != 1)		/* Upsampling is left to the bit-packer */
+		return(FALSE);
+	srcBytes = srcInfo->sampleSize / 8;
+	destBytes = destInfo->sampleSize / 8;
+	if(numSamples > dest->buflen / destBytes)
+		return(FALSE);
+
+	delta = 0;
+	if(destInfo->format != srcInfo->format)
+	{
+		if(destInfo->format == kOmfOffsetBinary)
+			delta = (omfUInt32)1 << (srcInfo->sampleSize - 1);
+		if(destInfo->format == kOmfSignedMagnitude)
+			delta = (omfUInt32)0 - ((omfUInt32)1 << (srcInfo->sampleSize - 1));
+	}
+
+	in = (omfUInt8 *)src->buf;
+	out = (omfUInt8 *)dest->buf;
+	if((multiplier.numerator == 1) && (multiplier.denominator == 1))
+	{
+		switch(srcBytes)
+		{
+		case 1:	XLATE_ALIGNED_DEST(GET_SAMPLE8);	break;
+		case 2:	XLATE_ALIGNED_DEST(GET_SAMPLE16);	break;
+		case 3:	XLATE_ALIGNED_DEST(GET_SAMPLE24);	break;
+		default: XLATE_ALIGNED_DEST(GET_SAMPLE32);	break;
+		}
+	}
+	else
+	{
+		/* Decimating: multiplier.denominator source samples are consumed for
+		 * each sample written.  Stop short if that would run off of the end
+		 * of the source buffer.
+		 */
+		for(n = 0, srcIndex = 0; (n < numSamples) && (srcIndex < numSamples);
+			n++, srcIndex += multiplier.denominator, out += destBytes)
+		{
+			in = (omfUInt8 *)src->buf + (srcIndex * srcBytes);
+			switch(srcBytes)
+			{
+			case 1:	aSample = GET_SAMPLE8(in);	break;
+			case 2:	aSample = GET_SAMPLE16(in);	break;
+			case 3:	aSample = GET_SAMPLE24(in);	break;
+			default: aSample = GET_SAMPLE32(in);	break;
+			}
+			aSample += delta;
+			switch(destBytes)
+			{
+			case 1:	PUT_SAMPLE8(out, aSample);	break;
+			case 2:	PUT_SAMPLE16(out, aSample);	break;
+			case 3:	PUT_SAMPLE24(out, aSample);	break;
+			default: PUT_SAMPLE32(out, aSample);	break;
+			}
+		}
+	}
+
+	/* The bit-packing loop clears the whole destination buffer first */
+	n = out - (omfUInt8 *)dest->buf;
+	if(n < dest->buflen)
+		memset(out, 0, dest->buflen - n);
+
+	return(TRUE);
+}
+
 /************************
  * name
  *
@@ -144,6 +283,9 @@ static omfErr_t translateAudioSamples(omfCodecStream_t *stream,
 		extraBits = (omfInt16)((src->buflen * BITS_PER_UINT8)%srcInfo->sampleSize);
 		XASSERT(extraBits == 0, OM_ERR_XFER_NOT_BYTES);
 			
+		if(translateAlignedAudioSamples(src, srcInfo, dest, destInfo, multiplier, numSamples))
+			return(OM_ERR_NONE);
+
 		in = (omfUInt8 *)src->buf;
 		out = (omfUInt8 *)dest->buf;
 		for(n = 0; n < dest->buflen; n++)
@@ -223,6 +365,108 @@ static omfErr_t translateAudioSamples(omfCodecStream_t *stream,
 	return(OM_ERR_NONE);
 }
 
+/* Colour conversion tables for changePixelFormat().  These only depend on
+ * constants, so they are built once by omfsInit(), before any codec (or
+ * decode worker thread) can use them.
+ * YCbCrToRGB values may fall anywhere in -CLAMP_OFFSET..(CLAMP_SIZE-CLAMP_OFFSET-1)
+ * before clamping, so the clamp is folded into the CCIR->RGB table.
+ */
+#define CLAMP_OFFSET	384
+#define CLAMP_SIZE		1024
+
+static omfInt32	CrToR[256], CbToG[256], CrToG[256], CbToB[256];
+static omfUInt8	CCIRtoRGBClamp[CLAMP_SIZE];
+static omfInt32	RToY[256], GToY[256], BToY[256];
+static omfInt32	RToCb[256], GToCb[256], BToCb[256];
+static omfInt32	RToCr[256], GToCr[256], BToCr[256];
+
+/************************
+ * stdCodecInitColorTables	(INTERNAL)
+ *
+ * 		Build the YCbCr<->RGB lookup tables used by changePixelFormat.
+ *		The RGB->YCbCr tables are indexed by the RGB value, with the
+ *		scaling into the 16-235 (CCIR) range already applied.
+ *
+ * Argument Notes:
+ *		Called once from omfsInit(), which must not be called from a
+ *		thread.
+ *
+ * ReturnValue:
+ *		<none>.
+ *
+ * Possible Errors:
+ *		<none>.
+ */
+void stdCodecInitColorTables(void)
+{
+	omfInt32	n, x2, ccir;
+	omfUInt8	RGBToCCIR;
+
+	/* The following RGB->YCbCr->RGB code was lifted directly from 
+	 * jdcolor.c, et. al.
+	 */
+
+	/*
+	 *	R = Y                +  * Cr
+	 *	G = Y - 0.34414 * Cb - 0.71414 * Cr
+	 *	B = Y + 1.77200 * Cb
+	 */
+
+	for (n = 0; n <= MAXJSAMPLE; n++) 
+	{
+		/* i is the actual input pixel value, in the range 0..MAXJSAMPLE */
+		/* The Cb or Cr value we are thinking of is x = i - MAXJSAMPLE/2 */
+		x2 = 2*n - MAXJSAMPLE;	/* twice x */
+		/* Cr=>R value is nearest int to 1.40200 * x */
+		CrToR[n] = (omfInt32)
+				RIGHT_SHIFT(FIX(1.40200/2) * x2 + ONE_HALF, SCALEBITS);
+		/* Cb=>B value is nearest int to 1.77200 * x */
+		CbToB[n] = (omfInt32)
+				RIGHT_SHIFT(FIX(1.77200/2) * x2 + ONE_HALF, SCALEBITS);
+		/* Cr=>G value is scaled-up -0.71414 * x */
+		CrToG[n] = (- FIX(0.71414/2)) * x2;
+		/* Cb=>G value is scaled-up -0.34414 * x */
+		/* We also add in ONE_HALF so that need not do it in inner loop */
+		CbToG[n] = (- FIX(0.34414/2)) * x2 + ONE_HALF;
+	}
+
+	for(n = 0; n < CLAMP_SIZE; n++)
+	{
+		ccir = n - CLAMP_OFFSET;
+		if(ccir <= 16)
+			CCIRtoRGBClamp[n] = 0;
+		else if(ccir >= 235) 
+			CCIRtoRGBClamp[n] = 255;
+		else
+			CCIRtoRGBClamp[n] = (omfUInt8) (((ccir-16) * 255) / 219.0 + 0.5);
+	}
+
+	/* The following RGB->YCbCr code was lifted directly from 
+	 * jccolor.c, et. al.
+	 */
+
+	/*
+	 *	Y  =  0.29900 * R + 0.58700 * G + 0.11400 * B
+	 *	Cb = -0.16874 * R - 0.33126 * G + 0.50000 * B  + MAXJSAMPLE/2
+	 *	Cr =  0.50000 * R - 0.41869 * G - 0.08131 * B  + MAXJSAMPLE/2
+	 */
+	for(n = 0; n <= MAXJSAMPLE; n++)
+	{
+		/* Maps colors in the 0-255 (RGB) range to the 16-235 (CCIR) range. */
+		RGBToCCIR = (omfUInt8) ( ((n * 219) / 255.0) + 16.5);
+
+		RToY[n] =  FIX(0.29900) * RGBToCCIR;
+		GToY[n] =  FIX(0.58700) * RGBToCCIR;
+		BToY[n] =  FIX(0.11400) * RGBToCCIR  + ONE_HALF;
+		RToCb[n] = (-FIX(0.16874)) * RGBToCCIR;
+		GToCb[n] = (-FIX(0.33126)) * RGBToCCIR;
+		BToCb[n] = FIX(0.50000) * RGBToCCIR  + ONE_HALF*(MAXJSAMPLE+1);
+		RToCr[n] = FIX(0.50000) * RGBToCCIR  + ONE_HALF*(MAXJSAMPLE+1);
+		GToCr[n] = (-FIX(0.41869)) * RGBToCCIR;
+		BToCr[n] = (-FIX(0.08131)) * RGBToCCIR;
+	}
+}
+
 static omfErr_t changePixelFormat(omfCodecStream_t	*stream,
 				                 omfUInt8		 	*srcBuf,
 				                 int 		 		srcBufLen,
@@ -238,7 +482,6 @@ static omfErr_t changePixelFormat(omfCodecStream_t	*stream,
 	omfInt16	xformMatrix[MAX_NUM_RGBA_COMPS];
 	omfUInt8	tmpBuf[MAX_NUM_RGBA_COMPS];
 	omfInt16	fillMatrix[MAX_NUM_RGBA_COMPS];
-	omfInt32	colorBuf[MAX_NUM_RGBA_COMPS];
 	omfInt16	fillSize = 0;
 	omfBool		found;
 	YUVType_t	YUVType;
@@ -284,12 +527,9 @@ static omfErr_t changePixelFormat(omfCodecStream_t	*stream,
 		
 		if((srcInfo->pixFormat == kOmfPixYUV) && (destInfo->pixFormat == kOmfPixRGBA))
 		{
-			omfUInt16	y1, y2;
-			omfInt16	Cb, Cr;
-			omfInt32	CrToR[256], CbToG[256], CrToG[256], CbToB[256];
-			omfUInt16	CCIRtoRGB[256];
+			omfInt32	y1, y2, Cb, Cr, rOff, gOff, bOff;
+			omfUInt8	*clamp;
 			omfInt16	saveDestSize;
-			omfInt32	x2;
 
 			saveDestSize = destSize;
 			destSize = 3;
@@ -311,46 +551,8 @@ static omfErr_t changePixelFormat(omfCodecStream_t	*stream,
 				destIncr = destSize;	/* Sizes of 2-pixel 4:4:4 blocks */
 			}
 
-			/* The following RGB->YCbCr->RGB code was lifted directly from 
-			 * jdcolor.c, et. al.
-			 */
-
-			/*
-			 *	R = Y                +  * Cr
-			 *	G = Y - 0.34414 * Cb - 0.71414 * Cr
-			 *	B = Y + 1.77200 * Cb
-			 */
-
-			for (n = 0; n <= MAXJSAMPLE; n++) 
-			{
-				/* i is the actual input pixel value, in the range 0..MAXJSAMPLE */
-				/* The Cb or Cr value we are thinking of is x = i - MAXJSAMPLE/2 */
-				x2 = 2*n - MAXJSAMPLE;	/* twice x */
-				/* Cr=>R value is nearest int to 1.40200 * x */
-				CrToR[n] = (omfInt32)
-						RIGHT_SHIFT(FIX(1.40200/2) * x2 + ONE_HALF, SCALEBITS);
-				/* Cb=>B value is nearest int to 1.77200 * x */
-				CbToB[n] = (omfInt32)
-						RIGHT_SHIFT(FIX(1.77200/2) * x2 + ONE_HALF, SCALEBITS);
-				/* Cr=>G value is scaled-up -0.71414 * x */
-				CrToG[n] = (- FIX(0.71414/2)) * x2;
-				/* Cb=>G value is scaled-up -0.34414 * x */
-				/* We also add in ONE_HALF so that need not do it in inner loop */
-				CbToG[n] = (- FIX(0.34414/2)) * x2 + ONE_HALF;
-			}
-			
-
- 			for(n = 0; n < 256; n++)
-			{
-				if(n <= 16)
-					CCIRtoRGB[n] = 0;
-				else if(n >= 235) 
-					CCIRtoRGB[n] = 255;
-				else
-					CCIRtoRGB[n] = (omfUInt8) (((n-16) * 255) / 219.0 + 0.5);
-			}
+			clamp = CCIRtoRGBClamp + CLAMP_OFFSET;
 
- 
  			intBufLen = (srcBufLen * destSize) / srcSize;
  			for(src = srcBufLen - srcIncr, dest = intBufLen - destIncr;
 				 src >= 0 ;
@@ -362,39 +564,24 @@ static omfErr_t changePixelFormat(omfCodecStream_t	*stream,
 					y1 = srcBuf[src+1] ;
 					Cr = srcBuf[src+2] ;
 					y2 = srcBuf[src+3] ;
-					colorBuf[0] = y1 + CrToR[Cr];
-					colorBuf[1] = y1 +((int) RIGHT_SHIFT(CbToG[Cb] + CrToG[Cr], SCALEBITS));
-					colorBuf[2] = y1 + CbToB[Cb];
-					colorBuf[3] = y2 + CrToR[Cr];
-					colorBuf[4] = y2 +((int) RIGHT_SHIFT(CbToG[Cb] + CrToG[Cr], SCALEBITS));
-					colorBuf[5] = y2 + CbToB[Cb];
-					for(n = 0; n < 6; n++)
-					{
-						if(colorBuf[n] < 0)
-							destBuf[dest+n] = 0;
-						else if(colorBuf[n] > 255)
-							destBuf[dest+n] = 255;
-						else
-							destBuf[dest+n] = (omfUInt8) CCIRtoRGB[ colorBuf[n] ];
-					}
+					rOff = CrToR[Cr];
+					gOff = (int) RIGHT_SHIFT(CbToG[Cb] + CrToG[Cr], SCALEBITS);
+					bOff = CbToB[Cb];
+					destBuf[dest+0] = clamp[y1 + rOff];
+					destBuf[dest+1] = clamp[y1 + gOff];
+					destBuf[dest+2] = clamp[y1 + bOff];
+					destBuf[dest+3] = clamp[y2 + rOff];
+					destBuf[dest+4] = clamp[y2 + gOff];
+					destBuf[dest+5] = clamp[y2 + bOff];
 				}
 				else
 				{
 					y1 = srcBuf[src+0];
 					Cb = srcBuf[src+1];
 					Cr = srcBuf[src+2];
-					colorBuf[0] = y1 + CrToR[Cr];
-					colorBuf[1] = y1 +((int) RIGHT_SHIFT(CbToG[Cb] + CrToG[Cr], SCALEBITS));
-					colorBuf[2] = y1 + CbToB[Cb];
-					for(n = 0; n < 3; n++)
-					{
-						if(colorBuf[n] < 0)
-							destBuf[dest+n] = 0;
-						else if(colorBuf[n] > 255)
-							destBuf[dest+n] = 255;
-						else
-							destBuf[dest+n] = (omfUInt8) CCIRtoRGB[ colorBuf[n] ];
-					}
+					destBuf[dest+0] = clamp[y1 + CrToR[Cr]];
+					destBuf[dest+1] = clamp[y1 + (int) RIGHT_SHIFT(CbToG[Cb] + CrToG[Cr], SCALEBITS)];
+					destBuf[dest+2] = clamp[y1 + CbToB[Cb]];
 				}
 			}
 
@@ -416,11 +603,7 @@ static omfErr_t changePixelFormat(omfCodecStream_t	*stream,
 
 		if((srcInfo->pixFormat == kOmfPixRGBA) && (destInfo->pixFormat == kOmfPixYUV))
 		{
-			omfUInt16	r1, g1, b1, r2, g2, b2;
-			omfInt32	RToY[256], GToY[256], BToY[256];
-			omfInt32	RToCb[256], GToCb[256], BToCb[256];
-			omfInt32	RToCr[256], GToCr[256], BToCr[256];
-			omfUInt16	RGBToCCIR[256];
+			omfUInt8	r1, g1, b1, r2, g2, b2;
 			
 			if(srcSize * 2 == destSize * 3)		/* If 4:2:2 */
 				YUVType = YUV422;
@@ -441,34 +624,9 @@ static omfErr_t changePixelFormat(omfCodecStream_t	*stream,
 			}
 
 
-			/* The following RGB->YCbCr code was lifted directly from 
-			 * jccolor.c, et. al.
-			 */
-			for(n = 0; n <= MAXJSAMPLE; n++)
-			{
-				RToY[n] =  FIX(0.29900) * n;
-				GToY[n] =  FIX(0.58700) * n;
-				BToY[n] =  FIX(0.11400) * n  + ONE_HALF;
-				RToCb[n] = (-FIX(0.16874)) * n;
-				GToCb[n] = (-FIX(0.33126)) * n;
-				BToCb[n] = FIX(0.50000) * n  + ONE_HALF*(MAXJSAMPLE+1);
-				RToCr[n] = FIX(0.50000) * n  + ONE_HALF*(MAXJSAMPLE+1);
-				GToCr[n] = (-FIX(0.41869)) * n;
-				BToCr[n] = (-FIX(0.08131)) * n;
-			}
-			
-			/*
-			 *	Y  =  0.29900 * R + 0.58700 * G + 0.11400 * B
-			 *	Cb = -0.16874 * R - 0.33126 * G + 0.50000 * B  + MAXJSAMPLE/2
-			 *	Cr =  0.50000 * R - 0.41869 * G - 0.08131 * B  + MAXJSAMPLE/2
-			 */
+			/* The tables fold in the RGB->CCIR range mapping */
 
  			intBufLen = (srcBufLen * destSize) / srcSize;
-  			for(n = 0; n < 256; n++)
-			{
-				/* Maps colors in the 0-255 (RGB) range to the 16-235 (CCIR) range. */
-				RGBToCCIR[n] = (omfUInt8) ( ((n * 219) / 255.0) + 16.5);
-			}
 
 			for(src = srcBufLen - srcIncr, dest = intBufLen - destIncr;
 				 src >= 0 ;
@@ -476,12 +634,12 @@ static omfErr_t changePixelFormat(omfCodecStream_t	*stream,
 			{
 				if(YUVType == YUV422)		/* If 4:2:2 */
 				{
-					r1 = RGBToCCIR[ srcBuf[src+0] ];
-					g1 = RGBToCCIR[ srcBuf[src+1] ];
-					b1 = RGBToCCIR[ srcBuf[src+2] ];  
-					r2 = RGBToCCIR[ srcBuf[src+3] ];
-					g2 = RGBToCCIR[ srcBuf[src+4] ];
-					b2 = RGBToCCIR[ srcBuf[src+5] ];
+					r1 = srcBuf[src+0];
+					g1 = srcBuf[src+1];
+					b1 = srcBuf[src+2];  
+					r2 = srcBuf[src+3];
+					g2 = srcBuf[src+4];
+					b2 = srcBuf[src+5];
 					destBuf[dest+0] = (omfUInt8)((RToCb[r1] + GToCb[g1] + BToCb[b1]) >> SCALEBITS);	/* Cb */
 					destBuf[dest+1] = (omfUInt8)((RToY[r1] + GToY[g1] + BToY[b1]) >> SCALEBITS );		/* Y1 */
 					destBuf[dest+2] = (omfUInt8)((RToCr[r2] + GToCr[g2] + BToCr[b2]) >> SCALEBITS);	/* Cr */
@@ -489,9 +647,9 @@ static omfErr_t changePixelFormat(omfCodecStream_t	*stream,
 				}
 				else
 				{
-					r1 = RGBToCCIR[ srcBuf[src+0] ];
-					g1 = RGBToCCIR[ srcBuf[src+1] ];
-					b1 = RGBToCCIR[ srcBuf[src+2] ];
+					r1 = srcBuf[src+0];
+					g1 = srcBuf[src+1];
+					b1 = srcBuf[src+2];
 					destBuf[dest+0] = (omfUInt8)((RToY[r1] + GToY[g1] + BToY[b1]) >> SCALEBITS );		/* Y1 */
 					destBuf[dest+1] = (omfUInt8)((RToCb[r1] + GToCb[g1] + BToCb[b1]) >> SCALEBITS);	/* Cb */
 					destBuf[dest+2] = (omfUInt8)((RToCr[r1] + GToCr[g1] + BToCr[b1]) >> SCALEBITS);	/* Cr */
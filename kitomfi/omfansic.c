@@ -113,20 +113,42 @@
 #include "dos.h"
 #endif
 
-#define USE_CACHE			0
-#define DEFAULT_READCACHE_SIZE	64L *1024L	/* 16L*1024L	*/
-#define NUM_CACHE_BLOCKS		3
+#define USE_CACHE			1
+
+/* Read-only files may be mapped into memory when opened through
+ * mappedContainerMetahandler().  Offsets are then used directly as
+ * pointer offsets, so this needs native 64-bit integers.
+ */
+#if PORT_SYS_UNIX && PORTKEY_INT64_NATIVE && !defined(PORT_FILESYS_40BIT)
+#define USE_MMAP			1
+#else
+#define USE_MMAP			0
+#endif
+
+#if USE_MMAP
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 static CMSize32   uncachedRead(CMRefCon refCon, CMPtr buffer, CMSize32 elementSize, CMCount32 theCount);
 static CMSize32   unoptimizedSeek(CMRefCon refCon, CMCount posOff, CMSeekMode mode);
 
+/*
+ * The read cache holds numCacheBlocks blocks of cacheBlockSize bytes each,
+ * aligned on cacheBlockSize boundaries in the file.  The block buffers are
+ * carved from a single arena so that a read-ahead can fill several adjacent
+ * blocks with one read.  Writes go straight through to the file, and update
+ * any cached copy of the bytes written.
+ */
 typedef struct
 {
-   char			*cacheBuffer;
-   int 			cachePhysSize;
-   int 			cacheLogicalSize;
-   CMCount		startOffset;
-   int 			useTime;
+   char			*cacheBuffer;		/* This block's slice of the arena */
+   omfInt32		cacheLogicalSize;	/* # of valid bytes, 0 if the block is empty */
+   CMCount		startOffset;		/* File offset of the first byte */
+   omfUInt32	useTime;			/* Used for LRU behavior */
 } readCacheEntry_t;
 
 /*
@@ -179,17 +201,38 @@ struct MyRefCon
    omfBool				inTOC;				/* Is current seek pos in the TOC */
    omfBool              tocPositionKnown;
 #if USE_CACHE
-	readCacheEntry_t	cacheEntry[NUM_CACHE_BLOCKS];
-	int 				numAccesses;		/* Used for LRU behavior */
-	CMCount				readPos;
-	CMCount				filePos;
-	CMCount				seekPos;
-	omfBool				writePending;
+	readCacheEntry_t	*cacheEntry;
+	char				*cacheArena;
+	omfInt32			numCacheBlocks;		/* 0 ==> the cache is not in use		*/
+	omfInt32			cacheBlockSize;
+	omfInt32			readAheadBlocks;	/* Extra blocks read on sequential misses */
+	omfUInt32			numAccesses;		/* Used for LRU behavior */
+	CMCount				readPos;			/* Logical position of the next read/write */
+	CMCount				filePos;			/* Actual position of the stream		*/
+	omfBool				filePosValid;
+	omfBool				writePending;		/* Last stream operation was a write	*/
+	CMCount				nextMissOffset;		/* A miss here is a sequential scan		*/
+	omfBool				hitEOF;
+#endif
+	omfBool				mapRequested;		/* Opened by mappedContainerMetahandler	*/
+#if USE_MMAP
+	char				*mapBase;			/* The whole file, or NULL if not mapped */
+	CMCount				mapSize;
+	CMCount				mapPos;
+	omfBool				mapEOF;
 #endif
    char            		pathname[1];		/* start of name of container file		*/
 };
 typedef struct MyRefCon MyRefCon, *MyRefConPtr;
 
+#if USE_CACHE
+static void		cacheSyncFilePos(MyRefConPtr p, omfBool forWrite);
+static readCacheEntry_t *cacheFill(MyRefConPtr p, CMCount blockStart);
+static CMSize32	cachedRead(MyRefConPtr p, CMPtr buffer, CMSize32 bytesToRead);
+static void		cacheWriteThrough(MyRefConPtr p, CMCount writeStart, CMPtr buffer,
+								  CMSize32 bytesWritten);
+#endif
+
 /* The current session data pointer is saved.  It is needed to allocate and
  * free the refCon and to report errors through the session handlers.
  *
@@ -319,9 +362,6 @@ CMRefCon CM_FIXEDARGS createRefConForMyHandlers(CMSession sessionData,
 			                omfHdl_t	file)
 {
 	MyRefConPtr     p = (MyRefConPtr) CMMalloc(NULL, sizeof(MyRefCon) + strlen(pathname), sessionData);
-#if USE_CACHE
-	short			n;
-#endif
 
 	if (p == NULL)
 	{			/* allocation failed!                   */
@@ -344,19 +384,27 @@ CMRefCon CM_FIXEDARGS createRefConForMyHandlers(CMSession sessionData,
     else
       p->swapMeta = FALSE;
 	p->tocPositionKnown = FALSE;
+	p->mapRequested = FALSE;
+#if USE_MMAP
+	p->mapBase = NULL;
+#endif
 
 #if USE_CACHE
-	for(n = 0; n < NUM_CACHE_BLOCKS; n++)
-	{
-		p->cacheEntry[n].cacheBuffer = NULL;
-		p->cacheEntry[n].cachePhysSize = 0;
-		p->cacheEntry[n].cacheLogicalSize = 0;
-	}
+	/* The cache geometry is taken from the session when the refCon is
+	 * created, and the buffers are allocated by the open.
+	 */
+	p->cacheEntry = NULL;
+	p->cacheArena = NULL;
+	p->numCacheBlocks = file->session->readCacheNumBlocks;
+	p->cacheBlockSize = file->session->readCacheBlockSize;
+	p->readAheadBlocks = file->session->readCacheReadAhead;
 	p->numAccesses = 0;
-	omfsCvtInt32toInt64(0, &p->seekPos);
 	omfsCvtInt32toInt64(0, &p->readPos);
 	omfsCvtInt32toInt64(0, &p->filePos);
+	omfsCvtInt32toInt64(-1, &p->nextMissOffset);
+	p->filePosValid = FALSE;
 	p->writePending = FALSE;
+	p->hitEOF = FALSE;
 #endif
 
 	return ((CMRefCon) p);	/* return refCon as anonymous ptr       */
@@ -386,6 +434,7 @@ CMRefCon CM_FIXEDARGS createRefConForMyHandlers(CMSession sessionData,
 CM_CFUNCTIONS
 
 static CMRefCon open_Handler(CMRefCon attributes, CMOpenMode mode);
+static CMRefCon mappedOpen_Handler(CMRefCon attributes, CMOpenMode mode);
 static void     close_Handler(CMRefCon refCon);
 static CMSize32   flush_Handler(CMRefCon refCon);
 static CMSize32   seek_Handler(CMRefCon refCon, CMCount posOff, CMSeekMode mode);
@@ -527,6 +576,26 @@ CMHandlerAddr CM_FIXEDARGS containerMetahandler(CMType targetType, CMconst_CMGlo
 }
 
 
+/*--------------------------------------------------------------------------*
+ | mappedContainerMetahandler - metahandler for memory-mapped read access   |
+ *--------------------------------------------------------------------------*
+
+ An alternative to containerMetahandler() which maps files opened for reading into memory,
+ so that the read and seek handlers become copies and pointer arithmetic instead of stream
+ calls.  Files opened for writing or updating, or which cannot be mapped, fall back to
+ the stream handlers.  The handlers are otherwise the same, so install it with
+ omfsSetSessionIOHandlers() along with createRefConForMyHandlers().
+*/
+
+CMHandlerAddr CM_FIXEDARGS mappedContainerMetahandler(CMType targetType, CMconst_CMGlobalName operationType)
+{
+	if (strcmp((char *) operationType, (char *) CMOpenOpType) == 0)
+		return ((CMHandlerAddr) mappedOpen_Handler);
+	else
+		return (containerMetahandler(targetType, operationType));
+}
+
+
 #if ENABLE_TRACING
 /*---------------------------------------------------*
  | setHandlersTrace - turn handler tracing on or off |
@@ -629,12 +698,72 @@ static CMRefCon open_Handler(CMRefCon attributes, CMOpenMode mode)
 	MyRefConPtr     p = (MyRefConPtr) attributes;
 	char			*ansiMode = (char *)mode;
 #if USE_CACHE
-	short			n;
+	omfInt32		n;
 #endif
 #ifdef PORT_FILESYS_40BIT
 	mode_t	perms;
 #endif
 
+#if USE_MMAP
+	if(p->mapRequested && (strcmp(ansiMode, "rb") == 0))
+	{
+		int			fd;
+		struct stat	info;
+		void		*base;
+
+		fd = open(p->pathname, O_RDONLY);
+		if((fd != -1) && (fstat(fd, &info) == 0) && (info.st_size > 0))
+		{
+			base = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if(base != MAP_FAILED)
+			{
+				p->mapBase = (char *)base;
+				p->mapSize = info.st_size;
+				p->mapPos = 0;
+				p->mapEOF = FALSE;
+			}
+		}
+		if(fd != -1)
+			close(fd);			/* The mapping stays valid */
+
+		if(p->mapBase != NULL)
+		{
+			p->f = NULL;
+			p->fTOC = NULL;
+#if USE_CACHE
+			p->numCacheBlocks = 0;
+#endif
+			p->haveSize = 0;
+			p->seekValid = 0;
+			return (attributes);
+		}
+	}
+#endif
+
+#if USE_CACHE
+	if(p->numCacheBlocks > 0)
+	{
+		p->cacheEntry = (readCacheEntry_t *)omfsMalloc(p->numCacheBlocks * sizeof(readCacheEntry_t));
+		p->cacheArena = (char *)omfsMalloc(p->numCacheBlocks * p->cacheBlockSize);
+		if((p->cacheEntry == NULL) || (p->cacheArena == NULL))
+		{
+			if(p->cacheEntry != NULL)
+				omfsFree(p->cacheEntry);
+			if(p->cacheArena != NULL)
+				omfsFree(p->cacheArena);
+			p->cacheEntry = NULL;
+			p->cacheArena = NULL;
+			p->numCacheBlocks = 0;		/* Run uncached rather than fail */
+		}
+		for(n = 0; n < p->numCacheBlocks; n++)
+		{
+			p->cacheEntry[n].cacheBuffer = p->cacheArena + (n * p->cacheBlockSize);
+			p->cacheEntry[n].cacheLogicalSize = 0;
+			p->cacheEntry[n].useTime = 0;
+		}
+	}
+#endif
+
 #ifdef PORT_FILESYS_40BIT
 	perms = S_IRUSR|S_IWUSR|S_IRGRP|S_IWGRP|S_IROTH|S_IWOTH;
 	p->fTOC = -1;
@@ -645,10 +774,12 @@ static CMRefCon open_Handler(CMRefCon attributes, CMOpenMode mode)
 	else
 	{
 		p->f = open(p->pathname, O_RDONLY, perms);
-#if !USE_CACHE
+#if USE_CACHE
+		if ((p->f != -1) && (p->numCacheBlocks == 0))
+#else
 		if (p->f != -1)
-			p->fTOC = open(p->pathname, O_RDONLY, perms);
 #endif
+			p->fTOC = open(p->pathname, O_RDONLY, perms);
 	}
 	if (p->f == -1)
 	  {			/* oops, open didn't work!      */
@@ -666,14 +797,16 @@ static CMRefCon open_Handler(CMRefCon attributes, CMOpenMode mode)
 		return (NULL);
 	  }
 	setvbuf(p->f, NULL, _IOFBF, 6000);	/* enlarge the I/O buffer       */
-#if !USE_CACHE
+#if USE_CACHE
+	if((strcmp(ansiMode, "rb") == 0) && (p->numCacheBlocks == 0))
+#else
 	if(strcmp(ansiMode, "rb") == 0)
+#endif
 	{
 		p->fTOC = fopen(p->pathname, (char *) mode);
 		setvbuf(p->fTOC, NULL, _IOFBF, 6000);	/* enlarge the I/O buffer       */
 	}
 	else
-#endif
 		p->fTOC = NULL;
 #endif
 
@@ -684,19 +817,26 @@ static CMRefCon open_Handler(CMRefCon attributes, CMOpenMode mode)
 
 	p->haveSize = 0;	/* size is not known            */
 	p->seekValid = 0;	/* no seek done yet either      */
-#if USE_CACHE
-	for(n = 0; n < NUM_CACHE_BLOCKS; n++)
-	{
-		p->cacheEntry[n].cacheBuffer = (char *)omfsMalloc(DEFAULT_READCACHE_SIZE);
-		if(p->cacheEntry[n].cacheBuffer != NULL)
-			p->cacheEntry[n].cachePhysSize = DEFAULT_READCACHE_SIZE;
-		p->cacheEntry[n].cacheLogicalSize = 0;
-	}
-#endif
 
 	return (attributes);
 }
 
+/*-------------------------------------------------------------------*
+ | mappedOpen_Handler - open a container, mapping it if read-only    |
+ *-------------------------------------------------------------------*
+
+ The open handler returned by mappedContainerMetahandler().  Marks the refCon so that
+ open_Handler() will try to map the file before falling back to stream I/O.
+*/
+
+static CMRefCon mappedOpen_Handler(CMRefCon attributes, CMOpenMode mode)
+{
+	MyRefConPtr     p = (MyRefConPtr) attributes;
+
+	p->mapRequested = TRUE;
+	return (open_Handler(attributes, mode));
+}
+
 
 /*------------------------------------------*
  | close_Handler - close the container file |
@@ -712,10 +852,16 @@ static CMRefCon open_Handler(CMRefCon attributes, CMOpenMode mode)
 static void     close_Handler(CMRefCon refCon)
 {
 	MyRefConPtr     p = (MyRefConPtr) refCon;
-#if USE_CACHE
-	short			n;
-#endif
 
+#if USE_MMAP
+	if (p->mapBase != NULL)
+	{
+		munmap(p->mapBase, (size_t)p->mapSize);
+		p->mapBase = NULL;
+	}
+	else
+#endif
+	{
 #ifdef PORT_FILESYS_40BIT
 	close(p->f);		/* close it...                  */
 	if(p->fTOC != -1)
@@ -725,6 +871,7 @@ static void     close_Handler(CMRefCon refCon)
 	if(p->fTOC != NULL)
 		fclose(p->fTOC);
 #endif
+	}
 
 #if ENABLE_TRACING
 	if (p->tracing)		/* tracing...                   */
@@ -733,11 +880,14 @@ static void     close_Handler(CMRefCon refCon)
 			"//////////////////////////////////////////////\n", p->pathname);
 #endif
 #if USE_CACHE
-	for(n = 0; n < NUM_CACHE_BLOCKS; n++)
-	{
-		if(p->cacheEntry[n].cacheBuffer != NULL)
-			omfsFree(p->cacheEntry[n].cacheBuffer);
-	}
+	p->file->session->readCacheHits += p->file->readCacheHits;
+	p->file->session->readCacheMisses += p->file->readCacheMisses;
+	p->file->readCacheHits = 0;
+	p->file->readCacheMisses = 0;
+	if(p->cacheEntry != NULL)
+		omfsFree(p->cacheEntry);
+	if(p->cacheArena != NULL)
+		omfsFree(p->cacheArena);
 #endif
 
 	CMFree(NULL, p, p->sessionData);	/* bye, bye, refcon...          */
@@ -765,6 +915,10 @@ static CMSize32   flush_Handler(CMRefCon refCon)
 	MyRefConPtr     p = (MyRefConPtr) refCon;
 	int             result;
 
+#if USE_MMAP
+	if (p->mapBase != NULL)
+		return (0);			/* Nothing is ever written */
+#endif
 #ifdef PORT_FILESYS_40BIT
 	result = 0;
 #else
@@ -833,12 +987,31 @@ static CMSize32 seek_Handler(CMRefCon refCon, CMCount posOff, CMSeekMode mode)
 			((mode == kCMSeekEnd) ? "kCMSeekEnd" : "kCMSeekCurrent"),
 			result);
 #endif
+#if USE_MMAP
+	if (p->mapBase != NULL)
+	{
+		if (mode == kCMSeekCurrent)
+			posOff += p->mapPos;
+		else if (mode == kCMSeekEnd)
+			posOff += p->mapSize;
+		if (posOff < 0)
+			return (1);
+		p->mapPos = posOff;
+		p->mapEOF = FALSE;
+		return (0);
+	}
+#endif
 #if USE_CACHE
-  	if (mode == kCMSeekSet)
-  	{
-  		p->seekPos = posOff;
-  		p->readPos = posOff;
-  		result = posOff32;
+	/* Absolute and relative seeks only move the logical position.  The
+	 * stream itself is positioned when a read misses or a write is done.
+	 */
+	if ((p->numCacheBlocks > 0) && (mode != kCMSeekEnd))
+	{
+		if (mode == kCMSeekCurrent)
+			omfsAddInt64toInt64(p->readPos, &posOff);
+		p->readPos = posOff;
+		p->hitEOF = FALSE;
+		result = 0;
 	}
 	else
 	{
@@ -880,8 +1053,9 @@ static CMSize32   unoptimizedSeek(CMRefCon refCon, CMCount posOff, CMSeekMode mo
 	result = seekResult;
 #if USE_CACHE
 	p->readPos = *((omfInt64 *)&seekResult);
-	p->seekPos = p->readPos;
 	p->filePos = p->readPos;
+	p->filePosValid = TRUE;
+	p->hitEOF = FALSE;
 #endif
 #else
 	omfsDecomposeInt64(posOff, &upper, &pos32);
@@ -893,8 +1067,9 @@ static CMSize32   unoptimizedSeek(CMRefCon refCon, CMCount posOff, CMSeekMode mo
 
 #if USE_CACHE && !defined(PORT_FILESYS_40BIT)
 	omfsCvtInt32toInt64(ftell(p->f), &p->readPos);
-	p->seekPos = p->readPos;
 	p->filePos = p->readPos;
+	p->filePosValid = TRUE;
+	p->hitEOF = FALSE;
 #endif
 	p->seekValid = 1;	/* indicate seek has been done          */
 	p->lastSeekMode = mode;	/* remember the mode that we just used  */
@@ -927,11 +1102,26 @@ static CMSize   tell_Handler(CMRefCon refCon)
 {
 	MyRefConPtr     p = (MyRefConPtr) refCon;
 #ifdef PORT_FILESYS_40BIT
-	off64_t          posOff = lseek64(p->f, 0, SEEK_CUR);	/* get position                 */
+	off64_t          posOff;
 #else
-	int             posOff = ftell(p->f);	/* get position                 */
+	int             posOff;
 #endif
-	CMCount largeOffset = *((CMCount *)&posOff);
+	CMCount largeOffset;
+
+#if USE_MMAP
+	if (p->mapBase != NULL)
+		return (p->mapPos);
+#endif
+#if USE_CACHE
+	if (p->numCacheBlocks > 0)
+		return (p->readPos);	/* The stream may be elsewhere */
+#endif
+#ifdef PORT_FILESYS_40BIT
+	posOff = lseek64(p->f, 0, SEEK_CUR);	/* get position                 */
+#else
+	posOff = ftell(p->f);	/* get position                 */
+#endif
+	largeOffset = *((CMCount *)&posOff);
 
 #if ENABLE_TRACING
 	if (p->tracing)		/* tracing...                   */
@@ -1016,15 +1206,6 @@ static CMSize32   read_Handler(CMRefCon refCon, CMPtr buffer, CMSize32 elementSi
 {
 	MyRefConPtr     p = (MyRefConPtr) refCon;
 	CMSize32          amountRead, bytesToRead;
-#if USE_CACHE
-	int 			oldestCache, cacheOffset;
-	short			n, lruCacheEntry;
-	omfBool			found;
-	readCacheEntry_t *entry;
-	CMCount			offset64;
-	omfErr_t		stat;
-	omfInt32		tellPos, filePos, seekPos, readPos;
-#endif
 
 #if ENABLE_TRACING
    unsigned int    fileOffset;
@@ -1034,79 +1215,27 @@ static CMSize32   read_Handler(CMRefCon refCon, CMPtr buffer, CMSize32 elementSi
 #endif
 
 	bytesToRead = elementSize * theCount;
-#if USE_CACHE
-	if(p->writePending)
+#if USE_MMAP
+	if (p->mapBase != NULL)
 	{
-		tellPos = ftell(p->f);	/* tracing (need initial offset)  */
-/*		printf("%ld %d %d %d\n", tellPos, p->filePos.words[3], p->readPos.words[3], p->seekPos.words[3]);	*/
-		(void)unoptimizedSeek(refCon, p->seekPos, kCMSeekSet);
-		p->writePending = !p->writePending;
+		if (p->mapPos >= p->mapSize)
+			amountRead = 0;
+		else if (p->mapSize - p->mapPos < bytesToRead)
+			amountRead = (CMSize32)(p->mapSize - p->mapPos);
+		else
+			amountRead = bytesToRead;
+		memcpy(buffer, p->mapBase + p->mapPos, amountRead);
+		p->mapPos += amountRead;
+		p->mapEOF = (amountRead < bytesToRead);
 	}
-
-	p->numAccesses++;					/* Just a counter used to determine least-recently-used */
-	if(bytesToRead > DEFAULT_READCACHE_SIZE)	/* read directly */
-	{
-/*		seek_Handler(refCon, p->readPos, kCMSeekSet);		*/
+	else
 #endif
-		amountRead = uncachedRead(refCon, buffer, 1, bytesToRead);
 #if USE_CACHE
-		omfsAddInt32toInt64(amountRead, &p->readPos);
-	}
+	if (p->numCacheBlocks > 0)
+		amountRead = cachedRead(p, buffer, bytesToRead);
 	else
-	{
-		found = FALSE;
-		for(n = 0; n < NUM_CACHE_BLOCKS && !found; n++)
-		{
-			offset64 = p->readPos;
-			stat = omfsSubInt64fromInt64(p->cacheEntry[n].startOffset, &offset64);
-			if(stat == OM_ERR_NONE)
-			{
-				stat = omfsTruncInt64toInt32(offset64, &cacheOffset);	/* OK MAXREAD */
-			}
-			if((stat == OM_ERR_NONE) && (cacheOffset >= 0) &&
-			   (cacheOffset + bytesToRead) < (p->cacheEntry[n].cacheLogicalSize))
-			{
-				memcpy(buffer, p->cacheEntry[n].cacheBuffer + cacheOffset, bytesToRead);
-				amountRead = bytesToRead;
-				p->cacheEntry[n].useTime = p->numAccesses;
-				omfsAddInt32toInt64(amountRead, &p->readPos);
-				found = TRUE;
-			}
-		}
-
-		if(!found)
-		{
-			lruCacheEntry = -1;
-			for(n = 0; n < NUM_CACHE_BLOCKS && (lruCacheEntry < 0); n++)
-			{
-				if(p->cacheEntry[n].cacheLogicalSize == 0)
-					lruCacheEntry = n;
-			}
-
-			oldestCache = p->numAccesses;
-			for(n = 0; n < NUM_CACHE_BLOCKS && (lruCacheEntry < 0); n++)
-			{
-				if(p->cacheEntry[n].useTime < oldestCache)
-				{
-					lruCacheEntry = n;
-					oldestCache = p->cacheEntry[n].useTime;
-				}
-			}
-
-			entry = &p->cacheEntry[lruCacheEntry];
-			entry->startOffset = p->readPos;
-			seek_Handler(refCon, p->readPos, kCMSeekSet);
-
-			amountRead = uncachedRead(refCon, entry->cacheBuffer, 1, entry->cachePhysSize);
-			entry->cacheLogicalSize = amountRead;
-			if(amountRead > bytesToRead)
-				amountRead = bytesToRead;
-			entry->useTime = p->numAccesses;
-			memcpy(buffer, entry->cacheBuffer, amountRead);
-			omfsAddInt32toInt64(amountRead, &p->readPos);
-		}
-	}
 #endif
+		amountRead = uncachedRead(refCon, buffer, 1, bytesToRead);
 
 #if ENABLE_TRACING
 	if (p->tracing)
@@ -1131,11 +1260,6 @@ static CMSize32   uncachedRead(CMRefCon refCon, CMPtr buffer, CMSize32 elementSi
 	int             bytesToRead, bytesInSegment;
 #endif
 
-#if USE_CACHE
-	if(omfsInt64NotEqual(p->seekPos, p->filePos))
-		(void)unoptimizedSeek(refCon, p->seekPos, kCMSeekSet);
-#endif
-
 #ifdef PORT_FILESYS_40BIT
 	if(p->inTOC && (p->fTOC != -1) && (p->lastSeekMode == kCMSeekSet))
 		amountRead = read(p->fTOC, (char *) buffer, elementSize * theCount);
@@ -1189,14 +1313,249 @@ static CMSize32   uncachedRead(CMRefCon refCon, CMPtr buffer, CMSize32 elementSi
 	}
 #endif
 
+	return (amountRead);
+}
+
 #if USE_CACHE
+/*---------------------------------------------------------------*
+ | cacheSyncFilePos - move the stream to the logical position    |
+ *---------------------------------------------------------------*
+
+ Positions the stream at p->readPos before a physical read or write.  ANSI requires a seek
+ between a write and a following read (and vice versa) on the same stream, so a seek is
+ also forced whenever the direction changes.
+*/
+
+static void cacheSyncFilePos(MyRefConPtr p, omfBool forWrite)
+{
+	if(!p->filePosValid || omfsInt64NotEqual(p->filePos, p->readPos) ||
+	   (p->writePending != forWrite))
+	{
+		(void)unoptimizedSeek((CMRefCon)p, p->readPos, kCMSeekSet);
+	}
+	p->writePending = forWrite;
+}
+
+/*---------------------------------------------------------------*
+ | cacheFill - read the block at blockStart into the cache       |
+ *---------------------------------------------------------------*
+
+ Loads the block starting at blockStart into the least-recently-used entry.  If the miss
+ continues a sequential scan (as when the TOC is being read), the following
+ readAheadBlocks blocks are loaded into the adjacent entries with the same read.  Returns
+ the entry holding blockStart, or NULL if nothing could be read.
+*/
+
+static readCacheEntry_t *cacheFill(MyRefConPtr p, CMCount blockStart)
+{
+	readCacheEntry_t	*entry;
+	omfInt32			victim, numBlocks, n, amountLeft;
+	omfUInt32			oldest;
+	CMSize32			amountRead;
+	CMCount				blockEnd, blockPos, savePos;
+
+	victim = 0;
+	oldest = p->cacheEntry[0].useTime;
+	for(n = 0; n < p->numCacheBlocks; n++)
+	{
+		if(p->cacheEntry[n].cacheLogicalSize == 0)
+		{
+			victim = n;
+			break;
+		}
+		if(p->cacheEntry[n].useTime < oldest)
+		{
+			victim = n;
+			oldest = p->cacheEntry[n].useTime;
+		}
+	}
+
+	numBlocks = 1;
+	if((p->readAheadBlocks > 0) && omfsInt64Equal(blockStart, p->nextMissOffset))
+	{
+		numBlocks += p->readAheadBlocks;
+		if(victim + numBlocks > p->numCacheBlocks)
+			numBlocks = p->numCacheBlocks - victim;
+	}
+
+	/* Drop any other copies of the blocks about to be loaded */
+	blockEnd = blockStart;
+	omfsAddInt32toInt64(numBlocks * p->cacheBlockSize, &blockEnd);
+	for(n = 0; n < p->numCacheBlocks; n++)
+	{
+		entry = &p->cacheEntry[n];
+		if((n < victim || n >= victim + numBlocks) && (entry->cacheLogicalSize != 0) &&
+		   omfsInt64GreaterEqual(entry->startOffset, blockStart) &&
+		   omfsInt64Less(entry->startOffset, blockEnd))
+			entry->cacheLogicalSize = 0;
+	}
+
+	savePos = p->readPos;
+	p->readPos = blockStart;
+	cacheSyncFilePos(p, FALSE);
+	amountRead = uncachedRead((CMRefCon)p, p->cacheEntry[victim].cacheBuffer, 1,
+							  numBlocks * p->cacheBlockSize);
 	omfsAddInt32toInt64(amountRead, &p->filePos);
-	p->seekPos = p->filePos;
-#endif
+	p->readPos = savePos;
 
-	return (amountRead);
+	blockPos = blockStart;
+	amountLeft = amountRead;
+	for(n = victim; n < victim + numBlocks; n++)
+	{
+		entry = &p->cacheEntry[n];
+		entry->startOffset = blockPos;
+		entry->cacheLogicalSize = (amountLeft > p->cacheBlockSize ? p->cacheBlockSize : amountLeft);
+		entry->useTime = p->numAccesses;
+		amountLeft -= entry->cacheLogicalSize;
+		omfsAddInt32toInt64(p->cacheBlockSize, &blockPos);
+	}
+	p->nextMissOffset = blockEnd;
+
+	if(amountRead == 0)
+		return(NULL);
+	return(&p->cacheEntry[victim]);
 }
 
+/*---------------------------------------------------------------*
+ | cachedRead - satisfy a read from the cache                    |
+ *---------------------------------------------------------------*
+
+ Copies bytesToRead bytes from p->readPos, loading blocks as needed.  Reads of a block or
+ more go directly to the file.  Hits and misses are counted in the file, and added into the
+ session's totals when the container is closed.
+*/
+
+static CMSize32 cachedRead(MyRefConPtr p, CMPtr buffer, CMSize32 bytesToRead)
+{
+	omfHdl_t			file = p->file;
+	readCacheEntry_t	*entry;
+	CMSize32			amountRead, bytesThisBlock;
+	CMCount				blockStart, quotient;
+	omfInt32			blockOffset, n;
+	char				*dest = (char *)buffer;
+
+	p->numAccesses++;
+	if(bytesToRead >= (CMSize32)p->cacheBlockSize)	/* read directly */
+	{
+		cacheSyncFilePos(p, FALSE);
+		amountRead = uncachedRead((CMRefCon)p, buffer, 1, bytesToRead);
+		omfsAddInt32toInt64(amountRead, &p->filePos);
+		p->readPos = p->filePos;
+		p->hitEOF = (amountRead < bytesToRead);
+		return(amountRead);
+	}
+
+	amountRead = 0;
+	while(amountRead < bytesToRead)
+	{
+		omfsDivideInt64byInt32(p->readPos, p->cacheBlockSize, &quotient, &blockOffset);
+		blockStart = p->readPos;
+		omfsSubInt32fromInt64(blockOffset, &blockStart);
+
+		entry = NULL;
+		for(n = 0; n < p->numCacheBlocks; n++)
+		{
+			if((p->cacheEntry[n].cacheLogicalSize != 0) &&
+			   omfsInt64Equal(p->cacheEntry[n].startOffset, blockStart))
+			{
+				entry = &p->cacheEntry[n];
+				break;
+			}
+		}
+		if(entry != NULL)
+			file->readCacheHits++;
+		else
+		{
+			file->readCacheMisses++;
+			entry = cacheFill(p, blockStart);
+			if(entry == NULL)
+				break;
+		}
+
+		entry->useTime = p->numAccesses;
+		if(blockOffset >= entry->cacheLogicalSize)
+			break;								/* Past the end of the file */
+		bytesThisBlock = entry->cacheLogicalSize - blockOffset;
+		if(bytesThisBlock > bytesToRead - amountRead)
+			bytesThisBlock = bytesToRead - amountRead;
+		memcpy(dest, entry->cacheBuffer + blockOffset, bytesThisBlock);
+		dest += bytesThisBlock;
+		amountRead += bytesThisBlock;
+		omfsAddInt32toInt64(bytesThisBlock, &p->readPos);
+
+		if((entry->cacheLogicalSize < p->cacheBlockSize) && (amountRead < bytesToRead))
+			break;								/* Short block, so at end of file */
+	}
+
+	p->hitEOF = (amountRead < bytesToRead);
+	return(amountRead);
+}
+
+/*---------------------------------------------------------------*
+ | cacheWriteThrough - keep cached blocks coherent with a write  |
+ *---------------------------------------------------------------*
+
+ Copies the bytes just written at writeStart into any cached block which they overlap.
+ A block is extended if the write runs past its valid bytes, and dropped if the write
+ would leave a hole in it or moves the end of file out from under it.
+*/
+
+static void cacheWriteThrough(MyRefConPtr p, CMCount writeStart, CMPtr buffer,
+							  CMSize32 bytesWritten)
+{
+	readCacheEntry_t	*entry;
+	CMCount				writeEnd, blockEnd, delta;
+	omfInt32			n, offsetInBlock, offsetInBuffer, len;
+
+	writeEnd = writeStart;
+	omfsAddInt32toInt64(bytesWritten, &writeEnd);
+	for(n = 0; n < p->numCacheBlocks; n++)
+	{
+		entry = &p->cacheEntry[n];
+		if(entry->cacheLogicalSize == 0)
+			continue;
+		blockEnd = entry->startOffset;
+		omfsAddInt32toInt64(p->cacheBlockSize, &blockEnd);
+		if(omfsInt64LessEqual(writeEnd, entry->startOffset))
+			continue;
+		if(omfsInt64GreaterEqual(writeStart, blockEnd))
+		{
+			/* A short block marks the old end of file, which has now moved */
+			if(entry->cacheLogicalSize < p->cacheBlockSize)
+				entry->cacheLogicalSize = 0;
+			continue;
+		}
+
+		if(omfsInt64GreaterEqual(writeStart, entry->startOffset))
+		{
+			delta = writeStart;
+			omfsSubInt64fromInt64(entry->startOffset, &delta);
+			omfsTruncInt64toInt32(delta, &offsetInBlock);	/* OK MAXREAD */
+			offsetInBuffer = 0;
+		}
+		else
+		{
+			delta = entry->startOffset;
+			omfsSubInt64fromInt64(writeStart, &delta);
+			omfsTruncInt64toInt32(delta, &offsetInBuffer);	/* OK MAXREAD */
+			offsetInBlock = 0;
+		}
+		len = p->cacheBlockSize - offsetInBlock;
+		if(len > (omfInt32)bytesWritten - offsetInBuffer)
+			len = bytesWritten - offsetInBuffer;
+
+		if(offsetInBlock > entry->cacheLogicalSize)
+			entry->cacheLogicalSize = 0;		/* Would leave a hole */
+		else
+		{
+			memcpy(entry->cacheBuffer + offsetInBlock, (char *)buffer + offsetInBuffer, len);
+			if(offsetInBlock + len > entry->cacheLogicalSize)
+				entry->cacheLogicalSize = offsetInBlock + len;
+		}
+	}
+}
+#endif
+
 
 
 /*------------------------------------------------------------------*
@@ -1221,7 +1580,8 @@ static CMSize32   write_Handler(CMRefCon refCon, CMPtr buffer, CMSize32 elementS
 	size_t          bytesPerBlock, bytesOut, partWritten;
 #endif
 #if USE_CACHE
-	short			n;
+	CMCount			writeStart;
+	CMPtr			origBuffer = buffer;
 #endif
 
 #if ENABLE_TRACING
@@ -1232,12 +1592,16 @@ static CMSize32   write_Handler(CMRefCon refCon, CMPtr buffer, CMSize32 elementS
 						 * offset)  */
 #endif
 
+#if USE_MMAP
+	if (p->mapBase != NULL)
+		return (0);			/* Mapped files are read-only */
+#endif
 #if USE_CACHE
-	if(omfsInt64NotEqual(p->seekPos, p->filePos))
-		(void)unoptimizedSeek(refCon, p->seekPos, kCMSeekSet);
-
-	for(n = 0; n < NUM_CACHE_BLOCKS; n++)
-		p->cacheEntry[n].cacheLogicalSize = 0;		/* Just invalidate the whole thing to be safe */
+	if(p->numCacheBlocks > 0)
+	{
+		cacheSyncFilePos(p, TRUE);
+		writeStart = p->readPos;
+	}
 #endif
 
 	if (theCount > 0)
@@ -1299,10 +1663,13 @@ static CMSize32   write_Handler(CMRefCon refCon, CMPtr buffer, CMSize32 elementS
 		amountWritten = 0;
 
 #if USE_CACHE
-	omfsAddInt32toInt64(amountWritten, &p->filePos);
-	p->seekPos = p->filePos;
-	p->readPos = p->filePos;
-	p->writePending = TRUE;
+	if(p->numCacheBlocks > 0)
+	{
+		cacheWriteThrough(p, writeStart, origBuffer, amountWritten);
+		omfsAddInt32toInt64(amountWritten, &p->filePos);
+		p->readPos = p->filePos;
+		p->hitEOF = FALSE;
+	}
 #endif
 
 #if ENABLE_TRACING
@@ -1332,10 +1699,22 @@ static CMSize32   write_Handler(CMRefCon refCon, CMPtr buffer, CMSize32 elementS
 static CMEofStatus eof_Handler(CMRefCon refCon)
 {
 	MyRefConPtr     p = (MyRefConPtr) refCon;
+	int             status;
+
+#if USE_MMAP
+	if (p->mapBase != NULL)
+		status = p->mapEOF;
+	else
+#endif
+#if USE_CACHE
+	if (p->numCacheBlocks > 0)
+		status = p->hitEOF;
+	else
+#endif
 #ifdef PORT_FILESYS_40BIT
-	int             status = 0;
+		status = 0;
 #else
-	int             status = (int ) feof(p->f);
+		status = (int ) feof(p->f);
 #endif
 
 #if ENABLE_TRACING
@@ -1424,6 +1803,10 @@ static CMSize   containerSize_Handler(CMRefCon refCon)
 	omfsCvtInt32toInt64(0, &zero);
 #endif
 
+#if USE_MMAP
+	if (p->mapBase != NULL)
+		return (p->mapSize);
+#endif
 	/*	if (p->haveSize == 0) !!! */
 	{			/* if size is not known...      */
 #ifdef PORT_FILESYS_40BIT
@@ -1451,6 +1834,11 @@ static CMSize   containerSize_Handler(CMRefCon refCon)
 	largeSize = p->fileSize;
 #else
 	omfsCvtInt32toInt64(p->fileSize, &largeSize);
+#endif
+#if USE_CACHE
+	p->readPos = largeSize;		/* The stream is now at the end */
+	p->filePos = largeSize;
+	p->filePosValid = TRUE;
 #endif
 	return (largeSize);
 }
@@ -171,6 +171,28 @@ static omfErr_t objectPurgeTree(
     omfHdl_t file,    /* IN - File Handle */
 	omfObject_t obj);  /* IN - Object to purge */
 
+static omfBool MobIsOfKind(
+    omfHdl_t file,
+	omfMobObj_t mob,
+	omfMobKind_t mobKind,
+	omfErr_t *omfError);
+
+static omfErr_t GetMobIndex(
+    omfHdl_t file,
+	struct omfMobIndex **result);
+
+static omfErr_t FindMobsOfKind(
+    omfHdl_t file,
+	omfMobKind_t mobKind,
+	omfObject_t **mobs,
+	omfInt32 *numMobs);
+
+static omfErr_t FindMobsByName(
+    omfHdl_t file,
+	omfString name,
+	omfObject_t **mobs,
+	omfInt32 *numMobs);
+
 /*******************************/
 /* Functions                   */
 /*******************************/
@@ -3870,6 +3892,7 @@ omfErr_t omfiSourceClipResolveRef(
 		CHECK(omfsGetHeadObject(file, &head));
 
 		/* Get the mob out of the mob hash table */
+		CHECK(omfsTableFill(file->mobs));
 		entry = (mobTableEntry_t *)omfsTableUIDLookupPtr(file->mobs, 
 												sourceRef.sourceID);
 		if (entry != NULL)
@@ -4532,6 +4555,7 @@ omfErr_t omfiIteratorAlloc(
 			RAISE(OM_ERR_NOMEMORY);
 		  }
 		tmpHdl->tableIter = NULL;
+		tmpHdl->mobList = NULL;
 		CHECK(omfiIteratorClear(file, tmpHdl));
 	  }
 	XEXCEPT
@@ -4591,6 +4615,8 @@ omfErr_t omfiIteratorDispose(
 			omOptFree(file, iterHdl->tableIter);
 			iterHdl->tableIter = NULL;
 		  }
+		if (iterHdl->mobList)
+		  omOptFree(file, iterHdl->mobList);
 		omOptFree(file, iterHdl);
 	  }
 	
@@ -4642,6 +4668,449 @@ omfErr_t omfiIteratorClear(
 		omOptFree(file, iterHdl->tableIter);
 		iterHdl->tableIter = NULL;
 	  }
+	if (iterHdl->mobList)
+	  {
+		omOptFree(file, iterHdl->mobList);
+		iterHdl->mobList = NULL;
+	  }
+	iterHdl->mobListSize = 0;
+	iterHdl->mobListNext = 0;
+
+	return(OM_ERR_NONE);
+}
+
+/*************************************************************************
+ * Mob indexes
+ *
+ *      omfiGetNextMob() answers kByMobKind and kByName searches from
+ *      indexes of file->mobs, so that a search costs time in proportion
+ *      to the number of matches rather than the number of mobs.  The
+ *      list of mobs of a kind, and the table of mob names, are each built
+ *      the first time they are needed, in mob table order.  All of them
+ *      are dropped when file->mobEditCount (bumped by mob table adds and
+ *      removes, and by writes of the properties that name a mob or
+ *      decide its kind) no longer matches file->mobIndexEdits, and are
+ *      rebuilt on demand.
+ *************************************************************************/
+typedef struct
+{
+	char			*name;
+	omfInt32		order;		/* Position in the mob table */
+	omfObject_t		mob;
+} mobNameEntry_t;
+
+struct omfMobIndex
+{
+	omfBool			kindBuilt[kAllMob+1];
+	omfObject_t		*kindMobs[kAllMob+1];
+	omfInt32		numKindMobs[kAllMob+1];
+	omfBool			namesBuilt;
+	mobNameEntry_t	*names;		/* Sorted by name, then table order */
+	omfInt32		numNames;
+};
+
+/*************************************************************************
+ * Private Function: MobIsOfKind()
+ *
+ *      Returns TRUE if the mob is of the given kind, as used by the
+ *      kByMobKind search criteria.
+ *
+ * Argument Notes:
+ *      If an error occurs, it is returned as the last argument, and the
+ *      return value will be FALSE.
+ *
+ * ReturnValue:
+ *		Boolean (as described above)
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ *************************************************************************/
+static omfBool MobIsOfKind(
+    omfHdl_t file,         /* IN - File Handle */
+	omfMobObj_t mob,       /* IN - Mob object */
+	omfMobKind_t mobKind,  /* IN - Mob kind to test for */
+	omfErr_t *omfError)    /* OUT - Error code */
+{
+	*omfError = OM_ERR_NONE;
+	switch (mobKind)
+	  {
+	  case kCompMob:
+		return(omfiIsACompositionMob(file, mob, omfError));
+	  case kMasterMob:
+		return(omfiIsAMasterMob(file, mob, omfError));
+	  case kFileMob:
+		return(omfiIsAFileMob(file, mob, omfError));
+	  case kTapeMob:
+		return(omfiIsATapeMob(file, mob, omfError));
+	  case kFilmMob:
+		return(omfiIsAFilmMob(file, mob, omfError));
+	  case kPrimaryMob:
+		return(omfiIsAPrimaryMob(file, mob, omfError));
+	  case kAllMob:
+		return(TRUE);
+	  default:
+		return(FALSE);
+	  }
+}
+
+/*************************************************************************
+ * Function: ompvtIsMobIndexProp()		(INTERNAL)
+ *
+ *      Returns TRUE if writing the property can change the name or kind
+ *      of a mob, as tested by FindMobsByName() and MobIsOfKind().
+ *************************************************************************/
+omfBool ompvtIsMobIndexProp(
+    omfProperty_t prop)  /* IN - Property being written */
+{
+	return((prop == OMCPNTName) || (prop == OMMOBJName) ||
+		   (prop == OMMOBJUsageCode) || (prop == OMMOBJPhysicalMedia) ||
+		   (prop == OMMDESMobKind) || (prop == OMSMOBMediaDescription) ||
+		   (prop == OMHEADPrimaryMobs));
+}
+
+/*************************************************************************
+ * Function: ompvtDisposeMobIndex()		(INTERNAL)
+ *
+ *      Frees the mob indexes of a file, if any.
+ *************************************************************************/
+void ompvtDisposeMobIndex(
+    omfHdl_t file)       /* IN - File Handle */
+{
+	struct omfMobIndex	*index = file->mobIndex;
+	omfInt32			n;
+
+	if (index == NULL)
+	  return;
+
+	for (n = 0; n <= kAllMob; n++)
+	  {
+		if (index->kindMobs[n] != NULL)
+		  omOptFree(file, index->kindMobs[n]);
+	  }
+	for (n = 0; n < index->numNames; n++)
+	  omOptFree(file, index->names[n].name);
+	if (index->names != NULL)
+	  omOptFree(file, index->names);
+	omOptFree(file, index);
+	file->mobIndex = NULL;
+}
+
+/*************************************************************************
+ * Private Function: GetMobIndex()
+ *
+ *      Returns the mob indexes of a file, first dropping them if the
+ *      file has been edited since they were built.
+ *
+ * Argument Notes:
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ *************************************************************************/
+static omfErr_t GetMobIndex(
+    omfHdl_t file,                /* IN - File Handle */
+	struct omfMobIndex **result)  /* OUT - Mob indexes */
+{
+	struct omfMobIndex	*index;
+	omfInt32			n;
+
+	*result = NULL;
+	if ((file->mobIndex != NULL) && (file->mobIndexEdits != file->mobEditCount))
+	  ompvtDisposeMobIndex(file);
+
+	if (file->mobIndex == NULL)
+	  {
+		index = (struct omfMobIndex *)omOptMalloc(file, 
+											sizeof(struct omfMobIndex));
+		if (index == NULL)
+		  return(OM_ERR_NOMEMORY);
+		for (n = 0; n <= kAllMob; n++)
+		  {
+			index->kindBuilt[n] = FALSE;
+			index->kindMobs[n] = NULL;
+			index->numKindMobs[n] = 0;
+		  }
+		index->namesBuilt = FALSE;
+		index->names = NULL;
+		index->numNames = 0;
+		file->mobIndex = index;
+		file->mobIndexEdits = file->mobEditCount;
+	  }
+
+	*result = file->mobIndex;
+	return(OM_ERR_NONE);
+}
+
+/*************************************************************************
+ * Private Function: CompareMobNames()
+ *
+ *      qsort() comparison for the mob name index: by name, then by
+ *      mob table order.
+ *************************************************************************/
+static int CompareMobNames(
+	const void *a,
+	const void *b)
+{
+	const mobNameEntry_t *entryA = (const mobNameEntry_t *)a;
+	const mobNameEntry_t *entryB = (const mobNameEntry_t *)b;
+	int cmp;
+
+	cmp = strcmp(entryA->name, entryB->name);
+	if (cmp == 0)
+	  cmp = (entryA->order < entryB->order ? -1 : 
+			 (entryA->order > entryB->order ? 1 : 0));
+	return(cmp);
+}
+
+/*************************************************************************
+ * Private Function: FindMobsOfKind()
+ *
+ *      Returns a newly allocated list of the mobs of the given kind,
+ *      in mob table order.  The list is copied from the index for the
+ *      kind, which is built by testing every mob the first time.
+ *
+ * Argument Notes:
+ *      The caller must free the list (which may be NULL if *numMobs is
+ *      zero) with omOptFree().
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ *************************************************************************/
+static omfErr_t FindMobsOfKind(
+    omfHdl_t file,          /* IN - File Handle */
+	omfMobKind_t mobKind,   /* IN - Mob kind to search for */
+	omfObject_t **mobs,     /* OUT - List of matching mobs */
+	omfInt32 *numMobs)      /* OUT - and its length */
+{
+	struct omfMobIndex	*index;
+	omTableIterate_t	iter;
+	mobTableEntry_t		*mobEntry;
+	omfObject_t			*list = NULL, *newList;
+	omfInt32			listSize = 0, listMax = 0;
+	omfBool				more;
+	omfErr_t			omfError = OM_ERR_NONE;
+
+	*mobs = NULL;
+	*numMobs = 0;
+	XPROTECT(file)
+	  {
+		if ((mobKind < kCompMob) || (mobKind > kAllMob))
+		  {
+			RAISE(OM_ERR_INVALID_SEARCH_CRIT);
+		  }
+
+		/* Walk the table first, in case it is filled in on first use */
+		CHECK(omfsTableFirstEntry(file->mobs, &iter, &more));
+		CHECK(GetMobIndex(file, &index));
+		if (!index->kindBuilt[mobKind])
+		  {
+			while (more)
+			  {
+				mobEntry = (mobTableEntry_t *)iter.valuePtr;
+				if (MobIsOfKind(file, mobEntry->mob, mobKind, &omfError))
+				  {
+					if (listSize == listMax)
+					  {
+						listMax = (listMax == 0 ? 64 : listMax * 2);
+						newList = (omfObject_t *)omOptMalloc(file, 
+											listMax * sizeof(omfObject_t));
+						if (newList == NULL)
+						  {
+							RAISE(OM_ERR_NOMEMORY);
+						  }
+						if (list != NULL)
+						  {
+							memcpy(newList, list, listSize * sizeof(omfObject_t));
+							omOptFree(file, list);
+						  }
+						list = newList;
+					  }
+					list[listSize++] = mobEntry->mob;
+				  }
+				if (omfError != OM_ERR_NONE)
+				  {
+					RAISE(omfError);
+				  }
+				CHECK(omfsTableNextEntry(&iter, &more));
+			  }
+
+			index->kindMobs[mobKind] = list;
+			index->numKindMobs[mobKind] = listSize;
+			index->kindBuilt[mobKind] = TRUE;
+			list = NULL;
+		  }
+
+		listSize = index->numKindMobs[mobKind];
+		if (listSize != 0)
+		  {
+			*mobs = (omfObject_t *)omOptMalloc(file, 
+											listSize * sizeof(omfObject_t));
+			if (*mobs == NULL)
+			  {
+				RAISE(OM_ERR_NOMEMORY);
+			  }
+			memcpy(*mobs, index->kindMobs[mobKind], 
+				   listSize * sizeof(omfObject_t));
+		  }
+		*numMobs = listSize;
+	  }
+	XEXCEPT
+	  {
+		if (list != NULL)
+		  omOptFree(file, list);
+		return(XCODE());
+	  }
+	XEND;
+
+	return(OM_ERR_NONE);
+}
+
+/*************************************************************************
+ * Private Function: FindMobsByName()
+ *
+ *      Returns a newly allocated list of the mobs with the given name,
+ *      in mob table order.  The name index is built by reading the name
+ *      of every mob the first time, and is then binary searched.  Mobs
+ *      without a name are not in the index.
+ *
+ * Argument Notes:
+ *      The caller must free the list (which may be NULL if *numMobs is
+ *      zero) with omOptFree().
+ *
+ * ReturnValue:
+ *		Error code (see below).
+ *
+ * Possible Errors:
+ *		Standard errors (see top of file).
+ *************************************************************************/
+static omfErr_t FindMobsByName(
+    omfHdl_t file,          /* IN - File Handle */
+	omfString name,         /* IN - Mob name to search for */
+	omfObject_t **mobs,     /* OUT - List of matching mobs */
+	omfInt32 *numMobs)      /* OUT - and its length */
+{
+	struct omfMobIndex	*index;
+	omTableIterate_t	iter;
+	mobTableEntry_t		*mobEntry;
+	mobNameEntry_t		*names = NULL, *newNames;
+	omfInt32			numNames = 0, maxNames = 0, order = 0;
+	omfInt32			low, high, mid, first, n;
+	char				mobName[OMMOBNAME_SIZE];
+	omfProperty_t		prop;
+	omfBool				more;
+	omfErr_t			omfError;
+
+	*mobs = NULL;
+	*numMobs = 0;
+	XPROTECT(file)
+	  {
+		if ((file->setrev == kOmfRev1x) || file->setrev == kOmfRevIMA)
+		  prop = OMCPNTName;
+		else
+		  prop = OMMOBJName;
+
+		/* Walk the table first, in case it is filled in on first use */
+		CHECK(omfsTableFirstEntry(file->mobs, &iter, &more));
+		CHECK(GetMobIndex(file, &index));
+		if (!index->namesBuilt)
+		  {
+			while (more)
+			  {
+				mobEntry = (mobTableEntry_t *)iter.valuePtr;
+				omfError = omfsReadString(file, mobEntry->mob, prop,
+										  mobName, OMMOBNAME_SIZE);
+				if (omfError == OM_ERR_NONE)
+				  {
+					if (numNames == maxNames)
+					  {
+						maxNames = (maxNames == 0 ? 64 : maxNames * 2);
+						newNames = (mobNameEntry_t *)omOptMalloc(file, 
+										maxNames * sizeof(mobNameEntry_t));
+						if (newNames == NULL)
+						  {
+							RAISE(OM_ERR_NOMEMORY);
+						  }
+						if (names != NULL)
+						  {
+							memcpy(newNames, names, 
+								   numNames * sizeof(mobNameEntry_t));
+							omOptFree(file, names);
+						  }
+						names = newNames;
+					  }
+					names[numNames].name = (char *)omOptMalloc(file, 
+													strlen(mobName) + 1);
+					if (names[numNames].name == NULL)
+					  {
+						RAISE(OM_ERR_NOMEMORY);
+					  }
+					strcpy(names[numNames].name, mobName);
+					names[numNames].order = order;
+					names[numNames].mob = mobEntry->mob;
+					numNames++;
+				  }
+				else if (omfError != OM_ERR_PROP_NOT_PRESENT)
+				  {
+					RAISE(omfError);
+				  }
+				order++;
+				CHECK(omfsTableNextEntry(&iter, &more));
+			  }
+
+			if (numNames > 1)
+			  qsort(names, numNames, sizeof(mobNameEntry_t), CompareMobNames);
+			index->names = names;
+			index->numNames = numNames;
+			index->namesBuilt = TRUE;
+			names = NULL;
+			numNames = 0;
+		  }
+
+		/* Find the first entry with the name, then copy out the run */
+		low = 0;
+		high = index->numNames;
+		while (low < high)
+		  {
+			mid = (low + high) / 2;
+			if (strcmp(index->names[mid].name, name) < 0)
+			  low = mid + 1;
+			else
+			  high = mid;
+		  }
+		first = low;
+		for (n = first; n < index->numNames; n++)
+		  {
+			if (strcmp(index->names[n].name, name) != 0)
+			  break;
+		  }
+
+		if (n > first)
+		  {
+			*mobs = (omfObject_t *)omOptMalloc(file, 
+										(n - first) * sizeof(omfObject_t));
+			if (*mobs == NULL)
+			  {
+				RAISE(OM_ERR_NOMEMORY);
+			  }
+			for (low = first; low < n; low++)
+			  (*mobs)[low - first] = index->names[low].mob;
+		  }
+		*numMobs = n - first;
+	  }
+	XEXCEPT
+	  {
+		for (n = 0; n < numNames; n++)
+		  omOptFree(file, names[n].name);
+		if (names != NULL)
+		  omOptFree(file, names);
+		return(XCODE());
+	  }
+	XEND;
 
 	return(OM_ERR_NONE);
 }
@@ -4718,10 +5187,8 @@ omfErr_t omfiGetNextMob(
 	omfInt32 rememberCurrIndex;
 	omfBool initialized = FALSE, found = FALSE, firstTime = FALSE;
 	omfBool foundEntry;
-	omfString name;
 	omfUID_t mobID;
 	mobTableEntry_t *mobEntry;
-	omfProperty_t prop;
 	omfErr_t omfError = OM_ERR_NONE;
 
 	*mob = NULL;
@@ -4767,7 +5234,7 @@ omfErr_t omfiGetNextMob(
 				else if ((*searchCrit).searchTag == kByName)
 				  {
 					iterHdl->searchCrit.tags.name = (omfString)
-					  omOptMalloc(iterHdl->file, strlen((omfString)searchCrit->tags.name));
+					  omOptMalloc(iterHdl->file, strlen((omfString)searchCrit->tags.name) + 1);
 					strcpy( (char*) iterHdl->searchCrit.tags.name, 
 						   (omfString)searchCrit->tags.name);
 				  }
@@ -4783,6 +5250,43 @@ omfErr_t omfiGetNextMob(
 
 		initialized = TRUE;
 
+		/* Searches by kind and by name are answered from the mob indexes */
+		if ((iterHdl->searchCrit.searchTag == kByMobKind) ||
+			(iterHdl->searchCrit.searchTag == kByName))
+		  {
+			if (firstTime)
+			  {
+				if (iterHdl->mobList != NULL)
+				  {
+					omOptFree(iterHdl->file, iterHdl->mobList);
+					iterHdl->mobList = NULL;
+				  }
+				iterHdl->mobListSize = 0;
+				iterHdl->mobListNext = 0;
+				if (iterHdl->searchCrit.searchTag == kByMobKind)
+				  {
+					CHECK(FindMobsOfKind(iterHdl->file, 
+										 iterHdl->searchCrit.tags.mobKind,
+										 &iterHdl->mobList, 
+										 &iterHdl->mobListSize));
+				  }
+				else
+				  {
+					CHECK(FindMobsByName(iterHdl->file, 
+										 iterHdl->searchCrit.tags.name,
+										 &iterHdl->mobList, 
+										 &iterHdl->mobListSize));
+				  }
+			  }
+
+			if (iterHdl->mobListNext >= iterHdl->mobListSize)
+			  {
+				RAISE(OM_ERR_NO_MORE_OBJECTS);
+			  }
+			*mob = iterHdl->mobList[iterHdl->mobListNext++];
+			return(OM_ERR_NONE);
+		  }
+
 		/* GET NEXT MOB using search criteria */
 		if (firstTime)
 		{
@@ -4804,53 +5308,12 @@ omfErr_t omfiGetNextMob(
 				found = TRUE;
 				break;
 				
-			  case kByName:
-				if ((iterHdl->file->setrev == kOmfRev1x) || 
-					iterHdl->file->setrev == kOmfRevIMA)
-				  prop = OMCPNTName;
-				else
-				  prop = OMMOBJName;
-				name = (omfString)omOptMalloc(iterHdl->file, OMMOBNAME_SIZE);
-				omfError = omfsReadString(iterHdl->file, tmpMob, prop,
-									 (char *)name, OMMOBNAME_SIZE);
-				if (name)
-				  {
-					if (!strcmp(name, iterHdl->searchCrit.tags.name))
-					  found = TRUE;
-				  }
-				if (name)
-				  omOptFree(iterHdl->file, name);
-				break;
-
 			  case kByMobID:
 				CHECK(omfsReadUID(iterHdl->file, tmpMob, OMMOBJMobID, &mobID));
 				if (equalUIDs(mobID, iterHdl->searchCrit.tags.mobID))
 					found = TRUE;
 				break;
 
-			  case kByMobKind:
-				if ((iterHdl->searchCrit.tags.mobKind == kCompMob) && 
-					omfiIsACompositionMob(iterHdl->file, tmpMob, &omfError))
-				  found = TRUE;
-				else if ((iterHdl->searchCrit.tags.mobKind == kMasterMob) && 
-					omfiIsAMasterMob(iterHdl->file, tmpMob, &omfError))
-				  found = TRUE;
-				else if ((iterHdl->searchCrit.tags.mobKind == kFileMob) && 
-				    omfiIsAFileMob(iterHdl->file, tmpMob, &omfError))
-				  found = TRUE;
-				else if ((iterHdl->searchCrit.tags.mobKind == kTapeMob) && 
-					omfiIsATapeMob(iterHdl->file, tmpMob, &omfError))
-				  found = TRUE;
-				else if ((iterHdl->searchCrit.tags.mobKind == kFilmMob) && 
-					omfiIsAFilmMob(iterHdl->file, tmpMob, &omfError))
-				  found = TRUE;
-				else if ((iterHdl->searchCrit.tags.mobKind == kPrimaryMob) &&
-						 omfiIsAPrimaryMob(iterHdl->file, tmpMob, &omfError))
-				  found = TRUE;
-				else if (iterHdl->searchCrit.tags.mobKind == kAllMob)
-				  found = TRUE;
-				break;
-
 			  default: /* Shouldn't reach this point */
 				RAISE(OM_ERR_INVALID_SEARCH_CRIT);
 				break;
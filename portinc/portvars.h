@@ -215,6 +215,17 @@
 #define PORT_COMP_MICROSOFT	0
 #endif
 
+/* Spelling of "inline" for small functions defined in headers */
+#if PORT_LANG_CPLUSPLUS || (defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L)
+#define PORT_INLINE	inline
+#elif defined(__GNUC__)
+#define PORT_INLINE	__inline__
+#elif PORT_COMP_MICROSOFT
+#define PORT_INLINE	__inline
+#else
+#define PORT_INLINE
+#endif
+
 #if defined(THINK_C)
 #define PORT_MAC_QD_SEPGLOBALS			1		/* Quickdraw globals not in structure */
 #else
@@ -0,0 +1,252 @@
+/***********************************************************************
+ *
+ *              Copyright (c) 1996 Avid Technology, Inc.
+ *
+ * Permission to use, copy and modify this software and to distribute
+ * and sublicense application software incorporating this software for
+ * any purpose is hereby granted, provided that (i) the above
+ * copyright notice and this permission notice appear in all copies of
+ * the software and related documentation, and (ii) the name Avid
+ * Technology, Inc. may not be used in any advertising or publicity
+ * relating to the software without the specific, prior written
+ * permission of Avid Technology, Inc.
+ *
+ * THE SOFTWARE IS PROVIDED "AS-IS" AND WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS, IMPLIED OR OTHERWISE, INCLUDING WITHOUT LIMITATION, ANY
+ * WARRANTY OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.
+ * IN NO EVENT SHALL AVID TECHNOLOGY, INC. BE LIABLE FOR ANY DIRECT,
+ * SPECIAL, INCIDENTAL, INDIRECT, CONSEQUENTIAL OR OTHER DAMAGES OF
+ * ANY KIND, OR ANY DAMAGES WHATSOEVER ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE, INCLUDING,
+ * WITHOUT  LIMITATION, DAMAGES RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, AND WHETHER OR NOT ADVISED OF THE POSSIBILITY OF
+ * DAMAGE, REGARDLESS OF THE THEORY OF LIABILITY.
+ *
+ ************************************************************************/
+
+/********************************************************************
+ * CvtBench - Times the two Toolkit paths that lean hardest on the
+ *          64-bit math of omCvt.h: finding a component of a long
+ *          sequence by position (MobFindCpntByPosition) and reading
+ *          a media data property in small pieces (omcReadStream).
+ *          Like IOBench, this is a standalone program and is not run
+ *          by UnitTest.  Build it against the library once with and
+ *          once without the change being measured, and compare the
+ *          nanoseconds per call it reports.
+ ********************************************************************/
+
+#include "masterhd.h"
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#define OMFI_ENABLE_SEMCHECK 1 /* for types defined in omPvt.h */
+
+#include "omPublic.h"
+#include "omMedia.h"
+#include "omPvt.h"
+#include "omcStrm.h"
+
+#define BENCH_FILE		"CvtBench.omf"
+#define NUM_SEGMENTS	5000L		/* fillers in the sequence searched */
+#define FIND_PASSES		200L		/* times every segment is looked up */
+#define DATA_BYTES		(4L * 1024L * 1024L)
+#define READ_SIZE		64L			/* bytes per omcReadStream() call */
+#define READ_PASSES		20L			/* times the data is read through */
+#define NUM_RUNS		7			/* best of this many runs is reported */
+
+#define check(a)  { omfErr_t e; e = a; \
+			  if (e != OM_ERR_NONE) FatalErrorCode(e, __LINE__, __FILE__); }
+
+static void FatalErrorCode(omfErr_t errcode, int line, char *file)
+{
+	printf("Error '%s' returned at line %d in %s\n",
+	       omfsGetErrorString(errcode), line, file);
+	exit(1);
+}
+
+/****************/
+/* nsPerCall    */
+/****************/
+static double nsPerCall(clock_t start, clock_t end, double calls)
+{
+	return(((double)(end - start) / CLOCKS_PER_SEC) * 1e9 / calls);
+}
+
+/****************/
+/* BenchFind    */
+/****************/
+/* Builds a composition mob whose one track is a sequence of
+ * NUM_SEGMENTS fillers of varying length, then looks every segment
+ * up by a position inside it FIND_PASSES times.
+ */
+static double BenchFind(omfSessionHdl_t session)
+{
+	omfHdl_t		file;
+	omfObject_t		mob, seq, fill, found;
+	omfDDefObj_t	pictureKind;
+	omfMSlotObj_t	track;
+	omfRational_t	editRate;
+	omfLength_t		fillLen, foundLen;
+	omfPosition_t	zero, pos, diff;
+	omfInt32		n, pass, start;
+	omfErr_t		status;
+	clock_t			startTime, endTime;
+
+	editRate.numerator = 2997;
+	editRate.denominator = 100;
+	omfsCvtInt32toPosition(0, zero);
+
+	remove(BENCH_FILE);
+	check(omfsCreateFile((fileHandleType)BENCH_FILE, session, kOmfRev2x, &file));
+	omfiDatakindLookup(file, PICTUREKIND, &pictureKind, &status);
+	check(status);
+	check(omfiCompMobNew(file, "CvtBench", TRUE, &mob));
+	check(omfiSequenceNew(file, pictureKind, &seq));
+	for(n = 0; n < NUM_SEGMENTS; n++)
+	{
+		omfsCvtInt32toLength(10 + (n % 7), fillLen);
+		check(omfiFillerNew(file, pictureKind, fillLen, &fill));
+		check(omfiSequenceAppendCpnt(file, seq, fill));
+	}
+	check(omfiMobAppendNewTrack(file, mob, editRate, seq, zero, 1, "V1", &track));
+
+	startTime = clock();
+	for(pass = 0; pass < FIND_PASSES; pass++)
+	{
+		for(n = 0, start = 0; n < NUM_SEGMENTS; n++)
+		{
+			omfsCvtInt32toPosition(start + 5, pos);
+			status = MobFindCpntByPosition(file, mob, 1, seq, zero, pos, NULL,
+											&diff, &found, &foundLen);
+			if(status != OM_ERR_FILL_FOUND)
+				check(status);
+			start += 10 + (n % 7);
+		}
+	}
+	endTime = clock();
+
+	check(omfsCloseFile(file));
+	return(nsPerCall(startTime, endTime, (double)FIND_PASSES * NUM_SEGMENTS));
+}
+
+/****************/
+/* WriteData    */
+/****************/
+/* Writes DATA_BYTES of image data through a codec stream into a
+ * new image data object, so the read pass has something to stream.
+ */
+static void WriteData(omfSessionHdl_t session)
+{
+	omfHdl_t			file;
+	omfObject_t			dataObj;
+	omfCodecStream_t	stream;
+	char				buf[4096];
+	omfInt32			n;
+
+	for(n = 0; n < (omfInt32)sizeof(buf); n++)
+		buf[n] = (char)n;
+
+	remove(BENCH_FILE);
+	check(omfsCreateFile((fileHandleType)BENCH_FILE, session, kOmfRev2x, &file));
+	check(omfsObjectNew(file, "IDAT", &dataObj));
+	memset(&stream, 0, sizeof(stream));
+	check(omcOpenStream(file, file, &stream, dataObj, OMIDATImageData, OMDataValue));
+	for(n = 0; n < DATA_BYTES / (omfInt32)sizeof(buf); n++)
+		check(omcWriteStream(&stream, sizeof(buf), buf));
+	check(omcCloseStream(&stream));
+	check(omfsCloseFile(file));
+}
+
+/****************/
+/* BenchRead    */
+/****************/
+/* Reads the image data written by WriteData() READ_SIZE bytes at a
+ * time, READ_PASSES times over.
+ */
+static double BenchRead(omfSessionHdl_t session)
+{
+	omfHdl_t			file;
+	omfIterHdl_t		iter;
+	omfObject_t			obj, dataObj = NULL;
+	omfClassID_t		classID;
+	omfCodecStream_t	stream;
+	char				buf[READ_SIZE];
+	omfUInt32			bytesRead;
+	omfInt32			pass;
+	double				calls = 0.0;
+	clock_t				startTime, endTime;
+
+	check(omfsOpenFile((fileHandleType)BENCH_FILE, session, &file));
+	check(omfiIteratorAlloc(file, &iter));
+	while(dataObj == NULL && omfiGetNextObject(iter, &obj) == OM_ERR_NONE && obj)
+	{
+		if(omfsReadClassID(file, obj, OMOOBJObjClass, classID) == OM_ERR_NONE &&
+		   strncmp(classID, "IDAT", 4) == 0)
+			dataObj = obj;
+	}
+	check(omfiIteratorDispose(file, iter));
+	if(dataObj == NULL)
+	{
+		printf("No image data found in %s\n", BENCH_FILE);
+		exit(1);
+	}
+
+	startTime = clock();
+	for(pass = 0; pass < READ_PASSES; pass++)
+	{
+		memset(&stream, 0, sizeof(stream));
+		check(omcOpenStream(file, file, &stream, dataObj, OMIDATImageData, OMDataValue));
+		while(omcReadStream(&stream, sizeof(buf), buf, &bytesRead) == OM_ERR_NONE)
+			calls += 1.0;
+		check(omcCloseStream(&stream));
+	}
+	endTime = clock();
+
+	check(omfsCloseFile(file));
+	if(calls != (double)READ_PASSES * (DATA_BYTES / READ_SIZE))
+	{
+		printf("Read %.0f pieces, expected %ld\n", calls, READ_PASSES * (DATA_BYTES / READ_SIZE));
+		exit(1);
+	}
+	return(nsPerCall(startTime, endTime, calls));
+}
+
+int main(void)
+{
+	omfSessionHdl_t	session;
+	double			find, read, bestFind = 0.0, bestRead = 0.0;
+	int				run;
+
+	check(omfsBeginSession(NULL, &session));
+	check(omfmInit(session));
+
+	printf("OMFI 64-bit math benchmarking (best of %d runs)\n", NUM_RUNS);
+	for(run = 1; run <= NUM_RUNS; run++)
+	{
+		find = BenchFind(session);
+		WriteData(session);
+		read = BenchRead(session);
+		printf("Run %d: MobFindCpntByPosition %8.1f ns/call, omcReadStream %8.1f ns/call\n",
+			   run, find, read);
+		if(run == 1 || find < bestFind)
+			bestFind = find;
+		if(run == 1 || read < bestRead)
+			bestRead = read;
+	}
+	printf("******* DONE *******\n");
+	printf("MobFindCpntByPosition, %ld-entry sequence: %8.1f ns/call\n", NUM_SEGMENTS, bestFind);
+	printf("omcReadStream, %ld-byte reads:              %8.1f ns/call\n", READ_SIZE, bestRead);
+
+	check(omfsEndSession(session));
+	remove(BENCH_FILE);
+	return(0);
+}
+
+/* INDENT OFF */
+/*
+;;; Local Variables: ***
+;;; tab-width:4 ***
+;;; End: ***
+*/
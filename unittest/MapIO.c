@@ -0,0 +1,310 @@
+/***********************************************************************
+ *
+ *              Copyright (c) 1996 Avid Technology, Inc.
+ *
+ * Permission to use, copy and modify this software and to distribute
+ * and sublicense application software incorporating this software for
+ * any purpose is hereby granted, provided that (i) the above
+ * copyright notice and this permission notice appear in all copies of
+ * the software and related documentation, and (ii) the name Avid
+ * Technology, Inc. may not be used in any advertising or publicity
+ * relating to the software without the specific, prior written
+ * permission of Avid Technology, Inc.
+ *
+ * THE SOFTWARE IS PROVIDED "AS-IS" AND WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS, IMPLIED OR OTHERWISE, INCLUDING WITHOUT LIMITATION, ANY
+ * WARRANTY OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.
+ * IN NO EVENT SHALL AVID TECHNOLOGY, INC. BE LIABLE FOR ANY DIRECT,
+ * SPECIAL, INCIDENTAL, INDIRECT, CONSEQUENTIAL OR OTHER DAMAGES OF
+ * ANY KIND, OR ANY DAMAGES WHATSOEVER ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE, INCLUDING,
+ * WITHOUT  LIMITATION, DAMAGES RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, AND WHETHER OR NOT ADVISED OF THE POSSIBILITY OF
+ * DAMAGE, REGARDLESS OF THE THEORY OF LIABILITY.
+ *
+ ************************************************************************/
+/********************************************************************
+ * MapIO - This unittest opens an existing OMF file through both
+ *          mappedContainerMetahandler and containerMetahandler, and
+ *          checks that they agree.  The Bento handlers themselves are
+ *          driven through the same seeks and reads, with the read cache
+ *          on and then off, comparing the data, positions and EOF
+ *          status.  Then the whole file is opened through each, and
+ *          the objects in it are counted.
+ ********************************************************************/
+
+#include "masterhd.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "omPublic.h"
+#include "omMedia.h"
+#include "omPvt.h"
+#include "XHandlrs.h"
+
+#include "UnitTest.h"
+
+#define MAP_CHUNK		4096
+
+typedef CMRefCon	(*mapOpenProc_t)(CMRefCon attributes, CMOpenMode mode);
+typedef void		(*mapCloseProc_t)(CMRefCon refCon);
+typedef CMSize32	(*mapSeekProc_t)(CMRefCon refCon, CMCount posOff, CMSeekMode mode);
+typedef CMSize		(*mapTellProc_t)(CMRefCon refCon);
+typedef CMSize32	(*mapReadProc_t)(CMRefCon refCon, CMPtr buffer, CMSize32 elementSize,
+										CMCount32 theCount);
+typedef CMEofStatus	(*mapEofProc_t)(CMRefCon refCon);
+typedef CMSize		(*mapSizeProc_t)(CMRefCon refCon);
+
+typedef struct
+{
+	CMRefCon		refCon;
+	mapCloseProc_t	close;
+	mapSeekProc_t	seek;
+	mapTellProc_t	tell;
+	mapReadProc_t	read;
+	mapEofProc_t	eof;
+	mapSizeProc_t	size;
+} mapHandlers_t;
+
+typedef struct
+{
+	omfInt32		offset;
+	CMSeekMode		mode;
+	omfInt32		bytes;
+} mapStep_t;
+
+/* Seeks of each kind, reads across cache blocks, and reads which end
+ * at, straddle, start at and start past the end of the file.
+ */
+static mapStep_t steps[] = {
+	{ 0,		kCMSeekSet,		24 },
+	{ 100,		kCMSeekCurrent,	1000 },
+	{ -24,		kCMSeekEnd,		24 },
+	{ 0,		kCMSeekCurrent,	1 },
+	{ 5,		kCMSeekSet,		1 },
+	{ -10,		kCMSeekEnd,		100 },
+	{ 4000,		kCMSeekSet,		70000 },
+	{ -3000,	kCMSeekCurrent,	500 },
+	{ 10,		kCMSeekEnd,		10 },
+	{ 1,		kCMSeekSet,		MAP_CHUNK }
+};
+
+static int OpenHandlers(CMHandlerAddr (*metahandler)(CMType, CMconst_CMGlobalName),
+						omfHdl_t file, char *filename, mapHandlers_t *h);
+static int CompareHandlers(omfHdl_t file, char *filename);
+static int CountObjects(omfSessionHdl_t session, char *filename,
+						omfInt32 *numObjects, omfInt32 *numMobs);
+
+#ifdef MAKE_TEST_HARNESS
+int MapIO(char *filename)
+{
+  int argc;
+  char *argv[2];
+#else
+int main(int argc, char *argv[])
+{
+#endif
+	omfSessionHdl_t				session;
+	omfHdl_t					fileHdl;
+	struct omfiBentoIOFuncs		ioFuncs;
+	omfInt32					streamObjs, streamMobs, mappedObjs, mappedMobs;
+	int							failures = 0;
+	omfProductIdentification_t	ProductInfo;
+
+	ProductInfo.companyName = "OMF Developers Desk";
+	ProductInfo.productName = "MapIO UnitTest";
+	ProductInfo.productVersion = omfiToolkitVersion;
+	ProductInfo.productVersionString = NULL;
+	ProductInfo.productID = -1;
+	ProductInfo.platform = NULL;
+
+	XPROTECT(NULL)
+	{
+#ifdef MAKE_TEST_HARNESS
+		argc = 2;
+		argv[1] = filename;
+#endif
+		if (argc < 2)
+		{
+			printf("*** ERROR - missing file name\n");
+			return(1);
+		}
+
+		/* The handlers, with the read cache on and then off */
+		CHECK(omfsBeginSession(&ProductInfo, &session));
+		CHECK(omfsOpenFile((fileHandleType) argv[1], session, &fileHdl));
+		failures += CompareHandlers(fileHdl, argv[1]);
+		CHECK(omfsSetReadCacheSize(session, 0, 0, 0));
+		failures += CompareHandlers(fileHdl, argv[1]);
+		CHECK(omfsCloseFile(fileHdl));
+
+		/* The whole file */
+		if (CountObjects(session, argv[1], &streamObjs, &streamMobs))
+			failures++;
+		ioFuncs = session->ioFuncs;
+		ioFuncs.containerMetahandlerFunc = mappedContainerMetahandler;
+		CHECK(omfsSetSessionIOHandlers(session, ioFuncs));
+		if (CountObjects(session, argv[1], &mappedObjs, &mappedMobs))
+			failures++;
+		if ((mappedObjs != streamObjs) || (mappedMobs != streamMobs))
+		{
+			printf("***ERROR: Mapped open found %ld objects and %ld mobs, expected %ld and %ld\n",
+				   (long)mappedObjs, (long)mappedMobs, (long)streamObjs, (long)streamMobs);
+			failures++;
+		}
+		CHECK(omfsEndSession(session));
+	}
+	XEXCEPT
+	{
+		printf("***ERROR: %d: %s\n", XCODE(), omfsGetErrorString(XCODE()));
+		return(-1);
+	}
+	XEND;
+
+	if (failures == 0)
+		printf("MapIO completed successfully.\n");
+	return(failures);
+}
+
+/****************/
+/* OpenHandlers */
+/****************/
+static int OpenHandlers(CMHandlerAddr (*metahandler)(CMType, CMconst_CMGlobalName),
+						omfHdl_t file, char *filename, mapHandlers_t *h)
+{
+	mapOpenProc_t	open;
+
+	open = (mapOpenProc_t)(*metahandler)(NULL, CMOpenOpType);
+	h->close = (mapCloseProc_t)(*metahandler)(NULL, CMCloseOpType);
+	h->seek = (mapSeekProc_t)(*metahandler)(NULL, CMSeekOpType);
+	h->tell = (mapTellProc_t)(*metahandler)(NULL, CMTellOpType);
+	h->read = (mapReadProc_t)(*metahandler)(NULL, CMReadOpType);
+	h->eof = (mapEofProc_t)(*metahandler)(NULL, CMEofOpType);
+	h->size = (mapSizeProc_t)(*metahandler)(NULL, CMSizeOpType);
+
+	h->refCon = createRefConForMyHandlers(file->session->BentoSession, filename,
+											NULL, file);
+	if ((h->refCon == NULL) || ((*open)(h->refCon, (CMOpenMode)"rb") == NULL))
+	{
+		printf("***ERROR: Can't open %s through the container handlers\n", filename);
+		return(1);
+	}
+	return(0);
+}
+
+/*******************/
+/* CompareHandlers */
+/*******************/
+static int CompareHandlers(omfHdl_t file, char *filename)
+{
+	mapHandlers_t	mapped, stream;
+	char			*mapBuf, *streamBuf;
+	CMCount			offset;
+	CMSize32		mapRead, streamRead, mapSeek, streamSeek;
+	omfInt32		n, size32, failures = 0;
+
+	if (OpenHandlers(mappedContainerMetahandler, file, filename, &mapped) ||
+		OpenHandlers(containerMetahandler, file, filename, &stream))
+		return(1);
+	mapBuf = (char *)omfsMalloc(70000);
+	streamBuf = (char *)omfsMalloc(70000);
+
+	if (omfsInt64NotEqual((*mapped.size)(mapped.refCon), (*stream.size)(stream.refCon)))
+	{
+		printf("***ERROR: Mapped container size differs\n");
+		failures++;
+	}
+
+	for (n = 0; n < (omfInt32)(sizeof(steps) / sizeof(steps[0])); n++)
+	{
+		omfsCvtInt32toInt64(steps[n].offset, &offset);
+		mapSeek = (*mapped.seek)(mapped.refCon, offset, steps[n].mode);
+		streamSeek = (*stream.seek)(stream.refCon, offset, steps[n].mode);
+		mapRead = (*mapped.read)(mapped.refCon, mapBuf, 1, steps[n].bytes);
+		streamRead = (*stream.read)(stream.refCon, streamBuf, 1, steps[n].bytes);
+		if ((mapSeek != streamSeek) || (mapRead != streamRead) ||
+			(memcmp(mapBuf, streamBuf, streamRead) != 0) ||
+			omfsInt64NotEqual((*mapped.tell)(mapped.refCon), (*stream.tell)(stream.refCon)) ||
+			(((*mapped.eof)(mapped.refCon) != 0) != ((*stream.eof)(stream.refCon) != 0)))
+		{
+			printf("***ERROR: Mapped handlers differ at step %ld (read %lu, expected %lu)\n",
+				   (long)n, (unsigned long)mapRead, (unsigned long)streamRead);
+			failures++;
+		}
+	}
+
+	/* Read the rest of the file from the last step's position */
+	do
+	{
+		mapRead = (*mapped.read)(mapped.refCon, mapBuf, 1, MAP_CHUNK);
+		streamRead = (*stream.read)(stream.refCon, streamBuf, 1, MAP_CHUNK);
+		if ((mapRead != streamRead) || (memcmp(mapBuf, streamBuf, streamRead) != 0))
+		{
+			printf("***ERROR: Mapped data differs\n");
+			failures++;
+			break;
+		}
+	} while (streamRead == MAP_CHUNK);
+	if (((*mapped.eof)(mapped.refCon) == 0) || ((*stream.eof)(stream.refCon) == 0))
+	{
+		printf("***ERROR: Missing EOF after reading to the end\n");
+		failures++;
+	}
+	omfsTruncInt64toInt32((*stream.tell)(stream.refCon), &size32);
+	if (size32 <= MAP_CHUNK)
+	{
+		printf("***ERROR: %s is too small to test the handlers\n", filename);
+		failures++;
+	}
+
+	(*mapped.close)(mapped.refCon);
+	(*stream.close)(stream.refCon);
+	omfsFree(mapBuf);
+	omfsFree(streamBuf);
+	return(failures);
+}
+
+/****************/
+/* CountObjects */
+/****************/
+static int CountObjects(omfSessionHdl_t session, char *filename,
+						omfInt32 *numObjects, omfInt32 *numMobs)
+{
+	omfHdl_t		fileHdl = NULL;
+	omfIterHdl_t	objIter = NULL;
+	omfObject_t		obj;
+
+	*numObjects = 0;
+	*numMobs = 0;
+	XPROTECT(NULL)
+	{
+		CHECK(omfsOpenFile((fileHandleType) filename, session, &fileHdl));
+		CHECK(omfiIteratorAlloc(fileHdl, &objIter));
+		while ((omfiGetNextObject(objIter, &obj) == OM_ERR_NONE) && obj)
+			(*numObjects)++;
+		CHECK(omfiIteratorDispose(fileHdl, objIter));
+		objIter = NULL;
+		CHECK(omfiGetNumMobs(fileHdl, kAllMob, numMobs));
+		CHECK(omfsCloseFile(fileHdl));
+	}
+	XEXCEPT
+	{
+		printf("***ERROR: %d: %s\n", XCODE(), omfsGetErrorString(XCODE()));
+		if (objIter)
+			omfiIteratorDispose(fileHdl, objIter);
+		if (fileHdl)
+			omfsCloseFile(fileHdl);
+		return(1);
+	}
+	XEND;
+
+	return(0);
+}
+
+/* INDENT OFF */
+/*
+;;; Local Variables: ***
+;;; tab-width:4 ***
+;;; End: ***
+*/
@@ -719,7 +719,10 @@ omfErr_t processEffect(omfHdl_t file,
  		CHECK(omfsInt64ToString(sourceRef.startTime, 10, sizeof(posBuf), posBuf));  
 		sprintf(printString,
 		    "Working Render - MobID %ld.%ld.%ld, Track %ld, Position %s\n",
-			sourceRef.sourceID, sourceRef.sourceTrackID, 
+			sourceRef.sourceID.prefix, 
+			sourceRef.sourceID.major, 
+			sourceRef.sourceID.minor, 
+			sourceRef.sourceTrackID, 
 			posBuf);
 	      }
 	  }
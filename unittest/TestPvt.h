@@ -114,4 +114,5 @@ int Wrap2TstAttr(char *filename, char *out);
 int WrapIMATstAttr(char *filename, char *out);
 int WrapTestCodecs(char *filename, char *out);
 int WrapCompIter(char *filename, char *out);
+int WrapMapIO(char *filename, char *out);
 
@@ -222,6 +222,8 @@ int WrapTestCodecs(char *filename, char *out)
 { return(TestCodecs()); }
 int WrapCompIter(char *filename, char *out)
 { return(TestCompIter(filename)); }
+int WrapMapIO(char *filename, char *out)
+{ return(MapIO(filename)); }
 
 /***************************/
 /*   Utility Functions     */
@@ -953,6 +955,10 @@ static int init_table()
 	    "Veriifies the workings of the codec user selection functions",
 	    "Prints out the complete list of codecs and their varieties.",
 	    kOmPosTest);
+  add2table("MappedIO","ManyObjs2x",WrapMapIO,NULL,
+	    "ManyO2x.omf",NULL,
+	    "reads a file through the memory-mapped and the stream Bento handlers, and compares them (2.x)",
+	    NULL,kOmNegTest);
 
   /* Now initialize the RunTheseTests & TheseTestsFailed */
   for (i=1; i<MAXTESTS; i++) 
@@ -62,6 +62,7 @@ int TstAttr(char *filename, char *version);
 int Patch1x(char *filename, char *version);
 int TestCodecs(void);
 int TestCompIter(char *filename);
+int MapIO(char *filename);
 #endif
 
 